@@ -0,0 +1,70 @@
+# Writes a C++ source that embeds compiled SPIR-V into the executable, so startup never reads or
+# compiles shaders. Each shader is keyed by the SHA-256 of its compile flags and GLSL source; the
+# renderer's hot-reload path recomputes the key and only recompiles shaders whose source changed.
+#
+#   cmake -DROSE_SHADER_NAMES=<a.vert,b.frag,...> -DROSE_SHADER_SOURCE_DIR=<dir>
+#         -DROSE_SHADER_OUTPUT_DIR=<dir> -DROSE_SHADER_FLAGS=<flags> -DROSE_EMBED_OUTPUT=<file>
+#         -P embed_shaders.cmake
+
+string(REPLACE "," ";" ROSE_SHADER_NAMES "${ROSE_SHADER_NAMES}")
+string(SHA256 ROSE_SHADER_FLAGS_HASH "${ROSE_SHADER_FLAGS}")
+
+set(ROSE_EMBED_ARRAYS "")
+set(ROSE_EMBED_ENTRIES "")
+foreach (ROSE_SHADER_NAME IN LISTS ROSE_SHADER_NAMES)
+    string(MAKE_C_IDENTIFIER "${ROSE_SHADER_NAME}" ROSE_SHADER_IDENTIFIER)
+    file(SHA256 "${ROSE_SHADER_SOURCE_DIR}/${ROSE_SHADER_NAME}" ROSE_SOURCE_HASH)
+    string(SHA256 ROSE_SHADER_KEY "${ROSE_SHADER_FLAGS_HASH}${ROSE_SOURCE_HASH}")
+
+    file(READ "${ROSE_SHADER_OUTPUT_DIR}/${ROSE_SHADER_NAME}.spv" ROSE_SPIRV_HEX HEX)
+    string(LENGTH "${ROSE_SPIRV_HEX}" ROSE_SPIRV_HEX_LENGTH)
+    math(EXPR ROSE_SPIRV_REMAINDER "${ROSE_SPIRV_HEX_LENGTH} % 8")
+    if (ROSE_SPIRV_HEX_LENGTH EQUAL 0 OR NOT ROSE_SPIRV_REMAINDER EQUAL 0)
+        message(FATAL_ERROR "${ROSE_SHADER_NAME}.spv is not a whole number of SPIR-V words")
+    endif ()
+    # SPIR-V is little-endian; emit one 32-bit word per four bytes, eight words per line.
+    string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1u, " ROSE_SPIRV_WORDS "${ROSE_SPIRV_HEX}")
+    string(REGEX REPLACE "((0x........u, ){8})" "\\1\n                " ROSE_SPIRV_WORDS "${ROSE_SPIRV_WORDS}")
+    string(STRIP "${ROSE_SPIRV_WORDS}" ROSE_SPIRV_WORDS)
+
+    string(APPEND ROSE_EMBED_ARRAYS
+            "        constexpr uint32_t k_${ROSE_SHADER_IDENTIFIER}[] = {\n"
+            "                ${ROSE_SPIRV_WORDS}\n"
+            "        };\n\n")
+    string(APPEND ROSE_EMBED_ENTRIES
+            "            EmbeddedShader{\"${ROSE_SHADER_NAME}.spv\", \"${ROSE_SHADER_NAME}\", \"${ROSE_SHADER_KEY}\", k_${ROSE_SHADER_IDENTIFIER}},\n")
+endforeach ()
+
+set(ROSE_EMBED_SOURCE "// Generated by cmake/embed_shaders.cmake. Do not edit.
+#include \"rose/core/vulkan/shader_library.hpp\"
+
+#include <array>
+
+namespace rose::core::vulkan
+{
+    namespace
+    {
+${ROSE_EMBED_ARRAYS}        const std::array k_embedded_shaders{
+${ROSE_EMBED_ENTRIES}        };
+    } // namespace
+
+    std::span<const EmbeddedShader> embedded_shaders() noexcept
+    {
+        return k_embedded_shaders;
+    }
+
+    std::string_view embedded_shader_flags() noexcept
+    {
+        return \"${ROSE_SHADER_FLAGS}\";
+    }
+} // namespace rose::core::vulkan
+")
+
+# Leave the file untouched when nothing changed so dependent objects are not rebuilt.
+if (EXISTS "${ROSE_EMBED_OUTPUT}")
+    file(READ "${ROSE_EMBED_OUTPUT}" ROSE_EMBED_PREVIOUS)
+    if (ROSE_EMBED_PREVIOUS STREQUAL ROSE_EMBED_SOURCE)
+        return()
+    endif ()
+endif ()
+file(WRITE "${ROSE_EMBED_OUTPUT}" "${ROSE_EMBED_SOURCE}")
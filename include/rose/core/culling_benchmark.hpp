@@ -0,0 +1,13 @@
+//
+// Created by orange on 16.10.2026.
+//
+#pragma once
+
+namespace rose::core
+{
+    // Times frustum culling of a synthetic scene of random boxes against a camera and four shadow
+    // cascades: Frustum::intersects() box by box, then the SIMD kernel into masks and into an
+    // index list. Logs the time per box of each and fails loudly if they disagree. Needs no
+    // window or GPU.
+    void run_culling_benchmark();
+} // namespace rose::core
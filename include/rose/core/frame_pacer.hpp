@@ -0,0 +1,78 @@
+//
+// Created by orange on 16.10.2026.
+//
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <deque>
+
+namespace rose::core
+{
+    enum class FramePacingMode : int
+    {
+        Unpaced,
+        FixedRate,  // the FPS limit
+        StreamRate, // the stream capture rate while a stream is connected, else the FPS limit
+        Display     // VK_KHR_present_wait: at most one frame waits for the display, no CPU limit
+    };
+
+    struct FramePacingStats final
+    {
+        double target_ms = 0.0;      // 0 when unpaced
+        double mean_ms = 0.0;        // frame start to frame start
+        double jitter_ms = 0.0;      // standard deviation of the frame time
+        double p99_ms = 0.0;
+        double max_ms = 0.0;
+        double oversleep_ms = 0.0;   // how early the pacer currently wakes before a deadline
+        double spin_ms = 0.0;        // mean time per frame spent yielding after the last sleep
+        std::size_t late_frames = 0; // frames more than 10% longer than the target
+        std::size_t samples = 0;
+    };
+
+    // Starts frames on a fixed schedule without spinning a core. The pacer sleeps until shortly
+    // before each deadline, by the OS oversleep it has measured so far (mean plus two standard
+    // deviations), and only yields through that last stretch. A frame that misses its deadline by
+    // more than a period restarts the schedule rather than rushing the following frames. Frame
+    // thread only.
+    class FramePacer final
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr std::size_t k_history_size = 240;
+
+        FramePacer();
+        ~FramePacer();
+
+        FramePacer(const FramePacer&) = delete;
+        FramePacer& operator=(const FramePacer&) = delete;
+
+        // 0 or less disables pacing; wait() then only records frame times.
+        void set_target_rate(double frames_per_second) noexcept;
+        [[nodiscard]] double target_rate() const noexcept { return m_target_rate; }
+
+        // Blocks until the current frame's deadline and starts the next frame.
+        void wait();
+
+        [[nodiscard]] FramePacingStats stats() const;
+
+    private:
+        void sleep_until(Clock::time_point deadline);
+        void record_oversleep(double oversleep_ns) noexcept;
+
+        double m_target_rate = 0.0;
+        Clock::time_point m_deadline{};
+        Clock::time_point m_frame_start{};
+        bool m_started = false;
+
+        // Running oversleep estimate in nanoseconds, exponentially weighted.
+        double m_oversleep_mean_ns = 500'000.0;
+        double m_oversleep_variance_ns2 = 0.0;
+        double m_spin_ns = 0.0;
+
+        std::deque<double> m_frame_ms;
+        std::deque<double> m_spin_ms;
+
+        void* m_timer = nullptr; // high-resolution waitable timer on Windows
+    };
+} // namespace rose::core
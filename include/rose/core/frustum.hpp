@@ -0,0 +1,81 @@
+//
+// Created by orange on 16.10.2026.
+//
+#pragma once
+#include "rose/core/collision_world.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rose::core
+{
+    // Six planes (a, b, c, d) with a·p + d >= 0 inside, in the order -x, +x, -y, +y, -z, +z of
+    // clip space. Normals are unit length, so a·p + d is a distance in world units. Build one per
+    // view per frame and share it between every test against that view.
+    struct Frustum final
+    {
+        static constexpr uint32_t k_all_planes = 0x3fu;
+
+        std::array<std::array<float, 4>, 6> planes{};
+
+        // Gribb-Hartmann extraction from an OpenGL-style column-major view-projection.
+        [[nodiscard]] static Frustum from_view_projection(const std::array<float, 16>& view_projection) noexcept;
+        // Normalises planes in the same order. A plane without a normal, such as (0, 0, 0, 1) for a
+        // dropped near plane, is kept as it is.
+        [[nodiscard]] static Frustum from_planes(const float (*planes)[4]) noexcept;
+
+        // False only if the box lies wholly outside one plane, so boxes near a frustum corner may
+        // pass.
+        [[nodiscard]] bool intersects(const Aabb& box) const noexcept;
+    };
+
+    // Boxes for cull_boxes(), in groups of eight stored as eight min x, then eight min y and so
+    // on through max z. The last group is padded with boxes that never intersect.
+    class AabbBatch final
+    {
+    public:
+        static constexpr std::size_t k_group_size = 8;
+        static constexpr std::size_t k_floats_per_group = 6 * k_group_size;
+
+        AabbBatch() = default;
+        explicit AabbBatch(std::span<const Aabb> boxes);
+
+        // New boxes never intersect until set.
+        void resize(std::size_t count);
+        void set(std::size_t index, const Aabb& box) noexcept;
+        [[nodiscard]] Aabb get(std::size_t index) const noexcept;
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+        [[nodiscard]] std::size_t group_count() const noexcept { return m_bounds.size() / k_floats_per_group; }
+        [[nodiscard]] const float* group(std::size_t index) const noexcept
+        {
+            return m_bounds.data() + index * k_floats_per_group;
+        }
+
+    private:
+        std::vector<float> m_bounds;
+        std::size_t m_size = 0;
+    };
+
+    // Writes one byte per group, starting at `first_group`: bit j is set when box j of the group
+    // intersects `frustum`. Only the planes in `planes` (bit i for plane i) are tested, so a caller
+    // that knows the boxes are inside some planes can skip them. Picks an AVX2, SSE2, NEON or
+    // scalar kernel once, from the running CPU.
+    void cull_box_groups(const Frustum& frustum,
+                         const AabbBatch& boxes,
+                         std::size_t first_group,
+                         std::size_t group_count,
+                         uint8_t* masks,
+                         uint32_t planes = Frustum::k_all_planes) noexcept;
+
+    // One bit per box of `boxes`, as cull_box_groups() writes them; bits past the last box are
+    // clear.
+    void cull_boxes(const Frustum& frustum, const AabbBatch& boxes, std::vector<uint8_t>& masks);
+    // Appends the index of every box that intersects `frustum`, in increasing order.
+    void cull_boxes(const Frustum& frustum, const AabbBatch& boxes, std::vector<std::size_t>& visible);
+
+    // "avx2", "sse2", "neon" or "scalar".
+    [[nodiscard]] const char* frustum_culling_isa() noexcept;
+} // namespace rose::core
@@ -0,0 +1,69 @@
+//
+// Created by orange on 16.10.2026.
+//
+#pragma once
+#include <omath/engines/opengl_engine/mesh.hpp>
+#include <omath/linear_algebra/vector3.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace rose::core
+{
+    struct MeshRayHit final
+    {
+        float distance = 0.0f; // ray parameter, in units of the ray direction
+        uint32_t triangle = 0; // index into the mesh's element buffer
+    };
+
+    // Triangle BVH of one mesh in its local space, so moving the mesh never invalidates it. Built
+    // with a binned surface area heuristic and flattened depth first: an interior node's left
+    // child follows it. Every leaf is one packet of up to four triangles, stored lane by lane so a
+    // single SSE test covers the whole leaf; other CPUs run the same tests one lane at a time.
+    class MeshBvh final
+    {
+    public:
+        static constexpr std::size_t k_leaf_size = 4;
+
+        MeshBvh() = default;
+        explicit MeshBvh(const omath::opengl_engine::Mesh& mesh);
+
+        // Nearest triangle hit by origin + t * direction for 0 <= t <= max_distance, in mesh
+        // space. Both faces count.
+        [[nodiscard]] std::optional<MeshRayHit> intersect(const omath::Vector3<float>& origin,
+                                                          const omath::Vector3<float>& direction,
+                                                          float max_distance) const noexcept;
+
+        [[nodiscard]] bool empty() const noexcept { return m_nodes.empty(); }
+        [[nodiscard]] std::size_t node_count() const noexcept { return m_nodes.size(); }
+
+    private:
+        // Interior nodes have no triangles and keep their right child in `index`; leaves keep
+        // their packet there.
+        struct Node final
+        {
+            float min[3];
+            uint32_t index;
+            float max[3];
+            uint32_t triangle_count;
+        };
+
+        // Vertex 0 and both edges of four triangles, one lane each. Unused lanes are degenerate
+        // and never hit.
+        struct alignas(16) TrianglePacket final
+        {
+            float v0[3][4];
+            float edge1[3][4];
+            float edge2[3][4];
+            uint32_t triangle[4];
+        };
+
+        struct BuildTriangle;
+
+        uint32_t build_node(std::vector<BuildTriangle>& triangles, std::size_t begin, std::size_t end, int depth);
+
+        std::vector<Node> m_nodes;
+        std::vector<TrianglePacket> m_packets;
+    };
+} // namespace rose::core
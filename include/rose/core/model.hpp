@@ -3,11 +3,14 @@
 //
 #pragma once
 #include "rose/core/collision_world.hpp"
+#include "rose/core/mesh_bvh.hpp"
+#include "rose/core/scene_bvh.hpp"
 #include "rose/core/vulkan/mesh.hpp"
 #include <omath/engines/opengl_engine/camera.hpp>
 #include <omath/engines/opengl_engine/mesh.hpp>
 #include <cstddef>
 #include <filesystem>
+#include <limits>
 #include <optional>
 #include <vector>
 
@@ -18,6 +21,13 @@ namespace rose::core
         class Renderer;
     }
 
+    struct ModelRayHit final
+    {
+        std::size_t mesh = 0;
+        float distance = 0.0f; // ray parameter, in units of the ray direction
+        omath::Vector3<float> position{};
+    };
+
     class Model final
     {
     public:
@@ -45,6 +55,14 @@ namespace rose::core
         void set_mesh_matrix(std::size_t mesh_index, const omath::opengl_engine::Mat4X4& matrix);
         [[nodiscard]] std::optional<std::size_t> pick_mesh(const omath::Vector2<float>& screen_position,
                                                            const omath::opengl_engine::Camera& camera) const;
+        // Nearest mesh hit by origin + t * direction for 0 <= t <= max_distance, in world space.
+        // Each mesh is traced in its own space against its triangle BVH.
+        [[nodiscard]] std::optional<ModelRayHit> raycast(const omath::Vector3<float>& origin,
+                                                         const omath::Vector3<float>& direction,
+                                                         float max_distance = std::numeric_limits<float>::max()) const;
+        // Index of `mesh` if it is one of this model's meshes. Only the address is compared, so
+        // `mesh` may be null or no longer alive.
+        [[nodiscard]] std::optional<std::size_t> mesh_index(const vulkan::Mesh* mesh) const;
 
         void draw(vulkan::Renderer& renderer,
                   const omath::opengl_engine::Camera& camera,
@@ -53,6 +71,8 @@ namespace rose::core
     private:
         std::vector<vulkan::Mesh> m_meshes;
         std::vector<Aabb>         m_mesh_aabbs; // world-space AABB per mesh, parallel to m_meshes
+        std::vector<MeshBvh>      m_mesh_bvhs;  // local-space triangle BVH per mesh, parallel to m_meshes
+        SceneBvh                  m_scene_bvh;  // over m_mesh_aabbs, refitted as meshes move
 
         void load(const std::filesystem::path& path);
     };
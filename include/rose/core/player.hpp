@@ -69,6 +69,9 @@ namespace rose::core
             float dt,
             const CollisionWorld& world,
             const PlayerInput& input);
+        // Integrates mouse movement that arrived after update() into the view angles as if it
+        // had been part of that update's input. Used to late-latch the camera before submission.
+        void apply_late_look(float mouse_dx, float mouse_dy);
 
         [[nodiscard]] omath::Vector3<float>                   get_eye_position() const;
         [[nodiscard]] const omath::opengl_engine::ViewAngles& get_view_angles()  const;
@@ -93,6 +96,7 @@ namespace rose::core
         omath::opengl_engine::ViewAngles m_view_angles{};
         float m_smooth_dx = 0.f;
         float m_smooth_dy = 0.f;
+        float m_look_weight = 0.f; // smoothing weight of the last update's input
 
         // Convex box collider — vertices stored in local space, origin = m_position
         omath::collision::MeshCollider<omath::opengl_engine::Mesh> m_collider;
@@ -0,0 +1,85 @@
+//
+// Created by orange on 16.10.2026.
+//
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#ifndef ROSE_ENABLE_PROFILER
+#define ROSE_ENABLE_PROFILER 0
+#endif
+
+// CPU profiler. Zones are recorded into a ring buffer owned by the thread that records them, so
+// recording never locks; readers copy the rings and drop whatever was overwritten while they
+// copied. Use the ROSE_PROFILE_* macros, which expand to nothing when the build is configured
+// without ROSE_ENABLE_PROFILER. Zone and thread names must be string literals or otherwise
+// outlive the process' last trace export.
+namespace rose::core::profiler
+{
+    inline constexpr bool k_enabled = ROSE_ENABLE_PROFILER != 0;
+
+    // Zones each thread keeps before the oldest are overwritten.
+    inline constexpr std::size_t k_zones_per_thread = 1u << 15;
+    inline constexpr std::size_t k_frame_marks = 1024;
+
+    struct ZoneSample final
+    {
+        const char* name = nullptr;
+        uint64_t start_ns = 0;
+        uint64_t end_ns = 0;
+        uint32_t depth = 0; // zones open on the thread when this one began
+    };
+
+    struct ThreadTimeline final
+    {
+        uint32_t thread_id = 0; // registration order, 0 is the first thread that profiled
+        std::string name;
+        std::vector<ZoneSample> zones; // in the order they ended
+    };
+
+    // Nanoseconds on the steady clock since the profiler was first used.
+    [[nodiscard]] uint64_t now_ns() noexcept;
+
+    void set_thread_name(const char* name);
+    // Marks the start of a frame on the calling thread's timeline.
+    void mark_frame() noexcept;
+    // Oldest first.
+    [[nodiscard]] std::vector<uint64_t> frame_marks();
+
+    // Buffered zones of every thread that overlap [begin_ns, end_ns].
+    [[nodiscard]] std::vector<ThreadTimeline> capture(uint64_t begin_ns, uint64_t end_ns);
+    // Writes everything still buffered in the Chrome trace event format, which chrome://tracing
+    // and Perfetto open. Throws std::runtime_error when the file cannot be written.
+    void write_chrome_trace(const std::filesystem::path& path);
+
+    class Zone final
+    {
+    public:
+        explicit Zone(const char* name) noexcept;
+        ~Zone();
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char* m_name;
+        uint32_t m_depth;
+        uint64_t m_start_ns;
+    };
+} // namespace rose::core::profiler
+
+#define ROSE_PROFILE_CONCAT_IMPL(lhs, rhs) lhs##rhs
+#define ROSE_PROFILE_CONCAT(lhs, rhs) ROSE_PROFILE_CONCAT_IMPL(lhs, rhs)
+
+#if ROSE_ENABLE_PROFILER
+#define ROSE_PROFILE_ZONE(name) const ::rose::core::profiler::Zone ROSE_PROFILE_CONCAT(rose_profile_zone_, __LINE__){name}
+#define ROSE_PROFILE_THREAD(name) ::rose::core::profiler::set_thread_name(name)
+#define ROSE_PROFILE_FRAME() ::rose::core::profiler::mark_frame()
+#else
+#define ROSE_PROFILE_ZONE(name) static_cast<void>(0)
+#define ROSE_PROFILE_THREAD(name) static_cast<void>(0)
+#define ROSE_PROFILE_FRAME() static_cast<void>(0)
+#endif
@@ -0,0 +1,60 @@
+//
+// Created by orange on 16.10.2026.
+//
+#pragma once
+#include "rose/core/collision_world.hpp"
+#include "rose/core/frustum.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace rose::core
+{
+    // Bounding-volume hierarchy over world-space boxes. Each leaf holds up to eight items whose
+    // boxes form one AabbBatch group, so a leaf is culled with a single SIMD test. Moving an item
+    // refits the boxes on its path to the root instead of rebuilding, so the tree keeps its
+    // shape: it stays correct however far items move, only looser.
+    class SceneBvh final
+    {
+    public:
+        // Items are indices into `boxes`.
+        void build(std::span<const Aabb> boxes);
+        void refit(std::size_t item, const Aabb& box);
+
+        // Appends every item whose box intersects `frustum`. Planes a subtree lies wholly inside
+        // are not tested again below it, and a subtree inside all six is appended untested.
+        void cull(const Frustum& frustum, std::vector<std::size_t>& items) const;
+
+        // Calls visit(item, max_distance) for the items whose box origin + t * direction enters
+        // within max_distance, nearer subtrees first. `visit` returns the new max_distance, such
+        // as the distance of a hit, and subtrees entered beyond it are skipped.
+        void raycast(const omath::Vector3<float>& origin,
+                     const omath::Vector3<float>& direction,
+                     float max_distance,
+                     const std::function<float(std::size_t item, float max_distance)>& visit) const;
+
+        [[nodiscard]] bool empty() const noexcept { return m_nodes.empty(); }
+
+    private:
+        // Flattened depth first: an interior node's left child follows it. Every node covers
+        // m_items[first, first + count).
+        struct Node final
+        {
+            Aabb bounds;
+            uint32_t first = 0;
+            uint32_t count = 0;
+            uint32_t right = 0; // right child of an interior node, 0 for a leaf
+            uint32_t parent = 0;
+            uint32_t group = 0; // a leaf's group in m_leaf_boxes, lane i holding m_items[first + i]
+        };
+
+        uint32_t build_node(std::span<const Aabb> boxes, uint32_t first, uint32_t count, uint32_t parent);
+
+        std::vector<Node> m_nodes;
+        std::vector<uint32_t> m_items;  // item indices in leaf order
+        std::vector<uint32_t> m_leaves; // leaf node of each item
+        AabbBatch m_leaf_boxes;
+    };
+} // namespace rose::core
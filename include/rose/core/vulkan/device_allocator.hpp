@@ -0,0 +1,119 @@
+//
+// Created by orange on 16.10.2026.
+//
+#pragma once
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace rose::core::vulkan
+{
+    // First-fit free list over a linear range [0, capacity).
+    // Freed ranges are coalesced with their neighbours, so long-lived mixes of
+    // small and large allocations do not fragment the range into slivers.
+    class RangeAllocator final
+    {
+    public:
+        explicit RangeAllocator(VkDeviceSize capacity = 0);
+
+        // Returns the aligned offset of a range of `size` bytes, or nullopt when no free range fits.
+        [[nodiscard]] std::optional<VkDeviceSize> allocate(VkDeviceSize size, VkDeviceSize alignment);
+        void free(VkDeviceSize offset, VkDeviceSize size);
+
+        [[nodiscard]] VkDeviceSize capacity() const noexcept { return m_capacity; }
+        [[nodiscard]] VkDeviceSize used() const noexcept { return m_used; }
+        [[nodiscard]] bool empty() const noexcept { return m_used == 0; }
+
+    private:
+        std::map<VkDeviceSize, VkDeviceSize> m_free_ranges; // offset -> size
+        VkDeviceSize m_capacity = 0;
+        VkDeviceSize m_used = 0;
+    };
+
+    struct MemoryBlock;
+
+    // A sub-range of a VkDeviceMemory object. `mapped` is non-null for host-visible memory,
+    // which stays persistently mapped for the lifetime of its block.
+    struct DeviceAllocation final
+    {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        void* mapped = nullptr;
+        uint32_t memory_type = 0;
+        MemoryBlock* block = nullptr; // null for dedicated allocations
+    };
+
+    struct DeviceHeapUsage final
+    {
+        uint32_t heap_index = 0;
+        VkMemoryHeapFlags flags = 0;
+        VkDeviceSize heap_size = 0;
+        VkDeviceSize reserved_bytes = 0;
+        VkDeviceSize used_bytes = 0;
+        uint32_t block_count = 0;
+        uint32_t dedicated_count = 0;
+        uint32_t allocation_count = 0;
+    };
+
+    // Pooled device-memory allocator.
+    // Each memory type owns large blocks that are suballocated with a RangeAllocator. Linear
+    // (buffer, linear image) and optimal (tiled image) resources live in separate pools so
+    // bufferImageGranularity never has to be honoured between neighbours. Requests larger than
+    // half a block get their own VkDeviceMemory.
+    class DeviceAllocator final
+    {
+    public:
+        static constexpr VkDeviceSize k_default_block_size = 64ull * 1024ull * 1024ull;
+
+        DeviceAllocator(VkPhysicalDevice physical_device,
+                        VkDevice device,
+                        VkDeviceSize block_size = k_default_block_size);
+        ~DeviceAllocator();
+
+        DeviceAllocator(const DeviceAllocator&) = delete;
+        DeviceAllocator& operator=(const DeviceAllocator&) = delete;
+
+        [[nodiscard]] DeviceAllocation allocate(const VkMemoryRequirements& requirements,
+                                                VkMemoryPropertyFlags properties,
+                                                bool linear);
+        void free(DeviceAllocation& allocation) noexcept;
+
+        [[nodiscard]] uint32_t find_memory_type(uint32_t type_filter, VkMemoryPropertyFlags properties) const;
+        [[nodiscard]] std::vector<DeviceHeapUsage> heap_usage() const;
+        [[nodiscard]] uint32_t device_memory_count() const;
+
+    private:
+        struct Pool final
+        {
+            std::vector<std::unique_ptr<MemoryBlock>> blocks;
+        };
+
+        struct TypeUsage final
+        {
+            VkDeviceSize dedicated_bytes = 0;
+            uint32_t dedicated_count = 0;
+            uint32_t allocation_count = 0;
+        };
+
+        [[nodiscard]] VkDeviceSize block_size_for_type(uint32_t memory_type) const;
+        [[nodiscard]] VkDeviceMemory allocate_device_memory(VkDeviceSize size, uint32_t memory_type, void** mapped);
+        void release_device_memory(VkDeviceMemory memory, uint32_t memory_type) noexcept;
+
+        VkDevice m_device = VK_NULL_HANDLE;
+        VkPhysicalDeviceMemoryProperties m_memory_properties{};
+        VkDeviceSize m_block_size = k_default_block_size;
+        uint32_t m_max_allocation_count = 0;
+        uint32_t m_device_memory_count = 0;
+
+        // [memory type][0 = linear, 1 = optimal]
+        std::array<std::array<Pool, 2>, VK_MAX_MEMORY_TYPES> m_pools{};
+        std::array<TypeUsage, VK_MAX_MEMORY_TYPES> m_type_usage{};
+        mutable std::mutex m_mutex;
+    };
+} // namespace rose::core::vulkan
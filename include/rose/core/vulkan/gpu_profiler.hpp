@@ -0,0 +1,112 @@
+//
+// Created by orange on 16.10.2026.
+//
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace rose::core::vulkan
+{
+    // Times numbered scopes of a frame's primary command buffer with timestamp queries, and
+    // optionally counts pipeline statistics over one span of it. Every frame in flight owns its
+    // query pools, which are read back without waiting when the frame slot comes round again,
+    // after its fence has signalled, so measuring never stalls the queue. Frame thread only,
+    // except for inherited_statistics().
+    class GpuProfiler final
+    {
+    public:
+        static constexpr std::size_t k_history_size = 240;
+        static constexpr std::size_t k_statistic_count = 6;
+        // Counted in this order: input-assembly vertices and primitives, vertex shader
+        // invocations, clipping primitives, fragment and compute shader invocations.
+        static constexpr VkQueryPipelineStatisticFlags k_statistics =
+            VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT
+            | VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT
+            | VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT
+            | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT
+            | VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT
+            | VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+
+        struct Frame final
+        {
+            double frame_ms = 0.0;
+            std::vector<double> scope_ms; // 0 for scopes that did not run
+            std::optional<std::array<uint64_t, k_statistic_count>> statistics;
+        };
+
+        // `pipeline_statistics` requires the pipelineStatisticsQuery and inheritedQueries
+        // features to be enabled on the device.
+        GpuProfiler(VkPhysicalDevice physical_device,
+                    VkDevice device,
+                    uint32_t queue_family,
+                    uint32_t frames_in_flight,
+                    uint32_t scope_count,
+                    bool pipeline_statistics);
+        ~GpuProfiler();
+
+        GpuProfiler(const GpuProfiler&) = delete;
+        GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+        [[nodiscard]] bool timestamps_supported() const noexcept { return m_timestamps_supported; }
+        [[nodiscard]] bool pipeline_statistics_supported() const noexcept { return m_statistics_supported; }
+        [[nodiscard]] bool enabled() const noexcept { return m_enabled; }
+        // Takes effect with the next frame; disabling keeps the history.
+        void set_enabled(bool enabled) noexcept { m_enabled = enabled; }
+        [[nodiscard]] bool statistics_enabled() const noexcept { return m_statistics_enabled; }
+        void set_statistics_enabled(bool enabled) noexcept { m_statistics_enabled = enabled; }
+        // Secondary command buffers executed inside the statistics span must be recorded with
+        // these flags in VkCommandBufferInheritanceInfo::pipelineStatistics.
+        [[nodiscard]] VkQueryPipelineStatisticFlags inherited_statistics() const noexcept
+        {
+            return m_statistics_supported ? k_statistics : 0;
+        }
+
+        // Reads back what `frame_index` measured the last time it was used, then starts
+        // measuring into it. Call right after vkBeginCommandBuffer, once the frame's fence has
+        // signalled.
+        void begin_frame(VkCommandBuffer command_buffer, uint32_t frame_index);
+        // Each scope is measured at most once per frame; scopes may enclose render passes or sit
+        // inside one.
+        void begin_scope(VkCommandBuffer command_buffer, uint32_t scope);
+        void end_scope(VkCommandBuffer command_buffer, uint32_t scope);
+        // Outside render passes, around at most one span per frame.
+        void begin_statistics(VkCommandBuffer command_buffer);
+        void end_statistics(VkCommandBuffer command_buffer);
+        void end_frame(VkCommandBuffer command_buffer);
+
+        // Oldest first.
+        [[nodiscard]] const std::deque<Frame>& history() const noexcept { return m_history; }
+
+    private:
+        struct Slot final
+        {
+            VkQueryPool timestamps = VK_NULL_HANDLE;
+            VkQueryPool statistics = VK_NULL_HANDLE;
+            std::vector<bool> scopes_written;
+            bool statistics_written = false;
+            bool pending = false;
+        };
+
+        [[nodiscard]] uint32_t timestamp_count() const noexcept { return 2u + 2u * m_scope_count; }
+        void read_back(Slot& slot);
+
+        VkDevice m_device = VK_NULL_HANDLE;
+        uint32_t m_scope_count = 0;
+        double m_nanoseconds_per_tick = 1.0;
+        uint64_t m_timestamp_mask = ~0ull;
+        bool m_timestamps_supported = false;
+        bool m_statistics_supported = false;
+        bool m_enabled = true;
+        bool m_statistics_enabled = false;
+        std::vector<Slot> m_slots;
+        Slot* m_active = nullptr;
+        bool m_statistics_frame = false; // statistics were reset for the active frame
+        bool m_statistics_active = false;
+        std::deque<Frame> m_history;
+    };
+} // namespace rose::core::vulkan
@@ -0,0 +1,49 @@
+//
+// Created by orange on 16.10.2026.
+//
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace rose::core::vulkan
+{
+    // VkPipelineCache persisted between runs, one file per GPU. The file starts with a header
+    // naming the device, driver and pipeline cache UUID it was written for plus a hash of the
+    // cache data; a file that does not match the current device is discarded and the cache starts
+    // empty. Saves go to a temporary file that is renamed over the old one, so an interrupted save
+    // never leaves a truncated cache behind.
+    class PipelineCache final
+    {
+    public:
+        PipelineCache(VkPhysicalDevice physical_device, VkDevice device, const std::filesystem::path& directory);
+        // Saves the cache, then destroys it.
+        ~PipelineCache();
+
+        PipelineCache(const PipelineCache&) = delete;
+        PipelineCache& operator=(const PipelineCache&) = delete;
+
+        // Vulkan synchronises pipeline caches internally, so pipelines may be created through
+        // this handle from several threads at once.
+        [[nodiscard]] VkPipelineCache handle() const noexcept { return m_cache; }
+        // Bytes of cache data accepted from disk; zero on a cold start.
+        [[nodiscard]] std::size_t loaded_size() const noexcept { return m_loaded_size; }
+        [[nodiscard]] const std::filesystem::path& path() const noexcept { return m_path; }
+
+        // Writes the cache if its data changed since it was loaded or last saved. Failures are
+        // logged rather than thrown: a missing cache only costs compile time on the next run.
+        void save();
+
+    private:
+        [[nodiscard]] std::vector<char> load_validated() const;
+
+        VkDevice m_device = VK_NULL_HANDLE;
+        VkPhysicalDeviceProperties m_properties{};
+        std::filesystem::path m_path;
+        VkPipelineCache m_cache = VK_NULL_HANDLE;
+        std::size_t m_loaded_size = 0;
+        uint64_t m_saved_hash = 0;
+    };
+} // namespace rose::core::vulkan
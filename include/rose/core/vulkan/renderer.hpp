@@ -2,10 +2,12 @@
 // Created by orange on 15.05.2026.
 //
 #pragma once
+#include "rose/core/frustum.hpp"
 #include "rose/core/vulkan/mesh.hpp"
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <omath/engines/opengl_engine/camera.hpp>
 #include <omath/linear_algebra/vector2.hpp>
@@ -17,6 +19,11 @@
 struct GLFWwindow;
 struct ImDrawData;
 
+namespace rose::core
+{
+    class Model;
+}
+
 namespace rose::core::vulkan
 {
     enum class DlssQuality : int
@@ -29,20 +36,27 @@ namespace rose::core::vulkan
         Dlaa
     };
 
+    // The glow is drawn in screen space around every selected mesh at once. `width` is in world
+    // units at the mesh's center, up to 64 pixels on screen; a higher smoothing quality fades the
+    // glow over more of that width at the same cost.
     struct SelectionOutlineSettings final
     {
         std::array<float, 3> color{0.02f, 0.72f, 1.0f};
         float width = 0.18f;
-        int smoothing_quality = 3;
+        int smoothing_quality = 3; // 1 to 64
     };
 
+    // Bloom is built in a mip pyramid below half resolution. Each level adds `radius` texels of
+    // spread at its own scale, so the reach grows with both and the cost with neither.
     struct BloomSettings final
     {
+        static constexpr int k_max_levels = 8;
+
         bool enabled = false;
         float threshold = 1.0f;
         float intensity = 0.35f;
-        float radius = 2.0f;
-        int quality = 8;
+        float radius = 1.0f; // texels of each level, 0 to 4
+        int levels = 6;      // 1 to k_max_levels
     };
 
     struct SpotlightSettings final
@@ -63,7 +77,175 @@ namespace rose::core::vulkan
         omath::Vector3<float> direction{-0.35f, -0.75f, -0.45f};
         std::array<float, 3> color{1.0f, 0.9f, 0.55f};
         float intensity = 2.5f;
+        // Distance from the camera covered by the shadow cascades.
         float shadow_distance = 60.0f;
+        // Cascade budget: 1-4 layers of cascade_resolution² texels (a power of two in
+        // [512, 4096]). split_lambda blends uniform (0) and logarithmic (1) cascade splits.
+        int cascade_count = 3;
+        int cascade_resolution = 2048;
+        float split_lambda = 0.75f;
+    };
+
+    // Applies to every material texture. Anisotropy is clamped to the device limit and is off
+    // when the device lacks samplerAnisotropy; disabling mipmaps samples only the top level.
+    struct TextureSettings final
+    {
+        float max_anisotropy = 8.0f;
+        float lod_bias = 0.0f;
+        bool mipmaps = true;
+    };
+
+    // Large textures keep only a mip tail of at most 256² texels resident and stream finer mips
+    // from a cooked on-disk copy as they cover more of the screen. The budget is further capped
+    // by what VK_EXT_memory_budget reports is left on the device, when available.
+    struct TextureStreamingSettings final
+    {
+        uint32_t budget_mib = 1024;
+    };
+
+    struct TextureStreamingStats final
+    {
+        uint64_t resident_bytes = 0;
+        uint64_t budget_bytes = 0;
+        std::size_t streamed_textures = 0;
+        std::size_t transitions_in_flight = 0;
+        uint64_t evicted_bytes = 0;
+        bool memory_budget_extension = false;
+    };
+
+    // Static meshes are shadowed through a per-light cache that is only re-rendered when the
+    // light or a static caster's transform changes; dynamic meshes are drawn over it every frame.
+    enum class MeshMobility
+    {
+        Static,
+        Dynamic
+    };
+
+    struct MemoryHeapStats final
+    {
+        uint32_t heap_index = 0;
+        bool device_local = false;
+        uint64_t heap_size = 0;
+        uint64_t reserved_bytes = 0;
+        uint64_t used_bytes = 0;
+        uint32_t block_count = 0;
+        uint32_t dedicated_count = 0;
+        uint32_t allocation_count = 0;
+    };
+
+    enum class PresentMode : int
+    {
+        Immediate,
+        Mailbox,
+        Fifo,
+        FifoRelaxed
+    };
+
+    // Trades input latency for throughput. A present mode the surface lacks falls back to FIFO,
+    // which every surface supports, and the image count is clamped to the surface limits.
+    struct LatencyProfile final
+    {
+        PresentMode present_mode = PresentMode::Mailbox;
+        uint32_t frames_in_flight = 2;  // 1 to 3
+        uint32_t swapchain_images = 0;  // 0 picks one more than the surface minimum
+
+        [[nodiscard]] static constexpr LatencyProfile low_latency() noexcept
+        {
+            return {PresentMode::Immediate, 1, 0};
+        }
+        [[nodiscard]] static constexpr LatencyProfile balanced() noexcept
+        {
+            return {PresentMode::Mailbox, 2, 0};
+        }
+        [[nodiscard]] static constexpr LatencyProfile throughput() noexcept
+        {
+            return {PresentMode::Fifo, 3, 3};
+        }
+    };
+
+    // Input-to-present latency of recent frames, from the input timestamp to when the frame was
+    // first seen on the display through VK_KHR_present_wait, or to when the GPU finished it
+    // without. Frames resolve when the renderer next checks, so samples run late by up to a frame.
+    struct LatencyStats final
+    {
+        PresentMode present_mode = PresentMode::Fifo; // in effect
+        uint32_t swapchain_images = 0;
+        uint32_t frames_in_flight = 0;
+        bool to_display = false;
+        float mean_ms = 0.0f;
+        float p50_ms = 0.0f;
+        float p95_ms = 0.0f;
+        float p99_ms = 0.0f;
+        std::size_t samples = 0;
+    };
+
+    // Late-latched frames: how long after the input sample the camera was latched, which is
+    // the input latency the latch removes, and how far the latch turned the camera.
+    struct LateLatchStats final
+    {
+        float mean_ms = 0.0f;
+        float p95_ms = 0.0f;
+        float mean_degrees = 0.0f;
+        float max_degrees = 0.0f;
+        std::size_t samples = 0;
+    };
+
+    struct ResidencyProgress final
+    {
+        std::size_t requested_meshes = 0;
+        std::size_t resident_meshes = 0;
+
+        [[nodiscard]] bool complete() const noexcept { return resident_meshes >= requested_meshes; }
+    };
+
+    // Spans of the frame timed by the GPU profiler. Present covers the blit to the swapchain and
+    // everything drawn over it, such as ImGui.
+    enum class GpuPass : int
+    {
+        Cull,
+        Shadows,
+        Scene,
+        Outline,
+        HiZ,
+        Dlss,
+        Bloom,
+        Present,
+        Count
+    };
+
+    inline constexpr std::size_t k_gpu_pass_count = static_cast<std::size_t>(GpuPass::Count);
+
+    [[nodiscard]] const char* gpu_pass_name(GpuPass pass) noexcept;
+
+    struct GpuTimingPercentiles final
+    {
+        float p50 = 0.0f;
+        float p95 = 0.0f;
+        float p99 = 0.0f;
+    };
+
+    // Counted over the scene pass.
+    struct GpuPipelineStatistics final
+    {
+        uint64_t input_assembly_vertices = 0;
+        uint64_t input_assembly_primitives = 0;
+        uint64_t vertex_shader_invocations = 0;
+        uint64_t clipping_primitives = 0;
+        uint64_t fragment_shader_invocations = 0;
+        uint64_t compute_shader_invocations = 0;
+    };
+
+    // Rolling GPU timings in milliseconds, oldest first. A pass that did not run in a frame
+    // reports 0 ms; results lag the frame being recorded by the frames in flight.
+    struct GpuProfile final
+    {
+        bool timestamps_supported = false;
+        bool pipeline_statistics_supported = false;
+        std::vector<float> frame_ms;
+        std::array<std::vector<float>, k_gpu_pass_count> pass_ms;
+        GpuTimingPercentiles frame_percentiles;
+        std::array<GpuTimingPercentiles, k_gpu_pass_count> pass_percentiles;
+        std::optional<GpuPipelineStatistics> statistics; // most recent frame
     };
 
     enum class CapturedFrameFormat
@@ -80,6 +262,14 @@ namespace rose::core::vulkan
         CapturedFrameFormat format = CapturedFrameFormat::Rgba;
     };
 
+    // Answer to Renderer::request_pick(). `mesh` is the frontmost mesh drawn at the picked pixel,
+    // or null over the background. It was drawn a few frames ago and may be gone since, so it is
+    // meant to be compared against, not dereferenced.
+    struct PickResult final
+    {
+        const Mesh* mesh = nullptr;
+    };
+
     class Renderer final
     {
     public:
@@ -89,12 +279,50 @@ namespace rose::core::vulkan
         Renderer(const Renderer&) = delete;
         Renderer& operator=(const Renderer&) = delete;
 
+        // Uploads every mesh and texture of `model` on background workers. Meshes that are drawn
+        // before they are resident are skipped rather than created on the frame thread.
+        void prepare(const Model& model);
+        [[nodiscard]] ResidencyProgress residency_progress() const;
+
         [[nodiscard]] bool begin_frame();
-        void draw_mesh(const Mesh& mesh, const omath::opengl_engine::Camera& camera);
+        void draw_mesh(const Mesh& mesh,
+                       const omath::opengl_engine::Camera& camera,
+                       MeshMobility mobility = MeshMobility::Static);
         void draw_mesh_outline(const Mesh& mesh, const omath::opengl_engine::Camera& camera);
+        // Frusta of every view that can show a mesh drawn with `camera` this frame: the camera's
+        // first, then each shadow map's. Meshes outside all of them need not be drawn. Only valid
+        // for the frame's first camera and its current light settings.
+        [[nodiscard]] std::vector<Frustum> culling_frusta(const omath::opengl_engine::Camera& camera);
+        // Picks the mesh at `screen_position`, in framebuffer pixels, with a one-pixel ID pass in
+        // the next frame that draws the scene. take_pick_result() returns the answer once that
+        // frame has finished on the GPU, usually a frame or two later; a newer request replaces
+        // one that was not drawn yet.
+        void request_pick(const omath::Vector2<float>& screen_position);
+        [[nodiscard]] std::optional<PickResult> take_pick_result();
         void render_imgui(ImDrawData* draw_data);
         [[nodiscard]] std::optional<CapturedFrame> end_frame(bool capture_screenshot);
         void wait_idle() const;
+        // VK_KHR_present_wait: blocks until at most `max_pending` presented frames are still
+        // waiting for the display, or `timeout_ns` passes. Returns at once when unsupported.
+        [[nodiscard]] bool present_wait_supported() const;
+        void wait_for_present(uint32_t max_pending, uint64_t timeout_ns);
+        // Takes effect at the next begin_frame(), which waits for the device and rebuilds the
+        // swapchain and per-frame resources.
+        [[nodiscard]] LatencyProfile latency_profile() const;
+        void set_latency_profile(const LatencyProfile& profile);
+        [[nodiscard]] LatencyStats latency_stats() const;
+        // When the input of the next frame was sampled; without it latency is measured from
+        // begin_frame().
+        void mark_input_sampled();
+        // Late latching: scene draws of `camera` read their view-projection from a per-frame
+        // uniform buffer that end_frame() writes after recording, right before the submit. There
+        // it first calls `update`, which may turn `camera` to follow input that arrived since the
+        // draws were queued. Call each frame before render_imgui(). Culling and shadows still use
+        // the camera as it was drawn, and so does everything but the view-projection.
+        [[nodiscard]] bool late_latch_enabled() const;
+        void set_late_latch_enabled(bool enabled);
+        void late_latch_camera(const omath::opengl_engine::Camera& camera, std::function<void()> update);
+        [[nodiscard]] LateLatchStats late_latch_stats() const;
 
         [[nodiscard]] omath::Vector2<int> framebuffer_size() const;
         [[nodiscard]] bool dlss_available() const;
@@ -111,6 +339,35 @@ namespace rose::core::vulkan
         void set_spotlight_settings(const SpotlightSettings& settings);
         [[nodiscard]] SunSettings sun_settings() const;
         void set_sun_settings(const SunSettings& settings);
+        [[nodiscard]] TextureSettings texture_settings() const;
+        void set_texture_settings(const TextureSettings& settings);
+        [[nodiscard]] TextureStreamingSettings texture_streaming_settings() const;
+        void set_texture_streaming_settings(const TextureStreamingSettings& settings);
+        [[nodiscard]] TextureStreamingStats texture_streaming_stats() const;
+        // Batches static geometry into indirect draws; needs drawIndirectFirstInstance.
+        [[nodiscard]] bool gpu_driven_supported() const;
+        [[nodiscard]] bool gpu_driven_enabled() const;
+        void set_gpu_driven_enabled(bool enabled);
+        // Per-view frustum culling, plus occlusion against last frame's depth, of the batched
+        // draws in a compute pass. Other draws are culled per view on the CPU, so callers submit
+        // meshes unculled and shadow casters outside the camera view still reach the shadow passes.
+        [[nodiscard]] bool gpu_culling_active() const;
+        [[nodiscard]] bool gpu_culling_enabled() const;
+        void set_gpu_culling_enabled(bool enabled);
+        [[nodiscard]] bool occlusion_culling_enabled() const;
+        void set_occlusion_culling_enabled(bool enabled);
+        [[nodiscard]] std::vector<MemoryHeapStats> memory_stats() const;
+        // Timestamp queries around every GpuPass, plus optional pipeline statistics over the
+        // scene pass when the device supports pipelineStatisticsQuery and inheritedQueries.
+        [[nodiscard]] bool gpu_profiler_enabled() const;
+        void set_gpu_profiler_enabled(bool enabled);
+        [[nodiscard]] bool gpu_pipeline_statistics_enabled() const;
+        void set_gpu_pipeline_statistics_enabled(bool enabled);
+        [[nodiscard]] GpuProfile gpu_profile() const;
+        // Shaders are embedded at build time. Reloading recompiles the GLSL sources that changed
+        // on a background thread and swaps the pipelines in at the start of a later frame.
+        void reload_shaders();
+        [[nodiscard]] std::string shader_reload_status() const;
 
     private:
         struct Impl;
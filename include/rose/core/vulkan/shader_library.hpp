@@ -0,0 +1,62 @@
+//
+// Created by orange on 16.10.2026.
+//
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rose::core::vulkan
+{
+    // SPIR-V compiled at build time and embedded by cmake/embed_shaders.cmake. `key` is the
+    // SHA-256 of the compile flags and the GLSL source the words were compiled from.
+    struct EmbeddedShader final
+    {
+        std::string_view name;
+        std::string_view source_name;
+        std::string_view key;
+        std::span<const uint32_t> spirv;
+    };
+
+    // Defined in the build-generated embedded_shaders.cpp.
+    [[nodiscard]] std::span<const EmbeddedShader> embedded_shaders() noexcept;
+    [[nodiscard]] std::string_view embedded_shader_flags() noexcept;
+
+    // Immutable set of SPIR-V modules by file name ("shader.vert.spv"). Startup uses the embedded
+    // set and never touches the file system; recompiled() is the hot-reload path. Copies share
+    // their SPIR-V, so a library can be handed between threads by value.
+    class ShaderLibrary final
+    {
+    public:
+        [[nodiscard]] static ShaderLibrary embedded();
+
+        // Copy of this library in which every shader whose GLSL source in `source_directory` no
+        // longer matches its key is recompiled with glslc. Blocks on the compiler, so call it off
+        // the frame thread. Throws std::runtime_error naming the shader when a compile fails.
+        [[nodiscard]] ShaderLibrary recompiled(const std::filesystem::path& source_directory,
+                                               std::size_t& compiled_count) const;
+
+        // Throws std::runtime_error for a name that is not in the library.
+        [[nodiscard]] std::span<const uint32_t> spirv(std::string_view name) const;
+        [[nodiscard]] std::size_t size() const noexcept { return m_shaders.size(); }
+
+    private:
+        struct Shader final
+        {
+            std::string name;
+            std::string source_name;
+            std::string key;
+            // Set for recompiled shaders; embedded words are referenced in place.
+            std::shared_ptr<const std::vector<uint32_t>> compiled;
+            std::span<const uint32_t> spirv;
+        };
+
+        std::vector<Shader> m_shaders;
+        std::string m_flags;
+    };
+} // namespace rose::core::vulkan
@@ -0,0 +1,18 @@
+//
+// Created by orange on 16.10.2026.
+//
+#pragma once
+#include <cstddef>
+
+namespace rose::core::vulkan
+{
+    // Expands tightly packed 1-4 component texels to RGBA8: grey is replicated to RGB, missing
+    // alpha becomes 255. Picks an AVX2, SSSE3 or scalar kernel once, from the running CPU.
+    void expand_texels_to_rgba8(const unsigned char* src,
+                                int components,
+                                std::size_t texel_count,
+                                unsigned char* dst) noexcept;
+
+    // "avx2", "ssse3" or "scalar".
+    [[nodiscard]] const char* texel_conversion_isa() noexcept;
+} // namespace rose::core::vulkan
@@ -2,6 +2,10 @@
 // Created by orange on 25.02.2026.
 //
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <utility>
 #include <vector>
 
 namespace rose::core::vulkan
@@ -14,6 +18,30 @@ namespace rose::core::vulkan
         Emissive,
     };
 
+    // GPU format of a texture's data. The BC formats are stored as 4x4 texel blocks.
+    enum class TextureFormat
+    {
+        Rgba8,
+        Bc1,
+        Bc3,
+        Bc5,
+        Bc7,
+    };
+
+    // One level of a mip chain; offset and size locate its texels in Texture::pixels().
+    struct TextureMip final
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::size_t offset = 0;
+        std::size_t size = 0;
+    };
+
+    // Either decoded pixels with 1-4 components and no mips, which the renderer expands to RGBA8
+    // and mips itself, or a ready-to-upload mip chain in `format`, as loaded from KTX2.
+    // Once the texels also live in a cooked KTX2 file the renderer streams mips from that file
+    // and releases the CPU copy; the texture stays valid and keeps its size, format and mip
+    // layout.
     class Texture final
     {
     public:
@@ -31,18 +59,56 @@ namespace rose::core::vulkan
                                 * static_cast<std::size_t>(components);
                 m_pixels.assign(data, data + size);
             }
+            m_has_texels = !m_pixels.empty();
+        }
+
+        Texture(int width, int height, int components, std::vector<unsigned char> pixels)
+            : m_width(width)
+            , m_height(height)
+            , m_components(components)
+            , m_pixels(std::move(pixels))
+            , m_has_texels(!m_pixels.empty())
+        {}
+
+        Texture(TextureFormat format, std::vector<TextureMip> mips, std::vector<unsigned char> data)
+            : m_components(format == TextureFormat::Bc5 ? 2 : 4)
+            , m_format(format)
+            , m_mips(std::move(mips))
+            , m_pixels(std::move(data))
+            , m_has_texels(!m_pixels.empty())
+        {
+            if (!m_mips.empty())
+            {
+                m_width = static_cast<int>(m_mips.front().width);
+                m_height = static_cast<int>(m_mips.front().height);
+            }
         }
 
         [[nodiscard]] int width() const noexcept { return m_width; }
         [[nodiscard]] int height() const noexcept { return m_height; }
         [[nodiscard]] int components() const noexcept { return m_components; }
+        [[nodiscard]] TextureFormat format() const noexcept { return m_format; }
+        // Empty for decoded pixels.
+        [[nodiscard]] const std::vector<TextureMip>& mips() const noexcept { return m_mips; }
         [[nodiscard]] const std::vector<unsigned char>& pixels() const noexcept { return m_pixels; }
-        [[nodiscard]] bool valid() const noexcept { return !m_pixels.empty() && m_width > 0 && m_height > 0; }
+        [[nodiscard]] bool block_compressed() const noexcept { return m_format != TextureFormat::Rgba8; }
+        // Does not look at pixels(), which the renderer may release from a worker thread.
+        [[nodiscard]] bool valid() const noexcept { return m_has_texels && m_width > 0 && m_height > 0; }
+
+        // KTX2 file holding this texture's texels as a full mip chain, if any.
+        [[nodiscard]] const std::filesystem::path& cooked_path() const noexcept { return m_cooked_path; }
+        void set_cooked_path(std::filesystem::path path) { m_cooked_path = std::move(path); }
+        // Frees the CPU copy; only valid once cooked_path() is set.
+        void release_pixels() noexcept { std::vector<unsigned char>().swap(m_pixels); }
 
     private:
         int m_width      = 0;
         int m_height     = 0;
         int m_components = 0;
+        TextureFormat m_format = TextureFormat::Rgba8;
+        std::vector<TextureMip> m_mips;
         std::vector<unsigned char> m_pixels;
+        std::filesystem::path m_cooked_path;
+        bool m_has_texels = false;
     };
 } // namespace rose::core::vulkan
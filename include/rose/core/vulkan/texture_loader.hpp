@@ -0,0 +1,44 @@
+//
+// Created by orange on 16.10.2026.
+//
+#pragma once
+#include "rose/core/vulkan/texture.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace rose::core::vulkan
+{
+    [[nodiscard]] uint32_t mip_level_count(uint32_t width, uint32_t height) noexcept;
+
+    // Decoded pixels laid out as a box-filtered RGBA8 mip chain. Mips 1 and below are filtered
+    // when prepared; mip 0 is expanded only by write_mip_chain, straight into its destination.
+    struct PreparedMipChain final
+    {
+        std::vector<TextureMip> mips;
+        std::vector<unsigned char> lower_mips; // mips[1..], packed from mips[1].offset
+        std::size_t size = 0;
+    };
+
+    // Colour textures are filtered in linear space and normal maps are renormalised per texel,
+    // so distant surfaces keep their brightness and shading. Runs on residency workers.
+    [[nodiscard]] PreparedMipChain prepare_mip_chain(const Texture& texture, TextureType type);
+    // Writes the whole chain, chain.size bytes, to dst (typically mapped staging memory).
+    void write_mip_chain(const Texture& texture, const PreparedMipChain& chain, unsigned char* dst) noexcept;
+
+    // Reads a KTX2 file without supercompression holding RGBA8 or BC1/BC3/BC5/BC7 data, from
+    // mip `first_level` (clamped to the last level) down; only those levels are read. sRGB
+    // formats load as their UNORM equivalents, matching how decoded images are sampled. An RGBA8
+    // file without mips loads as decoded pixels, so the renderer builds the chain for the
+    // texture's use. The result's cooked_path() is `path`. Throws std::runtime_error for
+    // malformed files, supercompression, arrays, cube maps and other formats.
+    [[nodiscard]] Texture load_ktx2(const std::filesystem::path& path, uint32_t first_level = 0);
+
+    // Writes a texture with a mip chain as KTX2 that load_ktx2 reads back. Throws
+    // std::runtime_error when the file cannot be written.
+    void write_ktx2(const std::filesystem::path& path, const Texture& texture);
+
+    // Copy of mips first_level.. of a texture with a mip chain.
+    [[nodiscard]] Texture mip_tail(const Texture& texture, uint32_t first_level);
+} // namespace rose::core::vulkan
@@ -0,0 +1,75 @@
+//
+// Created by orange on 16.10.2026.
+//
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace rose::core::vulkan
+{
+    // Decides which mips of streamed textures are resident. Every texture keeps its small mip
+    // tail resident; more detail is granted to the most visible requests while the resident
+    // bytes fit the budget, and detail of the least recently drawn textures is evicted to make
+    // room. Bookkeeping only: the renderer uploads the levels and reports each transition back.
+    // Thread-safe.
+    class TextureStreamer final
+    {
+    public:
+        using Key = const void*;
+
+        // Frames a texture keeps its requested detail after it was last drawn.
+        static constexpr uint64_t k_idle_frames = 120;
+
+        struct Transition final
+        {
+            Key key = nullptr;
+            uint32_t base_level = 0;
+        };
+
+        struct Stats final
+        {
+            uint64_t resident_bytes = 0;
+            std::size_t texture_count = 0;
+            std::size_t transitions_in_flight = 0;
+            uint64_t evicted_bytes = 0;
+        };
+
+        // level_bytes[i] is the size of mip i; levels tail_level.. stay resident for good.
+        void add(Key key, std::vector<uint64_t> level_bytes, uint32_t tail_level);
+        // Records that `key` was drawn in `frame` and wants mips from `base_level` down. The finest
+        // request of a frame wins.
+        void request(Key key, uint32_t base_level, uint64_t frame);
+        // Picks up to `max_transitions` level changes: evictions first while the resident bytes
+        // exceed `budget_bytes` or an upgrade needs room, then upgrades in priority order. Bytes
+        // freed by an eviction only count once it completes.
+        [[nodiscard]] std::vector<Transition> plan(uint64_t frame, uint64_t budget_bytes, std::size_t max_transitions);
+        void complete(Key key, uint32_t base_level);
+        void cancel(Key key);
+
+        [[nodiscard]] Stats stats() const;
+
+    private:
+        struct Entry final
+        {
+            std::vector<uint64_t> resident_bytes; // bytes resident with base level i
+            uint32_t tail_level = 0;
+            uint32_t resident_level = 0;
+            uint32_t requested_level = 0;
+            uint64_t requested_frame = 0;
+            bool requested = false;
+            bool in_flight = false;
+            uint32_t target_level = 0;
+        };
+
+        [[nodiscard]] static uint32_t wanted_level(const Entry& entry, uint64_t frame) noexcept;
+        // Bytes an entry holds while planning: an upgrade in flight already counts its target.
+        [[nodiscard]] static uint64_t committed_bytes(const Entry& entry) noexcept;
+
+        mutable std::mutex m_mutex;
+        std::unordered_map<Key, Entry> m_entries;
+        uint64_t m_evicted_bytes = 0;
+    };
+} // namespace rose::core::vulkan
@@ -0,0 +1,139 @@
+//
+// Created by orange on 16.10.2026.
+//
+#pragma once
+#include "rose/core/vulkan/device_allocator.hpp"
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace rose::core::vulkan
+{
+    // Monotonic id of the batch an upload was recorded into. A resource may be used by the
+    // GPU once UploadManager::is_complete() reports its ticket as finished.
+    using UploadTicket = uint64_t;
+
+    // One mip level of an image upload; offset is relative to the uploaded data.
+    struct ImageUploadLevel final
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        VkDeviceSize offset = 0;
+    };
+
+    struct UploadQueue final
+    {
+        VkQueue queue = VK_NULL_HANDLE;
+        uint32_t family = 0;
+        bool dedicated = false;          // transfer-only family, separate from graphics
+        bool timeline_semaphore = false; // timelineSemaphore feature enabled on the device
+    };
+
+    // Batches buffer and image uploads into one command buffer per flush.
+    // Source data is copied into a persistently mapped staging ring; requests that do not fit
+    // the free part of the ring get a one-off staging buffer that is released once the batch
+    // retires. Completion is tracked with a timeline semaphore when available and with one
+    // fence per batch otherwise, so callers never wait on the queue.
+    class UploadManager final
+    {
+    public:
+        static constexpr VkDeviceSize k_default_ring_size = 32ull * 1024ull * 1024ull;
+
+        UploadManager(VkPhysicalDevice physical_device,
+                      VkDevice device,
+                      DeviceAllocator& allocator,
+                      const UploadQueue& queue,
+                      VkDeviceSize ring_size = k_default_ring_size);
+        ~UploadManager();
+
+        UploadManager(const UploadManager&) = delete;
+        UploadManager& operator=(const UploadManager&) = delete;
+
+        [[nodiscard]] UploadTicket upload_buffer(VkBuffer destination,
+                                                 VkDeviceSize destination_offset,
+                                                 const void* data,
+                                                 VkDeviceSize size);
+        // Uploads tightly packed texels into mips 0..levels.size()-1 of a single-layer colour
+        // image and leaves them in SHADER_READ_ONLY_OPTIMAL. Level offsets must respect the
+        // format's texel block size.
+        [[nodiscard]] UploadTicket upload_image(VkImage destination,
+                                                std::span<const ImageUploadLevel> levels,
+                                                const void* data,
+                                                VkDeviceSize size);
+        // As above, but `write` fills the `size` bytes of mapped staging memory directly. It runs
+        // under the upload lock, so it should only stream texels that are already prepared.
+        [[nodiscard]] UploadTicket upload_image(VkImage destination,
+                                                std::span<const ImageUploadLevel> levels,
+                                                VkDeviceSize size,
+                                                const std::function<void(void* staging)>& write);
+
+        // Submits the open batch, if any. Returns the ticket of the newest submitted batch.
+        UploadTicket flush();
+        // Retires finished batches, returning their staging space to the ring.
+        void collect();
+        void wait(UploadTicket ticket);
+
+        [[nodiscard]] bool is_complete(UploadTicket ticket) const;
+        [[nodiscard]] UploadTicket completed_ticket() const;
+        [[nodiscard]] bool dedicated_queue() const noexcept { return m_queue.dedicated; }
+        [[nodiscard]] bool uses_timeline_semaphore() const noexcept { return m_queue.timeline_semaphore; }
+        // Null when batches are tracked with fences.
+        [[nodiscard]] VkSemaphore timeline_semaphore() const noexcept { return m_timeline; }
+
+    private:
+        struct StagingBuffer final
+        {
+            VkBuffer buffer = VK_NULL_HANDLE;
+            DeviceAllocation allocation;
+        };
+
+        struct Batch final
+        {
+            VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+            VkFence fence = VK_NULL_HANDLE;
+            UploadTicket ticket = 0;
+            VkDeviceSize ring_bytes = 0;
+            std::vector<StagingBuffer> dedicated_staging;
+        };
+
+        struct StagingRange final
+        {
+            VkBuffer buffer = VK_NULL_HANDLE;
+            VkDeviceSize offset = 0;
+            void* mapped = nullptr;
+        };
+
+        // Reserves ring space, or a dedicated buffer for oversized uploads, in the open batch.
+        [[nodiscard]] StagingRange stage(VkDeviceSize size);
+        [[nodiscard]] Batch& open_batch();
+        [[nodiscard]] StagingBuffer create_staging_buffer(VkDeviceSize size);
+        void destroy_staging_buffer(StagingBuffer& buffer) noexcept;
+        [[nodiscard]] UploadTicket query_completed_ticket() const;
+        void retire_completed(UploadTicket completed);
+
+        VkDevice m_device = VK_NULL_HANDLE;
+        DeviceAllocator& m_allocator;
+        UploadQueue m_queue;
+        VkCommandPool m_command_pool = VK_NULL_HANDLE;
+        VkSemaphore m_timeline = VK_NULL_HANDLE;
+
+        StagingBuffer m_ring;
+        VkDeviceSize m_ring_size = 0;
+        VkDeviceSize m_ring_head = 0;
+        VkDeviceSize m_ring_used = 0;
+        VkDeviceSize m_copy_alignment = 16;
+
+        std::vector<Batch> m_free_batches;
+        std::deque<Batch> m_in_flight;
+        Batch m_open;
+        bool m_has_open = false;
+        UploadTicket m_next_ticket = 1;
+        UploadTicket m_submitted_ticket = 0;
+        UploadTicket m_completed_ticket = 0;
+        mutable std::mutex m_mutex;
+    };
+} // namespace rose::core::vulkan
@@ -2,7 +2,9 @@
 // Created by orange on 16.02.2026.
 //
 #pragma once
+#include <filesystem>
 #include <memory>
+#include <optional>
 #include <omath/linear_algebra/vector2.hpp>
 
 struct GLFWwindow;
@@ -14,10 +16,18 @@ namespace rose::core
         class Renderer;
     }
 
+    struct LaunchOptions final
+    {
+        // A Chrome trace of the CPU profiler is written here when the window closes.
+        std::optional<std::filesystem::path> trace_path;
+        // Run the frustum culling micro-benchmark and exit instead of opening a window.
+        bool benchmark_culling = false;
+    };
+
     class WindowManager final
     {
     public:
-        explicit WindowManager();
+        explicit WindowManager(LaunchOptions options = {});
         ~WindowManager();
 
         WindowManager(const WindowManager&) = delete;
@@ -27,6 +37,7 @@ namespace rose::core
     private:
         omath::Vector2<int> m_window_size = {1280, 720};
         GLFWwindow* m_window = nullptr;
+        LaunchOptions m_options;
         std::unique_ptr<vulkan::Renderer> m_renderer;
     };
 } // namespace rose::core
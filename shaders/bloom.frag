@@ -3,43 +3,32 @@
 layout(location = 0) in vec2 vUv;
 
 layout(set = 0, binding = 0) uniform sampler2D uSceneColor;
+// First level of the bloom pyramid, which the upsample passes have accumulated every level into.
+layout(set = 0, binding = 1) uniform sampler2D uBloom;
 
 layout(push_constant) uniform BloomPushConstants {
-    vec2 uTexelSize;
-    float uThreshold;
+    vec2 uBloomTexelSize;
     float uIntensity;
     float uRadius;
-    int uQuality;
 } pc;
 
 layout(location = 0) out vec4 FragColor;
 
-const float kPi = 3.14159265359;
-const float kLumaR = 0.2126;
-const float kLumaG = 0.7152;
-const float kLumaB = 0.0722;
-
-vec3 brightPart(vec3 color) {
-    float luma = dot(color, vec3(kLumaR, kLumaG, kLumaB));
-    float amount = max(luma - pc.uThreshold, 0.0) / max(luma, 0.0001);
-    return color * amount;
+vec3 tent(vec2 uv, vec2 spread) {
+    vec3 sum = texture(uBloom, uv).rgb * 4.0;
+    sum += texture(uBloom, uv + vec2(-spread.x, 0.0)).rgb * 2.0;
+    sum += texture(uBloom, uv + vec2( spread.x, 0.0)).rgb * 2.0;
+    sum += texture(uBloom, uv + vec2(0.0, -spread.y)).rgb * 2.0;
+    sum += texture(uBloom, uv + vec2(0.0,  spread.y)).rgb * 2.0;
+    sum += texture(uBloom, uv + vec2(-spread.x, -spread.y)).rgb;
+    sum += texture(uBloom, uv + vec2( spread.x, -spread.y)).rgb;
+    sum += texture(uBloom, uv + vec2(-spread.x,  spread.y)).rgb;
+    sum += texture(uBloom, uv + vec2( spread.x,  spread.y)).rgb;
+    return sum / 16.0;
 }
 
 void main() {
     vec3 baseColor = texture(uSceneColor, vUv).rgb;
-    vec3 bloom = brightPart(baseColor);
-    float weightSum = 1.0;
-
-    int quality = clamp(pc.uQuality, 1, 64);
-    for (int i = 0; i < quality; ++i) {
-        float t = (float(i) + 0.5) / float(quality);
-        float angle = t * kPi * 2.39996323;
-        float radius = sqrt(t) * pc.uRadius;
-        vec2 offset = vec2(cos(angle), sin(angle)) * radius * pc.uTexelSize;
-        float weight = 1.0 - t * 0.65;
-        bloom += brightPart(texture(uSceneColor, vUv + offset).rgb) * weight;
-        weightSum += weight;
-    }
-
-    FragColor = vec4(baseColor + bloom * (pc.uIntensity / weightSum), 1.0);
+    vec3 bloom = tent(vUv, pc.uBloomTexelSize * pc.uRadius);
+    FragColor = vec4(baseColor + bloom * pc.uIntensity, 1.0);
 }
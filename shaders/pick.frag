@@ -0,0 +1,20 @@
+#version 450
+
+// Object-ID pass: every draw under the picked pixel writes its id, and the depth test leaves the
+// nearest one. 0 is the cleared background.
+layout(push_constant) uniform PushConstants {
+    mat4 uMVP;
+    mat4 uModel;
+    mat4 uPrevMVP;
+    vec3 uCameraPosition;
+    uint uCameraLatched;
+    float uSelectionWidth;
+    uint uObjectId;
+    vec2 uPadding1;
+} pc;
+
+layout(location = 0) out uint ObjectId;
+
+void main() {
+    ObjectId = pc.uObjectId;
+}
@@ -0,0 +1,24 @@
+#version 450
+
+// Selection mask: every visible pixel of a selected mesh becomes a jump flood seed that points at
+// itself, its coordinates packed 16 bits each. Next to it go the glow width in pixels and the
+// depth the glow around the pixel is tested at.
+layout(push_constant) uniform PushConstants {
+    mat4 uMVP;
+    mat4 uModel;
+    mat4 uPrevMVP;
+    vec3 uCameraPosition;
+    uint uCameraLatched;
+    float uSelectionWidth;
+    uint uObjectId;
+    vec2 uPadding1;
+} pc;
+
+layout(location = 0) out uint Seed;
+layout(location = 1) out vec2 SeedData;
+
+void main() {
+    uvec2 pixel = uvec2(gl_FragCoord.xy);
+    Seed = pixel.x | (pixel.y << 16);
+    SeedData = vec2(pc.uSelectionWidth, gl_FragCoord.z);
+}
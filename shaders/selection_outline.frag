@@ -0,0 +1,45 @@
+#version 450
+
+// Blends the selection glow into the scene color. After the jump flood every pixel near the
+// selection knows its nearest mask pixel; the glow fades with the distance to it over the width
+// that mask pixel was drawn with, and is depth tested at its depth.
+layout(set = 0, binding = 0, r32ui) uniform readonly uimage2D uSeeds;
+layout(set = 0, binding = 1, rg32f) uniform readonly image2D uSeedData;
+
+layout(push_constant) uniform SelectionParams {
+    vec3 uColor;
+    float uSoftness;
+    ivec2 uSize;
+    int uStep;
+    int uPadding;
+} params;
+
+layout(location = 0) out vec4 FragColor;
+
+const uint kNoSeed = 0xffffffffu;
+const float kAlpha = 0.85;
+
+void main() {
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    uint seed = imageLoad(uSeeds, pixel).r;
+    if (seed == kNoSeed) {
+        discard;
+    }
+    ivec2 seedPixel = ivec2(seed & 0xffffu, seed >> 16);
+    if (seedPixel == pixel) {
+        discard; // part of the selection itself
+    }
+
+    vec2 seedData = imageLoad(uSeedData, seedPixel).rg;
+    float width = seedData.x;
+    float gap = length(vec2(seedPixel - pixel));
+    // The outer edge is antialiased over one pixel.
+    float coverage = clamp(width - gap + 0.5, 0.0, 1.0);
+    if (coverage <= 0.0) {
+        discard;
+    }
+
+    float fade = params.uSoftness > 0.0 ? smoothstep(1.0 - params.uSoftness, 1.0, gap / max(width, 1.0)) : 0.0;
+    FragColor = vec4(params.uColor, kAlpha * coverage * (1.0 - fade));
+    gl_FragDepth = seedData.y;
+}
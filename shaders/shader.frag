@@ -5,7 +5,6 @@ layout(location = 2) in vec4 vClipPos;
 layout(location = 3) in vec4 vPrevClipPos;
 layout(location = 4) in vec3 vWorldPos;
 layout(location = 5) in vec4 vShadowClipPos;
-layout(location = 6) in vec4 vSunShadowClipPos;
 
 layout(set = 0, binding = 0) uniform sampler2D uBaseColor;
 layout(set = 0, binding = 1) uniform sampler2D uNormal;
@@ -17,7 +16,7 @@ layout(set = 0, binding = 4) uniform MaterialParams {
     float uMetallicFactor;
     float uRoughnessFactor;
     float uNormalScale;
-    float uPadding;
+    float uNormalReconstructZ;
 } material;
 
 layout(set = 1, binding = 0) uniform LightParams {
@@ -29,21 +28,21 @@ layout(set = 1, binding = 0) uniform LightParams {
     vec4 uSunDirectionEnabled;
     vec4 uSunColorIntensity;
     vec4 uSunParams;
-    mat4 uSunViewProjection;
+    mat4 uSunViewProjections[4];
 } light;
 layout(set = 1, binding = 1) uniform sampler2D uShadowMap;
-layout(set = 1, binding = 2) uniform sampler2D uSunShadowMap;
+// One layer per sun cascade; uSunParams.z holds the cascade count.
+layout(set = 1, binding = 2) uniform sampler2DArray uSunShadowMap;
 
 layout(push_constant) uniform PushConstants {
     mat4 uMVP;
     mat4 uModel;
     mat4 uPrevMVP;
-    vec3 uOutlineCenter;
-    float uOutlineWidth;
-    vec3 uOutlineColor;
-    float uOutlineAlpha;
-    int uOutlineEnabled;
-    vec3 uOutlinePadding;
+    vec3 uCameraPosition;
+    uint uCameraLatched;
+    float uSelectionWidth;
+    uint uObjectId;
+    vec2 uPadding1;
 } pc;
 
 layout(location = 0) out vec4 FragColor;
@@ -112,6 +111,9 @@ mat3 cotangentFrame(vec3 n, vec3 p, vec2 uv) {
 vec3 pbrNormal() {
     vec3 n = normalize(vWorldNormal);
     vec3 tangentNormal = texture(uNormal, vUv).xyz * 2.0 - 1.0;
+    // Two-channel (BC5) normal maps store only xy.
+    if (material.uNormalReconstructZ > 0.5)
+        tangentNormal.z = sqrt(max(1.0 - dot(tangentNormal.xy, tangentNormal.xy), 0.0));
     tangentNormal.xy *= material.uNormalScale;
     return normalize(cotangentFrame(n, vWorldPos, vUv) * normalize(tangentNormal));
 }
@@ -137,13 +139,41 @@ float shadowVisibility(vec4 shadowClipPos, sampler2D shadowMap, vec3 n, vec3 l,
     return mix(0.18, 1.0, visible / 9.0);
 }
 
-void main() {
-    if (pc.uOutlineEnabled != 0) {
-        FragColor = vec4(pc.uOutlineColor, pc.uOutlineAlpha);
-        MotionVector = vec2(0.0);
-        return;
+// Same clip convention as shader.vert.
+vec4 toVulkanClip(vec4 clipPos) {
+    clipPos.y = -clipPos.y;
+    clipPos.z = (clipPos.z + clipPos.w) * 0.5;
+    return clipPos;
+}
+
+// Uses the first cascade whose map covers the fragment with room for the PCF footprint. The
+// cascades are ordered from the camera outwards, so this is also the sharpest one.
+float sunShadowVisibility(vec3 n, vec3 l, float baseBias) {
+    int cascadeCount = int(light.uSunParams.z);
+    vec2 texelSize = 1.0 / vec2(textureSize(uSunShadowMap, 0).xy);
+    for (int cascade = 0; cascade < cascadeCount; ++cascade) {
+        vec4 shadowClipPos = toVulkanClip(light.uSunViewProjections[cascade] * vec4(vWorldPos, 1.0));
+        vec3 shadowNdc = shadowClipPos.xyz / shadowClipPos.w;
+        vec2 shadowUv = shadowNdc.xy * 0.5 + 0.5;
+        if (any(lessThan(shadowUv, texelSize * 2.0)) || any(greaterThan(shadowUv, 1.0 - texelSize * 2.0))
+            || shadowNdc.z < 0.0 || shadowNdc.z > 1.0) {
+            continue;
+        }
+
+        float bias = max(baseBias * (1.0 - dot(n, l)), baseBias * 0.35);
+        float visible = 0.0;
+        for (int y = -1; y <= 1; ++y) {
+            for (int x = -1; x <= 1; ++x) {
+                float closestDepth = texture(uSunShadowMap, vec3(shadowUv + vec2(x, y) * texelSize, float(cascade))).r;
+                visible += shadowNdc.z - bias <= closestDepth ? 1.0 : 0.0;
+            }
+        }
+        return mix(0.18, 1.0, visible / 9.0);
     }
+    return 1.0;
+}
 
+void main() {
     vec4 baseSample = texture(uBaseColor, vUv);
     vec3 albedo = srgbToLinear(baseSample.rgb) * material.uBaseColorFactor.rgb;
     float alpha = baseSample.a * material.uBaseColorFactor.a;
@@ -154,7 +184,7 @@ void main() {
     vec3 emissive = srgbToLinear(texture(uEmissive, vUv).rgb) * material.uEmissiveFactor.rgb;
 
     vec3 n = pbrNormal();
-    vec3 v = normalize(pc.uOutlineCenter - vWorldPos);
+    vec3 v = normalize(pc.uCameraPosition - vWorldPos);
     vec3 light_delta = light.uPositionEnabled.xyz - vWorldPos;
     float light_distance = length(light_delta);
     vec3 l = light_delta / max(light_distance, 0.0001);
@@ -175,7 +205,7 @@ void main() {
                   * shadow;
     vec3 f0 = mix(vec3(0.04), albedo, metallic);
     vec3 sunL = normalize(-light.uSunDirectionEnabled.xyz);
-    float sunShadow = shadowVisibility(vSunShadowClipPos, uSunShadowMap, n, sunL, light.uSunParams.x);
+    float sunShadow = sunShadowVisibility(n, sunL, light.uSunParams.x);
     vec3 sunRadiance = light.uSunColorIntensity.rgb
                      * light.uSunColorIntensity.a
                      * light.uSunDirectionEnabled.w
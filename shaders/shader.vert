@@ -3,16 +3,19 @@ layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aUv;
 
+// Set by the indirect pipelines: the model matrix comes from the per-draw buffer, selected by the
+// command's firstInstance, instead of the push constants.
+layout(constant_id = 0) const bool kGpuDriven = false;
+
 layout(push_constant) uniform PushConstants {
     mat4 uMVP;
     mat4 uModel;
     mat4 uPrevMVP;
-    vec3 uOutlineCenter;
-    float uOutlineWidth;
-    vec3 uOutlineColor;
-    float uOutlineAlpha;
-    int uOutlineEnabled;
-    vec3 uOutlinePadding;
+    vec3 uCameraPosition;
+    uint uCameraLatched;
+    float uSelectionWidth;
+    uint uObjectId;
+    vec2 uPadding1;
 } pc;
 
 layout(set = 1, binding = 0) uniform LightParams {
@@ -24,16 +27,40 @@ layout(set = 1, binding = 0) uniform LightParams {
     vec4 uSunDirectionEnabled;
     vec4 uSunColorIntensity;
     vec4 uSunParams;
-    mat4 uSunViewProjection;
+    mat4 uSunViewProjections[4];
 } light;
 
+// Written just before submission for the late-latched camera; used instead of uMVP and uPrevMVP
+// when uCameraLatched is set.
+layout(set = 1, binding = 3) uniform CameraParams {
+    mat4 uViewProjection;
+    mat4 uPrevViewProjection;
+} camera;
+
+struct DrawData {
+    mat4 model;
+    vec4 boundsCenter;
+    vec4 boundsExtent;
+    uint indexCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint batch;
+    uint batchFirst;
+    uint flags;
+    uint padding0;
+    uint padding1;
+};
+
+layout(std430, set = 2, binding = 0) readonly buffer DrawBuffer {
+    DrawData draws[];
+} drawBuffer;
+
 layout(location = 0) out vec3 vWorldNormal;
 layout(location = 1) out vec2 vUv;
 layout(location = 2) out vec4 vClipPos;
 layout(location = 3) out vec4 vPrevClipPos;
 layout(location = 4) out vec3 vWorldPos;
 layout(location = 5) out vec4 vShadowClipPos;
-layout(location = 6) out vec4 vSunShadowClipPos;
 
 vec4 toVulkanClip(vec4 clipPos) {
     clipPos.y = -clipPos.y;
@@ -42,25 +69,19 @@ vec4 toVulkanClip(vec4 clipPos) {
 }
 
 void main() {
-    vWorldNormal = normalize(mat3(transpose(inverse(pc.uModel))) * aNormal);
+    mat4 model = kGpuDriven ? drawBuffer.draws[gl_InstanceIndex].model : pc.uModel;
+    vWorldNormal = normalize(mat3(transpose(inverse(model))) * aNormal);
     vUv = aUv;
 
-    vec4 worldPos = pc.uModel * vec4(aPos, 1.0);
-    if (pc.uOutlineEnabled != 0) {
-        vec3 worldCenter = (pc.uModel * vec4(pc.uOutlineCenter, 1.0)).xyz;
-        vec3 expandDir = worldPos.xyz - worldCenter;
-        if (dot(expandDir, expandDir) < 0.000001) {
-            expandDir = vWorldNormal;
-        }
-        worldPos.xyz += normalize(expandDir) * pc.uOutlineWidth;
-    }
+    vec4 worldPos = model * vec4(aPos, 1.0);
 
-    vec4 clipPos = toVulkanClip(pc.uMVP * worldPos);
-    vec4 prevClipPos = toVulkanClip(pc.uPrevMVP * worldPos);
+    mat4 viewProjection = pc.uCameraLatched != 0u ? camera.uViewProjection : pc.uMVP;
+    mat4 prevViewProjection = pc.uCameraLatched != 0u ? camera.uPrevViewProjection : pc.uPrevMVP;
+    vec4 clipPos = toVulkanClip(viewProjection * worldPos);
+    vec4 prevClipPos = toVulkanClip(prevViewProjection * worldPos);
     vClipPos = clipPos;
     vPrevClipPos = prevClipPos;
     vWorldPos = worldPos.xyz;
     vShadowClipPos = toVulkanClip(light.uViewProjection * worldPos);
-    vSunShadowClipPos = toVulkanClip(light.uSunViewProjection * worldPos);
     gl_Position = clipPos;
 }
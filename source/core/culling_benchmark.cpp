@@ -0,0 +1,165 @@
+//
+// Created by orange on 16.10.2026.
+//
+#include "rose/core/culling_benchmark.hpp"
+#include "rose/core/frustum.hpp"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace rose::core
+{
+    namespace
+    {
+        constexpr std::size_t k_box_count = 100'000;
+        constexpr int k_repetitions = 20;
+        constexpr float k_scene_extent = 500.0f;
+
+        using Matrix = std::array<float, 16>; // column-major
+
+        [[nodiscard]] Matrix multiply(const Matrix& a, const Matrix& b) noexcept
+        {
+            Matrix result{};
+            for (int column = 0; column < 4; ++column)
+            {
+                for (int row = 0; row < 4; ++row)
+                {
+                    float sum = 0.0f;
+                    for (int k = 0; k < 4; ++k)
+                        sum += a[static_cast<std::size_t>(k * 4 + row)] * b[static_cast<std::size_t>(column * 4 + k)];
+                    result[static_cast<std::size_t>(column * 4 + row)] = sum;
+                }
+            }
+            return result;
+        }
+
+        // World to view for an eye at `eye` turned by `yaw` about +y, looking down -z.
+        [[nodiscard]] Matrix view_matrix(const std::array<float, 3>& eye, float yaw) noexcept
+        {
+            const float c = std::cos(yaw);
+            const float s = std::sin(yaw);
+            Matrix view{c, 0.0f, s, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, -s, 0.0f, c, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+            for (int row = 0; row < 3; ++row)
+            {
+                view[static_cast<std::size_t>(12 + row)] = -(view[static_cast<std::size_t>(row)] * eye[0]
+                                                             + view[static_cast<std::size_t>(4 + row)] * eye[1]
+                                                             + view[static_cast<std::size_t>(8 + row)] * eye[2]);
+            }
+            return view;
+        }
+
+        [[nodiscard]] Matrix perspective(float vertical_fov, float aspect, float near_plane, float far_plane) noexcept
+        {
+            const float f = 1.0f / std::tan(vertical_fov * 0.5f);
+            Matrix projection{};
+            projection[0] = f / aspect;
+            projection[5] = f;
+            projection[10] = (far_plane + near_plane) / (near_plane - far_plane);
+            projection[11] = -1.0f;
+            projection[14] = 2.0f * far_plane * near_plane / (near_plane - far_plane);
+            return projection;
+        }
+
+        [[nodiscard]] Matrix orthographic(float half_width, float depth) noexcept
+        {
+            Matrix projection{};
+            projection[0] = 1.0f / half_width;
+            projection[5] = 1.0f / half_width;
+            projection[10] = -2.0f / depth;
+            projection[14] = -1.0f;
+            projection[15] = 1.0f;
+            return projection;
+        }
+
+        // Best of k_repetitions, in nanoseconds per box.
+        [[nodiscard]] double time_per_box(const std::function<void()>& cull)
+        {
+            double best = std::numeric_limits<double>::max();
+            for (int repetition = 0; repetition < k_repetitions; ++repetition)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                cull();
+                const auto elapsed = std::chrono::steady_clock::now() - start;
+                best = std::min(best, std::chrono::duration<double, std::nano>(elapsed).count());
+            }
+            return best / static_cast<double>(k_box_count);
+        }
+    } // namespace
+
+    void run_culling_benchmark()
+    {
+        std::mt19937 random(0x5eedu);
+        std::uniform_real_distribution<float> position(-k_scene_extent, k_scene_extent);
+        std::uniform_real_distribution<float> half_size(0.25f, 5.0f);
+        std::vector<Aabb> boxes(k_box_count);
+        for (Aabb& box : boxes)
+        {
+            const float x = position(random);
+            const float y = position(random) * 0.1f;
+            const float z = position(random);
+            const float h = half_size(random);
+            box = {{x - h, y - h, z - h}, {x + h, y + h, z + h}};
+        }
+        const AabbBatch batch(boxes);
+
+        // A camera in the middle of the scene, and four sun cascades looking down at it.
+        std::vector<Frustum> frusta;
+        frusta.push_back(Frustum::from_view_projection(
+                multiply(perspective(1.2f, 16.0f / 9.0f, 0.1f, 1000.0f), view_matrix({0.0f, 2.0f, 0.0f}, 0.7f))));
+        for (int cascade = 0; cascade < 4; ++cascade)
+        {
+            const float half_width = 12.0f * std::pow(3.0f, static_cast<float>(cascade));
+            const Matrix sun_view{1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, -200.0f, 1.0f};
+            frusta.push_back(Frustum::from_view_projection(multiply(orthographic(half_width, 400.0f), sun_view)));
+        }
+
+        spdlog::info("Culling benchmark: {} boxes, {} frusta, {} kernel", k_box_count, frusta.size(), frustum_culling_isa());
+        const char* names[] = {"camera", "cascade 0", "cascade 1", "cascade 2", "cascade 3"};
+        std::vector<uint8_t> masks;
+        std::vector<std::size_t> visible;
+        visible.reserve(k_box_count);
+        for (std::size_t f = 0; f < frusta.size(); ++f)
+        {
+            const Frustum& frustum = frusta[f];
+            std::size_t reference_count = 0;
+            const double aos_ns = time_per_box(
+                    [&]
+                    {
+                        reference_count = 0;
+                        for (const Aabb& box : boxes)
+                            reference_count += frustum.intersects(box) ? 1u : 0u;
+                    });
+            const double mask_ns = time_per_box([&] { cull_boxes(frustum, batch, masks); });
+            const double list_ns = time_per_box(
+                    [&]
+                    {
+                        visible.clear();
+                        cull_boxes(frustum, batch, visible);
+                    });
+
+            std::size_t mask_count = 0;
+            for (const uint8_t mask : masks)
+                mask_count += static_cast<std::size_t>(std::popcount(static_cast<unsigned>(mask)));
+            if (mask_count != reference_count || visible.size() != reference_count)
+                throw std::runtime_error("Culling benchmark: the SIMD kernel disagrees with Frustum::intersects");
+
+            spdlog::info("  {:<9} {:>6} visible | per box: AoS {:.2f} ns, SoA mask {:.2f} ns ({:.1f}x), SoA list {:.2f} ns ({:.1f}x)",
+                         names[f],
+                         reference_count,
+                         aos_ns,
+                         mask_ns,
+                         aos_ns / mask_ns,
+                         list_ns,
+                         aos_ns / list_ns);
+        }
+    }
+} // namespace rose::core
@@ -0,0 +1,178 @@
+//
+// Created by orange on 16.10.2026.
+//
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include "rose/core/frame_pacer.hpp"
+#include "rose/core/profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32) && !defined(CREATE_WAITABLE_TIMER_HIGH_RESOLUTION)
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace rose::core
+{
+    namespace
+    {
+        // Weight of the newest oversleep sample in the running estimate.
+        constexpr double k_oversleep_weight = 0.05;
+        // Wake-ups later than this were preempted rather than overslept and are clamped.
+        constexpr double k_max_oversleep_ns = 4'000'000.0;
+
+        [[nodiscard]] double nanoseconds(FramePacer::Clock::duration duration) noexcept
+        {
+            return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+        }
+
+        void push_sample(std::deque<double>& history, double sample)
+        {
+            history.push_back(sample);
+            if (history.size() > FramePacer::k_history_size)
+                history.pop_front();
+        }
+    } // namespace
+
+    FramePacer::FramePacer()
+    {
+#ifdef _WIN32
+        // Unavailable before Windows 10 1803; sleep_for at the 1 ms timer period serves there.
+        m_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+#endif
+    }
+
+    FramePacer::~FramePacer()
+    {
+#ifdef _WIN32
+        if (m_timer != nullptr)
+            CloseHandle(m_timer);
+#endif
+    }
+
+    void FramePacer::set_target_rate(double frames_per_second) noexcept
+    {
+        frames_per_second = std::max(frames_per_second, 0.0);
+        if (frames_per_second == m_target_rate)
+            return;
+        m_target_rate = frames_per_second;
+        // The next deadline is a full period after the current frame started.
+        m_deadline = m_frame_start;
+    }
+
+    void FramePacer::wait()
+    {
+        ROSE_PROFILE_ZONE("FramePacer::wait");
+        m_spin_ns = 0.0;
+        const Clock::time_point now = Clock::now();
+        if (m_target_rate > 0.0 && m_started)
+        {
+            const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_target_rate));
+            m_deadline += period;
+            if (now > m_deadline + period)
+                m_deadline = now;
+            else if (now < m_deadline)
+                sleep_until(m_deadline);
+        }
+        else
+        {
+            m_deadline = now;
+        }
+
+        const Clock::time_point frame_start = Clock::now();
+        if (m_started)
+        {
+            push_sample(m_frame_ms, nanoseconds(frame_start - m_frame_start) / 1.0e6);
+            push_sample(m_spin_ms, m_spin_ns / 1.0e6);
+        }
+        m_frame_start = frame_start;
+        m_started = true;
+    }
+
+    void FramePacer::sleep_until(Clock::time_point deadline)
+    {
+        while (true)
+        {
+            const Clock::time_point before = Clock::now();
+            const double guard_ns = std::clamp(m_oversleep_mean_ns + 2.0 * std::sqrt(m_oversleep_variance_ns2),
+                                               0.0,
+                                               k_max_oversleep_ns);
+            const double request_ns = nanoseconds(deadline - before) - guard_ns;
+            if (request_ns <= 0.0)
+                break;
+
+#ifdef _WIN32
+            if (m_timer != nullptr)
+            {
+                // Relative due times are negative, in 100 ns units.
+                LARGE_INTEGER due_time{};
+                due_time.QuadPart = -static_cast<LONGLONG>(request_ns / 100.0);
+                if (SetWaitableTimer(m_timer, &due_time, 0, nullptr, nullptr, FALSE))
+                    WaitForSingleObject(m_timer, INFINITE);
+            }
+            else
+#endif
+            {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(static_cast<int64_t>(request_ns)));
+            }
+            record_oversleep(nanoseconds(Clock::now() - before) - request_ns);
+        }
+
+        // Only the guard is left, usually well under a millisecond. Yielding lets other threads
+        // of this and other instances run while it passes.
+        const Clock::time_point spin_start = Clock::now();
+        while (Clock::now() < deadline)
+            std::this_thread::yield();
+        m_spin_ns = nanoseconds(Clock::now() - spin_start);
+    }
+
+    void FramePacer::record_oversleep(double oversleep_ns) noexcept
+    {
+        oversleep_ns = std::clamp(oversleep_ns, 0.0, k_max_oversleep_ns);
+        const double delta = oversleep_ns - m_oversleep_mean_ns;
+        m_oversleep_mean_ns += k_oversleep_weight * delta;
+        m_oversleep_variance_ns2 = (1.0 - k_oversleep_weight) * (m_oversleep_variance_ns2 + k_oversleep_weight * delta * delta);
+    }
+
+    FramePacingStats FramePacer::stats() const
+    {
+        FramePacingStats stats;
+        stats.target_ms = m_target_rate > 0.0 ? 1000.0 / m_target_rate : 0.0;
+        stats.oversleep_ms = std::min(m_oversleep_mean_ns + 2.0 * std::sqrt(m_oversleep_variance_ns2), k_max_oversleep_ns)
+                           / 1.0e6;
+        stats.samples = m_frame_ms.size();
+        if (m_frame_ms.empty())
+            return stats;
+
+        double sum = 0.0;
+        for (const double frame_ms : m_frame_ms)
+        {
+            sum += frame_ms;
+            stats.max_ms = std::max(stats.max_ms, frame_ms);
+            if (stats.target_ms > 0.0 && frame_ms > stats.target_ms * 1.1)
+                ++stats.late_frames;
+        }
+        stats.mean_ms = sum / static_cast<double>(m_frame_ms.size());
+
+        double variance = 0.0;
+        for (const double frame_ms : m_frame_ms)
+            variance += (frame_ms - stats.mean_ms) * (frame_ms - stats.mean_ms);
+        stats.jitter_ms = std::sqrt(variance / static_cast<double>(m_frame_ms.size()));
+
+        std::vector<double> sorted(m_frame_ms.begin(), m_frame_ms.end());
+        std::ranges::sort(sorted);
+        const auto rank = static_cast<std::size_t>(std::ceil(0.99 * static_cast<double>(sorted.size())));
+        stats.p99_ms = sorted[std::clamp<std::size_t>(rank, 1u, sorted.size()) - 1u];
+
+        double spin_sum = 0.0;
+        for (const double spin_ms : m_spin_ms)
+            spin_sum += spin_ms;
+        stats.spin_ms = m_spin_ms.empty() ? 0.0 : spin_sum / static_cast<double>(m_spin_ms.size());
+        return stats;
+    }
+} // namespace rose::core
@@ -0,0 +1,416 @@
+//
+// Created by orange on 16.10.2026.
+//
+#include "rose/core/frustum.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ROSE_FRUSTUM_CULLING_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define ROSE_FRUSTUM_CULLING_X86 0
+#endif
+
+// NEON is part of every AArch64 CPU, so it needs no runtime check.
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define ROSE_FRUSTUM_CULLING_NEON 1
+#include <arm_neon.h>
+#else
+#define ROSE_FRUSTUM_CULLING_NEON 0
+#endif
+
+// MSVC emits any intrinsic without per-function target flags; GCC and Clang need them.
+#if defined(__GNUC__) || defined(__clang__)
+#define ROSE_CULLING_TARGET(isa) __attribute__((target(isa)))
+#else
+#define ROSE_CULLING_TARGET(isa)
+#endif
+
+namespace rose::core
+{
+    namespace
+    {
+        using CullKernel = void (*)(const Frustum&, uint32_t, const float*, std::size_t, uint8_t*) noexcept;
+
+        // Offsets of the bounds within a group.
+        constexpr std::size_t k_min_x = 0;
+        constexpr std::size_t k_max_x = 3 * AabbBatch::k_group_size;
+
+        // The corner of a box furthest along a plane's normal takes the max bound on every axis
+        // the normal points along, so one offset per axis picks it for a whole group.
+        struct GroupPlane final
+        {
+            std::array<std::size_t, 3> offsets;
+            std::array<float, 4> plane;
+        };
+
+        // The planes selected by `planes`, in order; returns how many there are.
+        [[nodiscard]] std::size_t group_planes(const Frustum& frustum,
+                                               uint32_t planes,
+                                               std::array<GroupPlane, 6>& out) noexcept
+        {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < frustum.planes.size(); ++i)
+            {
+                if ((planes & (1u << i)) == 0)
+                    continue;
+                const auto& plane = frustum.planes[i];
+                GroupPlane& group_plane = out[count++];
+                group_plane.plane = plane;
+                for (std::size_t axis = 0; axis < 3; ++axis)
+                    group_plane.offsets[axis] = (plane[axis] > 0.0f ? k_max_x : k_min_x) + axis * AabbBatch::k_group_size;
+            }
+            return count;
+        }
+
+        // Every kernel sums (a x + b y) + (c z + d) in this order so that they round alike.
+        void cull_scalar(const Frustum& frustum,
+                         uint32_t planes,
+                         const float* groups,
+                         std::size_t group_count,
+                         uint8_t* masks) noexcept
+        {
+            std::array<GroupPlane, 6> active{};
+            const std::size_t plane_count = group_planes(frustum, planes, active);
+            for (std::size_t g = 0; g < group_count; ++g)
+            {
+                const float* group = groups + g * AabbBatch::k_floats_per_group;
+                uint8_t mask = 0xffu;
+                for (std::size_t p = 0; p < plane_count; ++p)
+                {
+                    const GroupPlane& plane = active[p];
+                    for (std::size_t lane = 0; lane < AabbBatch::k_group_size; ++lane)
+                    {
+                        const float distance = (plane.plane[0] * group[plane.offsets[0] + lane]
+                                                + plane.plane[1] * group[plane.offsets[1] + lane])
+                                             + (plane.plane[2] * group[plane.offsets[2] + lane] + plane.plane[3]);
+                        if (!(distance >= 0.0f))
+                            mask = static_cast<uint8_t>(mask & ~(1u << lane));
+                    }
+                }
+                masks[g] = mask;
+            }
+        }
+
+#if ROSE_FRUSTUM_CULLING_X86
+        ROSE_CULLING_TARGET("sse2")
+        void cull_sse2(const Frustum& frustum,
+                       uint32_t planes,
+                       const float* groups,
+                       std::size_t group_count,
+                       uint8_t* masks) noexcept
+        {
+            std::array<GroupPlane, 6> active{};
+            const std::size_t plane_count = group_planes(frustum, planes, active);
+            const __m128 zero = _mm_setzero_ps();
+            for (std::size_t g = 0; g < group_count; ++g)
+            {
+                const float* group = groups + g * AabbBatch::k_floats_per_group;
+                int mask = 0;
+                for (std::size_t half = 0; half < 2; ++half)
+                {
+                    __m128 inside = _mm_cmpeq_ps(zero, zero);
+                    for (std::size_t p = 0; p < plane_count; ++p)
+                    {
+                        const GroupPlane& plane = active[p];
+                        const float* lanes = group + half * 4;
+                        const __m128 distance = _mm_add_ps(
+                                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.plane[0]), _mm_loadu_ps(lanes + plane.offsets[0])),
+                                           _mm_mul_ps(_mm_set1_ps(plane.plane[1]), _mm_loadu_ps(lanes + plane.offsets[1]))),
+                                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.plane[2]), _mm_loadu_ps(lanes + plane.offsets[2])),
+                                           _mm_set1_ps(plane.plane[3])));
+                        inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, zero));
+                    }
+                    mask |= _mm_movemask_ps(inside) << (half * 4);
+                }
+                masks[g] = static_cast<uint8_t>(mask);
+            }
+        }
+
+        ROSE_CULLING_TARGET("avx2")
+        void cull_avx2(const Frustum& frustum,
+                       uint32_t planes,
+                       const float* groups,
+                       std::size_t group_count,
+                       uint8_t* masks) noexcept
+        {
+            std::array<GroupPlane, 6> active{};
+            const std::size_t plane_count = group_planes(frustum, planes, active);
+            __m256 broadcast[6][4];
+            for (std::size_t p = 0; p < plane_count; ++p)
+            {
+                for (std::size_t i = 0; i < 4; ++i)
+                    broadcast[p][i] = _mm256_set1_ps(active[p].plane[i]);
+            }
+
+            const __m256 zero = _mm256_setzero_ps();
+            for (std::size_t g = 0; g < group_count; ++g)
+            {
+                const float* group = groups + g * AabbBatch::k_floats_per_group;
+                __m256 inside = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+                for (std::size_t p = 0; p < plane_count; ++p)
+                {
+                    const GroupPlane& plane = active[p];
+                    const __m256 distance = _mm256_add_ps(
+                            _mm256_add_ps(_mm256_mul_ps(broadcast[p][0], _mm256_loadu_ps(group + plane.offsets[0])),
+                                          _mm256_mul_ps(broadcast[p][1], _mm256_loadu_ps(group + plane.offsets[1]))),
+                            _mm256_add_ps(_mm256_mul_ps(broadcast[p][2], _mm256_loadu_ps(group + plane.offsets[2])),
+                                          broadcast[p][3]));
+                    inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, zero, _CMP_GE_OQ));
+                }
+                masks[g] = static_cast<uint8_t>(_mm256_movemask_ps(inside));
+            }
+        }
+
+        struct CpuFeatures final
+        {
+            bool sse2 = false;
+            bool avx2 = false;
+        };
+
+        [[nodiscard]] CpuFeatures cpu_features() noexcept
+        {
+            CpuFeatures features;
+#if defined(_MSC_VER) && !defined(__clang__)
+            std::array<int, 4> registers{};
+            __cpuid(registers.data(), 0);
+            const int max_leaf = registers[0];
+            __cpuid(registers.data(), 1);
+            features.sse2 = (registers[3] & (1 << 26)) != 0;
+            const bool os_saves_ymm = (registers[2] & (1 << 27)) != 0 && (registers[2] & (1 << 28)) != 0
+                                   && (_xgetbv(0) & 0x6u) == 0x6u;
+            if (max_leaf >= 7 && os_saves_ymm)
+            {
+                __cpuidex(registers.data(), 7, 0);
+                features.avx2 = (registers[1] & (1 << 5)) != 0;
+            }
+#else
+            __builtin_cpu_init();
+            features.sse2 = __builtin_cpu_supports("sse2") != 0;
+            features.avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+            return features;
+        }
+#endif
+
+#if ROSE_FRUSTUM_CULLING_NEON
+        void cull_neon(const Frustum& frustum,
+                       uint32_t planes,
+                       const float* groups,
+                       std::size_t group_count,
+                       uint8_t* masks) noexcept
+        {
+            std::array<GroupPlane, 6> active{};
+            const std::size_t plane_count = group_planes(frustum, planes, active);
+            const uint32_t lane_bits_values[4] = {1u, 2u, 4u, 8u};
+            const uint32x4_t lane_bits = vld1q_u32(lane_bits_values);
+            const float32x4_t zero = vdupq_n_f32(0.0f);
+            for (std::size_t g = 0; g < group_count; ++g)
+            {
+                const float* group = groups + g * AabbBatch::k_floats_per_group;
+                uint32_t mask = 0;
+                for (std::size_t half = 0; half < 2; ++half)
+                {
+                    uint32x4_t inside = vdupq_n_u32(~0u);
+                    for (std::size_t p = 0; p < plane_count; ++p)
+                    {
+                        const GroupPlane& plane = active[p];
+                        const float* lanes = group + half * 4;
+                        const float32x4_t distance = vaddq_f32(
+                                vaddq_f32(vmulq_n_f32(vld1q_f32(lanes + plane.offsets[0]), plane.plane[0]),
+                                          vmulq_n_f32(vld1q_f32(lanes + plane.offsets[1]), plane.plane[1])),
+                                vaddq_f32(vmulq_n_f32(vld1q_f32(lanes + plane.offsets[2]), plane.plane[2]),
+                                          vdupq_n_f32(plane.plane[3])));
+                        inside = vandq_u32(inside, vcgeq_f32(distance, zero));
+                    }
+                    mask |= vaddvq_u32(vandq_u32(inside, lane_bits)) << (half * 4);
+                }
+                masks[g] = static_cast<uint8_t>(mask);
+            }
+        }
+#endif
+
+        struct CullDispatch final
+        {
+            CullKernel kernel = cull_scalar;
+            const char* isa = "scalar";
+
+            CullDispatch() noexcept
+            {
+#if ROSE_FRUSTUM_CULLING_X86
+                const CpuFeatures features = cpu_features();
+                if (features.avx2)
+                {
+                    kernel = cull_avx2;
+                    isa = "avx2";
+                }
+                else if (features.sse2)
+                {
+                    kernel = cull_sse2;
+                    isa = "sse2";
+                }
+#elif ROSE_FRUSTUM_CULLING_NEON
+                kernel = cull_neon;
+                isa = "neon";
+#endif
+            }
+        };
+
+        [[nodiscard]] const CullDispatch& cull_dispatch() noexcept
+        {
+            static const CullDispatch dispatch;
+            return dispatch;
+        }
+
+        // Never inside a plane with a normal: the corner furthest along any normal is far out
+        // behind it. Finite, so that 0 * bound stays 0 for planes without one.
+        constexpr float k_empty_min = std::numeric_limits<float>::max();
+        constexpr float k_empty_max = std::numeric_limits<float>::lowest();
+    } // namespace
+
+    Frustum Frustum::from_view_projection(const std::array<float, 16>& view_projection) noexcept
+    {
+        const auto at = [&view_projection](int row, int column)
+        {
+            return view_projection[static_cast<std::size_t>(column * 4 + row)];
+        };
+
+        // Inside the -i half-space: clip[i] + clip[w] >= 0; inside the +i one: clip[w] - clip[i] >= 0.
+        float planes[6][4]{};
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            for (int side = 0; side < 2; ++side)
+            {
+                const float sign = side == 0 ? 1.0f : -1.0f;
+                for (int column = 0; column < 4; ++column)
+                    planes[axis * 2 + side][column] = at(3, column) + sign * at(axis, column);
+            }
+        }
+        return from_planes(planes);
+    }
+
+    Frustum Frustum::from_planes(const float (*planes)[4]) noexcept
+    {
+        Frustum frustum;
+        for (std::size_t i = 0; i < frustum.planes.size(); ++i)
+        {
+            const float* plane = planes[i];
+            const float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            const float scale = length > 0.0f ? 1.0f / length : 1.0f;
+            frustum.planes[i] = {plane[0] * scale, plane[1] * scale, plane[2] * scale, plane[3] * scale};
+        }
+        return frustum;
+    }
+
+    bool Frustum::intersects(const Aabb& box) const noexcept
+    {
+        for (const auto& plane : planes)
+        {
+            // The corner furthest along the plane normal.
+            const float x = plane[0] > 0.0f ? box.max.x : box.min.x;
+            const float y = plane[1] > 0.0f ? box.max.y : box.min.y;
+            const float z = plane[2] > 0.0f ? box.max.z : box.min.z;
+            if ((plane[0] * x + plane[1] * y) + (plane[2] * z + plane[3]) < 0.0f)
+                return false;
+        }
+        return true;
+    }
+
+    AabbBatch::AabbBatch(std::span<const Aabb> boxes)
+    {
+        resize(boxes.size());
+        for (std::size_t i = 0; i < boxes.size(); ++i)
+            set(i, boxes[i]);
+    }
+
+    void AabbBatch::resize(std::size_t count)
+    {
+        const std::size_t old_groups = group_count();
+        const std::size_t groups = (count + k_group_size - 1) / k_group_size;
+        m_bounds.resize(groups * k_floats_per_group);
+        for (std::size_t g = old_groups; g < groups; ++g)
+        {
+            float* group = m_bounds.data() + g * k_floats_per_group;
+            std::fill(group, group + k_max_x, k_empty_min);
+            std::fill(group + k_max_x, group + k_floats_per_group, k_empty_max);
+        }
+        // Boxes dropped from a group that stays must not come back when it grows again.
+        for (std::size_t i = count; i < std::min(m_size, groups * k_group_size); ++i)
+            set(i, {{k_empty_min, k_empty_min, k_empty_min}, {k_empty_max, k_empty_max, k_empty_max}});
+        m_size = count;
+    }
+
+    void AabbBatch::set(std::size_t index, const Aabb& box) noexcept
+    {
+        float* group = m_bounds.data() + (index / k_group_size) * k_floats_per_group;
+        const std::size_t lane = index % k_group_size;
+        group[lane] = box.min.x;
+        group[lane + k_group_size] = box.min.y;
+        group[lane + 2 * k_group_size] = box.min.z;
+        group[lane + 3 * k_group_size] = box.max.x;
+        group[lane + 4 * k_group_size] = box.max.y;
+        group[lane + 5 * k_group_size] = box.max.z;
+    }
+
+    Aabb AabbBatch::get(std::size_t index) const noexcept
+    {
+        const float* bounds = group(index / k_group_size);
+        const std::size_t lane = index % k_group_size;
+        return {{bounds[lane], bounds[lane + k_group_size], bounds[lane + 2 * k_group_size]},
+                {bounds[lane + 3 * k_group_size], bounds[lane + 4 * k_group_size], bounds[lane + 5 * k_group_size]}};
+    }
+
+    void cull_box_groups(const Frustum& frustum,
+                         const AabbBatch& boxes,
+                         std::size_t first_group,
+                         std::size_t group_count,
+                         uint8_t* masks,
+                         uint32_t planes) noexcept
+    {
+        if (group_count == 0)
+            return;
+        cull_dispatch().kernel(frustum, planes, boxes.group(first_group), group_count, masks);
+    }
+
+    void cull_boxes(const Frustum& frustum, const AabbBatch& boxes, std::vector<uint8_t>& masks)
+    {
+        masks.resize(boxes.group_count());
+        cull_box_groups(frustum, boxes, 0, masks.size(), masks.data());
+        if (const std::size_t used = boxes.size() % AabbBatch::k_group_size; used != 0)
+            masks.back() = static_cast<uint8_t>(masks.back() & ((1u << used) - 1u));
+    }
+
+    void cull_boxes(const Frustum& frustum, const AabbBatch& boxes, std::vector<std::size_t>& visible)
+    {
+        // Culled in slices so the masks stay on the stack.
+        constexpr std::size_t k_slice_groups = 64;
+        std::array<uint8_t, k_slice_groups> masks{};
+        for (std::size_t first = 0; first < boxes.group_count(); first += k_slice_groups)
+        {
+            const std::size_t count = std::min(k_slice_groups, boxes.group_count() - first);
+            cull_box_groups(frustum, boxes, first, count, masks.data());
+            for (std::size_t g = 0; g < count; ++g)
+            {
+                for (unsigned mask = masks[g]; mask != 0; mask &= mask - 1u)
+                {
+                    const std::size_t index = (first + g) * AabbBatch::k_group_size
+                                            + static_cast<std::size_t>(std::countr_zero(mask));
+                    if (index < boxes.size())
+                        visible.push_back(index);
+                }
+            }
+        }
+    }
+
+    const char* frustum_culling_isa() noexcept
+    {
+        return cull_dispatch().isa;
+    }
+} // namespace rose::core
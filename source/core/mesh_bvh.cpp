@@ -0,0 +1,467 @@
+//
+// Created by orange on 16.10.2026.
+//
+#include "rose/core/mesh_bvh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+// SSE2 is part of x86-64 and of every 32-bit build that targets it, so no runtime dispatch.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ROSE_MESH_BVH_SSE 1
+#include <emmintrin.h>
+#else
+#define ROSE_MESH_BVH_SSE 0
+#endif
+
+namespace rose::core
+{
+    namespace
+    {
+        constexpr std::size_t k_bin_count = 16;
+        // Past this depth splits fall back to the object median, which bounds the tree depth
+        // however badly the heuristic does on degenerate geometry.
+        constexpr int k_max_sah_depth = 40;
+        constexpr std::size_t k_traversal_stack_size = 128;
+        // Below this |determinant| the ray is treated as parallel to the triangle.
+        constexpr float k_parallel_epsilon = 1.0e-12f;
+
+        struct Bounds final
+        {
+            std::array<float, 3> min{std::numeric_limits<float>::max(),
+                                     std::numeric_limits<float>::max(),
+                                     std::numeric_limits<float>::max()};
+            std::array<float, 3> max{std::numeric_limits<float>::lowest(),
+                                     std::numeric_limits<float>::lowest(),
+                                     std::numeric_limits<float>::lowest()};
+
+            void grow(const std::array<float, 3>& point) noexcept
+            {
+                for (std::size_t axis = 0; axis < 3; ++axis)
+                {
+                    min[axis] = std::min(min[axis], point[axis]);
+                    max[axis] = std::max(max[axis], point[axis]);
+                }
+            }
+
+            void grow(const Bounds& other) noexcept
+            {
+                grow(other.min);
+                grow(other.max);
+            }
+
+            [[nodiscard]] bool valid() const noexcept { return min[0] <= max[0]; }
+
+            [[nodiscard]] float half_area() const noexcept
+            {
+                if (!valid())
+                    return 0.0f;
+                const float x = max[0] - min[0];
+                const float y = max[1] - min[1];
+                const float z = max[2] - min[2];
+                return x * y + y * z + z * x;
+            }
+        };
+
+        // The ray with every reciprocal precomputed. Zero direction components become a tiny
+        // signed value so their slabs reduce to +-infinity instead of 0 * infinity.
+        struct TraversalRay final
+        {
+            float origin[4];
+            float direction[4];
+            float inverse[4];
+        };
+
+        [[nodiscard]] TraversalRay make_ray(const omath::Vector3<float>& origin,
+                                            const omath::Vector3<float>& direction) noexcept
+        {
+            TraversalRay ray{{origin.x, origin.y, origin.z, 0.0f}, {direction.x, direction.y, direction.z, 0.0f}, {}};
+            for (std::size_t axis = 0; axis < 3; ++axis)
+            {
+                float component = ray.direction[axis];
+                if (std::abs(component) < 1.0e-20f)
+                    component = std::signbit(component) ? -1.0e-20f : 1.0e-20f;
+                ray.inverse[axis] = 1.0f / component;
+            }
+            return ray;
+        }
+    } // namespace
+
+    struct MeshBvh::BuildTriangle final
+    {
+        std::array<std::array<float, 3>, 3> vertices;
+        Bounds bounds;
+        std::array<float, 3> centroid;
+        uint32_t index;
+    };
+
+    MeshBvh::MeshBvh(const omath::opengl_engine::Mesh& mesh)
+    {
+        const auto& vertices = mesh.m_vertex_buffer;
+        const auto& elements = mesh.m_element_buffer_object;
+
+        std::vector<BuildTriangle> triangles;
+        triangles.reserve(elements.size());
+        for (std::size_t i = 0; i < elements.size(); ++i)
+        {
+            const auto& element = elements[i];
+            const std::array<std::size_t, 3> corners{static_cast<std::size_t>(element.x),
+                                                     static_cast<std::size_t>(element.y),
+                                                     static_cast<std::size_t>(element.z)};
+            if (std::ranges::any_of(corners, [&](std::size_t corner) { return corner >= vertices.size(); }))
+                continue;
+
+            BuildTriangle triangle{};
+            triangle.index = static_cast<uint32_t>(i);
+            for (std::size_t corner = 0; corner < 3; ++corner)
+            {
+                const auto& position = vertices[corners[corner]].position;
+                triangle.vertices[corner] = {position.x, position.y, position.z};
+                triangle.bounds.grow(triangle.vertices[corner]);
+            }
+            for (std::size_t axis = 0; axis < 3; ++axis)
+                triangle.centroid[axis] = 0.5f * (triangle.bounds.min[axis] + triangle.bounds.max[axis]);
+            triangles.push_back(triangle);
+        }
+        if (triangles.empty())
+            return;
+
+        m_nodes.reserve(2 * (triangles.size() / k_leaf_size + 1));
+        m_packets.reserve(triangles.size() / k_leaf_size + 1);
+        build_node(triangles, 0, triangles.size(), 0);
+    }
+
+    uint32_t MeshBvh::build_node(std::vector<BuildTriangle>& triangles, std::size_t begin, std::size_t end, int depth)
+    {
+        Bounds bounds;
+        Bounds centroid_bounds;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            bounds.grow(triangles[i].bounds);
+            centroid_bounds.grow(triangles[i].centroid);
+        }
+
+        const auto node_index = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.push_back({{bounds.min[0], bounds.min[1], bounds.min[2]}, 0, {bounds.max[0], bounds.max[1], bounds.max[2]}, 0});
+
+        const std::size_t count = end - begin;
+        if (count <= k_leaf_size)
+        {
+            TrianglePacket packet{};
+            for (std::size_t lane = 0; lane < count; ++lane)
+            {
+                const BuildTriangle& triangle = triangles[begin + lane];
+                for (std::size_t axis = 0; axis < 3; ++axis)
+                {
+                    packet.v0[axis][lane] = triangle.vertices[0][axis];
+                    packet.edge1[axis][lane] = triangle.vertices[1][axis] - triangle.vertices[0][axis];
+                    packet.edge2[axis][lane] = triangle.vertices[2][axis] - triangle.vertices[0][axis];
+                }
+                packet.triangle[lane] = triangle.index;
+            }
+            m_nodes[node_index].index = static_cast<uint32_t>(m_packets.size());
+            m_nodes[node_index].triangle_count = static_cast<uint32_t>(count);
+            m_packets.push_back(packet);
+            return node_index;
+        }
+
+        // Binned SAH over the centroid bounds of every axis.
+        std::size_t split_axis = 0;
+        std::size_t split_bin = 0;
+        float best_cost = std::numeric_limits<float>::max();
+        if (depth < k_max_sah_depth)
+        {
+            for (std::size_t axis = 0; axis < 3; ++axis)
+            {
+                const float extent = centroid_bounds.max[axis] - centroid_bounds.min[axis];
+                if (!(extent > 0.0f))
+                    continue;
+
+                std::array<Bounds, k_bin_count> bins{};
+                std::array<std::size_t, k_bin_count> bin_counts{};
+                const float scale = static_cast<float>(k_bin_count) / extent;
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    const auto bin = std::min(
+                            static_cast<std::size_t>((triangles[i].centroid[axis] - centroid_bounds.min[axis]) * scale),
+                            k_bin_count - 1);
+                    bins[bin].grow(triangles[i].bounds);
+                    ++bin_counts[bin];
+                }
+
+                // Sweep from the right to get every right-hand side, then from the left.
+                std::array<float, k_bin_count> right_cost{};
+                Bounds right;
+                std::size_t right_count = 0;
+                for (std::size_t bin = k_bin_count - 1; bin > 0; --bin)
+                {
+                    right.grow(bins[bin]);
+                    right_count += bin_counts[bin];
+                    right_cost[bin] = right.half_area() * static_cast<float>(right_count);
+                }
+
+                Bounds left;
+                std::size_t left_count = 0;
+                for (std::size_t bin = 1; bin < k_bin_count; ++bin)
+                {
+                    left.grow(bins[bin - 1]);
+                    left_count += bin_counts[bin - 1];
+                    if (left_count == 0 || left_count == count)
+                        continue;
+                    const float cost = left.half_area() * static_cast<float>(left_count) + right_cost[bin];
+                    if (cost < best_cost)
+                    {
+                        best_cost = cost;
+                        split_axis = axis;
+                        split_bin = bin;
+                    }
+                }
+            }
+        }
+
+        std::size_t middle = begin + count / 2;
+        if (best_cost < std::numeric_limits<float>::max())
+        {
+            const float extent = centroid_bounds.max[split_axis] - centroid_bounds.min[split_axis];
+            const float scale = static_cast<float>(k_bin_count) / extent;
+            const auto first_right = std::partition(triangles.begin() + static_cast<std::ptrdiff_t>(begin),
+                                                    triangles.begin() + static_cast<std::ptrdiff_t>(end),
+                                                    [&](const BuildTriangle& triangle)
+                                                    {
+                                                        const auto bin = std::min(
+                                                                static_cast<std::size_t>((triangle.centroid[split_axis]
+                                                                                          - centroid_bounds.min[split_axis])
+                                                                                         * scale),
+                                                                k_bin_count - 1);
+                                                        return bin < split_bin;
+                                                    });
+            middle = static_cast<std::size_t>(first_right - triangles.begin());
+        }
+        else
+        {
+            // Too deep, or every centroid coincides: halve along the widest axis.
+            std::size_t widest = 0;
+            for (std::size_t axis = 1; axis < 3; ++axis)
+            {
+                if (centroid_bounds.max[axis] - centroid_bounds.min[axis]
+                    > centroid_bounds.max[widest] - centroid_bounds.min[widest])
+                    widest = axis;
+            }
+            std::nth_element(triangles.begin() + static_cast<std::ptrdiff_t>(begin),
+                             triangles.begin() + static_cast<std::ptrdiff_t>(middle),
+                             triangles.begin() + static_cast<std::ptrdiff_t>(end),
+                             [widest](const BuildTriangle& a, const BuildTriangle& b)
+                             { return a.centroid[widest] < b.centroid[widest]; });
+        }
+
+        build_node(triangles, begin, middle, depth + 1);
+        const uint32_t right_child = build_node(triangles, middle, end, depth + 1);
+        m_nodes[node_index].index = right_child;
+        return node_index;
+    }
+
+    namespace
+    {
+        // Distance at which the ray enters the box, if it does so before `max_distance`.
+        template<class Node>
+        [[nodiscard]] bool enter_box(const Node& node, const TraversalRay& ray, float max_distance, float& entry) noexcept
+        {
+#if ROSE_MESH_BVH_SSE
+            // The fourth lane of each load is the neighbouring field; masking it keeps the slab
+            // math on finite zeros.
+            const __m128 xyz = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+            const __m128 origin = _mm_loadu_ps(ray.origin);
+            const __m128 inverse = _mm_loadu_ps(ray.inverse);
+            const __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_and_ps(_mm_loadu_ps(node.min), xyz), origin), inverse);
+            const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_and_ps(_mm_loadu_ps(node.max), xyz), origin), inverse);
+            const __m128 near_xyz = _mm_min_ps(t0, t1);
+            const __m128 far_xyz = _mm_max_ps(t0, t1);
+
+            const __m128 near_yz = _mm_max_ss(_mm_shuffle_ps(near_xyz, near_xyz, _MM_SHUFFLE(3, 3, 3, 1)),
+                                              _mm_shuffle_ps(near_xyz, near_xyz, _MM_SHUFFLE(3, 3, 3, 2)));
+            const __m128 far_yz = _mm_min_ss(_mm_shuffle_ps(far_xyz, far_xyz, _MM_SHUFFLE(3, 3, 3, 1)),
+                                             _mm_shuffle_ps(far_xyz, far_xyz, _MM_SHUFFLE(3, 3, 3, 2)));
+            const float t_enter = std::max(_mm_cvtss_f32(_mm_max_ss(near_xyz, near_yz)), 0.0f);
+            const float t_exit = std::min(_mm_cvtss_f32(_mm_min_ss(far_xyz, far_yz)), max_distance);
+#else
+            float t_enter = 0.0f;
+            float t_exit = max_distance;
+            for (std::size_t axis = 0; axis < 3; ++axis)
+            {
+                const float t0 = (node.min[axis] - ray.origin[axis]) * ray.inverse[axis];
+                const float t1 = (node.max[axis] - ray.origin[axis]) * ray.inverse[axis];
+                t_enter = std::max(t_enter, std::min(t0, t1));
+                t_exit = std::min(t_exit, std::max(t0, t1));
+            }
+#endif
+            entry = t_enter;
+            return t_enter <= t_exit;
+        }
+
+        // Möller–Trumbore against all four lanes; updates the closest hit in place.
+        template<class Packet>
+        void intersect_packet(const Packet& packet,
+                              const TraversalRay& ray,
+                              float& closest,
+                              uint32_t& closest_triangle) noexcept
+        {
+#if ROSE_MESH_BVH_SSE
+            const __m128 dx = _mm_set1_ps(ray.direction[0]);
+            const __m128 dy = _mm_set1_ps(ray.direction[1]);
+            const __m128 dz = _mm_set1_ps(ray.direction[2]);
+            const __m128 e1x = _mm_load_ps(packet.edge1[0]);
+            const __m128 e1y = _mm_load_ps(packet.edge1[1]);
+            const __m128 e1z = _mm_load_ps(packet.edge1[2]);
+            const __m128 e2x = _mm_load_ps(packet.edge2[0]);
+            const __m128 e2y = _mm_load_ps(packet.edge2[1]);
+            const __m128 e2z = _mm_load_ps(packet.edge2[2]);
+
+            // p = d x e2
+            const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+            const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+            const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+            const __m128 determinant =
+                    _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+            const __m128 absolute = _mm_andnot_ps(_mm_set1_ps(-0.0f), determinant);
+            const __m128 inverse = _mm_div_ps(_mm_set1_ps(1.0f), determinant);
+
+            // s = o - v0, q = s x e1
+            const __m128 sx = _mm_sub_ps(_mm_set1_ps(ray.origin[0]), _mm_load_ps(packet.v0[0]));
+            const __m128 sy = _mm_sub_ps(_mm_set1_ps(ray.origin[1]), _mm_load_ps(packet.v0[1]));
+            const __m128 sz = _mm_sub_ps(_mm_set1_ps(ray.origin[2]), _mm_load_ps(packet.v0[2]));
+            const __m128 u = _mm_mul_ps(
+                    _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), inverse);
+            const __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+            const __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+            const __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+            const __m128 v = _mm_mul_ps(
+                    _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inverse);
+            const __m128 t = _mm_mul_ps(
+                    _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inverse);
+
+            const __m128 zero = _mm_setzero_ps();
+            __m128 hit = _mm_cmpgt_ps(absolute, _mm_set1_ps(k_parallel_epsilon));
+            hit = _mm_and_ps(hit, _mm_cmpge_ps(u, zero));
+            hit = _mm_and_ps(hit, _mm_cmpge_ps(v, zero));
+            hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1.0f)));
+            hit = _mm_and_ps(hit, _mm_cmpge_ps(t, zero));
+            hit = _mm_and_ps(hit, _mm_cmple_ps(t, _mm_set1_ps(closest)));
+
+            int lanes = _mm_movemask_ps(hit);
+            if (lanes == 0)
+                return;
+            alignas(16) float distances[4];
+            _mm_store_ps(distances, t);
+            while (lanes != 0)
+            {
+                const int lane = std::countr_zero(static_cast<unsigned>(lanes));
+                lanes &= lanes - 1;
+                if (distances[lane] <= closest)
+                {
+                    closest = distances[lane];
+                    closest_triangle = packet.triangle[lane];
+                }
+            }
+#else
+            for (std::size_t lane = 0; lane < 4; ++lane)
+            {
+                const float e1[3] = {packet.edge1[0][lane], packet.edge1[1][lane], packet.edge1[2][lane]};
+                const float e2[3] = {packet.edge2[0][lane], packet.edge2[1][lane], packet.edge2[2][lane]};
+                const float* d = ray.direction;
+                const float p[3] = {d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0]};
+                const float determinant = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+                if (!(std::abs(determinant) > k_parallel_epsilon))
+                    continue;
+                const float inverse = 1.0f / determinant;
+
+                const float s[3] = {ray.origin[0] - packet.v0[0][lane],
+                                    ray.origin[1] - packet.v0[1][lane],
+                                    ray.origin[2] - packet.v0[2][lane]};
+                const float u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inverse;
+                if (u < 0.0f || u > 1.0f)
+                    continue;
+                const float q[3] = {s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0]};
+                const float v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * inverse;
+                if (v < 0.0f || u + v > 1.0f)
+                    continue;
+                const float t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inverse;
+                if (t >= 0.0f && t <= closest)
+                {
+                    closest = t;
+                    closest_triangle = packet.triangle[lane];
+                }
+            }
+#endif
+        }
+    } // namespace
+
+    std::optional<MeshRayHit> MeshBvh::intersect(const omath::Vector3<float>& origin,
+                                                 const omath::Vector3<float>& direction,
+                                                 float max_distance) const noexcept
+    {
+        if (m_nodes.empty() || !(max_distance >= 0.0f))
+            return std::nullopt;
+
+        const TraversalRay ray = make_ray(origin, direction);
+        float closest = max_distance;
+        uint32_t closest_triangle = std::numeric_limits<uint32_t>::max();
+
+        struct Pending final
+        {
+            uint32_t node;
+            float entry;
+        };
+        std::array<Pending, k_traversal_stack_size> stack;
+        std::size_t stack_size = 0;
+
+        float entry = 0.0f;
+        if (!enter_box(m_nodes[0], ray, closest, entry))
+            return std::nullopt;
+
+        uint32_t node_index = 0;
+        while (true)
+        {
+            const Node& node = m_nodes[node_index];
+            if (node.triangle_count > 0)
+            {
+                intersect_packet(m_packets[node.index], ray, closest, closest_triangle);
+            }
+            else
+            {
+                // Visit the nearer child first; the farther one waits with its entry distance.
+                const uint32_t left = node_index + 1;
+                const uint32_t right = node.index;
+                float left_entry = 0.0f;
+                float right_entry = 0.0f;
+                const bool hit_left = enter_box(m_nodes[left], ray, closest, left_entry);
+                const bool hit_right = enter_box(m_nodes[right], ray, closest, right_entry);
+                if (hit_left && hit_right)
+                {
+                    const bool left_first = left_entry <= right_entry;
+                    stack[stack_size++] = left_first ? Pending{right, right_entry} : Pending{left, left_entry};
+                    node_index = left_first ? left : right;
+                    continue;
+                }
+                if (hit_left || hit_right)
+                {
+                    node_index = hit_left ? left : right;
+                    continue;
+                }
+            }
+
+            // Skip deferred subtrees that start beyond a hit found since they were pushed.
+            while (stack_size > 0 && stack[stack_size - 1].entry > closest)
+                --stack_size;
+            if (stack_size == 0)
+                break;
+            node_index = stack[--stack_size].node;
+        }
+
+        if (closest_triangle == std::numeric_limits<uint32_t>::max())
+            return std::nullopt;
+        return MeshRayHit{closest, closest_triangle};
+    }
+} // namespace rose::core
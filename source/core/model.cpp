@@ -8,15 +8,20 @@
 #include <tiny_gltf.h>
 
 #include "rose/core/model.hpp"
+#include "rose/core/profiler.hpp"
+#include "rose/core/thread_pool.hpp"
 #include "rose/core/vulkan/renderer.hpp"
-#include <omath/collision/line_tracer.hpp>
+#include "rose/core/vulkan/texture_loader.hpp"
 #include <omath/engines/opengl_engine/constants.hpp>
 #include <spdlog/spdlog.h>
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <functional>
 #include <limits>
 #include <map>
 #include <stdexcept>
+#include <thread>
 
 namespace rose::core
 {
@@ -153,12 +158,84 @@ namespace rose::core
     // Texture helper
     // ---------------------------------------------------------------------------
 
-    static std::shared_ptr<vulkan::Texture> texture_from_image(const tinygltf::Image& image)
+    // tinygltf decodes images one after another while parsing. Model::load keeps the encoded
+    // bytes instead and decodes them in parallel, skipping images that have a cooked KTX2.
+    struct EncodedImages final
     {
+        std::vector<std::vector<unsigned char>> bytes; // indexed like tinygltf::Model::images
+    };
+
+    static bool defer_image_decode(tinygltf::Image*     image,
+                                   const int            image_index,
+                                   std::string*         err,
+                                   std::string*         warn,
+                                   int                  req_width,
+                                   int                  req_height,
+                                   const unsigned char* bytes,
+                                   int                  size,
+                                   void*                user_data)
+    {
+        if (image_index < 0)
+            return tinygltf::LoadImageData(image, image_index, err, warn, req_width, req_height, bytes, size, nullptr);
+
+        auto& encoded = static_cast<EncodedImages*>(user_data)->bytes;
+        const auto index = static_cast<std::size_t>(image_index);
+        if (encoded.size() <= index)
+            encoded.resize(index + 1);
+        encoded[index].assign(bytes, bytes + size);
+        return true;
+    }
+
+    // A cooked KTX2 next to the image file (textures/albedo.png -> textures/albedo.ktx2) is used
+    // instead of the decoded image; it carries its own mips and may be block-compressed.
+    // Runs on the load pool, one image per task.
+    static std::shared_ptr<vulkan::Texture> texture_from_image(tinygltf::Image&             image,
+                                                               int                          image_index,
+                                                               std::vector<unsigned char>&  encoded,
+                                                               const std::filesystem::path& model_directory)
+    {
+        if (!image.uri.empty() && !image.uri.starts_with("data:"))
+        {
+            auto cooked_path = model_directory / image.uri;
+            cooked_path.replace_extension(".ktx2");
+            std::error_code error;
+            if (std::filesystem::is_regular_file(cooked_path, error))
+            {
+                try
+                {
+                    return std::make_shared<vulkan::Texture>(vulkan::load_ktx2(cooked_path));
+                }
+                catch (const std::runtime_error& ex)
+                {
+                    spdlog::warn("Model: {}, using the source image", ex.what());
+                }
+            }
+        }
+
+        if (!encoded.empty())
+        {
+            std::string err, warn;
+            const bool decoded = tinygltf::LoadImageData(&image,
+                                                         image_index,
+                                                         &err,
+                                                         &warn,
+                                                         0,
+                                                         0,
+                                                         encoded.data(),
+                                                         static_cast<int>(encoded.size()),
+                                                         nullptr);
+            std::vector<unsigned char>().swap(encoded);
+            if (!decoded)
+            {
+                spdlog::warn("Model: failed to decode image {}: {}", image_index, err);
+                return nullptr;
+            }
+        }
+
         if (image.image.empty() || image.width <= 0 || image.height <= 0)
             return nullptr;
         return std::make_shared<vulkan::Texture>(
-            image.width, image.height, image.component, image.image.data());
+            image.width, image.height, image.component, std::move(image.image));
     }
 
     // ---------------------------------------------------------------------------
@@ -303,82 +380,32 @@ namespace rose::core
 
     Model::Model(const std::filesystem::path& path) { load(path); }
 
-    // ---------------------------------------------------------------------------
-    // AABB vs frustum — Gribb-Hartmann method.
-    //
-    // For each of the 6 clip half-spaces (±x, ±y, ±z in NDC), we compute the
-    // "P-vertex" of the AABB: the corner that maximises the signed distance into
-    // that half-space.  If even the P-vertex is outside (signed distance < 0),
-    // all 8 corners are outside → AABB is definitely culled.
-    //
-    // Plane coefficients are extracted from the view-projection matrix VP
-    // (column-major, .at(row, col)):
-    //   clip[i] = sum_j VP.at(i,j) * p[j]
-    //   clip[3] = sum_j VP.at(3,j) * p[j]   (w component)
-    //
-    // Inside condition for the -i half-space: clip[i] + clip[3] ≥ 0
-    //   → outside: (VP.at(i,j) + VP.at(3,j)) · p + (VP.at(i,3) + VP.at(3,3)) < 0
-    // Inside condition for the +i half-space: -clip[i] + clip[3] ≥ 0
-    //   → outside: (-VP.at(i,j) + VP.at(3,j)) · p + (-VP.at(i,3) + VP.at(3,3)) < 0
-    // ---------------------------------------------------------------------------
-    static bool is_aabb_culled_by_frustum(
-        const omath::opengl_engine::Camera& camera,
-        const Aabb& aabb) noexcept
-    {
-        const auto& vp = camera.get_view_projection_matrix();
-
-        for (int i = 0; i < 3; ++i)
-        {
-            for (const int s : {1, -1})   // s=+1 → -i half-space, s=-1 → +i half-space
-            {
-                const float a0 = vp.at(3, 0) + s * vp.at(i, 0);
-                const float a1 = vp.at(3, 1) + s * vp.at(i, 1);
-                const float a2 = vp.at(3, 2) + s * vp.at(i, 2);
-                const float d  = vp.at(3, 3) + s * vp.at(i, 3);
-
-                // P-vertex: the AABB corner that maximises a · p + d
-                const float px = a0 > 0.f ? aabb.max.x : aabb.min.x;
-                const float py = a1 > 0.f ? aabb.max.y : aabb.min.y;
-                const float pz = a2 > 0.f ? aabb.max.z : aabb.min.z;
-
-                if (a0 * px + a1 * py + a2 * pz + d < 0.f)
-                    return true; // all 8 corners outside this frustum plane → cull
-            }
-        }
-        return false;
-    }
-
-    static std::optional<omath::Vector3<float>> trace_mesh(
-        const omath::collision::Ray<>& ray,
+    // Inverse of a mesh's affine to-world matrix as three rows of (x, y, z, translation), or
+    // nothing if the mesh is scaled to zero.
+    static std::optional<std::array<std::array<float, 4>, 3>> world_to_mesh(
         const omath::opengl_engine::Mesh& mesh) noexcept
     {
-        std::optional<omath::Vector3<float>> closest_hit;
-        float closest_distance = std::numeric_limits<float>::max();
-
-        for (const auto& triangle : mesh.m_element_buffer_object)
-        {
-            const omath::Triangle<omath::Vector3<float>> world_triangle{
-                mesh.vertex_position_to_world_space(mesh.m_vertex_buffer.at(triangle.x).position),
-                mesh.vertex_position_to_world_space(mesh.m_vertex_buffer.at(triangle.y).position),
-                mesh.vertex_position_to_world_space(mesh.m_vertex_buffer.at(triangle.z).position)
-            };
-
-            const auto hit = omath::collision::LineTracer<>::get_ray_hit_point(ray, world_triangle);
-            if (hit == ray.end)
-                continue;
-
-            const float distance = hit.distance_to(ray.start);
-            if (distance < closest_distance)
-            {
-                closest_distance = distance;
-                closest_hit = hit;
-            }
-        }
-
-        return closest_hit;
+        const auto m = mesh.get_to_world_matrix().raw_array();
+        // Column-major: element (row, col) is m[col * 4 + row].
+        const auto a = [&m](int row, int col) { return m[static_cast<std::size_t>(col * 4 + row)]; };
+
+        const float c00 = a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1);
+        const float c01 = a(1, 2) * a(2, 0) - a(1, 0) * a(2, 2);
+        const float c02 = a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0);
+        const float det = a(0, 0) * c00 + a(0, 1) * c01 + a(0, 2) * c02;
+        if (std::abs(det) < std::numeric_limits<float>::min())
+            return std::nullopt;
+        const float inv = 1.f / det;
+
+        std::array<std::array<float, 4>, 3> r{};
+        r[0] = {c00 * inv, (a(0, 2) * a(2, 1) - a(0, 1) * a(2, 2)) * inv, (a(0, 1) * a(1, 2) - a(0, 2) * a(1, 1)) * inv, 0.f};
+        r[1] = {c01 * inv, (a(0, 0) * a(2, 2) - a(0, 2) * a(2, 0)) * inv, (a(0, 2) * a(1, 0) - a(0, 0) * a(1, 2)) * inv, 0.f};
+        r[2] = {c02 * inv, (a(0, 1) * a(2, 0) - a(0, 0) * a(2, 1)) * inv, (a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0)) * inv, 0.f};
+        for (auto& row : r)
+            row[3] = -(row[0] * a(0, 3) + row[1] * a(1, 3) + row[2] * a(2, 3));
+        return r;
     }
 
-
     std::optional<omath::opengl_engine::Mat4X4> Model::mesh_matrix(const std::size_t mesh_index) const
     {
         if (mesh_index >= m_meshes.size())
@@ -395,6 +422,7 @@ namespace rose::core
         auto& mesh = m_meshes[mesh_index].cpu_mesh();
         mesh.set_origin(origin);
         m_mesh_aabbs[mesh_index] = Aabb::from_mesh(mesh);
+        m_scene_bvh.refit(mesh_index, m_mesh_aabbs[mesh_index]);
     }
 
     void Model::set_mesh_matrix(const std::size_t mesh_index, const omath::opengl_engine::Mat4X4& matrix)
@@ -408,6 +436,7 @@ namespace rose::core
         mesh.set_scale(omath::mat_extract_scale(matrix));
         mesh.set_rotation(omath::opengl_engine::extract_rotation_angles(matrix));
         m_mesh_aabbs[mesh_index] = Aabb::from_mesh(mesh);
+        m_scene_bvh.refit(mesh_index, m_mesh_aabbs[mesh_index]);
     }
 
     std::optional<std::size_t> Model::pick_mesh(const omath::Vector2<float>& screen_position,
@@ -417,50 +446,77 @@ namespace rose::core
         if (!ray_end)
             return std::nullopt;
 
-        const omath::collision::Ray<> ray{
-            camera.get_origin(),
-            *ray_end,
-            true
-        };
-
-        std::optional<std::size_t> picked_mesh;
-        float closest_distance = std::numeric_limits<float>::max();
-
-        for (std::size_t i = 0; i < m_meshes.size(); ++i)
-        {
-            const omath::primitives::Aabb<float> broadphase_box{
-                m_mesh_aabbs[i].min,
-                m_mesh_aabbs[i].max
-            };
-            const auto broadphase_hit = omath::collision::LineTracer<>::get_ray_hit_point(ray, broadphase_box);
-            if (broadphase_hit == ray.end)
-                continue;
-
-            const auto mesh_hit = trace_mesh(ray, m_meshes[i].cpu_mesh());
-            if (!mesh_hit)
-                continue;
+        // Direction is unnormalised on purpose: the ray runs past the point under the cursor.
+        const auto origin = camera.get_origin();
+        const auto hit = raycast(origin, *ray_end - origin);
+        if (!hit)
+            return std::nullopt;
+        return hit->mesh;
+    }
 
-            const float distance = mesh_hit->distance_to(ray.start);
-            if (distance < closest_distance)
+    std::optional<ModelRayHit> Model::raycast(const omath::Vector3<float>& origin,
+                                              const omath::Vector3<float>& direction,
+                                              const float max_distance) const
+    {
+        ROSE_PROFILE_ZONE("Model::raycast");
+        std::optional<ModelRayHit> closest;
+        m_scene_bvh.raycast(
+            origin,
+            direction,
+            max_distance,
+            [&](std::size_t i, float closest_distance)
             {
-                closest_distance = distance;
-                picked_mesh = i;
-            }
-        }
+                // An affine transform keeps t, so the local hit distance is the world one.
+                const auto to_local = world_to_mesh(m_meshes[i].cpu_mesh());
+                if (!to_local)
+                    return closest_distance;
+                const auto& r = *to_local;
+                const omath::Vector3<float> local_origin{
+                    r[0][0] * origin.x + r[0][1] * origin.y + r[0][2] * origin.z + r[0][3],
+                    r[1][0] * origin.x + r[1][1] * origin.y + r[1][2] * origin.z + r[1][3],
+                    r[2][0] * origin.x + r[2][1] * origin.y + r[2][2] * origin.z + r[2][3]};
+                const omath::Vector3<float> local_direction{
+                    r[0][0] * direction.x + r[0][1] * direction.y + r[0][2] * direction.z,
+                    r[1][0] * direction.x + r[1][1] * direction.y + r[1][2] * direction.z,
+                    r[2][0] * direction.x + r[2][1] * direction.y + r[2][2] * direction.z};
+
+                const auto hit = m_mesh_bvhs[i].intersect(local_origin, local_direction, closest_distance);
+                if (!hit)
+                    return closest_distance;
+                closest = ModelRayHit{i, hit->distance, origin + direction * hit->distance};
+                return hit->distance;
+            });
+        return closest;
+    }
 
-        return picked_mesh;
+    std::optional<std::size_t> Model::mesh_index(const vulkan::Mesh* mesh) const
+    {
+        // std::less orders unrelated pointers too.
+        const std::less<const vulkan::Mesh*> before;
+        const vulkan::Mesh* first = m_meshes.data();
+        if (mesh == nullptr || before(mesh, first) || !before(mesh, first + m_meshes.size()))
+            return std::nullopt;
+        return static_cast<std::size_t>(mesh - first);
     }
 
     void Model::draw(vulkan::Renderer& renderer,
                      const omath::opengl_engine::Camera& camera,
                      std::optional<std::size_t> selected_mesh) const
     {
-        for (std::size_t i = 0; i < m_meshes.size(); ++i)
-            if (!is_aabb_culled_by_frustum(camera, m_mesh_aabbs[i]))
-                renderer.draw_mesh(m_meshes[i], camera);
+        ROSE_PROFILE_ZONE("Model::draw");
+        // Meshes outside the view can still cast shadows into it, so a mesh is submitted if the
+        // camera or any shadow map sees it; the renderer then culls it per view.
+        const std::vector<Frustum> frusta = renderer.culling_frusta(camera);
+        std::vector<std::size_t> visible;
+        for (const Frustum& frustum : frusta)
+            m_scene_bvh.cull(frustum, visible);
+        std::ranges::sort(visible);
+        visible.erase(std::ranges::unique(visible).begin(), visible.end());
+        for (const std::size_t i : visible)
+            renderer.draw_mesh(m_meshes[i], camera);
 
         if (selected_mesh && *selected_mesh < m_meshes.size()
-            && !is_aabb_culled_by_frustum(camera, m_mesh_aabbs[*selected_mesh]))
+            && frusta.front().intersects(m_mesh_aabbs[*selected_mesh]))
             renderer.draw_mesh_outline(m_meshes[*selected_mesh], camera);
     }
 
@@ -469,6 +525,8 @@ namespace rose::core
         tinygltf::Model    gltf;
         tinygltf::TinyGLTF loader;
         std::string        err, warn;
+        EncodedImages      encoded_images;
+        loader.SetImageLoader(defer_image_decode, &encoded_images);
 
         const bool ok = (path.extension() == ".glb")
             ? loader.LoadBinaryFromFile(&gltf, &err, &warn, path.string())
@@ -478,11 +536,29 @@ namespace rose::core
         if (!err.empty())  spdlog::error("Model ({}): {}", path.filename().string(), err);
         if (!ok)           throw std::runtime_error("Failed to load model: " + path.string());
 
-        // Pre-load texture pixels (shared across primitives).
-        std::vector<std::shared_ptr<vulkan::Texture>> textures;
-        textures.reserve(gltf.images.size());
-        for (const auto& image : gltf.images)
-            textures.push_back(texture_from_image(image));
+        // Decode texture pixels (shared across primitives) in parallel.
+        encoded_images.bytes.resize(gltf.images.size());
+        std::vector<std::shared_ptr<vulkan::Texture>> textures(gltf.images.size());
+        if (!gltf.images.empty())
+        {
+            const std::filesystem::path model_directory = path.parent_path();
+            const auto hardware_threads = static_cast<std::size_t>(std::max(1u, std::thread::hardware_concurrency()));
+            ThreadPool load_pool(static_cast<int>(std::min(hardware_threads, gltf.images.size())));
+
+            std::vector<std::future<std::shared_ptr<vulkan::Texture>>> decoded;
+            decoded.reserve(gltf.images.size());
+            for (std::size_t i = 0; i < gltf.images.size(); ++i)
+                decoded.push_back(load_pool.submit(
+                    [&gltf, &encoded_images, &model_directory, i]
+                    {
+                        return texture_from_image(gltf.images[i],
+                                                  static_cast<int>(i),
+                                                  encoded_images.bytes[i],
+                                                  model_directory);
+                    }));
+            for (std::size_t i = 0; i < decoded.size(); ++i)
+                textures[i] = decoded[i].get();
+        }
 
         // Collect per-mesh-index scale + translation from the scene graph
         std::map<int, NodeTransform> transforms;
@@ -519,5 +595,21 @@ namespace rose::core
         m_mesh_aabbs.reserve(m_meshes.size());
         for (const auto& mesh : m_meshes)
             m_mesh_aabbs.push_back(Aabb::from_mesh(mesh.cpu_mesh()));
+        m_scene_bvh.build(m_mesh_aabbs);
+
+        // Triangle BVHs are local-space, so moving a mesh never rebuilds its BVH.
+        m_mesh_bvhs.resize(m_meshes.size());
+        if (!m_meshes.empty())
+        {
+            const auto hardware_threads = static_cast<std::size_t>(std::max(1u, std::thread::hardware_concurrency()));
+            ThreadPool bvh_pool(static_cast<int>(std::min(hardware_threads, m_meshes.size())));
+
+            std::vector<std::future<void>> built;
+            built.reserve(m_meshes.size());
+            for (std::size_t i = 0; i < m_meshes.size(); ++i)
+                built.push_back(bvh_pool.submit([this, i] { m_mesh_bvhs[i] = MeshBvh(m_meshes[i].cpu_mesh()); }));
+            for (auto& future : built)
+                future.get();
+        }
     }
 } // namespace rose::core
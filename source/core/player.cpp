@@ -2,6 +2,7 @@
 // Created by orange on 26.02.2026.
 //
 #include "rose/core/player.hpp"
+#include "rose/core/profiler.hpp"
 #include <algorithm>
 #include <cmath>
 #include <omath/3d_primitives/mesh.hpp>
@@ -71,12 +72,23 @@ namespace rose::core
         m_collider.set_origin(position);
     }
 
+    void Player::apply_late_look(float mouse_dx, float mouse_dy)
+    {
+        // The smoothing filter is linear in its input, so the late movement adds its weighted
+        // share to the filter state and the angles.
+        m_smooth_dx += mouse_dx * m_look_weight;
+        m_smooth_dy += mouse_dy * m_look_weight;
+        m_view_angles.yaw   -= decltype(m_view_angles.yaw)::from_degrees(mouse_dx * m_look_weight * k_mouse_sensitivity);
+        m_view_angles.pitch -= decltype(m_view_angles.pitch)::from_degrees(mouse_dy * m_look_weight * k_mouse_sensitivity);
+    }
+
     void Player::update(
             float dt,
             const CollisionWorld& world,
             const PlayerInput& input
     )
     {
+        ROSE_PROFILE_ZONE("Player::update");
         // --- Noclip toggle (edge-triggered on Q) ---
         if (input.noclip && !m_noclip_was_pressed)
         {
@@ -93,6 +105,7 @@ namespace rose::core
 
         // --- Mouse look ---
         const float t = 1.f - std::exp(-k_look_smoothing * dt);
+        m_look_weight = t;
         m_smooth_dx += (input.mouse_dx - m_smooth_dx) * t;
         m_smooth_dy += (input.mouse_dy - m_smooth_dy) * t;
         m_view_angles.yaw   -= decltype(m_view_angles.yaw)::from_degrees(m_smooth_dx * k_mouse_sensitivity);
@@ -0,0 +1,256 @@
+//
+// Created by orange on 16.10.2026.
+//
+#include "rose/core/profiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+
+namespace rose::core::profiler
+{
+    namespace
+    {
+        // Each field is atomic so a reader racing the owning thread sees torn records only as
+        // values it discards, never as undefined behaviour.
+        struct ZoneSlot final
+        {
+            std::atomic<const char*> name{nullptr};
+            std::atomic<uint64_t> start_ns{0};
+            std::atomic<uint64_t> end_ns{0};
+            std::atomic<uint32_t> depth{0};
+        };
+
+        // Written by its thread only; `written` publishes the records below it.
+        struct ThreadBuffer final
+        {
+            uint32_t thread_id = 0;
+            std::atomic<const char*> name{nullptr};
+            std::atomic<uint64_t> written{0};
+            std::array<ZoneSlot, k_zones_per_thread> zones;
+        };
+
+        struct Registry final
+        {
+            std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+            std::mutex mutex;
+            // Buffers outlive their threads so zones of finished threads can still be exported.
+            std::vector<std::unique_ptr<ThreadBuffer>> threads;
+            std::atomic<uint64_t> frames_written{0};
+            std::array<std::atomic<uint64_t>, k_frame_marks> frames{};
+        };
+
+        Registry& registry()
+        {
+            static Registry instance;
+            return instance;
+        }
+
+        ThreadBuffer& thread_buffer()
+        {
+            thread_local ThreadBuffer* buffer = []
+            {
+                Registry& registry_instance = registry();
+                auto owned = std::make_unique<ThreadBuffer>();
+                std::lock_guard lock(registry_instance.mutex);
+                owned->thread_id = static_cast<uint32_t>(registry_instance.threads.size());
+                return registry_instance.threads.emplace_back(std::move(owned)).get();
+            }();
+            return *buffer;
+        }
+
+        thread_local uint32_t t_depth = 0;
+
+        [[nodiscard]] std::vector<ZoneSample> read_zones(const ThreadBuffer& buffer)
+        {
+            const uint64_t end = buffer.written.load(std::memory_order_acquire);
+            const uint64_t begin = end > k_zones_per_thread ? end - k_zones_per_thread : 0;
+
+            std::vector<ZoneSample> zones;
+            zones.reserve(static_cast<std::size_t>(end - begin));
+            for (uint64_t index = begin; index < end; ++index)
+            {
+                const ZoneSlot& slot = buffer.zones[index % k_zones_per_thread];
+                zones.push_back({slot.name.load(std::memory_order_relaxed),
+                                 slot.start_ns.load(std::memory_order_relaxed),
+                                 slot.end_ns.load(std::memory_order_relaxed),
+                                 slot.depth.load(std::memory_order_relaxed)});
+            }
+
+            // The owner may have overwritten the oldest records while they were copied; drop
+            // every record it could have reached by now.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t after = buffer.written.load(std::memory_order_relaxed);
+            const uint64_t overwritten = after >= k_zones_per_thread ? after - k_zones_per_thread + 1u : 0u;
+            if (overwritten > begin)
+                zones.erase(zones.begin(),
+                            zones.begin() + static_cast<std::ptrdiff_t>(std::min(overwritten - begin, end - begin)));
+            return zones;
+        }
+
+        void append_json_string(std::string& out, std::string_view text)
+        {
+            out += '"';
+            for (const char c : text)
+            {
+                switch (c)
+                {
+                    case '"':
+                        out += "\\\"";
+                        break;
+                    case '\\':
+                        out += "\\\\";
+                        break;
+                    default:
+                        if (static_cast<unsigned char>(c) < 0x20)
+                            out += std::format("\\u{:04x}", static_cast<unsigned>(c));
+                        else
+                            out += c;
+                }
+            }
+            out += '"';
+        }
+    } // namespace
+
+    uint64_t now_ns() noexcept
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - registry().epoch;
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+    void set_thread_name(const char* name)
+    {
+        thread_buffer().name.store(name, std::memory_order_relaxed);
+    }
+
+    void mark_frame() noexcept
+    {
+        Registry& registry_instance = registry();
+        const uint64_t index = registry_instance.frames_written.load(std::memory_order_relaxed);
+        registry_instance.frames[index % k_frame_marks].store(now_ns(), std::memory_order_relaxed);
+        registry_instance.frames_written.store(index + 1u, std::memory_order_release);
+    }
+
+    std::vector<uint64_t> frame_marks()
+    {
+        Registry& registry_instance = registry();
+        const uint64_t end = registry_instance.frames_written.load(std::memory_order_acquire);
+        const uint64_t begin = end > k_frame_marks ? end - k_frame_marks : 0;
+        std::vector<uint64_t> marks;
+        marks.reserve(static_cast<std::size_t>(end - begin));
+        for (uint64_t index = begin; index < end; ++index)
+            marks.push_back(registry_instance.frames[index % k_frame_marks].load(std::memory_order_relaxed));
+        return marks;
+    }
+
+    std::vector<ThreadTimeline> capture(uint64_t begin_ns, uint64_t end_ns)
+    {
+        Registry& registry_instance = registry();
+        std::lock_guard lock(registry_instance.mutex);
+
+        std::vector<ThreadTimeline> timelines;
+        for (const auto& buffer : registry_instance.threads)
+        {
+            ThreadTimeline timeline;
+            timeline.thread_id = buffer->thread_id;
+            if (const char* name = buffer->name.load(std::memory_order_relaxed))
+                timeline.name = name;
+            else
+                timeline.name = std::format("Thread {}", buffer->thread_id);
+
+            for (const ZoneSample& zone : read_zones(*buffer))
+            {
+                if (zone.name != nullptr && zone.end_ns >= begin_ns && zone.start_ns <= end_ns)
+                    timeline.zones.push_back(zone);
+            }
+            timelines.push_back(std::move(timeline));
+        }
+        return timelines;
+    }
+
+    void write_chrome_trace(const std::filesystem::path& path)
+    {
+        const std::vector<ThreadTimeline> timelines = capture(0, ~0ull);
+        const std::vector<uint64_t> frames = frame_marks();
+
+        // Trace timestamps are microseconds.
+        const auto microseconds = [](uint64_t nanoseconds)
+        {
+            return static_cast<double>(nanoseconds) / 1000.0;
+        };
+
+        std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        const auto begin_event = [&]
+        {
+            if (!first)
+                json += ",\n";
+            first = false;
+        };
+
+        for (const ThreadTimeline& timeline : timelines)
+        {
+            begin_event();
+            json += std::format(R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":)", timeline.thread_id);
+            append_json_string(json, timeline.name);
+            json += "}}";
+
+            for (const ZoneSample& zone : timeline.zones)
+            {
+                begin_event();
+                json += R"({"name":)";
+                append_json_string(json, zone.name);
+                json += std::format(R"(,"ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}})",
+                                    timeline.thread_id,
+                                    microseconds(zone.start_ns),
+                                    microseconds(zone.end_ns - zone.start_ns));
+            }
+        }
+
+        for (const uint64_t frame : frames)
+        {
+            begin_event();
+            json += std::format(R"({{"name":"Frame","ph":"i","s":"g","pid":1,"tid":0,"ts":{:.3f}}})", microseconds(frame));
+        }
+        json += "]}\n";
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            throw std::runtime_error("Failed to open trace file: " + path.string());
+        file.write(json.data(), static_cast<std::streamsize>(json.size()));
+        if (!file)
+            throw std::runtime_error("Failed to write trace file: " + path.string());
+    }
+
+    Zone::Zone(const char* name) noexcept
+        : m_name(name)
+        , m_depth(t_depth++)
+        , m_start_ns(now_ns())
+    {
+    }
+
+    Zone::~Zone()
+    {
+        const uint64_t end_ns = now_ns();
+        --t_depth;
+
+        ThreadBuffer& buffer = thread_buffer();
+        const uint64_t index = buffer.written.load(std::memory_order_relaxed);
+        ZoneSlot& slot = buffer.zones[index % k_zones_per_thread];
+        // Pairs with the fence in read_zones(): a reader that sees any of these stores also
+        // sees that the record it overwrites is gone.
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.name.store(m_name, std::memory_order_relaxed);
+        slot.start_ns.store(m_start_ns, std::memory_order_relaxed);
+        slot.end_ns.store(end_ns, std::memory_order_relaxed);
+        slot.depth.store(m_depth, std::memory_order_relaxed);
+        buffer.written.store(index + 1u, std::memory_order_release);
+    }
+} // namespace rose::core::profiler
@@ -0,0 +1,310 @@
+//
+// Created by orange on 16.10.2026.
+//
+#include "rose/core/scene_bvh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <optional>
+
+namespace rose::core
+{
+    namespace
+    {
+        // Median splits keep the depth near log2 of the leaf count, far below this.
+        constexpr std::size_t k_stack_size = 64;
+
+        [[nodiscard]] Aabb merge(const Aabb& a, const Aabb& b) noexcept
+        {
+            return {{std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z)},
+                    {std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z)}};
+        }
+
+        [[nodiscard]] bool same_box(const Aabb& a, const Aabb& b) noexcept
+        {
+            return a.min.x == b.min.x && a.min.y == b.min.y && a.min.z == b.min.z
+                && a.max.x == b.max.x && a.max.y == b.max.y && a.max.z == b.max.z;
+        }
+
+        [[nodiscard]] float centroid(const Aabb& box, int axis) noexcept
+        {
+            switch (axis)
+            {
+                case 0:
+                    return box.min.x + box.max.x;
+                case 1:
+                    return box.min.y + box.max.y;
+                default:
+                    return box.min.z + box.max.z;
+            }
+        }
+
+        struct RaySlabs final
+        {
+            float origin[3];
+            float inverse[3];
+        };
+
+        // Zero direction components become a tiny signed value so that their slabs reduce to
+        // +-infinity instead of 0 * infinity.
+        [[nodiscard]] RaySlabs make_slabs(const omath::Vector3<float>& origin, const omath::Vector3<float>& direction) noexcept
+        {
+            RaySlabs slabs{{origin.x, origin.y, origin.z}, {}};
+            const float components[3] = {direction.x, direction.y, direction.z};
+            for (std::size_t axis = 0; axis < 3; ++axis)
+            {
+                float component = components[axis];
+                if (std::abs(component) < 1.0e-20f)
+                    component = std::signbit(component) ? -1.0e-20f : 1.0e-20f;
+                slabs.inverse[axis] = 1.0f / component;
+            }
+            return slabs;
+        }
+
+        [[nodiscard]] std::optional<float> entry_distance(const Aabb& box, const RaySlabs& ray, float max_distance) noexcept
+        {
+            const float mins[3] = {box.min.x, box.min.y, box.min.z};
+            const float maxs[3] = {box.max.x, box.max.y, box.max.z};
+            float t_enter = 0.0f;
+            float t_exit = max_distance;
+            for (std::size_t axis = 0; axis < 3; ++axis)
+            {
+                const float t0 = (mins[axis] - ray.origin[axis]) * ray.inverse[axis];
+                const float t1 = (maxs[axis] - ray.origin[axis]) * ray.inverse[axis];
+                t_enter = std::max(t_enter, std::min(t0, t1));
+                t_exit = std::min(t_exit, std::max(t0, t1));
+            }
+            if (t_enter > t_exit)
+                return std::nullopt;
+            return t_enter;
+        }
+    } // namespace
+
+    void SceneBvh::build(std::span<const Aabb> boxes)
+    {
+        m_nodes.clear();
+        m_leaf_boxes.resize(0);
+        m_items.resize(boxes.size());
+        m_leaves.assign(boxes.size(), 0);
+        for (std::size_t i = 0; i < boxes.size(); ++i)
+            m_items[i] = static_cast<uint32_t>(i);
+        if (boxes.empty())
+            return;
+
+        m_nodes.reserve(2 * (boxes.size() / AabbBatch::k_group_size + 1));
+        build_node(boxes, 0, static_cast<uint32_t>(boxes.size()), 0);
+    }
+
+    uint32_t SceneBvh::build_node(std::span<const Aabb> boxes, uint32_t first, uint32_t count, uint32_t parent)
+    {
+        const auto node_index = static_cast<uint32_t>(m_nodes.size());
+        const Aabb& first_box = boxes[m_items[first]];
+        m_nodes.push_back({first_box, first, count, 0, parent});
+
+        float centroid_min[3]{centroid(first_box, 0), centroid(first_box, 1), centroid(first_box, 2)};
+        float centroid_max[3]{centroid_min[0], centroid_min[1], centroid_min[2]};
+        for (uint32_t i = first; i < first + count; ++i)
+        {
+            const Aabb& box = boxes[m_items[i]];
+            m_nodes[node_index].bounds = merge(m_nodes[node_index].bounds, box);
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                centroid_min[axis] = std::min(centroid_min[axis], centroid(box, axis));
+                centroid_max[axis] = std::max(centroid_max[axis], centroid(box, axis));
+            }
+        }
+
+        if (count <= AabbBatch::k_group_size)
+        {
+            const auto group = static_cast<uint32_t>(m_leaf_boxes.group_count());
+            m_leaf_boxes.resize((group + 1u) * AabbBatch::k_group_size);
+            for (uint32_t lane = 0; lane < count; ++lane)
+            {
+                m_leaves[m_items[first + lane]] = node_index;
+                m_leaf_boxes.set(group * AabbBatch::k_group_size + lane, boxes[m_items[first + lane]]);
+            }
+            m_nodes[node_index].group = group;
+            return node_index;
+        }
+
+        // Object median along the axis the centroids spread furthest on.
+        int axis = 0;
+        for (int candidate = 1; candidate < 3; ++candidate)
+        {
+            if (centroid_max[candidate] - centroid_min[candidate] > centroid_max[axis] - centroid_min[axis])
+                axis = candidate;
+        }
+        const uint32_t left_count = count / 2;
+        std::nth_element(m_items.begin() + first,
+                         m_items.begin() + first + left_count,
+                         m_items.begin() + first + count,
+                         [&boxes, axis](uint32_t a, uint32_t b) { return centroid(boxes[a], axis) < centroid(boxes[b], axis); });
+
+        build_node(boxes, first, left_count, node_index);
+        const uint32_t right = build_node(boxes, first + left_count, count - left_count, node_index);
+        m_nodes[node_index].right = right;
+        return node_index;
+    }
+
+    void SceneBvh::refit(std::size_t item, const Aabb& box)
+    {
+        if (item >= m_leaves.size() || m_nodes.empty())
+            return;
+
+        uint32_t node_index = m_leaves[item];
+        Node& leaf = m_nodes[node_index];
+        const std::size_t first_slot = leaf.group * AabbBatch::k_group_size;
+        Aabb bounds = box;
+        for (uint32_t lane = 0; lane < leaf.count; ++lane)
+        {
+            if (m_items[leaf.first + lane] == item)
+                m_leaf_boxes.set(first_slot + lane, box);
+            else
+                bounds = merge(bounds, m_leaf_boxes.get(first_slot + lane));
+        }
+        leaf.bounds = bounds;
+
+        while (node_index != 0)
+        {
+            node_index = m_nodes[node_index].parent;
+            Node& node = m_nodes[node_index];
+            bounds = merge(m_nodes[node_index + 1].bounds, m_nodes[node.right].bounds);
+            // Ancestors above an unchanged box are unchanged as well.
+            if (same_box(bounds, node.bounds))
+                break;
+            node.bounds = bounds;
+        }
+    }
+
+    void SceneBvh::cull(const Frustum& frustum, std::vector<std::size_t>& items) const
+    {
+        if (m_nodes.empty())
+            return;
+
+        struct Pending final
+        {
+            uint32_t node;
+            uint32_t planes; // bit i: plane i still cuts through the parent
+        };
+        std::array<Pending, k_stack_size> stack;
+        std::size_t stack_size = 0;
+        stack[stack_size++] = {0, 0x3fu};
+
+        while (stack_size > 0)
+        {
+            auto [node_index, planes] = stack[--stack_size];
+            const Node& node = m_nodes[node_index];
+            const Aabb& box = node.bounds;
+
+            bool outside = false;
+            for (std::size_t plane_index = 0; plane_index < frustum.planes.size(); ++plane_index)
+            {
+                const uint32_t bit = 1u << plane_index;
+                if ((planes & bit) == 0)
+                    continue;
+
+                const auto& plane = frustum.planes[plane_index];
+                const bool px = plane[0] > 0.0f;
+                const bool py = plane[1] > 0.0f;
+                const bool pz = plane[2] > 0.0f;
+                // Corners furthest along and against the plane normal.
+                const float furthest = plane[0] * (px ? box.max.x : box.min.x) + plane[1] * (py ? box.max.y : box.min.y)
+                                     + plane[2] * (pz ? box.max.z : box.min.z) + plane[3];
+                if (furthest < 0.0f)
+                {
+                    outside = true;
+                    break;
+                }
+                const float nearest = plane[0] * (px ? box.min.x : box.max.x) + plane[1] * (py ? box.min.y : box.max.y)
+                                    + plane[2] * (pz ? box.min.z : box.max.z) + plane[3];
+                if (nearest >= 0.0f)
+                    planes &= ~bit;
+            }
+            if (outside)
+                continue;
+
+            if (planes == 0)
+            {
+                for (uint32_t i = node.first; i < node.first + node.count; ++i)
+                    items.push_back(m_items[i]);
+                continue;
+            }
+            if (node.right == 0)
+            {
+                // Only the planes the leaf straddles are left to test on its boxes.
+                uint8_t mask = 0;
+                cull_box_groups(frustum, m_leaf_boxes, node.group, 1, &mask, planes);
+                for (uint32_t lane = 0; lane < node.count; ++lane)
+                {
+                    if ((mask & (1u << lane)) != 0)
+                        items.push_back(m_items[node.first + lane]);
+                }
+                continue;
+            }
+            stack[stack_size++] = {node.right, planes};
+            stack[stack_size++] = {node_index + 1, planes};
+        }
+    }
+
+    void SceneBvh::raycast(const omath::Vector3<float>& origin,
+                           const omath::Vector3<float>& direction,
+                           float max_distance,
+                           const std::function<float(std::size_t item, float max_distance)>& visit) const
+    {
+        if (m_nodes.empty())
+            return;
+
+        const RaySlabs ray = make_slabs(origin, direction);
+        const auto root_entry = entry_distance(m_nodes[0].bounds, ray, max_distance);
+        if (!root_entry)
+            return;
+
+        struct Pending final
+        {
+            uint32_t node;
+            float entry;
+        };
+        std::array<Pending, k_stack_size> stack;
+        std::size_t stack_size = 0;
+        stack[stack_size++] = {0, *root_entry};
+
+        while (stack_size > 0)
+        {
+            const Pending pending = stack[--stack_size];
+            if (pending.entry > max_distance)
+                continue;
+
+            const Node& node = m_nodes[pending.node];
+            if (node.right == 0)
+            {
+                for (uint32_t lane = 0; lane < node.count; ++lane)
+                {
+                    const Aabb box = m_leaf_boxes.get(node.group * AabbBatch::k_group_size + lane);
+                    if (entry_distance(box, ray, max_distance))
+                        max_distance = visit(m_items[node.first + lane], max_distance);
+                }
+                continue;
+            }
+
+            const uint32_t left = pending.node + 1;
+            const auto left_entry = entry_distance(m_nodes[left].bounds, ray, max_distance);
+            const auto right_entry = entry_distance(m_nodes[node.right].bounds, ray, max_distance);
+            // The nearer child goes on top so that it is visited first.
+            if (left_entry && right_entry)
+            {
+                const bool left_first = *left_entry <= *right_entry;
+                stack[stack_size++] = left_first ? Pending{node.right, *right_entry} : Pending{left, *left_entry};
+                stack[stack_size++] = left_first ? Pending{left, *left_entry} : Pending{node.right, *right_entry};
+            }
+            else if (left_entry)
+            {
+                stack[stack_size++] = {left, *left_entry};
+            }
+            else if (right_entry)
+            {
+                stack[stack_size++] = {node.right, *right_entry};
+            }
+        }
+    }
+} // namespace rose::core
@@ -0,0 +1,346 @@
+//
+// Created by orange on 16.10.2026.
+//
+#include "rose/core/vulkan/device_allocator.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+namespace rose::core::vulkan
+{
+    namespace
+    {
+        constexpr VkDeviceSize k_min_block_size = 1ull * 1024ull * 1024ull;
+
+        void check_allocator_vk(VkResult result, const char* message)
+        {
+            if (result != VK_SUCCESS)
+                throw std::runtime_error(std::string(message) + " (VkResult " + std::to_string(static_cast<int>(result)) + ")");
+        }
+
+        [[nodiscard]] constexpr VkDeviceSize align_up(VkDeviceSize value, VkDeviceSize alignment) noexcept
+        {
+            return alignment <= 1 ? value : (value + alignment - 1) / alignment * alignment;
+        }
+    } // namespace
+
+    struct MemoryBlock final
+    {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        void* mapped = nullptr;
+        RangeAllocator ranges;
+        uint32_t memory_type = 0;
+        bool linear = true;
+        uint32_t allocation_count = 0;
+    };
+
+    RangeAllocator::RangeAllocator(VkDeviceSize capacity)
+        : m_capacity(capacity)
+    {
+        if (capacity > 0)
+            m_free_ranges.emplace(0, capacity);
+    }
+
+    std::optional<VkDeviceSize> RangeAllocator::allocate(VkDeviceSize size, VkDeviceSize alignment)
+    {
+        if (size == 0)
+            return std::nullopt;
+
+        for (auto it = m_free_ranges.begin(); it != m_free_ranges.end(); ++it)
+        {
+            const VkDeviceSize range_offset = it->first;
+            const VkDeviceSize range_end = it->first + it->second;
+            const VkDeviceSize aligned_offset = align_up(range_offset, alignment);
+            if (aligned_offset + size > range_end)
+                continue;
+
+            m_free_ranges.erase(it);
+            if (aligned_offset > range_offset)
+                m_free_ranges.emplace(range_offset, aligned_offset - range_offset);
+            if (aligned_offset + size < range_end)
+                m_free_ranges.emplace(aligned_offset + size, range_end - (aligned_offset + size));
+
+            m_used += size;
+            return aligned_offset;
+        }
+        return std::nullopt;
+    }
+
+    void RangeAllocator::free(VkDeviceSize offset, VkDeviceSize size)
+    {
+        if (size == 0)
+            return;
+
+        m_used -= std::min(m_used, size);
+        auto [it, _] = m_free_ranges.emplace(offset, size);
+
+        const auto next = std::next(it);
+        if (next != m_free_ranges.end() && it->first + it->second == next->first)
+        {
+            it->second += next->second;
+            m_free_ranges.erase(next);
+        }
+
+        if (it != m_free_ranges.begin())
+        {
+            const auto previous = std::prev(it);
+            if (previous->first + previous->second == it->first)
+            {
+                previous->second += it->second;
+                m_free_ranges.erase(it);
+            }
+        }
+    }
+
+    DeviceAllocator::DeviceAllocator(VkPhysicalDevice physical_device, VkDevice device, VkDeviceSize block_size)
+        : m_device(device)
+        , m_block_size(std::max(block_size, k_min_block_size))
+    {
+        vkGetPhysicalDeviceMemoryProperties(physical_device, &m_memory_properties);
+
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(physical_device, &properties);
+        m_max_allocation_count = properties.limits.maxMemoryAllocationCount;
+        spdlog::info("Vulkan: device allocator ready block_size={} MiB memory_types={} heaps={} max_allocations={}",
+                     m_block_size / (1024ull * 1024ull),
+                     m_memory_properties.memoryTypeCount,
+                     m_memory_properties.memoryHeapCount,
+                     m_max_allocation_count);
+    }
+
+    DeviceAllocator::~DeviceAllocator()
+    {
+        for (uint32_t type = 0; type < m_memory_properties.memoryTypeCount; ++type)
+        {
+            for (Pool& pool : m_pools[type])
+            {
+                for (const std::unique_ptr<MemoryBlock>& block : pool.blocks)
+                {
+                    if (block->allocation_count != 0)
+                        spdlog::warn("Vulkan: releasing memory block with {} live allocation(s)", block->allocation_count);
+                    release_device_memory(block->memory, type);
+                }
+                pool.blocks.clear();
+            }
+            if (m_type_usage[type].dedicated_count != 0)
+                spdlog::warn("Vulkan: {} dedicated allocation(s) leaked from memory type {}",
+                             m_type_usage[type].dedicated_count,
+                             type);
+        }
+    }
+
+    uint32_t DeviceAllocator::find_memory_type(uint32_t type_filter, VkMemoryPropertyFlags properties) const
+    {
+        for (uint32_t i = 0; i < m_memory_properties.memoryTypeCount; ++i)
+        {
+            if ((type_filter & (1u << i)) != 0
+                && (m_memory_properties.memoryTypes[i].propertyFlags & properties) == properties)
+                return i;
+        }
+
+        throw std::runtime_error("Failed to find suitable Vulkan memory type");
+    }
+
+    VkDeviceSize DeviceAllocator::block_size_for_type(uint32_t memory_type) const
+    {
+        const uint32_t heap_index = m_memory_properties.memoryTypes[memory_type].heapIndex;
+        const VkDeviceSize heap_size = m_memory_properties.memoryHeaps[heap_index].size;
+        return std::min(m_block_size, std::max(heap_size / 8u, k_min_block_size));
+    }
+
+    VkDeviceMemory DeviceAllocator::allocate_device_memory(VkDeviceSize size, uint32_t memory_type, void** mapped)
+    {
+        if (m_max_allocation_count != 0 && m_device_memory_count >= m_max_allocation_count)
+            throw std::runtime_error("Vulkan device memory allocation count limit reached");
+
+        VkMemoryAllocateInfo alloc_info{};
+        alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        alloc_info.allocationSize = size;
+        alloc_info.memoryTypeIndex = memory_type;
+
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        check_allocator_vk(vkAllocateMemory(m_device, &alloc_info, nullptr, &memory), "Failed to allocate device memory");
+        ++m_device_memory_count;
+
+        *mapped = nullptr;
+        if ((m_memory_properties.memoryTypes[memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0)
+        {
+            const VkResult map_result = vkMapMemory(m_device, memory, 0, VK_WHOLE_SIZE, 0, mapped);
+            if (map_result != VK_SUCCESS)
+            {
+                release_device_memory(memory, memory_type);
+                check_allocator_vk(map_result, "Failed to map device memory");
+            }
+        }
+        return memory;
+    }
+
+    void DeviceAllocator::release_device_memory(VkDeviceMemory memory, uint32_t memory_type) noexcept
+    {
+        if (memory == VK_NULL_HANDLE)
+            return;
+
+        if ((m_memory_properties.memoryTypes[memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0)
+            vkUnmapMemory(m_device, memory);
+        vkFreeMemory(m_device, memory, nullptr);
+        --m_device_memory_count;
+    }
+
+    DeviceAllocation DeviceAllocator::allocate(const VkMemoryRequirements& requirements,
+                                               VkMemoryPropertyFlags properties,
+                                               bool linear)
+    {
+        const uint32_t memory_type = find_memory_type(requirements.memoryTypeBits, properties);
+        const VkDeviceSize block_size = block_size_for_type(memory_type);
+
+        std::lock_guard lock(m_mutex);
+        TypeUsage& usage = m_type_usage[memory_type];
+
+        DeviceAllocation allocation;
+        allocation.memory_type = memory_type;
+        allocation.size = requirements.size;
+
+        if (requirements.size > block_size / 2u)
+        {
+            allocation.memory = allocate_device_memory(requirements.size, memory_type, &allocation.mapped);
+            usage.dedicated_bytes += requirements.size;
+            ++usage.dedicated_count;
+            ++usage.allocation_count;
+            return allocation;
+        }
+
+        Pool& pool = m_pools[memory_type][linear ? 0 : 1];
+        for (const std::unique_ptr<MemoryBlock>& block : pool.blocks)
+        {
+            const std::optional<VkDeviceSize> offset = block->ranges.allocate(requirements.size, requirements.alignment);
+            if (!offset)
+                continue;
+
+            allocation.memory = block->memory;
+            allocation.offset = *offset;
+            allocation.block = block.get();
+            if (block->mapped != nullptr)
+                allocation.mapped = static_cast<std::byte*>(block->mapped) + *offset;
+            ++block->allocation_count;
+            ++usage.allocation_count;
+            return allocation;
+        }
+
+        auto block = std::make_unique<MemoryBlock>();
+        block->memory = allocate_device_memory(block_size, memory_type, &block->mapped);
+        block->ranges = RangeAllocator(block_size);
+        block->memory_type = memory_type;
+        block->linear = linear;
+
+        const std::optional<VkDeviceSize> offset = block->ranges.allocate(requirements.size, requirements.alignment);
+        if (!offset)
+        {
+            release_device_memory(block->memory, memory_type);
+            throw std::runtime_error("Failed to suballocate from a fresh device memory block");
+        }
+
+        allocation.memory = block->memory;
+        allocation.offset = *offset;
+        allocation.block = block.get();
+        if (block->mapped != nullptr)
+            allocation.mapped = static_cast<std::byte*>(block->mapped) + *offset;
+        ++block->allocation_count;
+        ++usage.allocation_count;
+        pool.blocks.push_back(std::move(block));
+        return allocation;
+    }
+
+    void DeviceAllocator::free(DeviceAllocation& allocation) noexcept
+    {
+        if (allocation.memory == VK_NULL_HANDLE)
+            return;
+
+        std::lock_guard lock(m_mutex);
+        TypeUsage& usage = m_type_usage[allocation.memory_type];
+        --usage.allocation_count;
+
+        if (allocation.block == nullptr)
+        {
+            release_device_memory(allocation.memory, allocation.memory_type);
+            usage.dedicated_bytes -= allocation.size;
+            --usage.dedicated_count;
+            allocation = {};
+            return;
+        }
+
+        MemoryBlock* block = allocation.block;
+        block->ranges.free(allocation.offset, allocation.size);
+        --block->allocation_count;
+        allocation = {};
+
+        // Keep one empty block per pool around so alternating create/destroy does not thrash vkAllocateMemory.
+        if (block->allocation_count != 0)
+            return;
+
+        Pool& pool = m_pools[block->memory_type][block->linear ? 0 : 1];
+        const auto empty_blocks = std::count_if(pool.blocks.begin(),
+                                                pool.blocks.end(),
+                                                [](const std::unique_ptr<MemoryBlock>& candidate)
+                                                {
+                                                    return candidate->allocation_count == 0;
+                                                });
+        if (empty_blocks <= 1)
+            return;
+
+        const auto it = std::find_if(pool.blocks.begin(),
+                                     pool.blocks.end(),
+                                     [block](const std::unique_ptr<MemoryBlock>& candidate)
+                                     {
+                                         return candidate.get() == block;
+                                     });
+        if (it == pool.blocks.end())
+            return;
+
+        release_device_memory(block->memory, block->memory_type);
+        pool.blocks.erase(it);
+    }
+
+    std::vector<DeviceHeapUsage> DeviceAllocator::heap_usage() const
+    {
+        std::vector<DeviceHeapUsage> heaps(m_memory_properties.memoryHeapCount);
+        for (uint32_t heap = 0; heap < m_memory_properties.memoryHeapCount; ++heap)
+        {
+            heaps[heap].heap_index = heap;
+            heaps[heap].flags = m_memory_properties.memoryHeaps[heap].flags;
+            heaps[heap].heap_size = m_memory_properties.memoryHeaps[heap].size;
+        }
+
+        std::lock_guard lock(m_mutex);
+        for (uint32_t type = 0; type < m_memory_properties.memoryTypeCount; ++type)
+        {
+            DeviceHeapUsage& heap = heaps[m_memory_properties.memoryTypes[type].heapIndex];
+            const TypeUsage& usage = m_type_usage[type];
+            heap.reserved_bytes += usage.dedicated_bytes;
+            heap.used_bytes += usage.dedicated_bytes;
+            heap.dedicated_count += usage.dedicated_count;
+            heap.allocation_count += usage.allocation_count;
+
+            for (const Pool& pool : m_pools[type])
+            {
+                for (const std::unique_ptr<MemoryBlock>& block : pool.blocks)
+                {
+                    heap.reserved_bytes += block->ranges.capacity();
+                    heap.used_bytes += block->ranges.used();
+                    ++heap.block_count;
+                }
+            }
+        }
+        return heaps;
+    }
+
+    uint32_t DeviceAllocator::device_memory_count() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_device_memory_count;
+    }
+} // namespace rose::core::vulkan
@@ -0,0 +1,226 @@
+//
+// Created by orange on 16.10.2026.
+//
+#include "rose/core/vulkan/gpu_profiler.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <stdexcept>
+#include <string>
+
+namespace rose::core::vulkan
+{
+    namespace
+    {
+        void check_profiler_vk(VkResult result, const char* message)
+        {
+            if (result != VK_SUCCESS)
+                throw std::runtime_error(std::string(message) + " (VkResult " + std::to_string(static_cast<int>(result)) + ")");
+        }
+
+        // Both ends of a scope wait for the work recorded before them, so consecutive scopes
+        // do not overlap in the breakdown.
+        constexpr VkPipelineStageFlagBits k_timestamp_stage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    } // namespace
+
+    GpuProfiler::GpuProfiler(VkPhysicalDevice physical_device,
+                             VkDevice device,
+                             uint32_t queue_family,
+                             uint32_t frames_in_flight,
+                             uint32_t scope_count,
+                             bool pipeline_statistics)
+        : m_device(device)
+        , m_scope_count(scope_count)
+        , m_statistics_supported(pipeline_statistics)
+    {
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(physical_device, &properties);
+        uint32_t family_count = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_count, nullptr);
+        std::vector<VkQueueFamilyProperties> families(family_count);
+        vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_count, families.data());
+
+        const uint32_t valid_bits = queue_family < family_count ? families[queue_family].timestampValidBits : 0u;
+        m_timestamps_supported = valid_bits > 0 && properties.limits.timestampPeriod > 0.0f;
+        m_timestamp_mask = valid_bits >= 64 ? ~0ull : (1ull << valid_bits) - 1ull;
+        m_nanoseconds_per_tick = static_cast<double>(properties.limits.timestampPeriod);
+
+        try
+        {
+            m_slots.resize(frames_in_flight);
+            for (Slot& slot : m_slots)
+            {
+                slot.scopes_written.assign(m_scope_count, false);
+                if (m_timestamps_supported)
+                {
+                    VkQueryPoolCreateInfo pool_info{};
+                    pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+                    pool_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+                    pool_info.queryCount = timestamp_count();
+                    check_profiler_vk(vkCreateQueryPool(m_device, &pool_info, nullptr, &slot.timestamps),
+                                      "Failed to create timestamp query pool");
+                }
+                if (m_statistics_supported)
+                {
+                    VkQueryPoolCreateInfo pool_info{};
+                    pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+                    pool_info.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+                    pool_info.queryCount = 1;
+                    pool_info.pipelineStatistics = k_statistics;
+                    check_profiler_vk(vkCreateQueryPool(m_device, &pool_info, nullptr, &slot.statistics),
+                                      "Failed to create pipeline statistics query pool");
+                }
+            }
+        }
+        catch (...)
+        {
+            for (const Slot& slot : m_slots)
+            {
+                if (slot.timestamps != VK_NULL_HANDLE)
+                    vkDestroyQueryPool(m_device, slot.timestamps, nullptr);
+                if (slot.statistics != VK_NULL_HANDLE)
+                    vkDestroyQueryPool(m_device, slot.statistics, nullptr);
+            }
+            throw;
+        }
+
+        spdlog::info("Vulkan: GPU profiler timestamps={} valid_bits={} period={} ns pipeline_statistics={}",
+                     m_timestamps_supported,
+                     valid_bits,
+                     properties.limits.timestampPeriod,
+                     m_statistics_supported);
+    }
+
+    GpuProfiler::~GpuProfiler()
+    {
+        for (const Slot& slot : m_slots)
+        {
+            if (slot.timestamps != VK_NULL_HANDLE)
+                vkDestroyQueryPool(m_device, slot.timestamps, nullptr);
+            if (slot.statistics != VK_NULL_HANDLE)
+                vkDestroyQueryPool(m_device, slot.statistics, nullptr);
+        }
+    }
+
+    void GpuProfiler::begin_frame(VkCommandBuffer command_buffer, uint32_t frame_index)
+    {
+        Slot& slot = m_slots.at(frame_index);
+        if (slot.pending)
+            read_back(slot);
+
+        m_active = nullptr;
+        m_statistics_active = false;
+        m_statistics_frame = false;
+        if (!m_enabled || !m_timestamps_supported)
+            return;
+
+        m_active = &slot;
+        slot.scopes_written.assign(m_scope_count, false);
+        slot.statistics_written = false;
+        vkCmdResetQueryPool(command_buffer, slot.timestamps, 0, timestamp_count());
+        m_statistics_frame = m_statistics_supported && m_statistics_enabled;
+        if (m_statistics_frame)
+            vkCmdResetQueryPool(command_buffer, slot.statistics, 0, 1);
+        vkCmdWriteTimestamp(command_buffer, k_timestamp_stage, slot.timestamps, 0);
+    }
+
+    void GpuProfiler::begin_scope(VkCommandBuffer command_buffer, uint32_t scope)
+    {
+        if (m_active == nullptr || scope >= m_scope_count || m_active->scopes_written[scope])
+            return;
+        vkCmdWriteTimestamp(command_buffer, k_timestamp_stage, m_active->timestamps, 2u + 2u * scope);
+    }
+
+    void GpuProfiler::end_scope(VkCommandBuffer command_buffer, uint32_t scope)
+    {
+        if (m_active == nullptr || scope >= m_scope_count || m_active->scopes_written[scope])
+            return;
+        vkCmdWriteTimestamp(command_buffer, k_timestamp_stage, m_active->timestamps, 3u + 2u * scope);
+        m_active->scopes_written[scope] = true;
+    }
+
+    void GpuProfiler::begin_statistics(VkCommandBuffer command_buffer)
+    {
+        if (m_active == nullptr || !m_statistics_frame || m_active->statistics_written)
+            return;
+        vkCmdBeginQuery(command_buffer, m_active->statistics, 0, 0);
+        m_statistics_active = true;
+    }
+
+    void GpuProfiler::end_statistics(VkCommandBuffer command_buffer)
+    {
+        if (!m_statistics_active)
+            return;
+        vkCmdEndQuery(command_buffer, m_active->statistics, 0);
+        m_statistics_active = false;
+        m_active->statistics_written = true;
+    }
+
+    void GpuProfiler::end_frame(VkCommandBuffer command_buffer)
+    {
+        if (m_active == nullptr)
+            return;
+        end_statistics(command_buffer);
+        vkCmdWriteTimestamp(command_buffer, k_timestamp_stage, m_active->timestamps, 1);
+        m_active->pending = true;
+        m_active = nullptr;
+    }
+
+    void GpuProfiler::read_back(Slot& slot)
+    {
+        slot.pending = false;
+
+        // Value and availability per query; the fence already signalled, so nothing waits here.
+        std::vector<uint64_t> timestamps(static_cast<std::size_t>(timestamp_count()) * 2u);
+        const VkResult result = vkGetQueryPoolResults(m_device,
+                                                      slot.timestamps,
+                                                      0,
+                                                      timestamp_count(),
+                                                      timestamps.size() * sizeof(uint64_t),
+                                                      timestamps.data(),
+                                                      2u * sizeof(uint64_t),
+                                                      VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+        if (result != VK_SUCCESS && result != VK_NOT_READY)
+            return;
+
+        const auto elapsed_ms = [&](uint32_t begin, uint32_t end) -> double
+        {
+            if (timestamps[begin * 2u + 1u] == 0 || timestamps[end * 2u + 1u] == 0)
+                return 0.0;
+            const uint64_t ticks = (timestamps[end * 2u] - timestamps[begin * 2u]) & m_timestamp_mask;
+            return static_cast<double>(ticks) * m_nanoseconds_per_tick / 1.0e6;
+        };
+
+        Frame frame;
+        frame.frame_ms = elapsed_ms(0, 1);
+        frame.scope_ms.resize(m_scope_count);
+        for (uint32_t scope = 0; scope < m_scope_count; ++scope)
+        {
+            if (slot.scopes_written[scope])
+                frame.scope_ms[scope] = elapsed_ms(2u + 2u * scope, 3u + 2u * scope);
+        }
+
+        if (slot.statistics_written)
+        {
+            std::array<uint64_t, k_statistic_count + 1u> statistics{};
+            if (vkGetQueryPoolResults(m_device,
+                                      slot.statistics,
+                                      0,
+                                      1,
+                                      sizeof(statistics),
+                                      statistics.data(),
+                                      sizeof(statistics),
+                                      VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT) == VK_SUCCESS
+                && statistics[k_statistic_count] != 0)
+            {
+                frame.statistics.emplace();
+                for (std::size_t i = 0; i < k_statistic_count; ++i)
+                    (*frame.statistics)[i] = statistics[i];
+            }
+        }
+
+        m_history.push_back(std::move(frame));
+        if (m_history.size() > k_history_size)
+            m_history.pop_front();
+    }
+} // namespace rose::core::vulkan
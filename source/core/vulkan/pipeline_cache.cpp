@@ -0,0 +1,226 @@
+//
+// Created by orange on 16.10.2026.
+//
+#include "rose/core/vulkan/pipeline_cache.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace rose::core::vulkan
+{
+    namespace
+    {
+        constexpr uint32_t k_cache_file_magic   = 0x48435052; // "RPCH"
+        constexpr uint32_t k_cache_file_version = 1;
+        constexpr uint64_t k_fnv_offset_basis   = 14695981039346656037ull;
+        constexpr uint64_t k_fnv_prime          = 1099511628211ull;
+
+        struct CacheFileHeader final
+        {
+            uint32_t magic = k_cache_file_magic;
+            uint32_t version = k_cache_file_version;
+            uint32_t vendor_id = 0;
+            uint32_t device_id = 0;
+            uint32_t driver_version = 0;
+            uint32_t api_version = 0;
+            uint8_t pipeline_cache_uuid[VK_UUID_SIZE]{};
+            uint64_t data_size = 0;
+            uint64_t data_hash = 0;
+        };
+        static_assert(sizeof(CacheFileHeader) == 56, "CacheFileHeader must not contain padding");
+
+        void check_cache_vk(VkResult result, const char* message)
+        {
+            if (result != VK_SUCCESS)
+                throw std::runtime_error(std::string(message) + " (VkResult " + std::to_string(static_cast<int>(result)) + ")");
+        }
+
+        [[nodiscard]] uint64_t hash_data(const std::vector<char>& data) noexcept
+        {
+            uint64_t hash = k_fnv_offset_basis;
+            for (const char byte : data)
+            {
+                hash ^= static_cast<uint8_t>(byte);
+                hash *= k_fnv_prime;
+            }
+            return hash;
+        }
+
+        [[nodiscard]] CacheFileHeader device_header(const VkPhysicalDeviceProperties& properties)
+        {
+            CacheFileHeader header;
+            header.vendor_id = properties.vendorID;
+            header.device_id = properties.deviceID;
+            header.driver_version = properties.driverVersion;
+            header.api_version = properties.apiVersion;
+            std::memcpy(header.pipeline_cache_uuid, properties.pipelineCacheUUID, VK_UUID_SIZE);
+            return header;
+        }
+
+        // Reason the file header does not describe the current device, if any.
+        [[nodiscard]] std::optional<std::string> header_mismatch(const CacheFileHeader& header,
+                                                                 const CacheFileHeader& expected)
+        {
+            if (header.magic != expected.magic || header.version != expected.version)
+                return "unknown file format";
+            if (header.vendor_id != expected.vendor_id || header.device_id != expected.device_id)
+                return "written for another device";
+            if (header.driver_version != expected.driver_version || header.api_version != expected.api_version)
+                return "written by another driver version";
+            if (std::memcmp(header.pipeline_cache_uuid, expected.pipeline_cache_uuid, VK_UUID_SIZE) != 0)
+                return "pipeline cache UUID changed";
+            return std::nullopt;
+        }
+
+        // The data itself starts with Vulkan's own header (VkPipelineCacheHeaderVersionOne).
+        [[nodiscard]] bool vulkan_header_matches(const std::vector<char>& data, const CacheFileHeader& expected)
+        {
+            constexpr std::size_t vulkan_header_size = 4u * sizeof(uint32_t) + VK_UUID_SIZE;
+            if (data.size() < vulkan_header_size)
+                return false;
+
+            uint32_t fields[4]{};
+            std::memcpy(fields, data.data(), sizeof(fields));
+            return fields[0] >= vulkan_header_size
+                && fields[1] == static_cast<uint32_t>(VK_PIPELINE_CACHE_HEADER_VERSION_ONE)
+                && fields[2] == expected.vendor_id
+                && fields[3] == expected.device_id
+                && std::memcmp(data.data() + sizeof(fields), expected.pipeline_cache_uuid, VK_UUID_SIZE) == 0;
+        }
+    } // namespace
+
+    PipelineCache::PipelineCache(VkPhysicalDevice physical_device,
+                                 VkDevice device,
+                                 const std::filesystem::path& directory)
+        : m_device(device)
+    {
+        vkGetPhysicalDeviceProperties(physical_device, &m_properties);
+        m_path = directory / std::format("pipelines_{:04x}_{:04x}.bin", m_properties.vendorID, m_properties.deviceID);
+
+        const std::vector<char> initial_data = load_validated();
+        VkPipelineCacheCreateInfo cache_info{};
+        cache_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        cache_info.initialDataSize = initial_data.size();
+        cache_info.pInitialData = initial_data.empty() ? nullptr : initial_data.data();
+
+        VkResult result = vkCreatePipelineCache(m_device, &cache_info, nullptr, &m_cache);
+        if (result != VK_SUCCESS && !initial_data.empty())
+        {
+            spdlog::warn("Vulkan: driver rejected pipeline cache '{}' (VkResult {}), starting empty",
+                         m_path.string(),
+                         static_cast<int>(result));
+            cache_info.initialDataSize = 0;
+            cache_info.pInitialData = nullptr;
+            result = vkCreatePipelineCache(m_device, &cache_info, nullptr, &m_cache);
+        }
+        else if (result == VK_SUCCESS)
+        {
+            m_loaded_size = initial_data.size();
+            m_saved_hash = initial_data.empty() ? 0 : hash_data(initial_data);
+        }
+        check_cache_vk(result, "Failed to create pipeline cache");
+
+        spdlog::info("Vulkan: pipeline cache '{}' loaded={} KiB",
+                     m_path.string(),
+                     (m_loaded_size + 1023u) / 1024u);
+    }
+
+    PipelineCache::~PipelineCache()
+    {
+        save();
+        if (m_cache != VK_NULL_HANDLE)
+            vkDestroyPipelineCache(m_device, m_cache, nullptr);
+    }
+
+    std::vector<char> PipelineCache::load_validated() const
+    {
+        std::error_code error;
+        if (!std::filesystem::exists(m_path, error))
+            return {};
+
+        const auto discard = [this](const std::string& reason)
+        {
+            spdlog::info("Vulkan: discarding pipeline cache '{}': {}", m_path.string(), reason);
+            return std::vector<char>{};
+        };
+
+        std::ifstream file(m_path, std::ios::binary);
+        CacheFileHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+            return discard("truncated header");
+
+        const CacheFileHeader expected = device_header(m_properties);
+        if (const std::optional<std::string> mismatch = header_mismatch(header, expected))
+            return discard(*mismatch);
+
+        std::vector<char> data(static_cast<std::size_t>(header.data_size));
+        if (data.empty() || !file.read(data.data(), static_cast<std::streamsize>(data.size())))
+            return discard("truncated data");
+        if (hash_data(data) != header.data_hash)
+            return discard("data hash mismatch");
+        if (!vulkan_header_matches(data, expected))
+            return discard("Vulkan cache header does not match the device");
+        return data;
+    }
+
+    void PipelineCache::save()
+    {
+        if (m_cache == VK_NULL_HANDLE)
+            return;
+
+        std::size_t data_size = 0;
+        if (vkGetPipelineCacheData(m_device, m_cache, &data_size, nullptr) != VK_SUCCESS || data_size == 0)
+            return;
+        std::vector<char> data(data_size);
+        const VkResult result = vkGetPipelineCacheData(m_device, m_cache, &data_size, data.data());
+        if (result != VK_SUCCESS && result != VK_INCOMPLETE)
+        {
+            spdlog::warn("Vulkan: failed to read pipeline cache data (VkResult {})", static_cast<int>(result));
+            return;
+        }
+        data.resize(data_size);
+
+        const uint64_t data_hash = hash_data(data);
+        if (data_hash == m_saved_hash)
+            return;
+
+        CacheFileHeader header = device_header(m_properties);
+        header.data_size = data.size();
+        header.data_hash = data_hash;
+
+        std::error_code error;
+        if (const std::filesystem::path parent_path = m_path.parent_path(); !parent_path.empty())
+            std::filesystem::create_directories(parent_path, error);
+
+        std::filesystem::path temporary_path = m_path;
+        temporary_path += ".tmp";
+        {
+            std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!file)
+            {
+                spdlog::warn("Vulkan: failed to write pipeline cache '{}'", temporary_path.string());
+                return;
+            }
+        }
+
+        std::filesystem::rename(temporary_path, m_path, error);
+        if (error)
+        {
+            spdlog::warn("Vulkan: failed to replace pipeline cache '{}': {}", m_path.string(), error.message());
+            std::filesystem::remove(temporary_path, error);
+            return;
+        }
+
+        m_saved_hash = data_hash;
+        spdlog::info("Vulkan: pipeline cache saved '{}' size={} KiB", m_path.string(), (data.size() + 1023u) / 1024u);
+    }
+} // namespace rose::core::vulkan
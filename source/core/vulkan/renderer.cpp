@@ -2,6 +2,17 @@
 // Created by orange on 15.05.2026.
 //
 #include "rose/core/vulkan/renderer.hpp"
+#include "rose/core/model.hpp"
+#include "rose/core/profiler.hpp"
+#include "rose/core/thread_pool.hpp"
+#include "rose/core/vulkan/device_allocator.hpp"
+#include "rose/core/vulkan/gpu_profiler.hpp"
+#include "rose/core/vulkan/pipeline_cache.hpp"
+#include "rose/core/vulkan/shader_library.hpp"
+#include "rose/core/vulkan/texel_conversion.hpp"
+#include "rose/core/vulkan/texture_loader.hpp"
+#include "rose/core/vulkan/texture_streamer.hpp"
+#include "rose/core/vulkan/upload_manager.hpp"
 
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
@@ -14,25 +25,35 @@
 #include <imgui_impl_vulkan.h>
 #include <spdlog/spdlog.h>
 
-#ifdef _WIN32
-#include <process.h>
-#endif
-
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <chrono>
 #include <cmath>
+#include <compare>
 #include <cstdint>
 #include <cstdlib>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <filesystem>
-#include <fstream>
+#include <future>
+#include <iterator>
 #include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
+#include <span>
+#include <thread>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <system_error>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace rose::core::vulkan
@@ -40,8 +61,200 @@ namespace rose::core::vulkan
     namespace
     {
         constexpr uint32_t k_api_version          = VK_API_VERSION_1_2;
-        constexpr int      k_max_frames_in_flight = 2;
+        // Capacity of the per-frame resources; the LatencyProfile picks how many are used.
+        constexpr int      k_max_frames_in_flight = 3;
         constexpr uint32_t k_shadow_map_size      = 2048;
+        constexpr std::size_t k_latency_history_size = 240;
+        constexpr uint32_t k_max_material_sets    = 4096;
+        // Streamed textures keep the mips up to this size resident and at most this many level
+        // changes are uploaded at once.
+        constexpr uint32_t    k_streaming_tail_extent   = 256;
+        constexpr std::size_t k_max_texture_transitions = 4;
+        constexpr uint32_t k_arena_vertex_count   = 4u * 1024u * 1024u;
+        constexpr uint32_t k_arena_index_count    = 16u * 1024u * 1024u;
+        constexpr uint32_t k_initial_draw_count   = 1024;
+        constexpr uint32_t k_max_sun_cascades     = 4;
+        // Culling views: the camera, then a static and a dynamic caster view per shadow map layer
+        // (the spotlight, then every sun cascade). The count buffer reserves k_max_cull_views
+        // slots for the views ahead of the per-batch scene counters.
+        constexpr uint32_t k_camera_cull_view            = 0;
+        constexpr uint32_t k_first_shadow_cull_view      = 1;
+        constexpr uint32_t k_cull_view_count             = k_first_shadow_cull_view + 2u * (1u + k_max_sun_cascades);
+        constexpr uint32_t k_max_cull_views              = 16;
+        constexpr uint32_t k_cull_group_size             = 64;
+        constexpr uint32_t k_hiz_group_size              = 8;
+        constexpr uint32_t k_bloom_group_size            = 8;
+        constexpr uint32_t k_selection_group_size        = 8;
+        // Widest selection glow; it bounds the jump flood at seven steps.
+        constexpr float    k_max_selection_outline_pixels = 64.0f;
+        constexpr uint32_t k_dynamic_draw_flag           = 1;
+        static_assert(k_cull_view_count <= k_max_cull_views, "Cull views do not fit the count buffer");
+        constexpr uint64_t k_fnv_offset_basis = 14695981039346656037ull;
+        constexpr uint64_t k_fnv_prime        = 1099511628211ull;
+        // Frames with fewer draws than this per recording slot use fewer slots; below it the frame
+        // thread records everything itself.
+        constexpr std::size_t k_min_draws_per_chunk = 64;
+        constexpr std::size_t k_max_recording_slots = 8;
+
+        // Residency work is memcpy- and allocation-bound, so a few workers saturate it.
+        [[nodiscard]] int residency_worker_count()
+        {
+            const int hardware_threads = static_cast<int>(std::thread::hardware_concurrency());
+            return std::clamp(hardware_threads / 2, 1, 4);
+        }
+
+        [[nodiscard]] long long elapsed_milliseconds(std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start)
+                .count();
+        }
+
+        // Command recording is pure CPU work split into equal chunks, so it uses every core.
+        [[nodiscard]] int recording_worker_count()
+        {
+            const int hardware_threads = static_cast<int>(std::thread::hardware_concurrency());
+            return std::clamp(hardware_threads, 1, static_cast<int>(k_max_recording_slots));
+        }
+
+        // Gribb-Hartmann planes (a, b, c, d with a·p + d >= 0 inside) of an OpenGL-style
+        // column-major view-projection; the cull shader only compares signs, so they are not
+        // normalised.
+        void write_frustum_planes(const std::array<float, 16>& view_projection, float (*planes)[4])
+        {
+            const auto at = [&view_projection](int row, int column)
+            {
+                return view_projection[static_cast<std::size_t>(column * 4 + row)];
+            };
+
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                for (int side = 0; side < 2; ++side)
+                {
+                    const float sign = side == 0 ? 1.0f : -1.0f;
+                    float* plane = planes[axis * 2 + side];
+                    for (int column = 0; column < 4; ++column)
+                        plane[column] = at(3, column) + sign * at(axis, column);
+                }
+            }
+        }
+
+        // Tests a local AABB under `model` against planes from write_frustum_planes(); the CPU
+        // counterpart of insideFrustum() in cull.comp.
+        [[nodiscard]] bool box_inside_planes(const float (*planes)[4],
+                                             const std::array<float, 16>& model,
+                                             const omath::Vector3<float>& local_center,
+                                             const omath::Vector3<float>& local_extent)
+        {
+            const float local_c[3] = {local_center.x, local_center.y, local_center.z};
+            const float local_e[3] = {local_extent.x, local_extent.y, local_extent.z};
+            float center[3]{};
+            float extent[3]{};
+            for (int row = 0; row < 3; ++row)
+            {
+                center[row] = model[static_cast<std::size_t>(12 + row)];
+                for (int column = 0; column < 3; ++column)
+                {
+                    const float axis = model[static_cast<std::size_t>(column * 4 + row)];
+                    center[row] += axis * local_c[column];
+                    extent[row] += std::abs(axis) * local_e[column];
+                }
+            }
+
+            for (int i = 0; i < 6; ++i)
+            {
+                const float* plane = planes[i];
+                float distance = plane[3];
+                for (int axis = 0; axis < 3; ++axis)
+                    distance += plane[axis] * center[axis] + std::abs(plane[axis]) * extent[axis];
+                if (distance < 0.0f)
+                    return false;
+            }
+            return true;
+        }
+
+        [[nodiscard]] uint64_t hash_bytes(uint64_t hash, const void* data, std::size_t size) noexcept
+        {
+            const auto* bytes = static_cast<const unsigned char*>(data);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                hash ^= bytes[i];
+                hash *= k_fnv_prime;
+            }
+            return hash;
+        }
+
+        // Nearest-rank percentiles of a timing history.
+        [[nodiscard]] GpuTimingPercentiles timing_percentiles(std::vector<float> samples)
+        {
+            GpuTimingPercentiles percentiles;
+            if (samples.empty())
+                return percentiles;
+            std::ranges::sort(samples);
+            const auto rank = [&samples](float percentile)
+            {
+                const auto index = static_cast<std::size_t>(std::ceil(percentile * static_cast<float>(samples.size())));
+                return samples[std::clamp<std::size_t>(index, 1u, samples.size()) - 1u];
+            };
+            percentiles.p50 = rank(0.50f);
+            percentiles.p95 = rank(0.95f);
+            percentiles.p99 = rank(0.99f);
+            return percentiles;
+        }
+
+        // General 4x4 inverse; the cofactor expansion does not depend on the storage order.
+        [[nodiscard]] std::optional<std::array<float, 16>> inverse_matrix(const std::array<float, 16>& m)
+        {
+            std::array<float, 16> inv{};
+            inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15]
+                   + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+            inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15]
+                   - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+            inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15]
+                   + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+            inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14]
+                    - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+            inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15]
+                   - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+            inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15]
+                   + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+            inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15]
+                   - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+            inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14]
+                    + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+            inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15]
+                   + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+            inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15]
+                   - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+            inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15]
+                    + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+            inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14]
+                    - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+            inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11]
+                   - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+            inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11]
+                   + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+            inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11]
+                    - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+            inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10]
+                    + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+            const float determinant = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+            if (std::abs(determinant) < 1e-12f)
+                return std::nullopt;
+            for (float& value : inv)
+                value /= determinant;
+            return inv;
+        }
+
+        // Column-major matrix times (x, y, z, 1), with the perspective divide.
+        [[nodiscard]] omath::Vector3<float> transform_point(const std::array<float, 16>& m, float x, float y, float z)
+        {
+            const float w = m[3] * x + m[7] * y + m[11] * z + m[15];
+            return omath::Vector3<float>{m[0] * x + m[4] * y + m[8] * z + m[12],
+                                         m[1] * x + m[5] * y + m[9] * z + m[13],
+                                         m[2] * x + m[6] * y + m[10] * z + m[14]}
+                 / w;
+        }
 
         class VulkanError final : public std::runtime_error
         {
@@ -86,173 +299,69 @@ namespace rose::core::vulkan
 #endif
         }
 
-        [[nodiscard]] std::string quote_command_arg(const std::filesystem::path& path)
-        {
-            std::string result = "\"";
-            for (const char c : path.string())
-            {
-                if (c == '"')
-                    result += "\\\"";
-                else
-                    result += c;
-            }
-            result += "\"";
-            return result;
-        }
-
-        [[nodiscard]] int run_glslc(const std::filesystem::path& compiler_path,
-                                    const std::filesystem::path& source_path,
-                                    const std::filesystem::path& output_path)
-        {
-#ifdef _WIN32
-            const std::wstring compiler = compiler_path.wstring();
-            const std::wstring target_env = L"--target-env=vulkan1.2";
-            const std::wstring source = source_path.wstring();
-            const std::wstring output_flag = L"-o";
-            const std::wstring output = output_path.wstring();
-            const wchar_t* args[] = {
-                compiler.c_str(),
-                target_env.c_str(),
-                source.c_str(),
-                output_flag.c_str(),
-                output.c_str(),
-                nullptr
-            };
-            return static_cast<int>(_wspawnvp(_P_WAIT, compiler.c_str(), args));
-#else
-            const std::string command = quote_command_arg(compiler_path)
-                                      + " --target-env=vulkan1.2 "
-                                      + quote_command_arg(source_path)
-                                      + " -o "
-                                      + quote_command_arg(output_path);
-            return std::system(command.c_str());
-#endif
-        }
-
-        [[nodiscard]] std::filesystem::path glslc_path()
+        // GLSL sources for shader hot reload: the source tree when the build recorded it, otherwise
+        // the shaders directory copied next to the executable.
+        [[nodiscard]] std::filesystem::path shader_source_directory()
         {
-#ifdef _WIN32
-            constexpr const char* glslc_filename = "glslc.exe";
-#else
-            constexpr const char* glslc_filename = "glslc";
+#ifdef ROSE_SHADER_SOURCE_DIR
+            if (std::filesystem::exists(ROSE_SHADER_SOURCE_DIR))
+                return ROSE_SHADER_SOURCE_DIR;
 #endif
             std::error_code ec;
-            const std::filesystem::path local_glslc = std::filesystem::current_path(ec) / glslc_filename;
-            if (!ec && std::filesystem::exists(local_glslc))
-                return local_glslc;
-
-            if (const auto vulkan_sdk = environment_value("VULKAN_SDK"))
-            {
-#ifdef _WIN32
-                const std::filesystem::path sdk_glslc = std::filesystem::path(*vulkan_sdk) / "Bin" / glslc_filename;
-#else
-                const std::filesystem::path sdk_glslc = std::filesystem::path(*vulkan_sdk) / "bin" / glslc_filename;
-#endif
-                if (std::filesystem::exists(sdk_glslc))
-                    return sdk_glslc;
-            }
-
-            return glslc_filename;
+            return std::filesystem::current_path(ec) / "shaders";
         }
 
-        [[nodiscard]] std::vector<char> read_binary_file(const std::filesystem::path& path)
+        // Cooked copies of decoded textures, reused across runs.
+        [[nodiscard]] std::filesystem::path texture_cache_directory()
         {
-            spdlog::info("Vulkan: loading shader '{}'", path.string());
-            std::ifstream file(path, std::ios::ate | std::ios::binary);
-            if (!file)
-            {
-                spdlog::critical("Vulkan: failed to open shader '{}'", path.string());
-                throw VulkanError("Failed to open shader file: " + path.string());
-            }
-
-            const auto end = file.tellg();
-            if (end <= 0)
-            {
-                spdlog::critical("Vulkan: shader file is empty '{}'", path.string());
-                throw VulkanError("Shader file is empty: " + path.string());
-            }
-
-            std::vector<char> buffer(static_cast<std::size_t>(end));
-            file.seekg(0, std::ios::beg);
-            file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
-            return buffer;
+            std::error_code ec;
+            std::filesystem::path directory = std::filesystem::temp_directory_path(ec);
+            if (ec)
+                return {};
+            directory /= "rose_texture_cache";
+            std::filesystem::create_directories(directory, ec);
+            return ec ? std::filesystem::path{} : directory;
         }
 
-        [[nodiscard]] std::filesystem::path shader_path(const char* filename)
+        // FNV-1a over the texels, eight bytes at a time, seeded with everything that changes the
+        // cooked mip chain.
+        [[nodiscard]] std::string texture_cache_name(const Texture& texture, TextureType type)
         {
-            const std::filesystem::path relative_path = std::filesystem::path("shaders") / filename;
-            std::error_code ec;
-            const std::filesystem::path cwd_path = std::filesystem::current_path(ec) / relative_path;
-            if (!ec && std::filesystem::exists(cwd_path))
-                return cwd_path;
-            if (std::filesystem::exists(relative_path))
-                return relative_path;
-
-            std::optional<std::filesystem::path> build_path;
-#ifdef ROSE_SHADER_DIR
-            build_path = std::filesystem::path(ROSE_SHADER_DIR) / filename;
-#endif
-
-            std::filesystem::path source_filename = filename;
-            if (source_filename.extension() == ".spv")
-                source_filename.replace_extension();
-
-            std::vector<std::filesystem::path> source_candidates;
-            if (!ec)
-                source_candidates.push_back(std::filesystem::current_path(ec) / "shaders" / source_filename);
-            source_candidates.push_back(std::filesystem::path("shaders") / source_filename);
-#ifdef ROSE_SHADER_SOURCE_DIR
-            source_candidates.push_back(std::filesystem::path(ROSE_SHADER_SOURCE_DIR) / source_filename);
-#endif
-
-            std::optional<std::filesystem::path> source_path;
-            for (const std::filesystem::path& candidate : source_candidates)
-            {
-                if (std::filesystem::exists(candidate))
-                {
-                    source_path = candidate;
-                    break;
-                }
-            }
-
-            const std::filesystem::path output_path = !ec ? cwd_path : relative_path;
-            if (!source_path)
+            constexpr uint64_t k_prime = 0x100000001b3ull;
+            uint64_t hash = 0xcbf29ce484222325ull;
+            auto mix = [&hash](uint64_t value)
             {
-                if (build_path && std::filesystem::exists(*build_path))
-                    return *build_path;
-
-                spdlog::critical("Vulkan: shader binary '{}' is missing and GLSL source '{}' was not found",
-                                 output_path.string(),
-                                 source_filename.string());
-                return output_path;
-            }
-
-            if (const std::filesystem::path parent_path = output_path.parent_path(); !parent_path.empty())
-                std::filesystem::create_directories(parent_path, ec);
-
-            const std::filesystem::path compiler_path = glslc_path();
-            spdlog::warn("Vulkan: shader binary '{}' is missing, compiling '{}' with '{}'",
-                         output_path.string(),
-                         source_path->string(),
-                         compiler_path.string());
-            const int result = run_glslc(compiler_path, *source_path, output_path);
-            if (result != 0 || !std::filesystem::exists(output_path))
+                hash = (hash ^ value) * k_prime;
+            };
+            mix(1); // cache format version
+            mix(static_cast<uint64_t>(type));
+            mix(static_cast<uint64_t>(texture.width()));
+            mix(static_cast<uint64_t>(texture.height()));
+            mix(static_cast<uint64_t>(texture.components()));
+
+            const std::vector<unsigned char>& pixels = texture.pixels();
+            std::size_t offset = 0;
+            for (; offset + sizeof(uint64_t) <= pixels.size(); offset += sizeof(uint64_t))
             {
-                spdlog::critical("Vulkan: failed to compile shader '{}' to '{}' using '{}'",
-                                 source_path->string(),
-                                 output_path.string(),
-                                 compiler_path.string());
-                if (build_path && std::filesystem::exists(*build_path))
-                    return *build_path;
+                uint64_t word = 0;
+                std::memcpy(&word, pixels.data() + offset, sizeof(word));
+                mix(word);
             }
-
-            return output_path;
+            for (; offset < pixels.size(); ++offset)
+                mix(pixels[offset]);
+
+            constexpr std::string_view k_digits = "0123456789abcdef";
+            std::string name(16, '0');
+            for (std::size_t i = 0; i < name.size(); ++i)
+                name[i] = k_digits[(hash >> (60u - 4u * i)) & 0xFu];
+            return name + ".ktx2";
         }
 
         struct QueueFamilies final
         {
             std::optional<uint32_t> graphics;
             std::optional<uint32_t> present;
+            std::optional<uint32_t> transfer; // transfer-capable family without graphics, if any
 
             [[nodiscard]] bool complete() const noexcept
             {
@@ -270,35 +379,56 @@ namespace rose::core::vulkan
         struct BufferResource final
         {
             VkBuffer buffer = VK_NULL_HANDLE;
-            VkDeviceMemory memory = VK_NULL_HANDLE;
+            DeviceAllocation allocation;
             VkDeviceSize size = 0;
         };
 
         struct ImageResource final
         {
             VkImage image = VK_NULL_HANDLE;
-            VkDeviceMemory memory = VK_NULL_HANDLE;
+            DeviceAllocation allocation;
             VkImageView view = VK_NULL_HANDLE;
             VkFormat format = VK_FORMAT_UNDEFINED;
             VkExtent2D extent{};
             VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
         };
 
+        // Every texture is sampled through the renderer's shared texture sampler. A streamed
+        // texture's image holds mips base_level.. of its source; the coarser levels are always
+        // resident and finer ones come and go with the streaming budget.
         struct GpuTexture final
         {
             ImageResource image;
-            VkSampler sampler = VK_NULL_HANDLE;
             VkDescriptorSet descriptor = VK_NULL_HANDLE;
+            UploadTicket ready_ticket = 0;
+            uint32_t mip_levels = 1;
+            uint32_t base_level = 0;
+            bool two_channel = false; // BC5: the shader rebuilds the third channel
+            Texture* streamed_source = nullptr;
+        };
+
+        struct GpuMaterial final
+        {
+            BufferResource uniform_buffer;
+            VkDescriptorSet descriptor = VK_NULL_HANDLE;
+            std::array<const GpuTexture*, 4> textures{};
         };
 
+        // Meshes live in the shared geometry arena and are addressed by first_index/vertex_offset;
+        // only meshes that did not fit own a vertex and index buffer.
         struct GpuMesh final
         {
             BufferResource vertex_buffer;
             BufferResource index_buffer;
-            BufferResource material_buffer;
+            UploadTicket ready_ticket = 0;
             uint32_t index_count = 0;
-            VkDescriptorSet descriptor = VK_NULL_HANDLE;
+            uint32_t first_index = 0;
+            int32_t vertex_offset = 0;
+            bool in_arena = false;
+            // Streaming replaces the material's descriptor set, so meshes read it through here.
+            const GpuMaterial* material = nullptr;
             omath::Vector3<float> local_center{};
+            omath::Vector3<float> local_extent{};
         };
 
         struct FrameSync final
@@ -306,6 +436,16 @@ namespace rose::core::vulkan
             VkSemaphore image_available = VK_NULL_HANDLE;
             VkSemaphore render_finished = VK_NULL_HANDLE;
             VkFence in_flight = VK_NULL_HANDLE;
+            // Number of the last frame submitted with in_flight; done once the fence has signalled.
+            uint64_t submitted_frame = 0;
+        };
+
+        // A presented frame whose input-to-present latency is not known yet.
+        struct LatencySample final
+        {
+            std::chrono::steady_clock::time_point input_sampled_at{};
+            uint64_t present_id = 0; // 0 without VK_KHR_present_wait
+            std::size_t frame_index = 0;
         };
 
         struct ReadbackSlot final
@@ -316,26 +456,43 @@ namespace rose::core::vulkan
             bool pending = false;
         };
 
+        // The object id read back from a frame's pick pass and the meshes it drew, [id - 1].
+        struct PickSlot final
+        {
+            ReadbackSlot readback;
+            std::vector<const Mesh*> meshes;
+        };
+
         struct PushConstants final
         {
             float view_projection[16]{};
             float model[16]{};
             float previous_view_projection[16]{};
-            float outline_center[3]{};
-            float outline_width = 0.0f;
-            float outline_color[3]{};
-            float outline_alpha = 0.0f;
-            int32_t outline_enabled = 0;
-            float outline_padding[3]{};
+            float camera_position[3]{};
+            // Non-zero when the view-projections come from the late-latched CameraUniform.
+            uint32_t camera_latched = 0;
+            // Glow width in pixels; only read by the selection mask.
+            float selection_width = 0.0f;
+            // Written by the pick pass; 0 is the background.
+            uint32_t object_id = 0;
+            float padding[2]{};
         };
 
         struct BloomPushConstants final
         {
-            float texel_size[2]{};
-            float threshold = 1.0f;
+            float bloom_texel_size[2]{};
             float intensity = 0.0f;
             float radius = 1.0f;
-            int32_t quality = 1;
+        };
+
+        struct BloomPyramidPushConstants final
+        {
+            float source_texel_size[2]{};
+            int32_t destination_size[2]{};
+            float threshold = 1.0f;
+            float radius = 1.0f;
+            int32_t prefilter = 0;
+            float padding = 0.0f;
         };
 
         struct MaterialUniform final
@@ -345,7 +502,157 @@ namespace rose::core::vulkan
             float metallic_factor = 0.0f;
             float roughness_factor = 0.8f;
             float normal_scale = 1.0f;
-            float padding = 0.0f;
+            float normal_reconstruct_z = 0.0f;
+        };
+
+        // Meshes with the same textures and factors share one material descriptor set.
+        struct MaterialKey final
+        {
+            std::array<const GpuTexture*, 4> textures{};
+            std::array<uint32_t, sizeof(MaterialUniform) / sizeof(uint32_t)> uniform_bits{};
+
+            auto operator<=>(const MaterialKey&) const = default;
+        };
+
+        // Matches DrawData in shader.vert and cull.comp (std430). Bounds are the mesh's local AABB;
+        // batch and batch_first locate the draw's material run for command compaction, and flags
+        // marks dynamic casters.
+        struct DrawData final
+        {
+            float model[16]{};
+            float bounds_center[4]{};
+            float bounds_extent[4]{};
+            uint32_t index_count = 0;
+            uint32_t first_index = 0;
+            int32_t vertex_offset = 0;
+            uint32_t batch = 0;
+            uint32_t batch_first = 0;
+            uint32_t flags = 0;
+            uint32_t padding[2]{};
+        };
+        static_assert(sizeof(DrawData) == 128, "DrawData must match the std430 layout in the shaders");
+
+        // Matches CullParams in cull.comp (std140).
+        struct CullUniform final
+        {
+            float occlusion_view_projection[16]{};
+            float hiz_size[4]{};
+            uint32_t counts[4]{};
+            // x: views that only take static draws, y: views that only take dynamic draws.
+            uint32_t view_masks[4]{};
+            float planes[k_max_cull_views * 6][4]{};
+        };
+
+        struct HizPushConstants final
+        {
+            int32_t source_size[2]{};
+            int32_t destination_size[2]{};
+        };
+
+        // Shared by the jump flood steps, which read size and step, and the composite, which reads
+        // color and softness.
+        struct SelectionPushConstants final
+        {
+            float color[3]{};
+            float softness = 0.0f;
+            int32_t size[2]{};
+            int32_t step = 0;
+            int32_t padding = 0;
+        };
+
+        // Commands are written by the cull pass, one region of `capacity` commands per cull view.
+        // The count buffer holds one counter per view followed by one per scene batch.
+        struct FrameDrawBuffers final
+        {
+            BufferResource draw_data;
+            BufferResource commands;
+            BufferResource counts;
+            BufferResource cull_uniform;
+            uint32_t capacity = 0;
+            VkDescriptorSet descriptor = VK_NULL_HANDLE;
+            VkDescriptorSet cull_descriptor = VK_NULL_HANDLE;
+        };
+
+        // A run of scene commands that share a material descriptor set.
+        struct IndirectBatch final
+        {
+            VkDescriptorSet descriptor = VK_NULL_HANDLE;
+            uint32_t first_command = 0;
+            uint32_t command_count = 0;
+        };
+
+        // Conservative depth pyramid of the previous frame: mip 0 is half the scene resolution and
+        // every texel holds the farthest depth it covers.
+        struct HizPyramid final
+        {
+            ImageResource image;
+            uint32_t mip_count = 0;
+            std::vector<VkImageView> mip_views;
+            std::vector<VkDescriptorSet> descriptors;
+            std::array<float, 16> view_projection{};
+            bool valid = false;
+        };
+
+        // Bloom mip chain: level 0 is half the resolution of the resolved image. The bright part of
+        // the scene is extracted once into level 0 and downsampled level by level; the upsample
+        // passes then add every level into the one above it, leaving the whole bloom in level 0.
+        // The prefilter and composite sets exist per bloom source: [0] reads the scene color and
+        // [1] the DLSS output, when there is one.
+        struct BloomPyramid final
+        {
+            ImageResource image;
+            uint32_t mip_count = 0;
+            std::vector<VkImageView> mip_views;
+            std::array<VkDescriptorSet, 2> prefilter_descriptors{};
+            std::array<VkDescriptorSet, 2> composite_descriptors{};
+            std::vector<VkDescriptorSet> downsample_descriptors; // [level - 1] writes level
+            std::vector<VkDescriptorSet> upsample_descriptors;   // [level] adds level + 1 to level
+        };
+
+        // Screen-space selection outline at scene resolution. The mask pass turns every visible
+        // pixel of the selected meshes into a seed; jump flooding then hands every pixel its nearest
+        // seed in log2(width) passes, and the composite draws the glow from the distance to it. The
+        // cost depends on neither the glow width nor its softness.
+        struct SelectionOutline final
+        {
+            std::array<ImageResource, 2> seeds;        // R32_UINT packed seed coordinates, ping-ponged
+            ImageResource seed_data;                    // R32G32_SFLOAT glow width in pixels and depth
+            VkFramebuffer mask_framebuffer = VK_NULL_HANDLE;
+            VkFramebuffer composite_framebuffer = VK_NULL_HANDLE;
+            std::array<VkDescriptorSet, 2> jump_descriptors{};      // [i] reads seeds[i], writes the other
+            std::array<VkDescriptorSet, 2> composite_descriptors{}; // [i] reads seeds[i] and the seed data
+        };
+
+        // One-pixel object-ID target of the pick pass, with a depth buffer of its own so the
+        // nearest draw wins regardless of the scene pass.
+        struct PickTarget final
+        {
+            ImageResource ids;
+            ImageResource depth;
+            VkFramebuffer framebuffer = VK_NULL_HANDLE;
+        };
+
+        // Static casters of one light, re-rendered only when the light or one of them changes.
+        // The light's shadow map is a copy of it with the dynamic casters drawn on top.
+        struct ShadowCache final
+        {
+            ImageResource image;
+            VkFramebuffer framebuffer = VK_NULL_HANDLE;
+            uint64_t signature = 0;
+            bool valid = false;
+            // The shadow map holds exactly the cached casters, so a frame without dynamic casters
+            // can leave it untouched.
+            bool shadow_map_current = false;
+        };
+
+        // Queued draws that reach one light, split by mobility. Indirect draws are culled per
+        // light on the GPU and only contribute to the signature and the dynamic flag.
+        struct ShadowCasters final
+        {
+            std::vector<std::size_t> static_draws;
+            std::vector<std::size_t> dynamic_draws;
+            uint64_t static_signature = k_fnv_offset_basis;
+            bool has_dynamic = false;
         };
 
         struct LightUniform final
@@ -358,7 +665,91 @@ namespace rose::core::vulkan
             float sun_direction_enabled[4]{};
             float sun_color_intensity[4]{};
             float sun_params[4]{};
-            float sun_view_projection[16]{};
+            float sun_view_projections[k_max_sun_cascades][16]{};
+        };
+
+        // Written by end_frame() just before submission; read instead of the push constants by
+        // the draws of the late-latched camera.
+        struct CameraUniform final
+        {
+            float view_projection[16]{};
+            float previous_view_projection[16]{};
+        };
+
+        // One pipeline of a batch that is compiled concurrently; exactly one create info is set.
+        struct PipelineBuild final
+        {
+            const VkGraphicsPipelineCreateInfo* graphics = nullptr;
+            const VkComputePipelineCreateInfo* compute = nullptr;
+            VkPipeline* pipeline = nullptr;
+            const char* error_message = "";
+        };
+
+        // Every pipeline built from the shader library. Layouts and render passes are not part of
+        // the set: they do not depend on shader code and outlive hot reloads.
+        struct PipelineSet final
+        {
+            VkPipeline graphics = VK_NULL_HANDLE;
+            VkPipeline selection_mask = VK_NULL_HANDLE;
+            VkPipeline shadow = VK_NULL_HANDLE;
+            VkPipeline indirect = VK_NULL_HANDLE;
+            VkPipeline indirect_shadow = VK_NULL_HANDLE;
+            VkPipeline bloom = VK_NULL_HANDLE;
+            VkPipeline bloom_downsample = VK_NULL_HANDLE;
+            VkPipeline bloom_upsample = VK_NULL_HANDLE;
+            VkPipeline cull = VK_NULL_HANDLE;
+            VkPipeline hiz = VK_NULL_HANDLE;
+            VkPipeline selection_jump_flood = VK_NULL_HANDLE;
+            VkPipeline selection_outline = VK_NULL_HANDLE;
+            VkPipeline pick = VK_NULL_HANDLE;
+        };
+
+        struct ShaderReload final
+        {
+            ShaderLibrary shaders;
+            PipelineSet pipelines;
+            std::size_t compiled_count = 0;
+        };
+
+        // Pipelines replaced by a hot reload, destroyed once no frame in flight can still use them.
+        struct RetiredPipelines final
+        {
+            PipelineSet pipelines;
+            std::size_t frames_left = 0;
+        };
+
+        // A streamed texture rebuilt at another base level by a residency worker; swapped in by the
+        // frame thread once its upload completes.
+        struct StreamedTexture final
+        {
+            GpuTexture* target = nullptr;
+            GpuTexture replacement;
+            bool failed = false;
+        };
+
+        // Image and material sets replaced by texture streaming; the other frame in flight may
+        // still sample them.
+        struct RetiredTexture final
+        {
+            ImageResource image;
+            std::vector<VkDescriptorSet> descriptors;
+            std::size_t frames_left = 0;
+        };
+
+        // Swapchain and frame targets replaced by a resize or a settings change while earlier
+        // frames were still in flight. Destroyed once the fence of `last_frame`, the last frame
+        // submitted before the replacement, has signalled; fences signal in submission order.
+        struct RetiredFrameResources final
+        {
+            uint64_t last_frame = 0;
+            VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+            std::vector<VkFramebuffer> framebuffers;
+            std::vector<VkImageView> image_views;
+            std::vector<ImageResource> images;
+            std::vector<VkDescriptorSet> descriptors;
+#ifdef ROSE_ENABLE_NGX_DLSS
+            NVSDK_NGX_Handle* dlss_feature = nullptr;
+#endif
         };
 
         struct QueuedDrawCall final
@@ -366,10 +757,9 @@ namespace rose::core::vulkan
             const Mesh* mesh = nullptr;
             const omath::opengl_engine::Camera* camera = nullptr;
             VkPipeline pipeline = VK_NULL_HANDLE;
-            std::array<float, 3> outline_color{};
-            float outline_width = 0.0f;
-            float outline_alpha = 0.0f;
-            bool outline_enabled = false;
+            // Drawn into the selection mask instead of the scene.
+            bool selected = false;
+            MeshMobility mobility = MeshMobility::Static;
         };
 
         enum class ShadowPassKind
@@ -378,6 +768,56 @@ namespace rose::core::vulkan
             Sun
         };
 
+        // A queued draw resolved on the frame thread. Recording workers only read these, so they
+        // never touch the residency maps or the per-frame camera state.
+        struct RecordedDraw final
+        {
+            const GpuMesh* gpu_mesh = nullptr;
+            VkPipeline pipeline = VK_NULL_HANDLE;
+            // Null for shadow casters, which do not sample their material.
+            VkDescriptorSet material = VK_NULL_HANDLE;
+            PushConstants push{};
+        };
+
+        enum class IndirectDraws
+        {
+            None,
+            Scene,
+            Shadow
+        };
+
+        // One render pass instance of the frame. Its draws are split into one chunk per recording
+        // slot and every chunk goes into its own secondary command buffer; the first chunk also
+        // records the pass's indirect draws so that draw order is kept.
+        struct RecordingPass final
+        {
+            VkRenderPass render_pass = VK_NULL_HANDLE;
+            VkFramebuffer framebuffer = VK_NULL_HANDLE;
+            VkExtent2D extent{};
+            std::size_t first_draw = 0;
+            std::size_t draw_count = 0;
+            IndirectDraws indirect = IndirectDraws::None;
+            uint32_t indirect_view = 0;
+            PushConstants indirect_push{};
+            std::array<VkCommandBuffer, k_max_recording_slots> command_buffers{};
+        };
+
+        // Secondary command buffers of one recording slot and frame in flight. A slot is used by a
+        // single job at a time, so its pool needs no locking and is reset as a whole every frame.
+        struct RecordingSlot final
+        {
+            VkCommandPool pool = VK_NULL_HANDLE;
+            std::vector<VkCommandBuffer> command_buffers;
+            std::size_t used = 0;
+        };
+
+        // Render passes planned for one shadow map, as indices into the frame's recording passes.
+        struct ShadowPassPlan final
+        {
+            std::array<std::optional<std::size_t>, k_max_sun_cascades> cache_passes{};
+            std::array<std::optional<std::size_t>, k_max_sun_cascades> composite_passes{};
+        };
+
         [[nodiscard]] const char* dlss_quality_label(DlssQuality quality) noexcept
         {
             switch (quality)
@@ -499,6 +939,37 @@ namespace rose::core::vulkan
             }
         }
 
+        [[nodiscard]] VkPresentModeKHR to_vk_present_mode(PresentMode mode) noexcept
+        {
+            switch (mode)
+            {
+            case PresentMode::Immediate:
+                return VK_PRESENT_MODE_IMMEDIATE_KHR;
+            case PresentMode::Mailbox:
+                return VK_PRESENT_MODE_MAILBOX_KHR;
+            case PresentMode::FifoRelaxed:
+                return VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+            case PresentMode::Fifo:
+            default:
+                return VK_PRESENT_MODE_FIFO_KHR;
+            }
+        }
+
+        [[nodiscard]] PresentMode from_vk_present_mode(VkPresentModeKHR mode) noexcept
+        {
+            switch (mode)
+            {
+            case VK_PRESENT_MODE_IMMEDIATE_KHR:
+                return PresentMode::Immediate;
+            case VK_PRESENT_MODE_MAILBOX_KHR:
+                return PresentMode::Mailbox;
+            case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+                return PresentMode::FifoRelaxed;
+            default:
+                return PresentMode::Fifo;
+            }
+        }
+
         [[nodiscard]] const char* physical_device_type_name(VkPhysicalDeviceType type) noexcept
         {
             switch (type)
@@ -572,10 +1043,28 @@ namespace rose::core::vulkan
         VkSurfaceKHR m_surface = VK_NULL_HANDLE;
         VkPhysicalDevice m_physical_device = VK_NULL_HANDLE;
         VkDevice m_device = VK_NULL_HANDLE;
+        std::unique_ptr<DeviceAllocator> m_allocator;
+        std::unique_ptr<UploadManager> m_uploads;
+        std::unique_ptr<GpuProfiler> m_gpu_profiler;
+        std::unique_ptr<PipelineCache> m_pipeline_cache;
+        std::chrono::steady_clock::time_point m_created_at = std::chrono::steady_clock::now();
+        bool m_first_frame_presented = false;
         VkQueue m_graphics_queue = VK_NULL_HANDLE;
         VkQueue m_present_queue = VK_NULL_HANDLE;
+        VkQueue m_transfer_queue = VK_NULL_HANDLE;
         uint32_t m_graphics_queue_family = 0;
         uint32_t m_present_queue_family = 0;
+        uint32_t m_transfer_queue_family = 0;
+        bool m_timeline_semaphore_supported = false;
+        bool m_multi_draw_indirect_supported = false;
+        bool m_draw_indirect_first_instance_supported = false;
+        bool m_draw_indirect_count_supported = false;
+        bool m_depth_clamp_supported = false;
+        bool m_texture_compression_bc_supported = false;
+        bool m_sampler_anisotropy_supported = false;
+        bool m_pipeline_statistics_supported = false;
+        float m_max_sampler_anisotropy = 1.0f;
+        uint32_t m_max_draw_indirect_count = 1;
 
         VkSwapchainKHR m_swapchain = VK_NULL_HANDLE;
         std::vector<VkImage> m_swapchain_images;
@@ -585,39 +1074,85 @@ namespace rose::core::vulkan
         uint32_t m_min_image_count = 2;
         bool m_swapchain_supports_transfer_src = false;
         bool m_swapchain_supports_transfer_dst = false;
+        // VK_KHR_present_id/VK_KHR_present_wait. Ids restart their meaning with every swapchain,
+        // so only ids from m_swapchain_first_present_id on are waited for.
+        bool m_present_wait_supported = false;
+        PFN_vkWaitForPresentKHR m_wait_for_present = nullptr;
+        uint64_t m_present_id = 0;
+        uint64_t m_swapchain_first_present_id = 1;
 
         VkRenderPass m_render_pass = VK_NULL_HANDLE;
         VkRenderPass m_shadow_render_pass = VK_NULL_HANDLE;
+        VkRenderPass m_shadow_composite_render_pass = VK_NULL_HANDLE;
         VkRenderPass m_present_render_pass = VK_NULL_HANDLE;
+        VkRenderPass m_selection_render_pass = VK_NULL_HANDLE;
+        VkRenderPass m_selection_outline_render_pass = VK_NULL_HANDLE;
+        VkRenderPass m_pick_render_pass = VK_NULL_HANDLE;
         VkDescriptorSetLayout m_descriptor_set_layout = VK_NULL_HANDLE;
         VkDescriptorSetLayout m_light_descriptor_set_layout = VK_NULL_HANDLE;
         VkDescriptorSetLayout m_post_descriptor_set_layout = VK_NULL_HANDLE;
+        VkDescriptorSetLayout m_draw_descriptor_set_layout = VK_NULL_HANDLE;
+        VkDescriptorSetLayout m_cull_descriptor_set_layout = VK_NULL_HANDLE;
+        VkDescriptorSetLayout m_hiz_descriptor_set_layout = VK_NULL_HANDLE;
+        VkDescriptorSetLayout m_bloom_pyramid_descriptor_set_layout = VK_NULL_HANDLE;
+        VkDescriptorSetLayout m_selection_descriptor_set_layout = VK_NULL_HANDLE;
         VkPipelineLayout m_pipeline_layout = VK_NULL_HANDLE;
         VkPipelineLayout m_bloom_pipeline_layout = VK_NULL_HANDLE;
+        VkPipelineLayout m_bloom_pyramid_pipeline_layout = VK_NULL_HANDLE;
+        VkPipelineLayout m_cull_pipeline_layout = VK_NULL_HANDLE;
+        VkPipelineLayout m_hiz_pipeline_layout = VK_NULL_HANDLE;
+        VkPipelineLayout m_selection_pipeline_layout = VK_NULL_HANDLE;
         VkPipeline m_graphics_pipeline = VK_NULL_HANDLE;
-        VkPipeline m_outline_pipeline = VK_NULL_HANDLE;
+        VkPipeline m_selection_mask_pipeline = VK_NULL_HANDLE;
         VkPipeline m_shadow_pipeline = VK_NULL_HANDLE;
         VkPipeline m_bloom_pipeline = VK_NULL_HANDLE;
+        VkPipeline m_bloom_downsample_pipeline = VK_NULL_HANDLE;
+        VkPipeline m_bloom_upsample_pipeline = VK_NULL_HANDLE;
+        VkPipeline m_indirect_pipeline = VK_NULL_HANDLE;
+        VkPipeline m_indirect_shadow_pipeline = VK_NULL_HANDLE;
+        VkPipeline m_cull_pipeline = VK_NULL_HANDLE;
+        VkPipeline m_hiz_pipeline = VK_NULL_HANDLE;
+        VkPipeline m_selection_jump_flood_pipeline = VK_NULL_HANDLE;
+        VkPipeline m_selection_outline_pipeline = VK_NULL_HANDLE;
+        VkPipeline m_pick_pipeline = VK_NULL_HANDLE;
+        // The pipelines above are built from m_shaders. Hot reload rebuilds them on
+        // m_residency_pool and swaps them in at the start of a frame.
+        ShaderLibrary m_shaders = ShaderLibrary::embedded();
+        std::future<ShaderReload> m_shader_reload;
+        std::vector<RetiredPipelines> m_retired_pipelines;
+        std::string m_shader_reload_status = "Embedded shaders";
         VkDescriptorPool m_descriptor_pool = VK_NULL_HANDLE;
-        VkDescriptorSet m_bloom_descriptor_set = VK_NULL_HANDLE;
-        VkImageView m_bloom_descriptor_image_view = VK_NULL_HANDLE;
+        VkDescriptorPool m_material_descriptor_pool = VK_NULL_HANDLE;
         VkSampler m_bloom_sampler = VK_NULL_HANDLE;
+        // Shared by all material textures; rebuilt when TextureSettings change.
+        VkSampler m_texture_sampler = VK_NULL_HANDLE;
         VkSampler m_shadow_sampler = VK_NULL_HANDLE;
+        VkSampler m_hiz_sampler = VK_NULL_HANDLE;
         std::array<BufferResource, k_max_frames_in_flight> m_light_buffers{};
         std::array<VkDescriptorSet, k_max_frames_in_flight> m_light_descriptor_sets{};
+        std::array<BufferResource, k_max_frames_in_flight> m_camera_buffers{};
 
         VkCommandPool m_command_pool = VK_NULL_HANDLE;
-        std::vector<VkCommandBuffer> m_command_buffers;
+        std::array<VkCommandBuffer, k_max_frames_in_flight> m_command_buffers{};
         std::vector<VkFramebuffer> m_framebuffers;
         VkFramebuffer m_scene_framebuffer = VK_NULL_HANDLE;
         VkFramebuffer m_shadow_framebuffer = VK_NULL_HANDLE;
-        VkFramebuffer m_sun_shadow_framebuffer = VK_NULL_HANDLE;
+        // One framebuffer and attachment view per sun cascade layer.
+        std::vector<VkFramebuffer> m_sun_shadow_framebuffers;
+        std::vector<VkImageView> m_sun_shadow_layer_views;
         ImageResource m_scene_color_image;
         ImageResource m_motion_vector_image;
         ImageResource m_dlss_output_image;
         ImageResource m_depth_image;
         ImageResource m_shadow_image;
         ImageResource m_sun_shadow_image;
+        ShadowCache m_shadow_cache;
+        std::array<ShadowCache, k_max_sun_cascades> m_sun_shadow_caches{};
+        std::array<ShadowCasters, k_max_sun_cascades> m_shadow_casters{};
+        // Cascade layout of the current sun shadow map; SunSettings changes apply when the render
+        // targets are recreated.
+        uint32_t m_sun_cascade_count = 0;
+        uint32_t m_sun_shadow_resolution = 0;
         VkFormat m_depth_format = VK_FORMAT_UNDEFINED;
         VkFormat m_scene_color_format = VK_FORMAT_R8G8B8A8_UNORM;
         VkFormat m_motion_vector_format = VK_FORMAT_R16G16_SFLOAT;
@@ -625,19 +1160,107 @@ namespace rose::core::vulkan
 
         std::array<FrameSync, k_max_frames_in_flight> m_frames{};
         std::array<ReadbackSlot, k_max_frames_in_flight> m_readback_slots{};
+        std::array<PickSlot, k_max_frames_in_flight> m_pick_slots{};
         std::vector<VkFence> m_images_in_flight;
         std::size_t m_current_frame = 0;
+        // Frame targets are replaced without waiting for the device. Every replacement bumps the
+        // generation; a frame slot rewrites its descriptor sets once it sees a newer one, and the
+        // old targets wait in m_retired_frame_resources until no submitted frame can use them.
+        uint64_t m_submitted_frames = 0;
+        uint64_t m_completed_frames = 0;
+        uint64_t m_frame_targets_generation = 1;
+        std::array<uint64_t, k_max_frames_in_flight> m_frame_descriptor_generations{};
+        std::deque<RetiredFrameResources> m_retired_frame_resources;
+        // The latency profile is applied at the start of a frame, never while one is recorded.
+        LatencyProfile m_latency_profile{};
+        bool m_latency_profile_dirty = false;
+        uint32_t m_frames_in_flight = LatencyProfile{}.frames_in_flight;
+        VkPresentModeKHR m_present_mode = VK_PRESENT_MODE_FIFO_KHR;
+        std::optional<std::chrono::steady_clock::time_point> m_input_sampled_at;
+        std::chrono::steady_clock::time_point m_frame_input_sampled_at{};
+        std::deque<LatencySample> m_pending_latency;
+        std::deque<float> m_latency_ms;
+        bool m_late_latch_enabled = true;
+        const omath::opengl_engine::Camera* m_late_latch_camera = nullptr;
+        std::function<void()> m_late_latch_update;
+        bool m_late_latch_used = false;
+        bool m_frame_view_projection_latched = false;
+        // Input sample to latch, and how far the latch turned the camera, per latched frame.
+        std::deque<float> m_late_latch_ms;
+        std::deque<float> m_late_latch_degrees;
         uint32_t m_active_image_index = 0;
         VkCommandBuffer m_active_command_buffer = VK_NULL_HANDLE;
         bool m_frame_started = false;
-        bool m_shadow_render_pass_active = false;
-        ShadowPassKind m_active_shadow_pass = ShadowPassKind::Spotlight;
         bool m_scene_render_pass_active = false;
         bool m_present_render_pass_active = false;
+        bool m_collecting_draws = false;
         std::vector<QueuedDrawCall> m_queued_draw_calls;
 
+        // Queued draws are resolved into m_recorded_draws, grouped by render pass, and recorded into
+        // secondary command buffers on m_recording_pool. Job N records chunk N of every pass into
+        // slot N of the current frame in flight. The pool is idle during startup and compiles the
+        // pipelines then.
+        ThreadPool m_recording_pool{recording_worker_count()};
+        std::array<std::array<RecordingSlot, k_max_recording_slots>, k_max_frames_in_flight> m_recording_slots{};
+        std::vector<std::future<void>> m_recording_jobs;
+        std::vector<RecordingPass> m_recording_passes;
+        std::vector<RecordedDraw> m_recorded_draws;
+
+        // Draws are recorded once per frame in finish_scene_rendering(). Static arena meshes go
+        // through per-frame DrawData and indirect command buffers; the rest is drawn one by one.
+        bool m_gpu_driven_enabled = true;
+        std::array<FrameDrawBuffers, k_max_frames_in_flight> m_draw_buffers{};
+        std::vector<IndirectBatch> m_scene_batches;
+        std::vector<bool> m_draw_call_indirect;
+        uint32_t m_indirect_draw_count = 0;
+        const omath::opengl_engine::Camera* m_indirect_camera = nullptr;
+        // The cull pass rewrites the commands every frame. Without drawIndirectCount it keeps every
+        // command in place and zeroes instanceCount for culled draws instead of compacting.
+        bool m_gpu_culling_enabled = true;
+        bool m_occlusion_culling_enabled = true;
+        HizPyramid m_hiz;
+        BloomPyramid m_bloom;
+        SelectionOutline m_selection;
+        // The planned selection mask pass of this frame and the widest glow it draws, in pixels.
+        std::optional<std::size_t> m_selection_pass;
+        float m_selection_width_pixels = 0.0f;
+        // A pick waits in m_pick_request until a frame plans it into m_pick_pass; the frame's
+        // PickSlot holds the readback until begin_frame() finds the frame finished.
+        PickTarget m_pick;
+        std::optional<omath::Vector2<float>> m_pick_request;
+        std::optional<std::size_t> m_pick_pass;
+        bool m_pick_recorded = false;
+        std::optional<PickResult> m_pick_result;
+
+        // Mesh resources are built on m_residency_pool and handed to the frame thread through
+        // m_completed_meshes; m_mesh_resources and m_pending_meshes are only touched by the frame
+        // thread. Textures are shared between workers and guarded by m_resource_mutex.
+        ThreadPool m_residency_pool{residency_worker_count()};
+        std::vector<std::future<void>> m_residency_jobs;
+        std::mutex m_resource_mutex;
+        std::condition_variable m_resource_condition;
+        std::unordered_set<const Texture*> m_textures_in_progress;
+        std::vector<std::pair<const Mesh*, GpuMesh>> m_completed_meshes;
+        std::unordered_set<const Mesh*> m_pending_meshes;
         std::unordered_map<const Texture*, GpuTexture> m_texture_resources;
         std::unordered_map<const Mesh*, GpuMesh> m_mesh_resources;
+        // Geometry arena and material cache are shared with residency workers (m_resource_mutex).
+        BufferResource m_arena_vertex_buffer;
+        BufferResource m_arena_index_buffer;
+        RangeAllocator m_arena_vertices;
+        RangeAllocator m_arena_indices;
+        std::map<MaterialKey, GpuMaterial> m_materials;
+        // Texture streaming: workers register textures and queue finished level changes in
+        // m_completed_texture_streams (m_resource_mutex); the rest is frame-thread state.
+        TextureStreamer m_texture_streamer;
+        TextureStreamingSettings m_texture_streaming_settings{};
+        std::vector<StreamedTexture> m_completed_texture_streams;
+        std::vector<StreamedTexture> m_pending_texture_swaps;
+        std::vector<RetiredTexture> m_retired_textures;
+        std::filesystem::path m_texture_cache_directory = texture_cache_directory();
+        uint64_t m_streaming_frame = 0;
+        uint64_t m_texture_budget_bytes = 0;
+        bool m_memory_budget_supported = false;
         GpuTexture m_default_texture;
         GpuTexture m_default_normal_texture;
         GpuTexture m_default_emissive_texture;
@@ -660,8 +1283,9 @@ namespace rose::core::vulkan
         BloomSettings m_bloom_settings{};
         SpotlightSettings m_spotlight_settings{};
         SunSettings m_sun_settings{};
+        TextureSettings m_texture_settings{};
         std::array<float, 16> m_light_view_projection{};
-        std::array<float, 16> m_sun_view_projection{};
+        std::array<std::array<float, 16>, k_max_sun_cascades> m_sun_view_projections{};
 
         std::vector<std::string> m_ngx_instance_extensions;
         std::vector<std::string> m_ngx_device_extensions;
@@ -685,6 +1309,7 @@ namespace rose::core::vulkan
             create_surface();
             pick_physical_device();
             create_logical_device();
+            create_pipeline_cache();
             create_command_pool();
             create_descriptor_pool();
 #ifdef ROSE_ENABLE_NGX_DLSS
@@ -705,19 +1330,49 @@ namespace rose::core::vulkan
             create_render_pass();
             create_descriptor_set_layout();
             create_light_resources();
-            create_graphics_pipeline();
+            create_draw_resources();
+            const auto pipelines_start = std::chrono::steady_clock::now();
+            create_pipeline_layouts();
+            install_pipelines(create_pipelines(m_shaders, true));
+            m_pipeline_cache->save();
+            spdlog::info("Vulkan: pipelines created from {} embedded shaders compaction={}",
+                         m_shaders.size(),
+                         m_draw_indirect_count_supported ? "draw_indirect_count" : "zero_instance_count");
+            spdlog::info("Vulkan: pipelines ready in {} ms (pipeline cache loaded={} KiB)",
+                         elapsed_milliseconds(pipelines_start),
+                         (m_pipeline_cache->loaded_size() + 1023u) / 1024u);
             create_render_targets();
             create_framebuffers();
             create_command_buffers();
             create_sync_objects();
             init_imgui();
-            spdlog::info("Vulkan: renderer initialization completed");
+            create_texture_sampler();
+            create_default_textures();
+            spdlog::info("Vulkan: renderer initialization completed in {} ms", elapsed_milliseconds(m_created_at));
         }
 
         ~Impl()
         {
+            for (std::future<void>& job : m_recording_jobs)
+                job.wait();
+            for (std::future<void>& job : m_residency_jobs)
+                job.wait();
+            m_residency_jobs.clear();
+            if (m_shader_reload.valid())
+            {
+                try
+                {
+                    destroy_pipelines(m_shader_reload.get().pipelines);
+                }
+                catch (const std::exception&)
+                {
+                }
+            }
+            collect_resident_meshes();
+
             if (m_device != VK_NULL_HANDLE)
                 vkDeviceWaitIdle(m_device);
+            destroy_texture_streams();
 
             ImGui_ImplVulkan_Shutdown();
             ImGui_ImplGlfw_Shutdown();
@@ -725,36 +1380,62 @@ namespace rose::core::vulkan
             destroy_gpu_resources();
             cleanup_swapchain();
             destroy_light_resources();
+            destroy_draw_resources();
             shutdown_dlss_sdk();
 
-            if (m_graphics_pipeline != VK_NULL_HANDLE)
-                vkDestroyPipeline(m_device, m_graphics_pipeline, nullptr);
-            if (m_outline_pipeline != VK_NULL_HANDLE)
-                vkDestroyPipeline(m_device, m_outline_pipeline, nullptr);
-            if (m_shadow_pipeline != VK_NULL_HANDLE)
-                vkDestroyPipeline(m_device, m_shadow_pipeline, nullptr);
-            if (m_bloom_pipeline != VK_NULL_HANDLE)
-                vkDestroyPipeline(m_device, m_bloom_pipeline, nullptr);
+            destroy_pipelines(installed_pipelines());
+            for (const RetiredPipelines& retired : m_retired_pipelines)
+                destroy_pipelines(retired.pipelines);
             if (m_pipeline_layout != VK_NULL_HANDLE)
                 vkDestroyPipelineLayout(m_device, m_pipeline_layout, nullptr);
             if (m_bloom_pipeline_layout != VK_NULL_HANDLE)
                 vkDestroyPipelineLayout(m_device, m_bloom_pipeline_layout, nullptr);
+            if (m_cull_pipeline_layout != VK_NULL_HANDLE)
+                vkDestroyPipelineLayout(m_device, m_cull_pipeline_layout, nullptr);
+            if (m_hiz_pipeline_layout != VK_NULL_HANDLE)
+                vkDestroyPipelineLayout(m_device, m_hiz_pipeline_layout, nullptr);
+            if (m_bloom_pyramid_pipeline_layout != VK_NULL_HANDLE)
+                vkDestroyPipelineLayout(m_device, m_bloom_pyramid_pipeline_layout, nullptr);
+            if (m_selection_pipeline_layout != VK_NULL_HANDLE)
+                vkDestroyPipelineLayout(m_device, m_selection_pipeline_layout, nullptr);
             if (m_descriptor_set_layout != VK_NULL_HANDLE)
                 vkDestroyDescriptorSetLayout(m_device, m_descriptor_set_layout, nullptr);
             if (m_light_descriptor_set_layout != VK_NULL_HANDLE)
                 vkDestroyDescriptorSetLayout(m_device, m_light_descriptor_set_layout, nullptr);
             if (m_post_descriptor_set_layout != VK_NULL_HANDLE)
                 vkDestroyDescriptorSetLayout(m_device, m_post_descriptor_set_layout, nullptr);
+            if (m_draw_descriptor_set_layout != VK_NULL_HANDLE)
+                vkDestroyDescriptorSetLayout(m_device, m_draw_descriptor_set_layout, nullptr);
+            if (m_cull_descriptor_set_layout != VK_NULL_HANDLE)
+                vkDestroyDescriptorSetLayout(m_device, m_cull_descriptor_set_layout, nullptr);
+            if (m_hiz_descriptor_set_layout != VK_NULL_HANDLE)
+                vkDestroyDescriptorSetLayout(m_device, m_hiz_descriptor_set_layout, nullptr);
+            if (m_bloom_pyramid_descriptor_set_layout != VK_NULL_HANDLE)
+                vkDestroyDescriptorSetLayout(m_device, m_bloom_pyramid_descriptor_set_layout, nullptr);
+            if (m_selection_descriptor_set_layout != VK_NULL_HANDLE)
+                vkDestroyDescriptorSetLayout(m_device, m_selection_descriptor_set_layout, nullptr);
             if (m_bloom_sampler != VK_NULL_HANDLE)
                 vkDestroySampler(m_device, m_bloom_sampler, nullptr);
+            if (m_texture_sampler != VK_NULL_HANDLE)
+                vkDestroySampler(m_device, m_texture_sampler, nullptr);
             if (m_shadow_sampler != VK_NULL_HANDLE)
                 vkDestroySampler(m_device, m_shadow_sampler, nullptr);
+            if (m_hiz_sampler != VK_NULL_HANDLE)
+                vkDestroySampler(m_device, m_hiz_sampler, nullptr);
             if (m_shadow_render_pass != VK_NULL_HANDLE)
                 vkDestroyRenderPass(m_device, m_shadow_render_pass, nullptr);
+            if (m_shadow_composite_render_pass != VK_NULL_HANDLE)
+                vkDestroyRenderPass(m_device, m_shadow_composite_render_pass, nullptr);
             if (m_render_pass != VK_NULL_HANDLE)
                 vkDestroyRenderPass(m_device, m_render_pass, nullptr);
             if (m_present_render_pass != VK_NULL_HANDLE)
                 vkDestroyRenderPass(m_device, m_present_render_pass, nullptr);
+            if (m_selection_render_pass != VK_NULL_HANDLE)
+                vkDestroyRenderPass(m_device, m_selection_render_pass, nullptr);
+            if (m_selection_outline_render_pass != VK_NULL_HANDLE)
+                vkDestroyRenderPass(m_device, m_selection_outline_render_pass, nullptr);
+            if (m_pick_render_pass != VK_NULL_HANDLE)
+                vkDestroyRenderPass(m_device, m_pick_render_pass, nullptr);
 
             for (FrameSync& frame : m_frames)
             {
@@ -766,10 +1447,24 @@ namespace rose::core::vulkan
                     vkDestroyFence(m_device, frame.in_flight, nullptr);
             }
 
+            for (std::array<RecordingSlot, k_max_recording_slots>& slots : m_recording_slots)
+            {
+                for (RecordingSlot& slot : slots)
+                {
+                    if (slot.pool != VK_NULL_HANDLE)
+                        vkDestroyCommandPool(m_device, slot.pool, nullptr);
+                }
+            }
             if (m_command_pool != VK_NULL_HANDLE)
                 vkDestroyCommandPool(m_device, m_command_pool, nullptr);
+            if (m_material_descriptor_pool != VK_NULL_HANDLE)
+                vkDestroyDescriptorPool(m_device, m_material_descriptor_pool, nullptr);
             if (m_descriptor_pool != VK_NULL_HANDLE)
                 vkDestroyDescriptorPool(m_device, m_descriptor_pool, nullptr);
+            m_pipeline_cache.reset();
+            m_gpu_profiler.reset();
+            m_uploads.reset();
+            m_allocator.reset();
             if (m_device != VK_NULL_HANDLE)
                 vkDestroyDevice(m_device, nullptr);
             if (m_surface != VK_NULL_HANDLE)
@@ -778,47 +1473,32 @@ namespace rose::core::vulkan
                 vkDestroyInstance(m_instance, nullptr);
         }
 
-        void begin_shadow_render_pass(ShadowPassKind pass_kind)
+        [[nodiscard]] uint32_t shadow_map_size(ShadowPassKind pass_kind) const noexcept
+        {
+            return pass_kind == ShadowPassKind::Sun ? m_sun_shadow_resolution : k_shadow_map_size;
+        }
+
+        // Shadow and scene passes are recorded into secondary command buffers; the primary buffer
+        // only begins the pass and executes them.
+        void begin_shadow_render_pass(const RecordingPass& pass)
         {
             const VkClearValue clear_value{.depthStencil = {1.0f, 0}};
-            const VkFramebuffer framebuffer = pass_kind == ShadowPassKind::Sun
-                ? m_sun_shadow_framebuffer
-                : m_shadow_framebuffer;
 
             VkRenderPassBeginInfo render_pass_info{};
             render_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-            render_pass_info.renderPass = m_shadow_render_pass;
-            render_pass_info.framebuffer = framebuffer;
+            render_pass_info.renderPass = pass.render_pass;
+            render_pass_info.framebuffer = pass.framebuffer;
             render_pass_info.renderArea.offset = {0, 0};
-            render_pass_info.renderArea.extent = {k_shadow_map_size, k_shadow_map_size};
+            render_pass_info.renderArea.extent = pass.extent;
             render_pass_info.clearValueCount = 1;
             render_pass_info.pClearValues = &clear_value;
 
-            vkCmdBeginRenderPass(m_active_command_buffer, &render_pass_info, VK_SUBPASS_CONTENTS_INLINE);
-            vkCmdBindPipeline(m_active_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_shadow_pipeline);
-
-            VkViewport viewport{};
-            viewport.x = 0.0f;
-            viewport.y = 0.0f;
-            viewport.width = static_cast<float>(k_shadow_map_size);
-            viewport.height = static_cast<float>(k_shadow_map_size);
-            viewport.minDepth = 0.0f;
-            viewport.maxDepth = 1.0f;
-            vkCmdSetViewport(m_active_command_buffer, 0, 1, &viewport);
-
-            const VkRect2D scissor{{0, 0}, {k_shadow_map_size, k_shadow_map_size}};
-            vkCmdSetScissor(m_active_command_buffer, 0, 1, &scissor);
-
-            m_shadow_render_pass_active = true;
-            m_active_shadow_pass = pass_kind;
-            m_scene_render_pass_active = false;
-            if (pass_kind == ShadowPassKind::Sun)
-                m_sun_shadow_image.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-            else
-                m_shadow_image.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+            vkCmdBeginRenderPass(m_active_command_buffer,
+                                 &render_pass_info,
+                                 VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
         }
 
-        void begin_scene_render_pass()
+        void begin_scene_render_pass(const RecordingPass& pass)
         {
             const std::array<VkClearValue, 3> clear_values{
                 VkClearValue{.color = {{0.3f, 0.3f, 0.3f, 1.0f}}},
@@ -828,38 +1508,55 @@ namespace rose::core::vulkan
 
             VkRenderPassBeginInfo render_pass_info{};
             render_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-            render_pass_info.renderPass = m_render_pass;
-            render_pass_info.framebuffer = m_scene_framebuffer;
+            render_pass_info.renderPass = pass.render_pass;
+            render_pass_info.framebuffer = pass.framebuffer;
             render_pass_info.renderArea.offset = {0, 0};
-            render_pass_info.renderArea.extent = m_scene_extent;
+            render_pass_info.renderArea.extent = pass.extent;
             render_pass_info.clearValueCount = static_cast<uint32_t>(clear_values.size());
             render_pass_info.pClearValues = clear_values.data();
 
-            vkCmdBeginRenderPass(m_active_command_buffer, &render_pass_info, VK_SUBPASS_CONTENTS_INLINE);
-            vkCmdBindPipeline(m_active_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphics_pipeline);
+            vkCmdBeginRenderPass(m_active_command_buffer,
+                                 &render_pass_info,
+                                 VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+            m_scene_render_pass_active = true;
+        }
 
-            VkViewport viewport{};
-            viewport.x = 0.0f;
-            viewport.y = 0.0f;
-            viewport.width = static_cast<float>(m_scene_extent.width);
-            viewport.height = static_cast<float>(m_scene_extent.height);
-            viewport.minDepth = 0.0f;
-            viewport.maxDepth = 1.0f;
-            vkCmdSetViewport(m_active_command_buffer, 0, 1, &viewport);
-
-            const VkRect2D scissor{{0, 0}, m_scene_extent};
-            vkCmdSetScissor(m_active_command_buffer, 0, 1, &scissor);
-
-            m_scene_render_pass_active = true;
-            m_frame_view_projection_set = false;
+        void execute_recording_pass(const RecordingPass& pass) const
+        {
+            std::array<VkCommandBuffer, k_max_recording_slots> command_buffers{};
+            uint32_t command_buffer_count = 0;
+            for (const VkCommandBuffer command_buffer : pass.command_buffers)
+            {
+                if (command_buffer != VK_NULL_HANDLE)
+                    command_buffers[command_buffer_count++] = command_buffer;
+            }
+            if (command_buffer_count > 0)
+                vkCmdExecuteCommands(m_active_command_buffer, command_buffer_count, command_buffers.data());
         }
 
         [[nodiscard]] bool begin_frame()
         {
+            ROSE_PROFILE_ZONE("Renderer::begin_frame");
+            m_frame_input_sampled_at = m_input_sampled_at.value_or(std::chrono::steady_clock::now());
+            m_input_sampled_at.reset();
+            if (m_latency_profile_dirty)
+                apply_latency_profile();
+
             FrameSync& frame = m_frames[m_current_frame];
-            check_vk(vkWaitForFences(m_device, 1, &frame.in_flight, VK_TRUE, UINT64_MAX), "Failed to wait for frame fence");
+            {
+                ROSE_PROFILE_ZONE("Wait for frame fence");
+                check_vk(vkWaitForFences(m_device, 1, &frame.in_flight, VK_TRUE, UINT64_MAX), "Failed to wait for frame fence");
+            }
+            m_completed_frames = std::max(m_completed_frames, frame.submitted_frame);
+            collect_retired_frame_resources();
+            collect_latency_samples();
             collect_completed_readback(m_current_frame);
+            collect_completed_pick(m_current_frame);
+            m_uploads->collect();
+            collect_resident_meshes();
+            update_texture_streaming();
             m_queued_draw_calls.clear();
+            collect_shader_reload();
 
             VkResult result = vkAcquireNextImageKHR(
                 m_device, m_swapchain, UINT64_MAX, frame.image_available, VK_NULL_HANDLE, &m_active_image_index);
@@ -877,652 +1574,1944 @@ namespace rose::core::vulkan
             m_images_in_flight[m_active_image_index] = frame.in_flight;
 
             check_vk(vkResetFences(m_device, 1, &frame.in_flight), "Failed to reset frame fence");
+            update_frame_descriptors(m_current_frame);
 
-            m_active_command_buffer = m_command_buffers[m_active_image_index];
+            m_active_command_buffer = m_command_buffers[m_current_frame];
             check_vk(vkResetCommandBuffer(m_active_command_buffer, 0), "Failed to reset command buffer");
 
             VkCommandBufferBeginInfo begin_info{};
             begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
             check_vk(vkBeginCommandBuffer(m_active_command_buffer, &begin_info), "Failed to begin command buffer");
-            update_light_buffer(m_current_frame);
-            begin_shadow_render_pass(ShadowPassKind::Spotlight);
+            m_gpu_profiler->begin_frame(m_active_command_buffer, static_cast<uint32_t>(m_current_frame));
 
             m_frame_started = true;
+            m_collecting_draws = true;
             m_present_render_pass_active = false;
             return true;
         }
 
-        void draw_mesh(const Mesh& mesh, const omath::opengl_engine::Camera& camera)
+        void draw_mesh(const Mesh& mesh, const omath::opengl_engine::Camera& camera, MeshMobility mobility)
         {
-            draw_mesh_with_pipeline(mesh, camera, m_graphics_pipeline, {}, 0.0f, 0.0f, false);
+            draw_mesh_with_pipeline(mesh, camera, m_graphics_pipeline, false, mobility);
         }
 
+        // Only marks the mesh for the selection mask; the glow itself is drawn once per frame for
+        // every selected mesh together.
         void draw_mesh_outline(const Mesh& mesh, const omath::opengl_engine::Camera& camera)
         {
-            const int pass_count = std::clamp(m_selection_outline_settings.smoothing_quality, 1, 64);
-            const float width = std::clamp(m_selection_outline_settings.width, 0.0f, 2.0f);
+            draw_mesh_with_pipeline(mesh, camera, m_selection_mask_pipeline, true);
+        }
 
-            if (pass_count == 1)
-            {
-                draw_mesh_with_pipeline(mesh,
-                                        camera,
-                                        m_outline_pipeline,
-                                        m_selection_outline_settings.color,
-                                        width,
-                                        0.85f,
-                                        true);
-                return;
-            }
+        void request_pick(const omath::Vector2<float>& screen_position)
+        {
+            m_pick_request = screen_position;
+        }
 
-            for (int pass = pass_count - 1; pass >= 0; --pass)
-            {
-                const float inner_t = static_cast<float>(pass_count - 1 - pass)
-                                    / static_cast<float>(pass_count - 1);
-                const float width_t = static_cast<float>(pass + 1) / static_cast<float>(pass_count);
-                const float alpha = 0.12f + (0.85f - 0.12f) * inner_t * inner_t;
-                draw_mesh_with_pipeline(mesh,
-                                        camera,
-                                        m_outline_pipeline,
-                                        m_selection_outline_settings.color,
-                                        width * width_t,
-                                        alpha,
-                                        true);
-            }
+        [[nodiscard]] std::optional<PickResult> take_pick_result()
+        {
+            return std::exchange(m_pick_result, std::nullopt);
         }
 
         void draw_mesh_with_pipeline(const Mesh& mesh,
                                      const omath::opengl_engine::Camera& camera,
                                      VkPipeline pipeline,
-                                     const std::array<float, 3>& outline_color,
-                                     float outline_width,
-                                     float outline_alpha,
-                                     bool outline_enabled)
+                                     bool selected,
+                                     MeshMobility mobility = MeshMobility::Static)
         {
             if (!m_frame_started)
                 throw VulkanError("draw_mesh() called outside a frame");
+            if (!m_collecting_draws)
+                throw VulkanError("draw_mesh() called after scene rendering finished");
 
-            GpuMesh& gpu_mesh = ensure_mesh_resource(mesh);
-            if (gpu_mesh.index_count == 0)
-                return;
-
-            if (m_shadow_render_pass_active)
-            {
-                if (!outline_enabled)
-                    draw_shadow_mesh(mesh, gpu_mesh);
-                m_queued_draw_calls.push_back({&mesh,
-                                               &camera,
-                                               pipeline,
-                                               outline_color,
-                                               outline_width,
-                                               outline_alpha,
-                                               outline_enabled});
+            if (resident_mesh(mesh) == nullptr)
                 return;
-            }
 
-            draw_scene_mesh_with_pipeline(mesh,
-                                          camera,
-                                          gpu_mesh,
-                                          pipeline,
-                                          outline_color,
-                                          outline_width,
-                                          outline_alpha,
-                                          outline_enabled);
+            m_queued_draw_calls.push_back({&mesh, &camera, pipeline, selected, mobility});
         }
 
-        void draw_shadow_mesh(const Mesh& mesh, const GpuMesh& gpu_mesh)
+        void bind_mesh_geometry(VkCommandBuffer command_buffer, const GpuMesh& gpu_mesh) const
         {
-            vkCmdBindPipeline(m_active_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_shadow_pipeline);
-
-            const VkBuffer vertex_buffers[] = {gpu_mesh.vertex_buffer.buffer};
+            const VkBuffer vertex_buffers[] = {
+                gpu_mesh.in_arena ? m_arena_vertex_buffer.buffer : gpu_mesh.vertex_buffer.buffer
+            };
             const VkDeviceSize offsets[] = {0};
-            vkCmdBindVertexBuffers(m_active_command_buffer, 0, 1, vertex_buffers, offsets);
-            vkCmdBindIndexBuffer(m_active_command_buffer, gpu_mesh.index_buffer.buffer, 0, VK_INDEX_TYPE_UINT32);
-            vkCmdBindDescriptorSets(m_active_command_buffer,
-                                    VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                    m_pipeline_layout,
-                                    1,
-                                    1,
-                                    &m_light_descriptor_sets[m_current_frame],
-                                    0,
-                                    nullptr);
-
-            PushConstants push{};
-            const auto model = mesh.cpu_mesh().get_to_world_matrix().raw_array();
-            const std::array<float, 16>& shadow_view_projection =
-                m_active_shadow_pass == ShadowPassKind::Sun ? m_sun_view_projection : m_light_view_projection;
-            std::memcpy(push.view_projection, shadow_view_projection.data(), sizeof(push.view_projection));
-            std::memcpy(push.model, model.data(), sizeof(push.model));
-            std::memcpy(push.previous_view_projection,
-                        shadow_view_projection.data(),
-                        sizeof(push.previous_view_projection));
-            vkCmdPushConstants(m_active_command_buffer,
-                               m_pipeline_layout,
-                               VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                               0,
-                               sizeof(PushConstants),
-                               &push);
-
-            vkCmdDrawIndexed(m_active_command_buffer, gpu_mesh.index_count, 1, 0, 0, 0);
+            vkCmdBindVertexBuffers(command_buffer, 0, 1, vertex_buffers, offsets);
+            vkCmdBindIndexBuffer(command_buffer,
+                                 gpu_mesh.in_arena ? m_arena_index_buffer.buffer : gpu_mesh.index_buffer.buffer,
+                                 0,
+                                 VK_INDEX_TYPE_UINT32);
         }
 
-        void draw_scene_mesh_with_pipeline(const Mesh& mesh,
-                                           const omath::opengl_engine::Camera& camera,
-                                           const GpuMesh& gpu_mesh,
-                                           VkPipeline pipeline,
-                                           const std::array<float, 3>& outline_color,
-                                           float outline_width,
-                                           float outline_alpha,
-                                           bool outline_enabled)
+        void bind_arena_geometry(VkCommandBuffer command_buffer) const
         {
-            if (!m_scene_render_pass_active)
-                throw VulkanError("draw_mesh() called after scene rendering finished");
-
-            vkCmdBindPipeline(m_active_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
-
-            const VkBuffer vertex_buffers[] = {gpu_mesh.vertex_buffer.buffer};
+            const VkBuffer vertex_buffers[] = {m_arena_vertex_buffer.buffer};
             const VkDeviceSize offsets[] = {0};
-            vkCmdBindVertexBuffers(m_active_command_buffer, 0, 1, vertex_buffers, offsets);
-            vkCmdBindIndexBuffer(m_active_command_buffer, gpu_mesh.index_buffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+            vkCmdBindVertexBuffers(command_buffer, 0, 1, vertex_buffers, offsets);
+            vkCmdBindIndexBuffer(command_buffer, m_arena_index_buffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+        }
+
+        // Binds the light and draw-data sets shared by every draw of the frame.
+        void bind_frame_descriptor_sets(VkCommandBuffer command_buffer) const
+        {
             const std::array<VkDescriptorSet, 2> descriptor_sets{
-                gpu_mesh.descriptor,
-                m_light_descriptor_sets[m_current_frame]
+                m_light_descriptor_sets[m_current_frame],
+                m_draw_buffers[m_current_frame].descriptor
             };
-            vkCmdBindDescriptorSets(m_active_command_buffer,
+            vkCmdBindDescriptorSets(command_buffer,
                                     VK_PIPELINE_BIND_POINT_GRAPHICS,
                                     m_pipeline_layout,
-                                    0,
+                                    1,
                                     static_cast<uint32_t>(descriptor_sets.size()),
                                     descriptor_sets.data(),
                                     0,
                                     nullptr);
+        }
+
+        [[nodiscard]] const std::array<float, 16>& shadow_view_projection(ShadowPassKind pass_kind,
+                                                                          uint32_t layer) const noexcept
+        {
+            return pass_kind == ShadowPassKind::Sun ? m_sun_view_projections[layer] : m_light_view_projection;
+        }
+
+        [[nodiscard]] static PushConstants shadow_push_constants(const std::array<float, 16>& view_projection)
+        {
+            PushConstants push{};
+            std::memcpy(push.view_projection, view_projection.data(), sizeof(push.view_projection));
+            std::memcpy(push.previous_view_projection, view_projection.data(), sizeof(push.previous_view_projection));
+            return push;
+        }
 
+        // Camera-dependent part of the scene push constants; the first camera of the frame also
+        // defines the view-projection used for next frame's motion vectors.
+        [[nodiscard]] PushConstants scene_push_constants(const omath::opengl_engine::Camera& camera)
+        {
             PushConstants push{};
+            const bool latched = m_late_latch_enabled && &camera == m_late_latch_camera;
             const auto vp = camera.get_view_projection_matrix().raw_array();
-            const auto model = mesh.cpu_mesh().get_to_world_matrix().raw_array();
             if (!m_frame_view_projection_set)
             {
                 std::copy(vp.begin(), vp.end(), m_frame_view_projection.begin());
                 m_frame_view_projection_set = true;
+                m_frame_view_projection_latched = latched;
+            }
+            if (latched)
+            {
+                push.camera_latched = 1;
+                m_late_latch_used = true;
             }
 
             std::memcpy(push.view_projection, vp.data(), sizeof(push.view_projection));
-            std::memcpy(push.model, model.data(), sizeof(push.model));
             const std::array<float, 16>& previous_vp =
                 m_previous_view_projection_valid ? m_previous_view_projection : m_frame_view_projection;
             std::memcpy(push.previous_view_projection, previous_vp.data(), sizeof(push.previous_view_projection));
             const omath::Vector3<float>& camera_origin = camera.get_origin();
-            const omath::Vector3<float>& aux_position = outline_enabled ? gpu_mesh.local_center : camera_origin;
-            push.outline_center[0] = aux_position.x;
-            push.outline_center[1] = aux_position.y;
-            push.outline_center[2] = aux_position.z;
-            push.outline_width = outline_width;
-            push.outline_color[0] = outline_color[0];
-            push.outline_color[1] = outline_color[1];
-            push.outline_color[2] = outline_color[2];
-            push.outline_alpha = outline_alpha;
-            push.outline_enabled = outline_enabled ? 1 : 0;
-            vkCmdPushConstants(m_active_command_buffer,
-                               m_pipeline_layout,
-                               VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                               0,
-                               sizeof(PushConstants),
-                               &push);
-
-            vkCmdDrawIndexed(m_active_command_buffer, gpu_mesh.index_count, 1, 0, 0, 0);
+            push.camera_position[0] = camera_origin.x;
+            push.camera_position[1] = camera_origin.y;
+            push.camera_position[2] = camera_origin.z;
+            return push;
         }
 
-        void render_imgui(ImDrawData* draw_data)
+        [[nodiscard]] PushConstants scene_draw_push_constants(const QueuedDrawCall& draw_call)
         {
-            if (!m_frame_started)
-                throw VulkanError("render_imgui() called outside a frame");
-            finish_scene_rendering();
-            ImGui_ImplVulkan_RenderDrawData(draw_data, m_active_command_buffer);
+            PushConstants push = scene_push_constants(*draw_call.camera);
+            const auto model = draw_call.mesh->cpu_mesh().get_to_world_matrix().raw_array();
+            std::memcpy(push.model, model.data(), sizeof(push.model));
+            return push;
         }
 
-        [[nodiscard]] std::optional<CapturedFrame> end_frame(bool capture_screenshot)
+        // Records resolved draws, rebinding only the state that differs from the previous draw.
+        void record_draws(VkCommandBuffer command_buffer, std::size_t first_draw, std::size_t draw_count) const
         {
-            if (!m_frame_started)
-                return std::nullopt;
-
-            std::optional<CapturedFrame> screenshot = std::move(m_completed_stream_frame);
-            m_completed_stream_frame.reset();
-
-            ReadbackSlot* readback_slot = nullptr;
-            const bool can_capture = capture_screenshot && m_swapchain_supports_transfer_src;
-            if (can_capture)
-            {
-                const VkDeviceSize image_size = static_cast<VkDeviceSize>(m_swapchain_extent.width)
-                                              * static_cast<VkDeviceSize>(m_swapchain_extent.height)
-                                              * 4u;
-                readback_slot = &m_readback_slots[m_current_frame];
-                ensure_readback_slot(*readback_slot, image_size);
-                readback_slot->extent = m_swapchain_extent;
-                readback_slot->format = m_swapchain_image_format;
-            }
+            if (draw_count == 0)
+                return;
 
-            finish_scene_rendering();
-            if (m_present_render_pass_active)
+            bind_frame_descriptor_sets(command_buffer);
+            VkPipeline bound_pipeline = VK_NULL_HANDLE;
+            VkBuffer bound_vertex_buffer = VK_NULL_HANDLE;
+            VkDescriptorSet bound_material = VK_NULL_HANDLE;
+            for (std::size_t i = first_draw; i < first_draw + draw_count; ++i)
             {
-                vkCmdEndRenderPass(m_active_command_buffer);
-                m_present_render_pass_active = false;
-            }
-
-            if (readback_slot != nullptr)
-                record_screenshot_copy(readback_slot->buffer);
-
-            check_vk(vkEndCommandBuffer(m_active_command_buffer), "Failed to end command buffer");
-
-            FrameSync& frame = m_frames[m_current_frame];
-            const VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_TRANSFER_BIT
-                                                  | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-
-            VkSubmitInfo submit_info{};
-            submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-            submit_info.waitSemaphoreCount = 1;
-            submit_info.pWaitSemaphores = &frame.image_available;
-            submit_info.pWaitDstStageMask = &wait_stage;
-            submit_info.commandBufferCount = 1;
-            submit_info.pCommandBuffers = &m_active_command_buffer;
-            submit_info.signalSemaphoreCount = 1;
-            submit_info.pSignalSemaphores = &frame.render_finished;
-            check_vk(vkQueueSubmit(m_graphics_queue, 1, &submit_info, frame.in_flight), "Failed to submit draw command buffer");
-
-            if (readback_slot != nullptr)
-                readback_slot->pending = true;
+                const RecordedDraw& draw = m_recorded_draws[i];
+                const GpuMesh& gpu_mesh = *draw.gpu_mesh;
+                if (draw.pipeline != bound_pipeline)
+                {
+                    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, draw.pipeline);
+                    bound_pipeline = draw.pipeline;
+                }
 
-            VkPresentInfoKHR present_info{};
-            present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-            present_info.waitSemaphoreCount = 1;
-            present_info.pWaitSemaphores = &frame.render_finished;
-            present_info.swapchainCount = 1;
-            present_info.pSwapchains = &m_swapchain;
-            present_info.pImageIndices = &m_active_image_index;
+                const VkBuffer vertex_buffer =
+                    gpu_mesh.in_arena ? m_arena_vertex_buffer.buffer : gpu_mesh.vertex_buffer.buffer;
+                if (vertex_buffer != bound_vertex_buffer)
+                {
+                    bind_mesh_geometry(command_buffer, gpu_mesh);
+                    bound_vertex_buffer = vertex_buffer;
+                }
 
-            const VkResult result = vkQueuePresentKHR(m_present_queue, &present_info);
-            if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
-                recreate_swapchain();
-            else if (result != VK_SUCCESS)
-                check_vk(result, "Failed to present swapchain image");
+                if (draw.material != VK_NULL_HANDLE && draw.material != bound_material)
+                {
+                    vkCmdBindDescriptorSets(command_buffer,
+                                            VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                            m_pipeline_layout,
+                                            0,
+                                            1,
+                                            &draw.material,
+                                            0,
+                                            nullptr);
+                    bound_material = draw.material;
+                }
 
-            m_current_frame = (m_current_frame + 1u) % static_cast<std::size_t>(k_max_frames_in_flight);
-            m_active_command_buffer = VK_NULL_HANDLE;
-            m_frame_started = false;
-            if (m_frame_view_projection_set)
-            {
-                m_previous_view_projection = m_frame_view_projection;
-                m_previous_view_projection_valid = true;
-                m_frame_view_projection_set = false;
+                vkCmdPushConstants(command_buffer,
+                                   m_pipeline_layout,
+                                   VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                                   0,
+                                   sizeof(PushConstants),
+                                   &draw.push);
+                vkCmdDrawIndexed(command_buffer,
+                                 gpu_mesh.index_count,
+                                 1,
+                                 gpu_mesh.first_index,
+                                 gpu_mesh.vertex_offset,
+                                 0);
             }
-            return screenshot;
         }
 
-        void wait_idle() const
+        [[nodiscard]] bool gpu_driven_supported() const noexcept
         {
-            check_vk(vkDeviceWaitIdle(m_device), "Failed to wait for Vulkan device");
+            return m_draw_indirect_first_instance_supported;
         }
 
-        [[nodiscard]] omath::Vector2<int> framebuffer_size() const
+        [[nodiscard]] bool gpu_culling_active() const noexcept
         {
-            return {
-                static_cast<int>(m_swapchain_extent.width),
-                static_cast<int>(m_swapchain_extent.height)
-            };
+            return m_gpu_culling_enabled && m_gpu_driven_enabled && gpu_driven_supported();
         }
 
-        [[nodiscard]] bool dlss_available() const
+        void set_occlusion_culling_enabled(bool enabled)
         {
-#ifdef ROSE_ENABLE_NGX_DLSS
-            return m_ngx_available
-                || (!m_ngx_init_attempted && !m_ngx_disabled_by_env && m_ngx_extensions_available);
-#else
-            return false;
-#endif
+            m_occlusion_culling_enabled = enabled;
+            m_hiz.valid = false;
         }
 
-        [[nodiscard]] bool dlss_active() const
+        // Compacted commands need vkCmdDrawIndexedIndirectCount; otherwise every draw keeps its slot.
+        [[nodiscard]] bool compact_indirect_draws() const noexcept
         {
-#ifdef ROSE_ENABLE_NGX_DLSS
-            return m_dlss_requested
-                && m_ngx_available
-                && m_ngx_dlss_handle != nullptr;
-#else
-            return false;
-#endif
+            return m_draw_indirect_count_supported
+                && m_multi_draw_indirect_supported
+                && m_indirect_draw_count <= m_max_draw_indirect_count;
         }
 
-        [[nodiscard]] VkExtent2D choose_scene_extent()
+        // Writes DrawData for every queued draw that can be batched: opaque arena meshes seen
+        // through the frame's first camera, sorted by material so that each material is one
+        // contiguous run. The indirect commands themselves are written by the cull pass.
+        [[nodiscard]] bool build_indirect_draws()
         {
-            VkExtent2D extent = m_swapchain_extent;
-#ifdef ROSE_ENABLE_NGX_DLSS
-            release_dlss_feature();
-            if (!m_dlss_requested || !m_ngx_available || m_ngx_parameters == nullptr)
-                return extent;
+            m_scene_batches.clear();
+            m_indirect_draw_count = 0;
+            m_indirect_camera = nullptr;
+            m_draw_call_indirect.assign(m_queued_draw_calls.size(), false);
+            if (!m_gpu_driven_enabled || !gpu_driven_supported())
+                return false;
 
-            unsigned int optimal_width = m_swapchain_extent.width;
-            unsigned int optimal_height = m_swapchain_extent.height;
-            unsigned int max_width = optimal_width;
-            unsigned int max_height = optimal_height;
-            unsigned int min_width = optimal_width;
-            unsigned int min_height = optimal_height;
-            float sharpness = 0.0f;
-            const NVSDK_NGX_Result settings_result = NGX_DLSS_GET_OPTIMAL_SETTINGS(m_ngx_parameters,
-                                                                                   m_swapchain_extent.width,
-                                                                                   m_swapchain_extent.height,
-                                                                                   to_ngx_quality(m_dlss_quality),
-                                                                                   &optimal_width,
-                                                                                   &optimal_height,
-                                                                                   &max_width,
-                                                                                   &max_height,
-                                                                                   &min_width,
-                                                                                   &min_height,
-                                                                                   &sharpness);
-            if (NVSDK_NGX_FAILED(settings_result) || optimal_width == 0 || optimal_height == 0)
+            std::vector<std::pair<const GpuMesh*, std::size_t>> eligible;
+            eligible.reserve(m_queued_draw_calls.size());
+            for (std::size_t i = 0; i < m_queued_draw_calls.size(); ++i)
             {
-                m_dlss_status = std::string("DLSS settings query failed: ") + ngx_result_name(settings_result);
-                return extent;
+                const QueuedDrawCall& draw_call = m_queued_draw_calls[i];
+                if (draw_call.mesh == nullptr
+                    || draw_call.camera == nullptr
+                    || draw_call.selected
+                    || draw_call.pipeline != m_graphics_pipeline)
+                    continue;
+
+                const GpuMesh* gpu_mesh = resident_mesh(*draw_call.mesh);
+                if (gpu_mesh == nullptr || !gpu_mesh->in_arena)
+                    continue;
+                if (m_indirect_camera == nullptr)
+                    m_indirect_camera = draw_call.camera;
+                if (draw_call.camera != m_indirect_camera)
+                    continue;
+                eligible.emplace_back(gpu_mesh, i);
             }
+            if (eligible.empty())
+                return false;
 
-            extent.width = optimal_width;
-            extent.height = optimal_height;
-            m_dlss_sharpness = sharpness;
-            if (!create_dlss_feature(extent))
+            std::stable_sort(eligible.begin(),
+                             eligible.end(),
+                             [](const auto& lhs, const auto& rhs)
+                             {
+                                 return lhs.first->material->descriptor < rhs.first->material->descriptor;
+                             });
+
+            const auto draw_count = static_cast<uint32_t>(eligible.size());
+            FrameDrawBuffers& buffers = m_draw_buffers[m_current_frame];
+            if (draw_count > buffers.capacity)
+                resize_draw_buffers(buffers, std::max(draw_count, buffers.capacity * 2u));
+
+            auto* draw_data = static_cast<DrawData*>(
+                mapped_memory(buffers.draw_data, "Draw data buffer is not host visible"));
+            for (uint32_t draw = 0; draw < draw_count; ++draw)
             {
-                m_dlss_requested = false;
-                extent = m_swapchain_extent;
+                const auto& [gpu_mesh, call_index] = eligible[draw];
+                const QueuedDrawCall& draw_call = m_queued_draw_calls[call_index];
+                const Mesh& mesh = *draw_call.mesh;
+                const auto model = mesh.cpu_mesh().get_to_world_matrix().raw_array();
+
+                if (m_scene_batches.empty() || m_scene_batches.back().descriptor != gpu_mesh->material->descriptor)
+                    m_scene_batches.push_back({gpu_mesh->material->descriptor, draw, 0});
+                ++m_scene_batches.back().command_count;
+
+                DrawData data{};
+                std::memcpy(data.model, model.data(), sizeof(data.model));
+                data.bounds_center[0] = gpu_mesh->local_center.x;
+                data.bounds_center[1] = gpu_mesh->local_center.y;
+                data.bounds_center[2] = gpu_mesh->local_center.z;
+                data.bounds_center[3] = 1.0f;
+                data.bounds_extent[0] = gpu_mesh->local_extent.x;
+                data.bounds_extent[1] = gpu_mesh->local_extent.y;
+                data.bounds_extent[2] = gpu_mesh->local_extent.z;
+                data.index_count = gpu_mesh->index_count;
+                data.first_index = gpu_mesh->first_index;
+                data.vertex_offset = gpu_mesh->vertex_offset;
+                data.batch = static_cast<uint32_t>(m_scene_batches.size() - 1u);
+                data.batch_first = m_scene_batches.back().first_command;
+                data.flags = draw_call.mobility == MeshMobility::Dynamic ? k_dynamic_draw_flag : 0u;
+                draw_data[draw] = data;
+                m_draw_call_indirect[call_index] = true;
             }
-#endif
-            return extent;
+
+            m_indirect_draw_count = draw_count;
+            return true;
         }
 
-        [[nodiscard]] bool ensure_dlss_sdk_initialized()
-        {
-#ifdef ROSE_ENABLE_NGX_DLSS
-            if (m_ngx_available)
-                return true;
-            if (m_ngx_disabled_by_env)
+        // Tests every batched draw against the camera and both shadow frusta, and the camera draws
+        // against last frame's depth pyramid, then writes the indirect commands for all views.
+        // Each light has a static and a dynamic view so that the two can be drawn separately.
+        void record_cull_pass()
+        {
+            FrameDrawBuffers& buffers = m_draw_buffers[m_current_frame];
+            const bool occlusion = m_gpu_culling_enabled && m_occlusion_culling_enabled && m_hiz.valid;
+
+            CullUniform cull{};
+            if (occlusion)
+                std::memcpy(cull.occlusion_view_projection,
+                            m_hiz.view_projection.data(),
+                            sizeof(cull.occlusion_view_projection));
+            cull.hiz_size[0] = static_cast<float>(m_hiz.image.extent.width);
+            cull.hiz_size[1] = static_cast<float>(m_hiz.image.extent.height);
+            cull.hiz_size[2] = static_cast<float>(m_hiz.mip_count);
+            cull.counts[0] = m_indirect_draw_count;
+            cull.counts[1] = k_first_shadow_cull_view + 2u * (1u + m_sun_cascade_count);
+            cull.counts[2] = buffers.capacity;
+            cull.counts[3] = (m_gpu_culling_enabled ? 1u : 0u)
+                           | (occlusion ? 2u : 0u)
+                           | (compact_indirect_draws() ? 4u : 0u);
+            write_frustum_planes(m_indirect_camera->get_view_projection_matrix().raw_array(),
+                                 &cull.planes[k_camera_cull_view * 6u]);
+            for (const ShadowPassKind pass_kind : {ShadowPassKind::Spotlight, ShadowPassKind::Sun})
             {
-                m_dlss_status = "DLSS disabled by ROSE_DISABLE_NGX_DLSS";
-                return false;
+                for (uint32_t layer = 0; layer < shadow_layer_count(pass_kind); ++layer)
+                {
+                    const uint32_t static_view = shadow_cull_view(pass_kind, layer, MeshMobility::Static);
+                    const uint32_t dynamic_view = shadow_cull_view(pass_kind, layer, MeshMobility::Dynamic);
+                    write_shadow_cull_planes(pass_kind, layer, &cull.planes[static_view * 6u]);
+                    write_shadow_cull_planes(pass_kind, layer, &cull.planes[dynamic_view * 6u]);
+                    cull.view_masks[0] |= 1u << static_view;
+                    cull.view_masks[1] |= 1u << dynamic_view;
+                }
             }
-            if (m_ngx_init_attempted)
-                return false;
+            std::memcpy(mapped_memory(buffers.cull_uniform, "Cull uniform buffer is not host visible"),
+                        &cull,
+                        sizeof(cull));
 
-            m_ngx_init_attempted = true;
-            init_dlss_sdk();
-            return m_ngx_available;
-#else
-            m_dlss_status = "DLSS support was not compiled";
-            return false;
-#endif
+            // The previous user of this frame's buffers was the indirect draw of the same slot;
+            // the depth pyramid was last written at the end of the previous frame.
+            record_memory_barrier(0,
+                                  0,
+                                  VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                                  VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+            if (m_hiz.image.layout == VK_IMAGE_LAYOUT_UNDEFINED)
+                record_image_barrier(m_hiz.image,
+                                     VK_IMAGE_ASPECT_COLOR_BIT,
+                                     VK_IMAGE_LAYOUT_GENERAL,
+                                     0,
+                                     VK_ACCESS_SHADER_READ_BIT,
+                                     VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+            vkCmdFillBuffer(m_active_command_buffer, buffers.counts.buffer, 0, VK_WHOLE_SIZE, 0);
+            record_memory_barrier(VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                                  VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                                  VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+            vkCmdBindPipeline(m_active_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_cull_pipeline);
+            vkCmdBindDescriptorSets(m_active_command_buffer,
+                                    VK_PIPELINE_BIND_POINT_COMPUTE,
+                                    m_cull_pipeline_layout,
+                                    0,
+                                    1,
+                                    &buffers.cull_descriptor,
+                                    0,
+                                    nullptr);
+            vkCmdDispatch(m_active_command_buffer,
+                          (m_indirect_draw_count + k_cull_group_size - 1u) / k_cull_group_size,
+                          1,
+                          1);
+
+            record_memory_barrier(VK_ACCESS_SHADER_WRITE_BIT,
+                                  VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+                                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT);
         }
 
-        void init_dlss_sdk()
+        [[nodiscard]] VkImageAspectFlags depth_barrier_aspect() const noexcept
         {
-#ifdef ROSE_ENABLE_NGX_DLSS
-            if (!m_ngx_extensions_available)
-            {
-                spdlog::warn("Vulkan: skipping NGX init because required extensions are unavailable");
-                return;
-            }
+            return m_depth_format == VK_FORMAT_D32_SFLOAT
+                ? VK_IMAGE_ASPECT_DEPTH_BIT
+                : VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+        }
 
-            std::error_code error;
-            const std::filesystem::path log_path = std::filesystem::current_path(error) / "ngx";
-            if (!error)
-                std::filesystem::create_directories(log_path, error);
-            const std::wstring log_path_w = log_path.wstring();
-            spdlog::info("Vulkan: initializing NVIDIA NGX/DLSS");
+        // Reduces the scene depth into the pyramid for next frame's occlusion test. The depth
+        // image is returned to attachment layout so the DLSS barriers see the state they expect.
+        void record_hiz_build()
+        {
+            const VkImageAspectFlags depth_aspect = depth_barrier_aspect();
+            record_image_barrier(m_depth_image,
+                                 depth_aspect,
+                                 VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+                                 VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                                 VK_ACCESS_SHADER_READ_BIT,
+                                 VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+            record_image_barrier(m_hiz.image,
+                                 VK_IMAGE_ASPECT_COLOR_BIT,
+                                 VK_IMAGE_LAYOUT_GENERAL,
+                                 0,
+                                 VK_ACCESS_SHADER_WRITE_BIT,
+                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
 
-            NVSDK_NGX_FeatureCommonInfo feature_info{};
-            feature_info.LoggingInfo.MinimumLoggingLevel = NVSDK_NGX_LOGGING_LEVEL_ON;
-            const NVSDK_NGX_Result init_result =
-                NVSDK_NGX_VULKAN_Init_with_ProjectID("7b8f624d-44ea-4bc6-b656-4e72206d8d54",
-                                                     NVSDK_NGX_ENGINE_TYPE_CUSTOM,
-                                                     "1.0.0",
-                                                     log_path_w.c_str(),
-                                                     m_instance,
-                                                     m_physical_device,
-                                                     m_device,
-                                                     vkGetInstanceProcAddr,
-                                                     vkGetDeviceProcAddr,
-                                                     &feature_info);
-            if (NVSDK_NGX_FAILED(init_result))
+            vkCmdBindPipeline(m_active_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_hiz_pipeline);
+            VkExtent2D source = m_scene_extent;
+            for (uint32_t mip = 0; mip < m_hiz.mip_count; ++mip)
             {
-                m_dlss_status = std::string("NGX init failed: ") + ngx_result_name(init_result);
-                spdlog::warn("Vulkan: {}", m_dlss_status);
-                return;
+                const VkExtent2D destination{
+                    std::max(1u, m_hiz.image.extent.width >> mip),
+                    std::max(1u, m_hiz.image.extent.height >> mip)
+                };
+
+                HizPushConstants push{};
+                push.source_size[0] = static_cast<int32_t>(source.width);
+                push.source_size[1] = static_cast<int32_t>(source.height);
+                push.destination_size[0] = static_cast<int32_t>(destination.width);
+                push.destination_size[1] = static_cast<int32_t>(destination.height);
+                vkCmdBindDescriptorSets(m_active_command_buffer,
+                                        VK_PIPELINE_BIND_POINT_COMPUTE,
+                                        m_hiz_pipeline_layout,
+                                        0,
+                                        1,
+                                        &m_hiz.descriptors[mip],
+                                        0,
+                                        nullptr);
+                vkCmdPushConstants(m_active_command_buffer,
+                                   m_hiz_pipeline_layout,
+                                   VK_SHADER_STAGE_COMPUTE_BIT,
+                                   0,
+                                   sizeof(HizPushConstants),
+                                   &push);
+                vkCmdDispatch(m_active_command_buffer,
+                              (destination.width + k_hiz_group_size - 1u) / k_hiz_group_size,
+                              (destination.height + k_hiz_group_size - 1u) / k_hiz_group_size,
+                              1);
+                record_memory_barrier(VK_ACCESS_SHADER_WRITE_BIT,
+                                      VK_ACCESS_SHADER_READ_BIT,
+                                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+                source = destination;
             }
-            m_ngx_initialized = true;
 
-            const NVSDK_NGX_Result params_result = NVSDK_NGX_VULKAN_GetCapabilityParameters(&m_ngx_parameters);
-            if (NVSDK_NGX_FAILED(params_result) || m_ngx_parameters == nullptr)
+            record_image_barrier(m_depth_image,
+                                 depth_aspect,
+                                 VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                                 0,
+                                 VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+                                     | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                 VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT);
+            m_hiz.view_projection = m_frame_view_projection;
+            m_hiz.valid = true;
+        }
+
+        void draw_indexed_indirect(VkCommandBuffer command_buffer, uint32_t first_command, uint32_t command_count) const
+        {
+            constexpr auto stride = static_cast<uint32_t>(sizeof(VkDrawIndexedIndirectCommand));
+            const VkBuffer commands = m_draw_buffers[m_current_frame].commands.buffer;
+            while (command_count > 0)
             {
-                m_dlss_status = std::string("NGX capability query failed: ") + ngx_result_name(params_result);
-                spdlog::warn("Vulkan: {}", m_dlss_status);
-                return;
+                const uint32_t count = std::min(command_count, m_max_draw_indirect_count);
+                vkCmdDrawIndexedIndirect(command_buffer,
+                                         commands,
+                                         static_cast<VkDeviceSize>(first_command) * stride,
+                                         count,
+                                         stride);
+                first_command += count;
+                command_count -= count;
             }
+        }
 
-            int available = 0;
-            const NVSDK_NGX_Result available_result =
-                m_ngx_parameters->Get(NVSDK_NGX_Parameter_SuperSampling_Available, &available);
-            if (NVSDK_NGX_FAILED(available_result) || available == 0)
+        // Draws the commands of one cull view region: compacted ones through the GPU-written
+        // counter, otherwise the full range with culled draws at zero instances.
+        void draw_culled_indirect(VkCommandBuffer command_buffer,
+                                  uint32_t view,
+                                  uint32_t first_command,
+                                  uint32_t command_count,
+                                  uint32_t counter) const
+        {
+            const FrameDrawBuffers& buffers = m_draw_buffers[m_current_frame];
+            first_command += view * buffers.capacity;
+            if (!compact_indirect_draws())
             {
-                m_dlss_status = "DLSS is not available on this system";
-                spdlog::warn("Vulkan: {}", m_dlss_status);
+                draw_indexed_indirect(command_buffer, first_command, command_count);
                 return;
             }
 
-            m_ngx_available = true;
-            m_dlss_status = "DLSS is available";
-            spdlog::info("Vulkan: {}", m_dlss_status);
-#else
-            m_dlss_status = "DLSS support was not compiled";
-#endif
+            constexpr auto stride = static_cast<uint32_t>(sizeof(VkDrawIndexedIndirectCommand));
+            vkCmdDrawIndexedIndirectCount(command_buffer,
+                                          buffers.commands.buffer,
+                                          static_cast<VkDeviceSize>(first_command) * stride,
+                                          buffers.counts.buffer,
+                                          static_cast<VkDeviceSize>(counter) * sizeof(uint32_t),
+                                          command_count,
+                                          stride);
         }
 
-        void release_dlss_feature()
+        void draw_shadow_indirect(VkCommandBuffer command_buffer, const RecordingPass& pass) const
         {
-#ifdef ROSE_ENABLE_NGX_DLSS
-            if (m_ngx_dlss_handle != nullptr)
-            {
-                const NVSDK_NGX_Result result = NVSDK_NGX_VULKAN_ReleaseFeature(m_ngx_dlss_handle);
-                if (NVSDK_NGX_FAILED(result))
-                    spdlog::warn("Failed to release DLSS feature: {}", ngx_result_name(result));
-                m_ngx_dlss_handle = nullptr;
-            }
-#endif
+            vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_indirect_shadow_pipeline);
+            bind_arena_geometry(command_buffer);
+            bind_frame_descriptor_sets(command_buffer);
+            vkCmdPushConstants(command_buffer,
+                               m_pipeline_layout,
+                               VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                               0,
+                               sizeof(PushConstants),
+                               &pass.indirect_push);
+            draw_culled_indirect(command_buffer, pass.indirect_view, 0, m_indirect_draw_count, pass.indirect_view);
         }
 
-        [[nodiscard]] bool create_dlss_feature(VkExtent2D render_extent)
+        // Materials are bound per descriptor set, so the scene pass issues one indirect call per
+        // material run rather than a single call for the whole pass.
+        void draw_scene_indirect(VkCommandBuffer command_buffer, const RecordingPass& pass) const
         {
-#ifdef ROSE_ENABLE_NGX_DLSS
-            NVSDK_NGX_DLSS_Create_Params create_params{};
-            create_params.Feature.InWidth = render_extent.width;
-            create_params.Feature.InHeight = render_extent.height;
-            create_params.Feature.InTargetWidth = m_swapchain_extent.width;
-            create_params.Feature.InTargetHeight = m_swapchain_extent.height;
-            create_params.Feature.InPerfQualityValue = to_ngx_quality(m_dlss_quality);
-            create_params.InFeatureCreateFlags = NVSDK_NGX_DLSS_Feature_Flags_MVLowRes
-                                               | NVSDK_NGX_DLSS_Feature_Flags_AutoExposure;
-            create_params.InEnableOutputSubrects = false;
-
-            VkCommandBuffer command_buffer = begin_single_time_commands();
-            const NVSDK_NGX_Result result = NGX_VULKAN_CREATE_DLSS_EXT1(m_device,
-                                                                        command_buffer,
-                                                                        1,
-                                                                        1,
-                                                                        &m_ngx_dlss_handle,
-                                                                        m_ngx_parameters,
-                                                                        &create_params);
-            end_single_time_commands(command_buffer);
+            vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_indirect_pipeline);
+            bind_arena_geometry(command_buffer);
+            bind_frame_descriptor_sets(command_buffer);
+            vkCmdPushConstants(command_buffer,
+                               m_pipeline_layout,
+                               VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                               0,
+                               sizeof(PushConstants),
+                               &pass.indirect_push);
 
-            if (NVSDK_NGX_FAILED(result) || m_ngx_dlss_handle == nullptr)
+            for (std::size_t batch_index = 0; batch_index < m_scene_batches.size(); ++batch_index)
             {
-                m_ngx_dlss_handle = nullptr;
-                m_dlss_status = std::string("DLSS feature creation failed: ") + ngx_result_name(result);
-                spdlog::warn("Vulkan: {}", m_dlss_status);
-                return false;
+                const IndirectBatch& batch = m_scene_batches[batch_index];
+                vkCmdBindDescriptorSets(command_buffer,
+                                        VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                        m_pipeline_layout,
+                                        0,
+                                        1,
+                                        &batch.descriptor,
+                                        0,
+                                        nullptr);
+                draw_culled_indirect(command_buffer,
+                                     k_camera_cull_view,
+                                     batch.first_command,
+                                     batch.command_count,
+                                     k_max_cull_views + static_cast<uint32_t>(batch_index));
             }
+        }
 
-            m_dlss_reset_next_frame = true;
-            m_dlss_status = std::string("DLSS ") + dlss_quality_label(m_dlss_quality)
-                          + " (" + std::to_string(render_extent.width) + "x" + std::to_string(render_extent.height)
-                          + " -> " + std::to_string(m_swapchain_extent.width) + "x" + std::to_string(m_swapchain_extent.height)
-                          + ")";
-            spdlog::info("Vulkan: {}", m_dlss_status);
-            return true;
-#else
-            static_cast<void>(render_extent);
-            return false;
-#endif
+        [[nodiscard]] uint32_t shadow_layer_count(ShadowPassKind pass_kind) const noexcept
+        {
+            return pass_kind == ShadowPassKind::Sun ? m_sun_cascade_count : 1u;
         }
 
-        void shutdown_dlss_sdk()
+        [[nodiscard]] static uint32_t shadow_cull_view(ShadowPassKind pass_kind,
+                                                       uint32_t layer,
+                                                       MeshMobility mobility) noexcept
         {
-#ifdef ROSE_ENABLE_NGX_DLSS
-            release_dlss_feature();
-            if (m_ngx_parameters != nullptr)
-            {
-                const NVSDK_NGX_Result result = NVSDK_NGX_VULKAN_DestroyParameters(m_ngx_parameters);
-                if (NVSDK_NGX_FAILED(result))
-                    spdlog::warn("Failed to destroy NGX parameters: {}", ngx_result_name(result));
-                m_ngx_parameters = nullptr;
-            }
-            if (m_ngx_initialized)
+            const uint32_t shadow_layer = pass_kind == ShadowPassKind::Sun ? 1u + layer : 0u;
+            return k_first_shadow_cull_view + 2u * shadow_layer + (mobility == MeshMobility::Dynamic ? 1u : 0u);
+        }
+
+        // The light's frustum. With depth clamping the sun's near plane is dropped: casters between
+        // the sun and its shadow box are flattened onto the near plane instead of being lost.
+        void write_shadow_cull_planes(ShadowPassKind pass_kind, uint32_t layer, float (*planes)[4]) const
+        {
+            write_frustum_planes(shadow_view_projection(pass_kind, layer), planes);
+            if (pass_kind == ShadowPassKind::Sun && m_depth_clamp_supported)
             {
-                const NVSDK_NGX_Result result = NVSDK_NGX_VULKAN_Shutdown1(m_device);
-                if (NVSDK_NGX_FAILED(result))
-                    spdlog::warn("Failed to shut down NGX: {}", ngx_result_name(result));
-                m_ngx_initialized = false;
+                planes[4][0] = 0.0f;
+                planes[4][1] = 0.0f;
+                planes[4][2] = 0.0f;
+                planes[4][3] = 1.0f;
             }
-            m_ngx_available = false;
-#endif
         }
 
-        void destroy_frame_targets() noexcept
+        // Culls the queued draws against one shadow map layer. The signature covers the layer's
+        // view-projection and every static caster it can see, so it changes whenever the cached
+        // shadow map would.
+        void collect_shadow_casters(ShadowPassKind pass_kind, uint32_t layer, ShadowCasters& casters) const
         {
-            for (VkFramebuffer framebuffer : m_framebuffers)
-                vkDestroyFramebuffer(m_device, framebuffer, nullptr);
-            m_framebuffers.clear();
+            casters.static_draws.clear();
+            casters.dynamic_draws.clear();
+            casters.has_dynamic = false;
 
-            if (m_scene_framebuffer != VK_NULL_HANDLE)
-            {
-                vkDestroyFramebuffer(m_device, m_scene_framebuffer, nullptr);
-                m_scene_framebuffer = VK_NULL_HANDLE;
-            }
-            if (m_shadow_framebuffer != VK_NULL_HANDLE)
+            float planes[6][4]{};
+            write_shadow_cull_planes(pass_kind, layer, planes);
+            const std::array<float, 16>& view_projection = shadow_view_projection(pass_kind, layer);
+            uint64_t signature = hash_bytes(k_fnv_offset_basis, view_projection.data(), sizeof(float) * 16u);
+
+            for (std::size_t i = 0; i < m_queued_draw_calls.size(); ++i)
             {
-                vkDestroyFramebuffer(m_device, m_shadow_framebuffer, nullptr);
-                m_shadow_framebuffer = VK_NULL_HANDLE;
+                const QueuedDrawCall& draw_call = m_queued_draw_calls[i];
+                if (draw_call.mesh == nullptr || draw_call.selected)
+                    continue;
+
+                const GpuMesh* gpu_mesh = resident_mesh(*draw_call.mesh);
+                if (gpu_mesh == nullptr)
+                    continue;
+
+                const auto model = draw_call.mesh->cpu_mesh().get_to_world_matrix().raw_array();
+                if (!box_inside_planes(planes, model, gpu_mesh->local_center, gpu_mesh->local_extent))
+                    continue;
+
+                if (draw_call.mobility == MeshMobility::Dynamic)
+                {
+                    casters.has_dynamic = true;
+                    if (!m_draw_call_indirect[i])
+                        casters.dynamic_draws.push_back(i);
+                    continue;
+                }
+
+                const Mesh* mesh = draw_call.mesh;
+                signature = hash_bytes(signature, &mesh, sizeof(mesh));
+                signature = hash_bytes(signature, model.data(), sizeof(float) * 16u);
+                if (!m_draw_call_indirect[i])
+                    casters.static_draws.push_back(i);
             }
-            if (m_sun_shadow_framebuffer != VK_NULL_HANDLE)
+            casters.static_signature = signature;
+        }
+
+        [[nodiscard]] RecordingPass& add_recording_pass(VkRenderPass render_pass,
+                                                        VkFramebuffer framebuffer,
+                                                        VkExtent2D extent)
+        {
+            RecordingPass& pass = m_recording_passes.emplace_back();
+            pass.render_pass = render_pass;
+            pass.framebuffer = framebuffer;
+            pass.extent = extent;
+            pass.first_draw = m_recorded_draws.size();
+            return pass;
+        }
+
+        void add_shadow_draws(RecordingPass& pass,
+                              const std::vector<std::size_t>& draw_indices,
+                              const std::array<float, 16>& view_projection)
+        {
+            for (const std::size_t i : draw_indices)
             {
-                vkDestroyFramebuffer(m_device, m_sun_shadow_framebuffer, nullptr);
-                m_sun_shadow_framebuffer = VK_NULL_HANDLE;
+                const Mesh& mesh = *m_queued_draw_calls[i].mesh;
+                RecordedDraw& draw = m_recorded_draws.emplace_back();
+                draw.gpu_mesh = resident_mesh(mesh);
+                draw.pipeline = m_shadow_pipeline;
+                draw.push = shadow_push_constants(view_projection);
+                const auto model = mesh.cpu_mesh().get_to_world_matrix().raw_array();
+                std::memcpy(draw.push.model, model.data(), sizeof(draw.push.model));
             }
-
-            release_dlss_feature();
-            m_bloom_descriptor_image_view = VK_NULL_HANDLE;
-            destroy_image(m_dlss_output_image);
-            destroy_image(m_motion_vector_image);
-            destroy_image(m_scene_color_image);
-            destroy_image(m_depth_image);
-            destroy_image(m_shadow_image);
-            destroy_image(m_sun_shadow_image);
+            pass.draw_count = m_recorded_draws.size() - pass.first_draw;
         }
 
-        void recreate_frame_targets()
+        // Plans a cache pass for every layer whose signature changed and a composite pass for every
+        // layer whose shadow map is rebuilt from its cache plus this frame's dynamic casters. Layers
+        // with a clean cache and nothing dynamic in view keep the shadow map from an earlier frame.
+        [[nodiscard]] ShadowPassPlan plan_shadow_pass(ShadowPassKind pass_kind, bool indirect)
         {
-            if (m_frame_started)
-                return;
+            const bool sun = pass_kind == ShadowPassKind::Sun;
+            const uint32_t size = shadow_map_size(pass_kind);
+            ShadowPassPlan plan;
+            for (uint32_t layer = 0; layer < shadow_layer_count(pass_kind); ++layer)
+            {
+                ShadowCache& cache = sun ? m_sun_shadow_caches[layer] : m_shadow_cache;
+                ShadowCasters& casters = m_shadow_casters[layer];
+                collect_shadow_casters(pass_kind, layer, casters);
+                const std::array<float, 16>& view_projection = shadow_view_projection(pass_kind, layer);
+                const auto use_indirect_draws = [&](RecordingPass& pass, MeshMobility mobility)
+                {
+                    pass.indirect = IndirectDraws::Shadow;
+                    pass.indirect_view = shadow_cull_view(pass_kind, layer, mobility);
+                    pass.indirect_push = shadow_push_constants(view_projection);
+                };
 
-            spdlog::info("Vulkan: recreating frame targets");
-            check_vk(vkDeviceWaitIdle(m_device), "Failed to wait for device before recreating render targets");
-            destroy_frame_targets();
-            create_render_targets();
-            create_framebuffers();
+                if (!cache.valid || cache.signature != casters.static_signature)
+                {
+                    plan.cache_passes[layer] = m_recording_passes.size();
+                    RecordingPass& pass = add_recording_pass(m_shadow_render_pass, cache.framebuffer, {size, size});
+                    if (indirect)
+                        use_indirect_draws(pass, MeshMobility::Static);
+                    add_shadow_draws(pass, casters.static_draws, view_projection);
+                    cache.signature = casters.static_signature;
+                    cache.valid = true;
+                    cache.shadow_map_current = false;
+                }
+
+                if (!cache.shadow_map_current || casters.has_dynamic)
+                {
+                    plan.composite_passes[layer] = m_recording_passes.size();
+                    RecordingPass& pass = add_recording_pass(m_shadow_composite_render_pass,
+                                                             sun ? m_sun_shadow_framebuffers[layer] : m_shadow_framebuffer,
+                                                             {size, size});
+                    if (indirect && casters.has_dynamic)
+                        use_indirect_draws(pass, MeshMobility::Dynamic);
+                    add_shadow_draws(pass, casters.dynamic_draws, view_projection);
+                    cache.shadow_map_current = !casters.has_dynamic;
+                }
+            }
+            return plan;
         }
 
-        void set_dlss_enabled(bool enabled)
+        // Resolves the scene draws in submission order. Meshes are queued unculled so that they can
+        // reach the shadow passes; the remaining ones are culled against their camera here.
+        void plan_scene_pass(bool indirect)
         {
-            spdlog::info("Vulkan: DLSS {}", enabled ? "enable requested" : "disable requested");
-            if (enabled && !ensure_dlss_sdk_initialized())
+            m_frame_view_projection_set = false;
+            RecordingPass& pass = add_recording_pass(m_render_pass, m_scene_framebuffer, m_scene_extent);
+            if (indirect)
             {
-                m_dlss_requested = false;
-                m_dlss_reset_next_frame = true;
-                spdlog::warn("Vulkan: DLSS enable failed: {}", m_dlss_status);
-                return;
+                pass.indirect = IndirectDraws::Scene;
+                pass.indirect_view = k_camera_cull_view;
+                pass.indirect_push = scene_push_constants(*m_indirect_camera);
             }
 
-            if (m_dlss_requested == enabled)
-                return;
+            const omath::opengl_engine::Camera* culling_camera = nullptr;
+            float camera_planes[6][4]{};
+            for (std::size_t i = 0; i < m_queued_draw_calls.size(); ++i)
+            {
+                const QueuedDrawCall& draw_call = m_queued_draw_calls[i];
+                if (draw_call.mesh == nullptr
+                    || draw_call.camera == nullptr
+                    || draw_call.selected
+                    || m_draw_call_indirect[i])
+                    continue;
 
-            m_dlss_requested = enabled;
-            m_dlss_reset_next_frame = true;
-            if (!enabled)
-                m_dlss_status = "DLSS is disabled";
-            recreate_frame_targets();
-        }
+                const GpuMesh* gpu_mesh = resident_mesh(*draw_call.mesh);
+                if (gpu_mesh == nullptr)
+                    continue;
 
-        void set_dlss_quality(DlssQuality quality)
-        {
-            if (m_dlss_quality == quality)
-                return;
+                if (draw_call.camera != culling_camera)
+                {
+                    culling_camera = draw_call.camera;
+                    write_frustum_planes(culling_camera->get_view_projection_matrix().raw_array(), camera_planes);
+                }
+                if (!box_inside_planes(camera_planes,
+                                       draw_call.mesh->cpu_mesh().get_to_world_matrix().raw_array(),
+                                       gpu_mesh->local_center,
+                                       gpu_mesh->local_extent))
+                    continue;
 
-            m_dlss_quality = quality;
-            m_dlss_reset_next_frame = true;
-            if (m_dlss_requested)
-                recreate_frame_targets();
+                RecordedDraw& draw = m_recorded_draws.emplace_back();
+                draw.gpu_mesh = gpu_mesh;
+                draw.pipeline = draw_call.pipeline;
+                draw.material = gpu_mesh->material->descriptor;
+                draw.push = scene_draw_push_constants(draw_call);
+            }
+            pass.draw_count = m_recorded_draws.size() - pass.first_draw;
         }
 
-        void set_selection_outline_settings(const SelectionOutlineSettings& settings)
+        // Pixels that SelectionOutlineSettings::width world units cover at the mesh's center. The
+        // second row of the view-projection is the camera's up axis scaled by the projection, and
+        // clip w is the view depth.
+        [[nodiscard]] float selection_width_pixels(const QueuedDrawCall& draw_call, const GpuMesh& gpu_mesh) const
         {
-            m_selection_outline_settings = settings;
-            for (float& channel : m_selection_outline_settings.color)
-                channel = std::clamp(channel, 0.0f, 1.0f);
-            m_selection_outline_settings.width = std::clamp(m_selection_outline_settings.width, 0.0f, 2.0f);
-            m_selection_outline_settings.smoothing_quality =
-                std::clamp(m_selection_outline_settings.smoothing_quality, 1, 64);
+            const auto view_projection = draw_call.camera->get_view_projection_matrix().raw_array();
+            const auto at = [&view_projection](int row, int column)
+            {
+                return view_projection[static_cast<std::size_t>(column * 4 + row)];
+            };
+
+            const auto model = draw_call.mesh->cpu_mesh().get_to_world_matrix().raw_array();
+            const float local_center[3] = {gpu_mesh.local_center.x, gpu_mesh.local_center.y, gpu_mesh.local_center.z};
+            float clip_w = at(3, 3);
+            for (int row = 0; row < 3; ++row)
+            {
+                float center = model[static_cast<std::size_t>(12 + row)];
+                for (int column = 0; column < 3; ++column)
+                    center += model[static_cast<std::size_t>(column * 4 + row)] * local_center[column];
+                clip_w += at(3, row) * center;
+            }
+
+            // A center behind the camera leaves only the nearest part of the mesh on screen.
+            if (clip_w <= 0.0001f)
+                return k_max_selection_outline_pixels;
+            const float y_scale = std::hypot(at(1, 0), at(1, 1), at(1, 2));
+            const float width = std::clamp(m_selection_outline_settings.width, 0.0f, 2.0f);
+            return std::min(width * y_scale * 0.5f * static_cast<float>(m_scene_extent.height) / clip_w,
+                            k_max_selection_outline_pixels);
         }
 
-        void set_bloom_settings(const BloomSettings& settings)
+        // Queues the selected meshes into the selection mask pass, which runs after the scene pass
+        // and tests them against its depth. Returns nothing when no glow is visible this frame.
+        [[nodiscard]] std::optional<std::size_t> plan_selection_pass()
         {
-            m_bloom_settings = settings;
-            m_bloom_settings.threshold = std::clamp(m_bloom_settings.threshold, 0.0f, 8.0f);
-            m_bloom_settings.intensity = std::clamp(m_bloom_settings.intensity, 0.0f, 5.0f);
-            m_bloom_settings.radius = std::clamp(m_bloom_settings.radius, 0.0f, 32.0f);
-            m_bloom_settings.quality = std::clamp(m_bloom_settings.quality, 1, 64);
+            m_selection_width_pixels = 0.0f;
+            const std::size_t pass_index = m_recording_passes.size();
+            RecordingPass& pass = add_recording_pass(m_selection_render_pass, m_selection.mask_framebuffer, m_scene_extent);
+            for (const QueuedDrawCall& draw_call : m_queued_draw_calls)
+            {
+                if (draw_call.mesh == nullptr || draw_call.camera == nullptr || !draw_call.selected)
+                    continue;
+
+                const GpuMesh* gpu_mesh = resident_mesh(*draw_call.mesh);
+                if (gpu_mesh == nullptr)
+                    continue;
+
+                const float width = selection_width_pixels(draw_call, *gpu_mesh);
+                if (width < 0.5f)
+                    continue;
+
+                RecordedDraw& draw = m_recorded_draws.emplace_back();
+                draw.gpu_mesh = gpu_mesh;
+                draw.pipeline = draw_call.pipeline;
+                draw.push = scene_draw_push_constants(draw_call);
+                draw.push.selection_width = width;
+                m_selection_width_pixels = std::max(m_selection_width_pixels, width);
+            }
+            pass.draw_count = m_recorded_draws.size() - pass.first_draw;
+            if (pass.draw_count > 0)
+                return pass_index;
+
+            m_recording_passes.pop_back();
+            return std::nullopt;
         }
 
-        void set_spotlight_settings(const SpotlightSettings& settings)
+        // Narrows `view_projection` to the footprint of scene pixel (x, y), which then fills the
+        // clip volume, so a one-pixel viewport shows only what covers that pixel. Row 1 moves the
+        // other way because shader.vert flips clip y for Vulkan.
+        [[nodiscard]] std::array<float, 16> pick_view_projection(const std::array<float, 16>& view_projection,
+                                                                 uint32_t x,
+                                                                 uint32_t y) const
         {
-            m_spotlight_settings = settings;
-            for (float& channel : m_spotlight_settings.color)
-                channel = std::clamp(channel, 0.0f, 1.0f);
-            m_spotlight_settings.intensity = std::clamp(m_spotlight_settings.intensity, 0.0f, 1000.0f);
-            m_spotlight_settings.range = std::clamp(m_spotlight_settings.range, 0.1f, 500.0f);
-            m_spotlight_settings.inner_angle_degrees =
-                std::clamp(m_spotlight_settings.inner_angle_degrees, 0.1f, 89.0f);
-            m_spotlight_settings.outer_angle_degrees =
-                std::clamp(m_spotlight_settings.outer_angle_degrees,
-                           m_spotlight_settings.inner_angle_degrees + 0.1f,
-                           89.9f);
+            const auto width = static_cast<float>(m_scene_extent.width);
+            const auto height = static_cast<float>(m_scene_extent.height);
+            const float center_x = 2.0f * (static_cast<float>(x) + 0.5f) / width - 1.0f;
+            const float center_y = 2.0f * (static_cast<float>(y) + 0.5f) / height - 1.0f;
 
-            const float length = std::sqrt(m_spotlight_settings.direction.x * m_spotlight_settings.direction.x
-                                         + m_spotlight_settings.direction.y * m_spotlight_settings.direction.y
-                                         + m_spotlight_settings.direction.z * m_spotlight_settings.direction.z);
-            if (length > 0.0001f)
-                m_spotlight_settings.direction = m_spotlight_settings.direction / length;
-            else
-                m_spotlight_settings.direction = {0.0f, 0.0f, -1.0f};
+            std::array<float, 16> narrowed = view_projection;
+            for (std::size_t column = 0; column < 4; ++column)
+            {
+                const float w = view_projection[column * 4 + 3];
+                narrowed[column * 4 + 0] = width * (view_projection[column * 4 + 0] - center_x * w);
+                narrowed[column * 4 + 1] = height * (view_projection[column * 4 + 1] + center_y * w);
+            }
+            return narrowed;
         }
 
-        void set_sun_settings(const SunSettings& settings)
+        // Queues the pending pick into the one-pixel pick pass. Each draw is culled against the
+        // frustum of the picked pixel, so only meshes under it are drawn again.
+        [[nodiscard]] std::optional<std::size_t> plan_pick_pass()
         {
-            m_sun_settings = settings;
-            for (float& channel : m_sun_settings.color)
-                channel = std::clamp(channel, 0.0f, 1.0f);
-            m_sun_settings.intensity = std::clamp(m_sun_settings.intensity, 0.0f, 50.0f);
-            m_sun_settings.shadow_distance = std::clamp(m_sun_settings.shadow_distance, 5.0f, 500.0f);
+            const std::optional<omath::Vector2<float>> request = std::exchange(m_pick_request, std::nullopt);
+            if (!request || m_swapchain_extent.width == 0 || m_swapchain_extent.height == 0)
+                return std::nullopt;
+
+            PickSlot& slot = m_pick_slots[m_current_frame];
+            ensure_readback_slot(slot.readback, sizeof(uint32_t));
+            slot.meshes.clear();
+
+            // The scene may render below the swapchain resolution and is stretched over it.
+            const auto scene_coordinate = [](float position, uint32_t swapchain_size, uint32_t scene_size)
+            {
+                const float scaled = position * static_cast<float>(scene_size) / static_cast<float>(swapchain_size);
+                return static_cast<uint32_t>(std::clamp(scaled, 0.0f, static_cast<float>(scene_size - 1u)));
+            };
+            const uint32_t x = scene_coordinate(request->x, m_swapchain_extent.width, m_scene_extent.width);
+            const uint32_t y = scene_coordinate(request->y, m_swapchain_extent.height, m_scene_extent.height);
+
+            const std::size_t pass_index = m_recording_passes.size();
+            RecordingPass& pass = add_recording_pass(m_pick_render_pass, m_pick.framebuffer, VkExtent2D{1, 1});
+            const omath::opengl_engine::Camera* pick_camera = nullptr;
+            std::array<float, 16> view_projection{};
+            float planes[6][4]{};
+            for (const QueuedDrawCall& draw_call : m_queued_draw_calls)
+            {
+                if (draw_call.mesh == nullptr || draw_call.camera == nullptr || draw_call.selected)
+                    continue;
+
+                const GpuMesh* gpu_mesh = resident_mesh(*draw_call.mesh);
+                if (gpu_mesh == nullptr)
+                    continue;
+
+                if (draw_call.camera != pick_camera)
+                {
+                    pick_camera = draw_call.camera;
+                    view_projection = pick_view_projection(pick_camera->get_view_projection_matrix().raw_array(), x, y);
+                    write_frustum_planes(view_projection, planes);
+                }
+                if (!box_inside_planes(planes,
+                                       draw_call.mesh->cpu_mesh().get_to_world_matrix().raw_array(),
+                                       gpu_mesh->local_center,
+                                       gpu_mesh->local_extent))
+                    continue;
+
+                slot.meshes.push_back(draw_call.mesh);
+                RecordedDraw& draw = m_recorded_draws.emplace_back();
+                draw.gpu_mesh = gpu_mesh;
+                draw.pipeline = m_pick_pipeline;
+                draw.push = scene_draw_push_constants(draw_call);
+                std::ranges::copy(view_projection, draw.push.view_projection);
+                draw.push.camera_latched = 0;
+                draw.push.object_id = static_cast<uint32_t>(slot.meshes.size());
+            }
+            // An empty pass still clears the id, which reads back as the background.
+            pass.draw_count = m_recorded_draws.size() - pass.first_draw;
+            return pass_index;
+        }
+
+        // Begins the next secondary command buffer of `slot` inside `pass`. Dynamic state is not
+        // inherited from the primary buffer, so every secondary sets its own viewport and scissor.
+        [[nodiscard]] VkCommandBuffer begin_secondary_command_buffer(RecordingSlot& slot, const RecordingPass& pass) const
+        {
+            if (slot.used == slot.command_buffers.size())
+            {
+                VkCommandBufferAllocateInfo alloc_info{};
+                alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+                alloc_info.commandPool = slot.pool;
+                alloc_info.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+                alloc_info.commandBufferCount = 1;
+
+                VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+                check_vk(vkAllocateCommandBuffers(m_device, &alloc_info, &command_buffer),
+                         "Failed to allocate secondary command buffer");
+                slot.command_buffers.push_back(command_buffer);
+            }
+            const VkCommandBuffer command_buffer = slot.command_buffers[slot.used++];
+
+            VkCommandBufferInheritanceInfo inheritance_info{};
+            inheritance_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+            inheritance_info.renderPass = pass.render_pass;
+            inheritance_info.subpass = 0;
+            inheritance_info.framebuffer = pass.framebuffer;
+            inheritance_info.pipelineStatistics = m_gpu_profiler->inherited_statistics();
+
+            VkCommandBufferBeginInfo begin_info{};
+            begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+                             | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+            begin_info.pInheritanceInfo = &inheritance_info;
+            check_vk(vkBeginCommandBuffer(command_buffer, &begin_info), "Failed to begin secondary command buffer");
+
+            VkViewport viewport{};
+            viewport.x = 0.0f;
+            viewport.y = 0.0f;
+            viewport.width = static_cast<float>(pass.extent.width);
+            viewport.height = static_cast<float>(pass.extent.height);
+            viewport.minDepth = 0.0f;
+            viewport.maxDepth = 1.0f;
+            vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+
+            const VkRect2D scissor{{0, 0}, pass.extent};
+            vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+            return command_buffer;
+        }
+
+        // Records chunk `chunk` of every planned pass into slot `chunk` of the current frame.
+        void record_pass_chunk(std::size_t chunk, std::size_t chunk_count)
+        {
+            ROSE_PROFILE_ZONE("Record pass chunk");
+            RecordingSlot& slot = m_recording_slots[m_current_frame][chunk];
+            for (RecordingPass& pass : m_recording_passes)
+            {
+                const std::size_t first = pass.first_draw + pass.draw_count * chunk / chunk_count;
+                const std::size_t last = pass.first_draw + pass.draw_count * (chunk + 1u) / chunk_count;
+                const bool indirect = chunk == 0 && pass.indirect != IndirectDraws::None;
+                if (first == last && !indirect)
+                    continue;
+
+                const VkCommandBuffer command_buffer = begin_secondary_command_buffer(slot, pass);
+                if (indirect && pass.indirect == IndirectDraws::Scene)
+                    draw_scene_indirect(command_buffer, pass);
+                else if (indirect)
+                    draw_shadow_indirect(command_buffer, pass);
+                record_draws(command_buffer, first, last - first);
+                check_vk(vkEndCommandBuffer(command_buffer), "Failed to end secondary command buffer");
+                pass.command_buffers[chunk] = command_buffer;
+            }
+        }
+
+        // Splits the planned draws into one chunk per recording slot, as far as the draw count
+        // allows, and starts recording them. Single-chunk frames are recorded right here.
+        void start_pass_recording()
+        {
+            const auto slot_count = static_cast<std::size_t>(m_recording_pool.size());
+            for (std::size_t slot = 0; slot < slot_count; ++slot)
+            {
+                RecordingSlot& recording_slot = m_recording_slots[m_current_frame][slot];
+                check_vk(vkResetCommandPool(m_device, recording_slot.pool, 0), "Failed to reset recording command pool");
+                recording_slot.used = 0;
+            }
+
+            const std::size_t chunk_count =
+                std::clamp<std::size_t>(m_recorded_draws.size() / k_min_draws_per_chunk, 1, slot_count);
+            if (chunk_count == 1)
+            {
+                record_pass_chunk(0, 1);
+                return;
+            }
+
+            for (std::size_t chunk = 0; chunk < chunk_count; ++chunk)
+            {
+                m_recording_jobs.push_back(m_recording_pool.submit(
+                    [this, chunk, chunk_count]
+                    {
+                        ROSE_PROFILE_THREAD("Recording worker");
+                        record_pass_chunk(chunk, chunk_count);
+                    }));
+            }
+        }
+
+        // Every job writes into the frame's passes, so all of them finish before a failure is
+        // rethrown.
+        void finish_pass_recording()
+        {
+            for (std::future<void>& job : m_recording_jobs)
+                job.wait();
+            std::vector<std::future<void>> jobs = std::move(m_recording_jobs);
+            m_recording_jobs.clear();
+            for (std::future<void>& job : jobs)
+                job.get();
+        }
+
+        // Executes the planned passes of one shadow map: refreshed caches first, then every rebuilt
+        // layer is copied from its cache and gets its composite pass.
+        void record_shadow_pass(ShadowPassKind pass_kind, const ShadowPassPlan& plan)
+        {
+            const bool sun = pass_kind == ShadowPassKind::Sun;
+            ImageResource& shadow_map = sun ? m_sun_shadow_image : m_shadow_image;
+            const uint32_t size = shadow_map_size(pass_kind);
+            const uint32_t layer_count = shadow_layer_count(pass_kind);
+
+            for (uint32_t layer = 0; layer < layer_count; ++layer)
+            {
+                if (!plan.cache_passes[layer].has_value())
+                    continue;
+
+                const RecordingPass& pass = m_recording_passes[*plan.cache_passes[layer]];
+                begin_shadow_render_pass(pass);
+                execute_recording_pass(pass);
+                vkCmdEndRenderPass(m_active_command_buffer);
+                ShadowCache& cache = sun ? m_sun_shadow_caches[layer] : m_shadow_cache;
+                cache.image.layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            }
+
+            // Every layer is in the same layout between frames; each refreshed layer moves through
+            // the copy and its composite pass on its own.
+            const VkImageLayout resting_layout = shadow_map.layout;
+            bool refreshed = false;
+            for (uint32_t layer = 0; layer < layer_count; ++layer)
+            {
+                if (!plan.composite_passes[layer].has_value())
+                    continue;
+
+                const ShadowCache& cache = sun ? m_sun_shadow_caches[layer] : m_shadow_cache;
+                // The shadow map was last sampled by the previous scene pass.
+                shadow_map.layout = resting_layout;
+                record_image_barrier(shadow_map,
+                                     depth_barrier_aspect(),
+                                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                     0,
+                                     VK_ACCESS_TRANSFER_WRITE_BIT,
+                                     VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                     VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                     layer,
+                                     1);
+                VkImageCopy region{};
+                region.srcSubresource = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 0, 1};
+                region.dstSubresource = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, layer, 1};
+                region.extent = {size, size, 1};
+                vkCmdCopyImage(m_active_command_buffer,
+                               cache.image.image,
+                               VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                               shadow_map.image,
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               1,
+                               &region);
+
+                const RecordingPass& pass = m_recording_passes[*plan.composite_passes[layer]];
+                begin_shadow_render_pass(pass);
+                execute_recording_pass(pass);
+                vkCmdEndRenderPass(m_active_command_buffer);
+                refreshed = true;
+            }
+            if (refreshed)
+                shadow_map.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        }
+
+        // The frame's first camera drives the sun cascades.
+        [[nodiscard]] const omath::opengl_engine::Camera* frame_camera() const noexcept
+        {
+            for (const QueuedDrawCall& draw_call : m_queued_draw_calls)
+            {
+                if (draw_call.camera != nullptr)
+                    return draw_call.camera;
+            }
+            return nullptr;
+        }
+
+        // Resolves the draws queued this frame into shadow and scene passes and records those into
+        // secondary command buffers on the recording workers while the cull pass is recorded here.
+        // The primary buffer then runs the cull pass, both shadow passes and the scene pass.
+        void record_queued_draws()
+        {
+            ROSE_PROFILE_ZONE("Record queued draws");
+            update_light_buffer(m_current_frame, frame_camera());
+            request_texture_levels();
+            const bool indirect = build_indirect_draws();
+
+            m_recording_passes.clear();
+            m_recorded_draws.clear();
+            const ShadowPassPlan spotlight_plan = plan_shadow_pass(ShadowPassKind::Spotlight, indirect);
+            const ShadowPassPlan sun_plan = plan_shadow_pass(ShadowPassKind::Sun, indirect);
+            const std::size_t scene_pass = m_recording_passes.size();
+            plan_scene_pass(indirect);
+            m_selection_pass = plan_selection_pass();
+            m_pick_pass = plan_pick_pass();
+
+            start_pass_recording();
+            if (indirect)
+            {
+                begin_gpu_pass(GpuPass::Cull);
+                record_cull_pass();
+                end_gpu_pass(GpuPass::Cull);
+            }
+            finish_pass_recording();
+
+            begin_gpu_pass(GpuPass::Shadows);
+            record_shadow_pass(ShadowPassKind::Spotlight, spotlight_plan);
+            record_shadow_pass(ShadowPassKind::Sun, sun_plan);
+            end_gpu_pass(GpuPass::Shadows);
+            begin_gpu_pass(GpuPass::Scene);
+            m_gpu_profiler->begin_statistics(m_active_command_buffer);
+            begin_scene_render_pass(m_recording_passes[scene_pass]);
+            execute_recording_pass(m_recording_passes[scene_pass]);
+            m_queued_draw_calls.clear();
+        }
+
+        void render_imgui(ImDrawData* draw_data)
+        {
+            if (!m_frame_started)
+                throw VulkanError("render_imgui() called outside a frame");
+            finish_scene_rendering();
+            ImGui_ImplVulkan_RenderDrawData(draw_data, m_active_command_buffer);
+        }
+
+        [[nodiscard]] std::optional<CapturedFrame> end_frame(bool capture_screenshot)
+        {
+            ROSE_PROFILE_ZONE("Renderer::end_frame");
+            if (!m_frame_started)
+                return std::nullopt;
+
+            std::optional<CapturedFrame> screenshot = std::move(m_completed_stream_frame);
+            m_completed_stream_frame.reset();
+
+            ReadbackSlot* readback_slot = nullptr;
+            const bool can_capture = capture_screenshot && m_swapchain_supports_transfer_src;
+            if (can_capture)
+            {
+                const VkDeviceSize image_size = static_cast<VkDeviceSize>(m_swapchain_extent.width)
+                                              * static_cast<VkDeviceSize>(m_swapchain_extent.height)
+                                              * 4u;
+                readback_slot = &m_readback_slots[m_current_frame];
+                ensure_readback_slot(*readback_slot, image_size);
+                readback_slot->extent = m_swapchain_extent;
+                readback_slot->format = m_swapchain_image_format;
+            }
+
+            finish_scene_rendering();
+            if (m_present_render_pass_active)
+            {
+                vkCmdEndRenderPass(m_active_command_buffer);
+                m_present_render_pass_active = false;
+            }
+            end_gpu_pass(GpuPass::Present);
+
+            if (readback_slot != nullptr)
+                record_screenshot_copy(readback_slot->buffer);
+
+            m_gpu_profiler->end_frame(m_active_command_buffer);
+            check_vk(vkEndCommandBuffer(m_active_command_buffer), "Failed to end command buffer");
+
+            // Uploads recorded while building this frame go out in one batch. Only resources whose
+            // batch has already retired were drawn, so the frame waits on an already signalled value;
+            // the wait is what makes the transfer writes visible to the graphics queue.
+            m_uploads->flush();
+
+            latch_camera();
+
+            FrameSync& frame = m_frames[m_current_frame];
+            const std::array<VkSemaphore, 2> wait_semaphores{frame.image_available, m_uploads->timeline_semaphore()};
+            const std::array<VkPipelineStageFlags, 2> wait_stages{
+                VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+            };
+            const std::array<uint64_t, 2> wait_values{0, m_uploads->completed_ticket()};
+            const uint64_t signal_value = 0;
+
+            VkTimelineSemaphoreSubmitInfo timeline_info{};
+            timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+            timeline_info.waitSemaphoreValueCount = static_cast<uint32_t>(wait_values.size());
+            timeline_info.pWaitSemaphoreValues = wait_values.data();
+            timeline_info.signalSemaphoreValueCount = 1;
+            timeline_info.pSignalSemaphoreValues = &signal_value;
+
+            VkSubmitInfo submit_info{};
+            submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submit_info.waitSemaphoreCount = 1;
+            submit_info.pWaitSemaphores = wait_semaphores.data();
+            submit_info.pWaitDstStageMask = wait_stages.data();
+            if (m_uploads->uses_timeline_semaphore())
+            {
+                submit_info.pNext = &timeline_info;
+                submit_info.waitSemaphoreCount = static_cast<uint32_t>(wait_semaphores.size());
+            }
+            submit_info.commandBufferCount = 1;
+            submit_info.pCommandBuffers = &m_active_command_buffer;
+            submit_info.signalSemaphoreCount = 1;
+            submit_info.pSignalSemaphores = &frame.render_finished;
+            check_vk(vkQueueSubmit(m_graphics_queue, 1, &submit_info, frame.in_flight), "Failed to submit draw command buffer");
+            frame.submitted_frame = ++m_submitted_frames;
+
+            if (readback_slot != nullptr)
+                readback_slot->pending = true;
+            if (std::exchange(m_pick_recorded, false))
+                m_pick_slots[m_current_frame].readback.pending = true;
+
+            VkPresentInfoKHR present_info{};
+            present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+            present_info.waitSemaphoreCount = 1;
+            present_info.pWaitSemaphores = &frame.render_finished;
+            present_info.swapchainCount = 1;
+            present_info.pSwapchains = &m_swapchain;
+            present_info.pImageIndices = &m_active_image_index;
+
+            VkPresentIdKHR present_id{};
+            if (m_present_wait_supported)
+            {
+                ++m_present_id;
+                present_id.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+                present_id.swapchainCount = 1;
+                present_id.pPresentIds = &m_present_id;
+                present_info.pNext = &present_id;
+            }
+
+            const VkResult result = vkQueuePresentKHR(m_present_queue, &present_info);
+            m_pending_latency.push_back({m_frame_input_sampled_at, m_present_wait_supported ? m_present_id : 0u, m_current_frame});
+            if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
+                recreate_swapchain();
+            else if (result != VK_SUCCESS)
+                check_vk(result, "Failed to present swapchain image");
+
+            if (!m_first_frame_presented)
+            {
+                m_first_frame_presented = true;
+                spdlog::info("Vulkan: first frame presented {} ms after renderer creation",
+                             elapsed_milliseconds(m_created_at));
+            }
+
+            m_current_frame = (m_current_frame + 1u) % static_cast<std::size_t>(m_frames_in_flight);
+            m_active_command_buffer = VK_NULL_HANDLE;
+            m_frame_started = false;
+            if (m_frame_view_projection_set)
+            {
+                m_previous_view_projection = m_frame_view_projection;
+                m_previous_view_projection_valid = true;
+                m_frame_view_projection_set = false;
+            }
+            return screenshot;
+        }
+
+        void late_latch_camera(const omath::opengl_engine::Camera& camera, std::function<void()> update)
+        {
+            if (!m_frame_started)
+                throw VulkanError("late_latch_camera() called outside a frame");
+            m_late_latch_camera = &camera;
+            m_late_latch_update = std::move(update);
+        }
+
+        // Lets the caller move the late-latched camera one last time and writes its matrices for
+        // the draws recorded with it. Runs after the command buffer is closed, so only the
+        // uniform write and the submit separate the latch from the GPU.
+        void latch_camera()
+        {
+            const omath::opengl_engine::Camera* camera = std::exchange(m_late_latch_camera, nullptr);
+            std::function<void()> update = std::exchange(m_late_latch_update, {});
+            const bool used = std::exchange(m_late_latch_used, false);
+            const bool frame_latched = std::exchange(m_frame_view_projection_latched, false);
+            if (camera == nullptr || !used)
+                return;
+
+            ROSE_PROFILE_ZONE("Latch camera");
+            const omath::opengl_engine::ViewAngles early_angles = camera->get_view_angles();
+            if (update)
+                update();
+            const auto latched_at = std::chrono::steady_clock::now();
+
+            const auto vp = camera->get_view_projection_matrix().raw_array();
+            CameraUniform uniform{};
+            std::memcpy(uniform.view_projection, vp.data(), sizeof(uniform.view_projection));
+            std::memcpy(uniform.previous_view_projection,
+                        m_previous_view_projection_valid ? m_previous_view_projection.data() : vp.data(),
+                        sizeof(uniform.previous_view_projection));
+            std::memcpy(mapped_memory(m_camera_buffers[m_current_frame], "Camera buffer is not host visible"),
+                        &uniform,
+                        sizeof(CameraUniform));
+
+            // The scene was rendered from the latched camera, so motion vectors of the next frame
+            // and its occlusion test against this frame's depth must start from it as well.
+            if (frame_latched)
+            {
+                std::copy(vp.begin(), vp.end(), m_frame_view_projection.begin());
+                if (m_hiz.valid)
+                    m_hiz.view_projection = m_frame_view_projection;
+            }
+
+            const omath::opengl_engine::ViewAngles& latched_angles = camera->get_view_angles();
+            const float yaw_degrees = std::remainder(latched_angles.yaw.as_degrees() - early_angles.yaw.as_degrees(), 360.0f);
+            const float pitch_degrees = latched_angles.pitch.as_degrees() - early_angles.pitch.as_degrees();
+            m_late_latch_ms.push_back(std::chrono::duration<float, std::milli>(latched_at - m_frame_input_sampled_at).count());
+            m_late_latch_degrees.push_back(std::hypot(yaw_degrees, pitch_degrees));
+            if (m_late_latch_ms.size() > k_latency_history_size)
+            {
+                m_late_latch_ms.pop_front();
+                m_late_latch_degrees.pop_front();
+            }
+        }
+
+        [[nodiscard]] LateLatchStats late_latch_stats() const
+        {
+            LateLatchStats stats;
+            stats.samples = m_late_latch_ms.size();
+            if (m_late_latch_ms.empty())
+                return stats;
+
+            float sum_ms = 0.0f;
+            float sum_degrees = 0.0f;
+            for (std::size_t i = 0; i < m_late_latch_ms.size(); ++i)
+            {
+                sum_ms += m_late_latch_ms[i];
+                sum_degrees += m_late_latch_degrees[i];
+                stats.max_degrees = std::max(stats.max_degrees, m_late_latch_degrees[i]);
+            }
+            stats.mean_ms = sum_ms / static_cast<float>(stats.samples);
+            stats.mean_degrees = sum_degrees / static_cast<float>(stats.samples);
+            const GpuTimingPercentiles percentiles = timing_percentiles(std::vector<float>(m_late_latch_ms.begin(), m_late_latch_ms.end()));
+            stats.p95_ms = percentiles.p95;
+            return stats;
+        }
+
+        void wait_idle() const
+        {
+            check_vk(vkDeviceWaitIdle(m_device), "Failed to wait for Vulkan device");
+        }
+
+        void wait_for_present(uint32_t max_pending, uint64_t timeout_ns)
+        {
+            if (!m_present_wait_supported || m_present_id < m_swapchain_first_present_id + max_pending)
+                return;
+
+            ROSE_PROFILE_ZONE("Wait for present");
+            const VkResult result = m_wait_for_present(m_device, m_swapchain, m_present_id - max_pending, timeout_ns);
+            // An out-of-date swapchain is recreated by the next acquire or present.
+            if (result != VK_SUCCESS && result != VK_TIMEOUT && result != VK_SUBOPTIMAL_KHR
+                && result != VK_ERROR_OUT_OF_DATE_KHR)
+                check_vk(result, "Failed to wait for present");
+            collect_latency_samples();
+        }
+
+        void set_latency_profile(const LatencyProfile& profile)
+        {
+            LatencyProfile clamped = profile;
+            clamped.frames_in_flight = std::clamp<uint32_t>(profile.frames_in_flight, 1u, k_max_frames_in_flight);
+            clamped.swapchain_images = std::min(profile.swapchain_images, 8u);
+            if (clamped.present_mode == m_latency_profile.present_mode
+                && clamped.frames_in_flight == m_latency_profile.frames_in_flight
+                && clamped.swapchain_images == m_latency_profile.swapchain_images)
+                return;
+            m_latency_profile = clamped;
+            m_latency_profile_dirty = true;
+        }
+
+        void apply_latency_profile()
+        {
+            m_latency_profile_dirty = false;
+            check_vk(vkDeviceWaitIdle(m_device), "Failed to wait for device before applying the latency profile");
+            m_completed_frames = m_submitted_frames;
+            // Every frame slot is idle, so the next frame may start at any of them.
+            m_frames_in_flight = m_latency_profile.frames_in_flight;
+            m_current_frame = 0;
+            m_pending_latency.clear();
+            m_latency_ms.clear();
+            recreate_swapchain();
+            spdlog::info("Vulkan: latency profile frames_in_flight={} swapchain_images={} present_mode={}",
+                         m_frames_in_flight,
+                         m_swapchain_images.size(),
+                         present_mode_name(m_present_mode));
+        }
+
+        // Samples resolve in submission order, each the first time its frame is seen displayed
+        // or finished; the slot's fence is checked before it is reset for another frame.
+        void collect_latency_samples()
+        {
+            const auto now = std::chrono::steady_clock::now();
+            while (!m_pending_latency.empty())
+            {
+                const LatencySample& sample = m_pending_latency.front();
+                bool done = false;
+                if (sample.present_id != 0)
+                {
+                    // Ids of a destroyed swapchain never complete.
+                    if (sample.present_id < m_swapchain_first_present_id)
+                    {
+                        m_pending_latency.pop_front();
+                        continue;
+                    }
+                    done = m_wait_for_present(m_device, m_swapchain, sample.present_id, 0) == VK_SUCCESS;
+                }
+                else
+                {
+                    done = vkGetFenceStatus(m_device, m_frames[sample.frame_index].in_flight) == VK_SUCCESS;
+                }
+                if (!done)
+                    break;
+
+                m_latency_ms.push_back(std::chrono::duration<float, std::milli>(now - sample.input_sampled_at).count());
+                if (m_latency_ms.size() > k_latency_history_size)
+                    m_latency_ms.pop_front();
+                m_pending_latency.pop_front();
+            }
+        }
+
+        [[nodiscard]] LatencyStats latency_stats() const
+        {
+            LatencyStats stats;
+            stats.present_mode = from_vk_present_mode(m_present_mode);
+            stats.swapchain_images = static_cast<uint32_t>(m_swapchain_images.size());
+            stats.frames_in_flight = m_frames_in_flight;
+            stats.to_display = m_present_wait_supported;
+            stats.samples = m_latency_ms.size();
+            if (m_latency_ms.empty())
+                return stats;
+
+            float sum = 0.0f;
+            for (const float latency : m_latency_ms)
+                sum += latency;
+            stats.mean_ms = sum / static_cast<float>(m_latency_ms.size());
+            const GpuTimingPercentiles percentiles = timing_percentiles(std::vector<float>(m_latency_ms.begin(), m_latency_ms.end()));
+            stats.p50_ms = percentiles.p50;
+            stats.p95_ms = percentiles.p95;
+            stats.p99_ms = percentiles.p99;
+            return stats;
+        }
+
+        [[nodiscard]] omath::Vector2<int> framebuffer_size() const
+        {
+            return {
+                static_cast<int>(m_swapchain_extent.width),
+                static_cast<int>(m_swapchain_extent.height)
+            };
+        }
+
+        [[nodiscard]] bool dlss_available() const
+        {
+#ifdef ROSE_ENABLE_NGX_DLSS
+            return m_ngx_available
+                || (!m_ngx_init_attempted && !m_ngx_disabled_by_env && m_ngx_extensions_available);
+#else
+            return false;
+#endif
+        }
+
+        [[nodiscard]] bool dlss_active() const
+        {
+#ifdef ROSE_ENABLE_NGX_DLSS
+            return m_dlss_requested
+                && m_ngx_available
+                && m_ngx_dlss_handle != nullptr;
+#else
+            return false;
+#endif
+        }
+
+        [[nodiscard]] VkExtent2D choose_scene_extent()
+        {
+            VkExtent2D extent = m_swapchain_extent;
+#ifdef ROSE_ENABLE_NGX_DLSS
+            release_dlss_feature();
+            if (!m_dlss_requested || !m_ngx_available || m_ngx_parameters == nullptr)
+                return extent;
+
+            unsigned int optimal_width = m_swapchain_extent.width;
+            unsigned int optimal_height = m_swapchain_extent.height;
+            unsigned int max_width = optimal_width;
+            unsigned int max_height = optimal_height;
+            unsigned int min_width = optimal_width;
+            unsigned int min_height = optimal_height;
+            float sharpness = 0.0f;
+            const NVSDK_NGX_Result settings_result = NGX_DLSS_GET_OPTIMAL_SETTINGS(m_ngx_parameters,
+                                                                                   m_swapchain_extent.width,
+                                                                                   m_swapchain_extent.height,
+                                                                                   to_ngx_quality(m_dlss_quality),
+                                                                                   &optimal_width,
+                                                                                   &optimal_height,
+                                                                                   &max_width,
+                                                                                   &max_height,
+                                                                                   &min_width,
+                                                                                   &min_height,
+                                                                                   &sharpness);
+            if (NVSDK_NGX_FAILED(settings_result) || optimal_width == 0 || optimal_height == 0)
+            {
+                m_dlss_status = std::string("DLSS settings query failed: ") + ngx_result_name(settings_result);
+                return extent;
+            }
+
+            extent.width = optimal_width;
+            extent.height = optimal_height;
+            m_dlss_sharpness = sharpness;
+            if (!create_dlss_feature(extent))
+            {
+                m_dlss_requested = false;
+                extent = m_swapchain_extent;
+            }
+#endif
+            return extent;
+        }
+
+        [[nodiscard]] bool ensure_dlss_sdk_initialized()
+        {
+#ifdef ROSE_ENABLE_NGX_DLSS
+            if (m_ngx_available)
+                return true;
+            if (m_ngx_disabled_by_env)
+            {
+                m_dlss_status = "DLSS disabled by ROSE_DISABLE_NGX_DLSS";
+                return false;
+            }
+            if (m_ngx_init_attempted)
+                return false;
+
+            m_ngx_init_attempted = true;
+            init_dlss_sdk();
+            return m_ngx_available;
+#else
+            m_dlss_status = "DLSS support was not compiled";
+            return false;
+#endif
+        }
+
+        void init_dlss_sdk()
+        {
+#ifdef ROSE_ENABLE_NGX_DLSS
+            if (!m_ngx_extensions_available)
+            {
+                spdlog::warn("Vulkan: skipping NGX init because required extensions are unavailable");
+                return;
+            }
+
+            std::error_code error;
+            const std::filesystem::path log_path = std::filesystem::current_path(error) / "ngx";
+            if (!error)
+                std::filesystem::create_directories(log_path, error);
+            const std::wstring log_path_w = log_path.wstring();
+            spdlog::info("Vulkan: initializing NVIDIA NGX/DLSS");
+
+            NVSDK_NGX_FeatureCommonInfo feature_info{};
+            feature_info.LoggingInfo.MinimumLoggingLevel = NVSDK_NGX_LOGGING_LEVEL_ON;
+            const NVSDK_NGX_Result init_result =
+                NVSDK_NGX_VULKAN_Init_with_ProjectID("7b8f624d-44ea-4bc6-b656-4e72206d8d54",
+                                                     NVSDK_NGX_ENGINE_TYPE_CUSTOM,
+                                                     "1.0.0",
+                                                     log_path_w.c_str(),
+                                                     m_instance,
+                                                     m_physical_device,
+                                                     m_device,
+                                                     vkGetInstanceProcAddr,
+                                                     vkGetDeviceProcAddr,
+                                                     &feature_info);
+            if (NVSDK_NGX_FAILED(init_result))
+            {
+                m_dlss_status = std::string("NGX init failed: ") + ngx_result_name(init_result);
+                spdlog::warn("Vulkan: {}", m_dlss_status);
+                return;
+            }
+            m_ngx_initialized = true;
+
+            const NVSDK_NGX_Result params_result = NVSDK_NGX_VULKAN_GetCapabilityParameters(&m_ngx_parameters);
+            if (NVSDK_NGX_FAILED(params_result) || m_ngx_parameters == nullptr)
+            {
+                m_dlss_status = std::string("NGX capability query failed: ") + ngx_result_name(params_result);
+                spdlog::warn("Vulkan: {}", m_dlss_status);
+                return;
+            }
+
+            int available = 0;
+            const NVSDK_NGX_Result available_result =
+                m_ngx_parameters->Get(NVSDK_NGX_Parameter_SuperSampling_Available, &available);
+            if (NVSDK_NGX_FAILED(available_result) || available == 0)
+            {
+                m_dlss_status = "DLSS is not available on this system";
+                spdlog::warn("Vulkan: {}", m_dlss_status);
+                return;
+            }
+
+            m_ngx_available = true;
+            m_dlss_status = "DLSS is available";
+            spdlog::info("Vulkan: {}", m_dlss_status);
+#else
+            m_dlss_status = "DLSS support was not compiled";
+#endif
+        }
+
+        void release_dlss_feature()
+        {
+#ifdef ROSE_ENABLE_NGX_DLSS
+            if (m_ngx_dlss_handle != nullptr)
+            {
+                const NVSDK_NGX_Result result = NVSDK_NGX_VULKAN_ReleaseFeature(m_ngx_dlss_handle);
+                if (NVSDK_NGX_FAILED(result))
+                    spdlog::warn("Failed to release DLSS feature: {}", ngx_result_name(result));
+                m_ngx_dlss_handle = nullptr;
+            }
+#endif
+        }
+
+        [[nodiscard]] bool create_dlss_feature(VkExtent2D render_extent)
+        {
+#ifdef ROSE_ENABLE_NGX_DLSS
+            NVSDK_NGX_DLSS_Create_Params create_params{};
+            create_params.Feature.InWidth = render_extent.width;
+            create_params.Feature.InHeight = render_extent.height;
+            create_params.Feature.InTargetWidth = m_swapchain_extent.width;
+            create_params.Feature.InTargetHeight = m_swapchain_extent.height;
+            create_params.Feature.InPerfQualityValue = to_ngx_quality(m_dlss_quality);
+            create_params.InFeatureCreateFlags = NVSDK_NGX_DLSS_Feature_Flags_MVLowRes
+                                               | NVSDK_NGX_DLSS_Feature_Flags_AutoExposure;
+            create_params.InEnableOutputSubrects = false;
+
+            VkCommandBuffer command_buffer = begin_single_time_commands();
+            const NVSDK_NGX_Result result = NGX_VULKAN_CREATE_DLSS_EXT1(m_device,
+                                                                        command_buffer,
+                                                                        1,
+                                                                        1,
+                                                                        &m_ngx_dlss_handle,
+                                                                        m_ngx_parameters,
+                                                                        &create_params);
+            end_single_time_commands(command_buffer);
+
+            if (NVSDK_NGX_FAILED(result) || m_ngx_dlss_handle == nullptr)
+            {
+                m_ngx_dlss_handle = nullptr;
+                m_dlss_status = std::string("DLSS feature creation failed: ") + ngx_result_name(result);
+                spdlog::warn("Vulkan: {}", m_dlss_status);
+                return false;
+            }
+
+            m_dlss_reset_next_frame = true;
+            m_dlss_status = std::string("DLSS ") + dlss_quality_label(m_dlss_quality)
+                          + " (" + std::to_string(render_extent.width) + "x" + std::to_string(render_extent.height)
+                          + " -> " + std::to_string(m_swapchain_extent.width) + "x" + std::to_string(m_swapchain_extent.height)
+                          + ")";
+            spdlog::info("Vulkan: {}", m_dlss_status);
+            return true;
+#else
+            static_cast<void>(render_extent);
+            return false;
+#endif
+        }
+
+        void shutdown_dlss_sdk()
+        {
+#ifdef ROSE_ENABLE_NGX_DLSS
+            release_dlss_feature();
+            if (m_ngx_parameters != nullptr)
+            {
+                const NVSDK_NGX_Result result = NVSDK_NGX_VULKAN_DestroyParameters(m_ngx_parameters);
+                if (NVSDK_NGX_FAILED(result))
+                    spdlog::warn("Failed to destroy NGX parameters: {}", ngx_result_name(result));
+                m_ngx_parameters = nullptr;
+            }
+            if (m_ngx_initialized)
+            {
+                const NVSDK_NGX_Result result = NVSDK_NGX_VULKAN_Shutdown1(m_device);
+                if (NVSDK_NGX_FAILED(result))
+                    spdlog::warn("Failed to shut down NGX: {}", ngx_result_name(result));
+                m_ngx_initialized = false;
+            }
+            m_ngx_available = false;
+#endif
+        }
+
+        // Hands the scene-sized targets to `retired`: color, motion vectors, depth, the depth and
+        // bloom pyramids, the selection outline and pick targets, the DLSS output and the DLSS
+        // feature recorded against them.
+        void retire_scene_targets(RetiredFrameResources& retired)
+        {
+            if (m_scene_framebuffer != VK_NULL_HANDLE)
+                retired.framebuffers.push_back(std::exchange(m_scene_framebuffer, VK_NULL_HANDLE));
+            for (ImageResource* image : {&m_dlss_output_image, &m_motion_vector_image, &m_scene_color_image, &m_depth_image})
+            {
+                if (image->image != VK_NULL_HANDLE)
+                    retired.images.push_back(std::exchange(*image, {}));
+            }
+
+            std::ranges::move(m_hiz.mip_views, std::back_inserter(retired.image_views));
+            std::ranges::move(m_hiz.descriptors, std::back_inserter(retired.descriptors));
+            if (m_hiz.image.image != VK_NULL_HANDLE)
+                retired.images.push_back(m_hiz.image);
+            m_hiz = {};
+
+            std::ranges::move(m_bloom.mip_views, std::back_inserter(retired.image_views));
+            for (const auto& descriptors : {std::span<const VkDescriptorSet>(m_bloom.prefilter_descriptors),
+                                            std::span<const VkDescriptorSet>(m_bloom.composite_descriptors),
+                                            std::span<const VkDescriptorSet>(m_bloom.downsample_descriptors),
+                                            std::span<const VkDescriptorSet>(m_bloom.upsample_descriptors)})
+            {
+                for (const VkDescriptorSet descriptor : descriptors)
+                {
+                    if (descriptor != VK_NULL_HANDLE)
+                        retired.descriptors.push_back(descriptor);
+                }
+            }
+            if (m_bloom.image.image != VK_NULL_HANDLE)
+                retired.images.push_back(m_bloom.image);
+            m_bloom = {};
+
+            for (const VkFramebuffer framebuffer : {m_selection.mask_framebuffer, m_selection.composite_framebuffer})
+            {
+                if (framebuffer != VK_NULL_HANDLE)
+                    retired.framebuffers.push_back(framebuffer);
+            }
+            for (const ImageResource& image : {m_selection.seeds[0], m_selection.seeds[1], m_selection.seed_data})
+            {
+                if (image.image != VK_NULL_HANDLE)
+                    retired.images.push_back(image);
+            }
+            for (const VkDescriptorSet descriptor : {m_selection.jump_descriptors[0],
+                                                     m_selection.jump_descriptors[1],
+                                                     m_selection.composite_descriptors[0],
+                                                     m_selection.composite_descriptors[1]})
+            {
+                if (descriptor != VK_NULL_HANDLE)
+                    retired.descriptors.push_back(descriptor);
+            }
+            m_selection = {};
+
+            if (m_pick.framebuffer != VK_NULL_HANDLE)
+                retired.framebuffers.push_back(m_pick.framebuffer);
+            for (const ImageResource& image : {m_pick.ids, m_pick.depth})
+            {
+                if (image.image != VK_NULL_HANDLE)
+                    retired.images.push_back(image);
+            }
+            m_pick = {};
+#ifdef ROSE_ENABLE_NGX_DLSS
+            retired.dlss_feature = std::exchange(m_ngx_dlss_handle, nullptr);
+#endif
+        }
+
+        void retire_shadow_targets(RetiredFrameResources& retired)
+        {
+            if (m_shadow_framebuffer != VK_NULL_HANDLE)
+                retired.framebuffers.push_back(std::exchange(m_shadow_framebuffer, VK_NULL_HANDLE));
+            std::ranges::move(m_sun_shadow_framebuffers, std::back_inserter(retired.framebuffers));
+            m_sun_shadow_framebuffers.clear();
+            std::ranges::move(m_sun_shadow_layer_views, std::back_inserter(retired.image_views));
+            m_sun_shadow_layer_views.clear();
+
+            retire_shadow_cache(retired, m_shadow_cache);
+            for (ShadowCache& cache : m_sun_shadow_caches)
+                retire_shadow_cache(retired, cache);
+            for (ImageResource* image : {&m_shadow_image, &m_sun_shadow_image})
+            {
+                if (image->image != VK_NULL_HANDLE)
+                    retired.images.push_back(std::exchange(*image, {}));
+            }
+        }
+
+        // Queues `retired` behind every frame submitted so far.
+        void retire_frame_resources(RetiredFrameResources&& retired)
+        {
+            retired.last_frame = m_submitted_frames;
+            if (retired.last_frame <= m_completed_frames)
+                destroy_retired_frame_resources(retired);
+            else
+                m_retired_frame_resources.push_back(std::move(retired));
+        }
+
+        void collect_retired_frame_resources() noexcept
+        {
+            while (!m_retired_frame_resources.empty()
+                   && m_retired_frame_resources.front().last_frame <= m_completed_frames)
+            {
+                destroy_retired_frame_resources(m_retired_frame_resources.front());
+                m_retired_frame_resources.pop_front();
+            }
+        }
+
+        void destroy_retired_frame_resources(RetiredFrameResources& retired) noexcept
+        {
+            for (VkFramebuffer framebuffer : retired.framebuffers)
+                vkDestroyFramebuffer(m_device, framebuffer, nullptr);
+            for (VkImageView view : retired.image_views)
+                vkDestroyImageView(m_device, view, nullptr);
+            for (ImageResource& image : retired.images)
+                destroy_image(image);
+            if (!retired.descriptors.empty())
+                vkFreeDescriptorSets(m_device,
+                                     m_descriptor_pool,
+                                     static_cast<uint32_t>(retired.descriptors.size()),
+                                     retired.descriptors.data());
+#ifdef ROSE_ENABLE_NGX_DLSS
+            if (retired.dlss_feature != nullptr)
+            {
+                const NVSDK_NGX_Result result = NVSDK_NGX_VULKAN_ReleaseFeature(retired.dlss_feature);
+                if (NVSDK_NGX_FAILED(result))
+                    spdlog::warn("Failed to release DLSS feature: {}", ngx_result_name(result));
+            }
+#endif
+            if (retired.swapchain != VK_NULL_HANDLE)
+                vkDestroySwapchainKHR(m_device, retired.swapchain, nullptr);
+            retired = {};
+        }
+
+        // The device must be idle.
+        void destroy_frame_targets() noexcept
+        {
+            RetiredFrameResources retired;
+            retire_scene_targets(retired);
+            retire_shadow_targets(retired);
+            std::ranges::move(m_framebuffers, std::back_inserter(retired.framebuffers));
+            m_framebuffers.clear();
+            destroy_retired_frame_resources(retired);
+
+            for (RetiredFrameResources& pending : m_retired_frame_resources)
+                destroy_retired_frame_resources(pending);
+            m_retired_frame_resources.clear();
+        }
+
+        // Frames in flight keep rendering with the old targets; they are destroyed once retired.
+        void recreate_scene_targets()
+        {
+            if (m_frame_started)
+                return;
+
+            spdlog::info("Vulkan: recreating scene targets");
+            RetiredFrameResources retired;
+            retire_scene_targets(retired);
+            create_scene_targets();
+            retire_frame_resources(std::move(retired));
+        }
+
+        void recreate_shadow_targets()
+        {
+            if (m_frame_started)
+                return;
+
+            spdlog::info("Vulkan: recreating shadow targets");
+            RetiredFrameResources retired;
+            retire_shadow_targets(retired);
+            create_shadow_targets();
+            retire_frame_resources(std::move(retired));
+        }
+
+        void set_dlss_enabled(bool enabled)
+        {
+            spdlog::info("Vulkan: DLSS {}", enabled ? "enable requested" : "disable requested");
+            if (enabled && !ensure_dlss_sdk_initialized())
+            {
+                m_dlss_requested = false;
+                m_dlss_reset_next_frame = true;
+                spdlog::warn("Vulkan: DLSS enable failed: {}", m_dlss_status);
+                return;
+            }
+
+            if (m_dlss_requested == enabled)
+                return;
+
+            m_dlss_requested = enabled;
+            m_dlss_reset_next_frame = true;
+            if (!enabled)
+                m_dlss_status = "DLSS is disabled";
+            recreate_scene_targets();
+        }
+
+        void set_dlss_quality(DlssQuality quality)
+        {
+            if (m_dlss_quality == quality)
+                return;
+
+            m_dlss_quality = quality;
+            m_dlss_reset_next_frame = true;
+            if (m_dlss_requested)
+                recreate_scene_targets();
+        }
+
+        void set_selection_outline_settings(const SelectionOutlineSettings& settings)
+        {
+            m_selection_outline_settings = settings;
+            for (float& channel : m_selection_outline_settings.color)
+                channel = std::clamp(channel, 0.0f, 1.0f);
+            m_selection_outline_settings.width = std::clamp(m_selection_outline_settings.width, 0.0f, 2.0f);
+            m_selection_outline_settings.smoothing_quality =
+                std::clamp(m_selection_outline_settings.smoothing_quality, 1, 64);
+        }
+
+        void set_bloom_settings(const BloomSettings& settings)
+        {
+            m_bloom_settings = settings;
+            m_bloom_settings.threshold = std::clamp(m_bloom_settings.threshold, 0.0f, 8.0f);
+            m_bloom_settings.intensity = std::clamp(m_bloom_settings.intensity, 0.0f, 5.0f);
+            m_bloom_settings.radius = std::clamp(m_bloom_settings.radius, 0.0f, 4.0f);
+            m_bloom_settings.levels = std::clamp(m_bloom_settings.levels, 1, BloomSettings::k_max_levels);
+        }
+
+        void set_spotlight_settings(const SpotlightSettings& settings)
+        {
+            m_spotlight_settings = settings;
+            for (float& channel : m_spotlight_settings.color)
+                channel = std::clamp(channel, 0.0f, 1.0f);
+            m_spotlight_settings.intensity = std::clamp(m_spotlight_settings.intensity, 0.0f, 1000.0f);
+            m_spotlight_settings.range = std::clamp(m_spotlight_settings.range, 0.1f, 500.0f);
+            m_spotlight_settings.inner_angle_degrees =
+                std::clamp(m_spotlight_settings.inner_angle_degrees, 0.1f, 89.0f);
+            m_spotlight_settings.outer_angle_degrees =
+                std::clamp(m_spotlight_settings.outer_angle_degrees,
+                           m_spotlight_settings.inner_angle_degrees + 0.1f,
+                           89.9f);
+
+            const float length = std::sqrt(m_spotlight_settings.direction.x * m_spotlight_settings.direction.x
+                                         + m_spotlight_settings.direction.y * m_spotlight_settings.direction.y
+                                         + m_spotlight_settings.direction.z * m_spotlight_settings.direction.z);
+            if (length > 0.0001f)
+                m_spotlight_settings.direction = m_spotlight_settings.direction / length;
+            else
+                m_spotlight_settings.direction = {0.0f, 0.0f, -1.0f};
+        }
+
+        void set_sun_settings(const SunSettings& settings)
+        {
+            m_sun_settings = settings;
+            for (float& channel : m_sun_settings.color)
+                channel = std::clamp(channel, 0.0f, 1.0f);
+            m_sun_settings.intensity = std::clamp(m_sun_settings.intensity, 0.0f, 50.0f);
+            m_sun_settings.shadow_distance = std::clamp(m_sun_settings.shadow_distance, 5.0f, 500.0f);
 
             const float length = std::sqrt(m_sun_settings.direction.x * m_sun_settings.direction.x
                                          + m_sun_settings.direction.y * m_sun_settings.direction.y
@@ -1531,9 +3520,46 @@ namespace rose::core::vulkan
                 m_sun_settings.direction = m_sun_settings.direction / length;
             else
                 m_sun_settings.direction = {-0.35f, -0.75f, -0.45f};
+
+            m_sun_settings.cascade_count =
+                std::clamp(m_sun_settings.cascade_count, 1, static_cast<int>(k_max_sun_cascades));
+            m_sun_settings.cascade_resolution = static_cast<int>(
+                std::bit_floor(static_cast<uint32_t>(std::clamp(m_sun_settings.cascade_resolution, 512, 4096))));
+            m_sun_settings.split_lambda = std::clamp(m_sun_settings.split_lambda, 0.0f, 1.0f);
+            if (m_sun_shadow_image.image != VK_NULL_HANDLE
+                && (static_cast<uint32_t>(m_sun_settings.cascade_count) != m_sun_cascade_count
+                    || static_cast<uint32_t>(m_sun_settings.cascade_resolution) != m_sun_shadow_resolution))
+                recreate_shadow_targets();
+        }
+
+        [[nodiscard]] std::vector<MemoryHeapStats> memory_stats() const
+        {
+            std::vector<MemoryHeapStats> stats;
+            if (!m_allocator)
+                return stats;
+
+            for (const DeviceHeapUsage& usage : m_allocator->heap_usage())
+            {
+                MemoryHeapStats heap;
+                heap.heap_index = usage.heap_index;
+                heap.device_local = (usage.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+                heap.heap_size = usage.heap_size;
+                heap.reserved_bytes = usage.reserved_bytes;
+                heap.used_bytes = usage.used_bytes;
+                heap.block_count = usage.block_count;
+                heap.dedicated_count = usage.dedicated_count;
+                heap.allocation_count = usage.allocation_count;
+                stats.push_back(heap);
+            }
+            return stats;
         }
 
-        [[nodiscard]] std::array<float, 16> compute_sun_view_projection() const
+        // Orthographic sun projection around a bounding sphere. The view only rotates, and the
+        // sphere centre is snapped to whole shadow map texels in light space, so the projection
+        // changes in texel steps: the map does not shimmer while the camera moves, and a camera
+        // that moves less than a texel keeps the cascade (and its cached map) unchanged.
+        [[nodiscard]] std::array<float, 16> compute_sun_view_projection(const omath::Vector3<float>& center,
+                                                                        float radius) const
         {
             omath::Vector3<float> direction = m_sun_settings.direction;
             const float length = std::sqrt(direction.x * direction.x
@@ -1544,34 +3570,100 @@ namespace rose::core::vulkan
             else
                 direction = {-0.35f, -0.75f, -0.45f};
 
-            const float half_extent = m_sun_settings.shadow_distance;
-            const float far_plane = half_extent * 2.5f;
-            const omath::Vector3<float> eye = -direction * half_extent;
-            const omath::Vector3<float> target{0.0f, 0.0f, 0.0f};
+            const omath::Vector3<float> origin{0.0f, 0.0f, 0.0f};
             const omath::Vector3<float> up = std::abs(direction.y) > 0.92f
                 ? omath::Vector3<float>{0.0f, 0.0f, 1.0f}
                 : omath::Vector3<float>{0.0f, 1.0f, 0.0f};
+            const auto view =
+                omath::mat_look_at_right_handed<float, omath::MatStoreType::COLUMN_MAJOR>(origin, direction, up);
+
+            const float texel = 2.0f * radius / static_cast<float>(m_sun_shadow_resolution);
+            const omath::Vector3<float> light_center = transform_point(view.raw_array(), center.x, center.y, center.z);
+            const float x = std::floor(light_center.x / texel) * texel;
+            const float y = std::floor(light_center.y / texel) * texel;
+            const float depth = -std::floor(light_center.z / texel) * texel;
+            // Without depth clamping, casters between the sun and the sphere need room in front.
+            const float extrusion = m_depth_clamp_supported ? 0.0f : m_sun_settings.shadow_distance;
 
             const auto projection =
                 omath::mat_ortho_right_handed<float, omath::MatStoreType::COLUMN_MAJOR>(
-                    -half_extent,
-                    half_extent,
-                    -half_extent,
-                    half_extent,
-                    0.05f,
-                    far_plane);
-            const auto view =
-                omath::mat_look_at_right_handed<float, omath::MatStoreType::COLUMN_MAJOR>(eye, target, up);
+                    x - radius,
+                    x + radius,
+                    y - radius,
+                    y + radius,
+                    depth - radius - extrusion,
+                    depth + radius);
             return (projection * view).raw_array();
         }
 
-        void update_light_buffer(std::size_t frame_index)
+        // Splits the camera frustum up to shadow_distance into one slice per cascade, blending
+        // logarithmic and uniform splits by split_lambda, and bounds each slice with a sphere so
+        // that the cascade size does not change as the camera turns.
+        void update_sun_cascades(const omath::opengl_engine::Camera& camera)
         {
-            constexpr float pi = 3.14159265358979323846f;
-            constexpr float radians_per_degree = pi / 180.0f;
+            const auto inverse = inverse_matrix(camera.get_view_projection_matrix().raw_array());
+            if (!inverse)
+                return;
 
-            const float inner_cos = std::cos(m_spotlight_settings.inner_angle_degrees * radians_per_degree);
-            const float outer_cos = std::cos(m_spotlight_settings.outer_angle_degrees * radians_per_degree);
+            std::array<omath::Vector3<float>, 4> near_corners{};
+            std::array<omath::Vector3<float>, 4> far_corners{};
+            for (std::size_t i = 0; i < near_corners.size(); ++i)
+            {
+                const float x = (i & 1u) != 0 ? 1.0f : -1.0f;
+                const float y = (i & 2u) != 0 ? 1.0f : -1.0f;
+                near_corners[i] = transform_point(*inverse, x, y, -1.0f);
+                far_corners[i] = transform_point(*inverse, x, y, 1.0f);
+            }
+
+            const auto distance = [](const omath::Vector3<float>& a, const omath::Vector3<float>& b)
+            {
+                const omath::Vector3<float> d = a - b;
+                return std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z);
+            };
+            const omath::Vector3<float> eye = camera.get_origin();
+            const float near_depth = std::max(distance(transform_point(*inverse, 0.0f, 0.0f, -1.0f), eye), 0.001f);
+            const float far_depth = distance(transform_point(*inverse, 0.0f, 0.0f, 1.0f), eye);
+            if (far_depth <= near_depth)
+                return;
+            const float shadow_depth = std::clamp(m_sun_settings.shadow_distance, near_depth * 1.01f, far_depth);
+
+            float slice_near = near_depth;
+            for (uint32_t cascade = 0; cascade < m_sun_cascade_count; ++cascade)
+            {
+                const float t = static_cast<float>(cascade + 1u) / static_cast<float>(m_sun_cascade_count);
+                const float log_split = near_depth * std::pow(shadow_depth / near_depth, t);
+                const float uniform_split = near_depth + (shadow_depth - near_depth) * t;
+                const float slice_far = m_sun_settings.split_lambda * log_split
+                                      + (1.0f - m_sun_settings.split_lambda) * uniform_split;
+
+                // Points of equal view depth lie at the same fraction along every corner edge.
+                const float near_t = (slice_near - near_depth) / (far_depth - near_depth);
+                const float far_t = (slice_far - near_depth) / (far_depth - near_depth);
+                std::array<omath::Vector3<float>, 8> corners{};
+                omath::Vector3<float> center{0.0f, 0.0f, 0.0f};
+                for (std::size_t i = 0; i < near_corners.size(); ++i)
+                {
+                    const omath::Vector3<float> edge = far_corners[i] - near_corners[i];
+                    corners[i] = near_corners[i] + edge * near_t;
+                    corners[i + 4] = near_corners[i] + edge * far_t;
+                    center = center + corners[i] + corners[i + 4];
+                }
+                center = center / 8.0f;
+
+                float radius = 0.0f;
+                for (const omath::Vector3<float>& corner : corners)
+                    radius = std::max(radius, distance(corner, center));
+                // Rounded up so that floating-point noise does not resize the cascade.
+                radius = std::ceil(radius * 16.0f) / 16.0f;
+
+                m_sun_view_projections[cascade] = compute_sun_view_projection(center, radius);
+                slice_near = slice_far;
+            }
+        }
+
+        // Without a camera this frame the sun cascades keep their previous fit.
+        [[nodiscard]] std::array<float, 16> spotlight_view_projection() const
+        {
             const float light_fov = std::clamp(m_spotlight_settings.outer_angle_degrees * 2.0f, 1.0f, 170.0f);
             omath::opengl_engine::Camera light_camera{
                 m_spotlight_settings.position,
@@ -1582,8 +3674,41 @@ namespace rose::core::vulkan
                 m_spotlight_settings.range
             };
             light_camera.look_at(m_spotlight_settings.position + m_spotlight_settings.direction);
-            m_light_view_projection = light_camera.get_view_projection_matrix().raw_array();
-            m_sun_view_projection = compute_sun_view_projection();
+            return light_camera.get_view_projection_matrix().raw_array();
+        }
+
+        // Fits the shadow maps to `camera` now; record_queued_draws() fits them to the frame's
+        // first camera again, so for that camera both agree.
+        [[nodiscard]] std::vector<Frustum> culling_frusta(const omath::opengl_engine::Camera& camera)
+        {
+            m_light_view_projection = spotlight_view_projection();
+            update_sun_cascades(camera);
+
+            std::vector<Frustum> frusta;
+            frusta.reserve(2u + m_sun_cascade_count);
+            frusta.push_back(Frustum::from_view_projection(camera.get_view_projection_matrix().raw_array()));
+            for (const ShadowPassKind pass_kind : {ShadowPassKind::Spotlight, ShadowPassKind::Sun})
+            {
+                for (uint32_t layer = 0; layer < shadow_layer_count(pass_kind); ++layer)
+                {
+                    float planes[6][4]{};
+                    write_shadow_cull_planes(pass_kind, layer, planes);
+                    frusta.push_back(Frustum::from_planes(planes));
+                }
+            }
+            return frusta;
+        }
+
+        void update_light_buffer(std::size_t frame_index, const omath::opengl_engine::Camera* camera)
+        {
+            constexpr float pi = 3.14159265358979323846f;
+            constexpr float radians_per_degree = pi / 180.0f;
+
+            const float inner_cos = std::cos(m_spotlight_settings.inner_angle_degrees * radians_per_degree);
+            const float outer_cos = std::cos(m_spotlight_settings.outer_angle_degrees * radians_per_degree);
+            m_light_view_projection = spotlight_view_projection();
+            if (camera != nullptr)
+                update_sun_cascades(*camera);
 
             LightUniform uniform{};
             uniform.position[0] = m_spotlight_settings.position.x;
@@ -1612,20 +3737,15 @@ namespace rose::core::vulkan
             uniform.sun_color_intensity[3] = m_sun_settings.intensity;
             uniform.sun_params[0] = 0.0035f;
             uniform.sun_params[1] = m_sun_settings.shadow_distance;
-            std::memcpy(uniform.sun_view_projection,
-                        m_sun_view_projection.data(),
-                        sizeof(uniform.sun_view_projection));
-
-            void* mapped = nullptr;
-            check_vk(vkMapMemory(m_device,
-                                  m_light_buffers[frame_index].memory,
-                                  0,
-                                  sizeof(LightUniform),
-                                  0,
-                                  &mapped),
-                     "Failed to map light buffer");
-            std::memcpy(mapped, &uniform, sizeof(LightUniform));
-            vkUnmapMemory(m_device, m_light_buffers[frame_index].memory);
+            uniform.sun_params[2] = static_cast<float>(m_sun_cascade_count);
+            for (uint32_t cascade = 0; cascade < m_sun_cascade_count; ++cascade)
+                std::memcpy(uniform.sun_view_projections[cascade],
+                            m_sun_view_projections[cascade].data(),
+                            sizeof(uniform.sun_view_projections[cascade]));
+
+            std::memcpy(mapped_memory(m_light_buffers[frame_index], "Light buffer is not host visible"),
+                        &uniform,
+                        sizeof(LightUniform));
         }
 
         void create_instance()
@@ -1753,10 +3873,33 @@ namespace rose::core::vulkan
                                });
         }
 
+        [[nodiscard]] bool present_wait_features_supported() const
+        {
+            VkPhysicalDeviceProperties properties{};
+            vkGetPhysicalDeviceProperties(m_physical_device, &properties);
+            if (properties.apiVersion < VK_API_VERSION_1_2
+                || !device_extension_available(VK_KHR_PRESENT_ID_EXTENSION_NAME)
+                || !device_extension_available(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+                return false;
+
+            VkPhysicalDevicePresentWaitFeaturesKHR present_wait{};
+            present_wait.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+            VkPhysicalDevicePresentIdFeaturesKHR present_id{};
+            present_id.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+            present_id.pNext = &present_wait;
+            VkPhysicalDeviceFeatures2 features{};
+            features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features.pNext = &present_id;
+            vkGetPhysicalDeviceFeatures2(m_physical_device, &features);
+            return present_id.presentId == VK_TRUE && present_wait.presentWait == VK_TRUE;
+        }
+
         void append_available_device_extensions(std::vector<std::string>& extensions)
         {
             for (const std::string& extension : m_ngx_device_extensions)
             {
+                if (std::ranges::find(extensions, extension) != extensions.end())
+                    continue;
                 if (device_extension_available(extension.c_str()))
                     extensions.push_back(extension);
                 else
@@ -1792,6 +3935,17 @@ namespace rose::core::vulkan
                     break;
             }
 
+            for (uint32_t i = 0; i < queue_family_count; ++i)
+            {
+                const VkQueueFlags flags = queue_families[i].queueFlags;
+                if ((flags & VK_QUEUE_TRANSFER_BIT) == 0 || (flags & VK_QUEUE_GRAPHICS_BIT) != 0)
+                    continue;
+
+                // Prefer a pure copy engine over an async compute family.
+                if (!indices.transfer || (flags & VK_QUEUE_COMPUTE_BIT) == 0)
+                    indices.transfer = i;
+            }
+
             return indices;
         }
 
@@ -1906,8 +4060,13 @@ namespace rose::core::vulkan
             const QueueFamilies indices = find_queue_families(m_physical_device);
             m_graphics_queue_family = indices.graphics.value();
             m_present_queue_family = indices.present.value();
+            m_transfer_queue_family = indices.transfer.value_or(m_graphics_queue_family);
 
-            const std::set<uint32_t> unique_queue_families{m_graphics_queue_family, m_present_queue_family};
+            const std::set<uint32_t> unique_queue_families{
+                m_graphics_queue_family,
+                m_present_queue_family,
+                m_transfer_queue_family
+            };
             const float queue_priority = 1.0f;
             std::vector<VkDeviceQueueCreateInfo> queue_create_infos;
             queue_create_infos.reserve(unique_queue_families.size());
@@ -1922,19 +4081,92 @@ namespace rose::core::vulkan
             }
 
             std::vector<std::string> extension_names{VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+            m_memory_budget_supported = device_extension_available(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+            if (m_memory_budget_supported)
+                extension_names.emplace_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+            m_present_wait_supported = present_wait_features_supported();
+            if (m_present_wait_supported)
+            {
+                extension_names.emplace_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+                extension_names.emplace_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+            }
             append_available_device_extensions(extension_names);
             std::vector<const char*> extension_ptrs;
             extension_ptrs.reserve(extension_names.size());
             for (const std::string& extension : extension_names)
                 extension_ptrs.push_back(extension.c_str());
-            spdlog::info("Vulkan: creating logical device graphics_queue={} present_queue={} extensions=[{}]",
+            spdlog::info("Vulkan: creating logical device graphics_queue={} present_queue={} transfer_queue={} extensions=[{}]",
                          m_graphics_queue_family,
                          m_present_queue_family,
+                         m_transfer_queue_family,
                          join_names(extension_names));
 
+            VkPhysicalDeviceProperties properties{};
+            vkGetPhysicalDeviceProperties(m_physical_device, &properties);
+            VkPhysicalDeviceVulkan12Features supported_features12{};
+            supported_features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+            if (properties.apiVersion >= VK_API_VERSION_1_2)
+            {
+                VkPhysicalDeviceFeatures2 supported_features{};
+                supported_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+                supported_features.pNext = &supported_features12;
+                vkGetPhysicalDeviceFeatures2(m_physical_device, &supported_features);
+            }
+            m_timeline_semaphore_supported = supported_features12.timelineSemaphore == VK_TRUE;
+            m_draw_indirect_count_supported = supported_features12.drawIndirectCount == VK_TRUE;
+
+            VkPhysicalDeviceVulkan12Features features12{};
+            features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+            features12.timelineSemaphore = m_timeline_semaphore_supported ? VK_TRUE : VK_FALSE;
+            features12.drawIndirectCount = m_draw_indirect_count_supported ? VK_TRUE : VK_FALSE;
+            VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features{};
+            present_wait_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+            present_wait_features.presentWait = VK_TRUE;
+            VkPhysicalDevicePresentIdFeaturesKHR present_id_features{};
+            present_id_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+            present_id_features.pNext = &present_wait_features;
+            present_id_features.presentId = VK_TRUE;
+            if (m_present_wait_supported)
+                features12.pNext = &present_id_features;
+
+            VkPhysicalDeviceFeatures supported_features10{};
+            vkGetPhysicalDeviceFeatures(m_physical_device, &supported_features10);
+            m_multi_draw_indirect_supported = supported_features10.multiDrawIndirect == VK_TRUE;
+            m_draw_indirect_first_instance_supported = supported_features10.drawIndirectFirstInstance == VK_TRUE;
+            m_max_draw_indirect_count = m_multi_draw_indirect_supported ? properties.limits.maxDrawIndirectCount : 1u;
+            m_depth_clamp_supported = supported_features10.depthClamp == VK_TRUE;
+            m_texture_compression_bc_supported = supported_features10.textureCompressionBC == VK_TRUE;
+            m_sampler_anisotropy_supported = supported_features10.samplerAnisotropy == VK_TRUE;
+            m_max_sampler_anisotropy = m_sampler_anisotropy_supported ? properties.limits.maxSamplerAnisotropy : 1.0f;
+            // The scene pass executes secondary command buffers, so counting it needs both.
+            m_pipeline_statistics_supported = supported_features10.pipelineStatisticsQuery == VK_TRUE
+                                           && supported_features10.inheritedQueries == VK_TRUE;
+
             VkPhysicalDeviceFeatures device_features{};
+            device_features.multiDrawIndirect = m_multi_draw_indirect_supported ? VK_TRUE : VK_FALSE;
+            device_features.drawIndirectFirstInstance = m_draw_indirect_first_instance_supported ? VK_TRUE : VK_FALSE;
+            device_features.depthClamp = m_depth_clamp_supported ? VK_TRUE : VK_FALSE;
+            device_features.textureCompressionBC = m_texture_compression_bc_supported ? VK_TRUE : VK_FALSE;
+            device_features.samplerAnisotropy = m_sampler_anisotropy_supported ? VK_TRUE : VK_FALSE;
+            device_features.pipelineStatisticsQuery = m_pipeline_statistics_supported ? VK_TRUE : VK_FALSE;
+            device_features.inheritedQueries = m_pipeline_statistics_supported ? VK_TRUE : VK_FALSE;
+            spdlog::info("Vulkan: indirect drawing multi_draw={} first_instance={} draw_count={} max_draw_count={}",
+                         m_multi_draw_indirect_supported,
+                         m_draw_indirect_first_instance_supported,
+                         m_draw_indirect_count_supported,
+                         m_max_draw_indirect_count);
+            spdlog::info("Vulkan: shadow depth clamp={}", m_depth_clamp_supported);
+            spdlog::info("Vulkan: present wait={}", m_present_wait_supported);
+            spdlog::info("Vulkan: textures bc_compression={} max_anisotropy={} texel_conversion={} memory_budget={}",
+                         m_texture_compression_bc_supported,
+                         m_max_sampler_anisotropy,
+                         texel_conversion_isa(),
+                         m_memory_budget_supported);
+
             VkDeviceCreateInfo create_info{};
             create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+            if (properties.apiVersion >= VK_API_VERSION_1_2)
+                create_info.pNext = &features12;
             create_info.queueCreateInfoCount = static_cast<uint32_t>(queue_create_infos.size());
             create_info.pQueueCreateInfos = queue_create_infos.data();
             create_info.pEnabledFeatures = &device_features;
@@ -1944,6 +4176,27 @@ namespace rose::core::vulkan
             check_vk(vkCreateDevice(m_physical_device, &create_info, nullptr, &m_device), "Failed to create Vulkan device");
             vkGetDeviceQueue(m_device, m_graphics_queue_family, 0, &m_graphics_queue);
             vkGetDeviceQueue(m_device, m_present_queue_family, 0, &m_present_queue);
+            vkGetDeviceQueue(m_device, m_transfer_queue_family, 0, &m_transfer_queue);
+            if (m_present_wait_supported)
+            {
+                m_wait_for_present = reinterpret_cast<PFN_vkWaitForPresentKHR>(
+                    vkGetDeviceProcAddr(m_device, "vkWaitForPresentKHR"));
+                m_present_wait_supported = m_wait_for_present != nullptr;
+            }
+            m_allocator = std::make_unique<DeviceAllocator>(m_physical_device, m_device);
+
+            UploadQueue upload_queue;
+            upload_queue.queue = m_transfer_queue;
+            upload_queue.family = m_transfer_queue_family;
+            upload_queue.dedicated = m_transfer_queue_family != m_graphics_queue_family;
+            upload_queue.timeline_semaphore = m_timeline_semaphore_supported;
+            m_uploads = std::make_unique<UploadManager>(m_physical_device, m_device, *m_allocator, upload_queue);
+            m_gpu_profiler = std::make_unique<GpuProfiler>(m_physical_device,
+                                                           m_device,
+                                                           m_graphics_queue_family,
+                                                           static_cast<uint32_t>(k_max_frames_in_flight),
+                                                           static_cast<uint32_t>(k_gpu_pass_count),
+                                                           m_pipeline_statistics_supported);
             spdlog::info("Vulkan: logical device created");
         }
 
@@ -1969,11 +4222,10 @@ namespace rose::core::vulkan
 
         [[nodiscard]] VkPresentModeKHR choose_present_mode(const std::vector<VkPresentModeKHR>& present_modes) const
         {
-            for (VkPresentModeKHR mode : present_modes)
-            {
-                if (mode == VK_PRESENT_MODE_MAILBOX_KHR)
-                    return mode;
-            }
+            const VkPresentModeKHR requested = to_vk_present_mode(m_latency_profile.present_mode);
+            if (std::ranges::find(present_modes, requested) != present_modes.end())
+                return requested;
+            spdlog::warn("Vulkan: {} is not supported by the surface, falling back to FIFO", present_mode_name(requested));
             return VK_PRESENT_MODE_FIFO_KHR;
         }
 
@@ -1999,14 +4251,18 @@ namespace rose::core::vulkan
             return actual_extent;
         }
 
-        void create_swapchain()
+        // `old_swapchain` is retired by the call and must be destroyed by the caller once no frame
+        // in flight uses it.
+        void create_swapchain(VkSwapchainKHR old_swapchain = VK_NULL_HANDLE)
         {
             const SwapchainSupport support = query_swapchain_support(m_physical_device);
             const VkSurfaceFormatKHR surface_format = choose_surface_format(support.formats);
             const VkPresentModeKHR present_mode = choose_present_mode(support.present_modes);
             const VkExtent2D extent = choose_extent(support.capabilities);
 
-            uint32_t image_count = support.capabilities.minImageCount + 1u;
+            uint32_t image_count = m_latency_profile.swapchain_images == 0
+                                 ? support.capabilities.minImageCount + 1u
+                                 : std::max(m_latency_profile.swapchain_images, support.capabilities.minImageCount);
             if (support.capabilities.maxImageCount > 0 && image_count > support.capabilities.maxImageCount)
                 image_count = support.capabilities.maxImageCount;
             m_min_image_count = support.capabilities.minImageCount;
@@ -2047,10 +4303,12 @@ namespace rose::core::vulkan
             create_info.preTransform = support.capabilities.currentTransform;
             create_info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
             create_info.presentMode = present_mode;
+            m_present_mode = present_mode;
             create_info.clipped = VK_TRUE;
-            create_info.oldSwapchain = VK_NULL_HANDLE;
+            create_info.oldSwapchain = old_swapchain;
 
             check_vk(vkCreateSwapchainKHR(m_device, &create_info, nullptr, &m_swapchain), "Failed to create swapchain");
+            m_swapchain_first_present_id = m_present_id + 1u;
 
             check_vk(vkGetSwapchainImagesKHR(m_device, m_swapchain, &image_count, nullptr), "Failed to get swapchain image count");
             m_swapchain_images.resize(image_count);
@@ -2071,18 +4329,25 @@ namespace rose::core::vulkan
                          m_swapchain_supports_transfer_dst);
         }
 
-        [[nodiscard]] VkImageView create_image_view(VkImage image, VkFormat format, VkImageAspectFlags aspect_flags) const
+        [[nodiscard]] VkImageView create_image_view(VkImage image,
+                                                    VkFormat format,
+                                                    VkImageAspectFlags aspect_flags,
+                                                    uint32_t base_mip_level = 0,
+                                                    uint32_t mip_level_count = 1,
+                                                    VkImageViewType view_type = VK_IMAGE_VIEW_TYPE_2D,
+                                                    uint32_t base_array_layer = 0,
+                                                    uint32_t layer_count = 1) const
         {
             VkImageViewCreateInfo view_info{};
             view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
             view_info.image = image;
-            view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            view_info.viewType = view_type;
             view_info.format = format;
             view_info.subresourceRange.aspectMask = aspect_flags;
-            view_info.subresourceRange.baseMipLevel = 0;
-            view_info.subresourceRange.levelCount = 1;
-            view_info.subresourceRange.baseArrayLayer = 0;
-            view_info.subresourceRange.layerCount = 1;
+            view_info.subresourceRange.baseMipLevel = base_mip_level;
+            view_info.subresourceRange.levelCount = mip_level_count;
+            view_info.subresourceRange.baseArrayLayer = base_array_layer;
+            view_info.subresourceRange.layerCount = layer_count;
 
             VkImageView image_view = VK_NULL_HANDLE;
             check_vk(vkCreateImageView(m_device, &view_info, nullptr, &image_view), "Failed to create image view");
@@ -2139,7 +4404,8 @@ namespace rose::core::vulkan
             depth_attachment.format = m_depth_format;
             depth_attachment.samples = VK_SAMPLE_COUNT_1_BIT;
             depth_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-            depth_attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            // Kept for the depth pyramid that next frame's occlusion culling reads.
+            depth_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
             depth_attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
             depth_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
             depth_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -2184,6 +4450,8 @@ namespace rose::core::vulkan
 
             check_vk(vkCreateRenderPass(m_device, &render_pass_info, nullptr, &m_render_pass), "Failed to create render pass");
 
+            // Static casters are rendered into a per-light cache that is copied into the shadow map;
+            // the composite pass then loads the copy and adds the dynamic casters.
             VkAttachmentDescription shadow_attachment{};
             shadow_attachment.format = m_depth_format;
             shadow_attachment.samples = VK_SAMPLE_COUNT_1_BIT;
@@ -2192,7 +4460,7 @@ namespace rose::core::vulkan
             shadow_attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
             shadow_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
             shadow_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            shadow_attachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+            shadow_attachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
 
             const VkAttachmentReference shadow_attachment_ref{0, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
 
@@ -2203,7 +4471,7 @@ namespace rose::core::vulkan
             std::array<VkSubpassDependency, 2> shadow_dependencies{};
             shadow_dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
             shadow_dependencies[0].dstSubpass = 0;
-            shadow_dependencies[0].srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            shadow_dependencies[0].srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
             shadow_dependencies[0].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT
                                                 | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
             shadow_dependencies[0].srcAccessMask = 0;
@@ -2211,9 +4479,9 @@ namespace rose::core::vulkan
             shadow_dependencies[1].srcSubpass = 0;
             shadow_dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
             shadow_dependencies[1].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-            shadow_dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            shadow_dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
             shadow_dependencies[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-            shadow_dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            shadow_dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
 
             VkRenderPassCreateInfo shadow_render_pass_info{};
             shadow_render_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
@@ -2227,6 +4495,17 @@ namespace rose::core::vulkan
             check_vk(vkCreateRenderPass(m_device, &shadow_render_pass_info, nullptr, &m_shadow_render_pass),
                      "Failed to create shadow render pass");
 
+            shadow_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+            shadow_attachment.initialLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            shadow_attachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+            shadow_dependencies[0].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            shadow_dependencies[0].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+                                                 | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            shadow_dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            shadow_dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            check_vk(vkCreateRenderPass(m_device, &shadow_render_pass_info, nullptr, &m_shadow_composite_render_pass),
+                     "Failed to create shadow composite render pass");
+
             VkAttachmentDescription present_attachment{};
             present_attachment.format = m_swapchain_image_format;
             present_attachment.samples = VK_SAMPLE_COUNT_1_BIT;
@@ -2263,6 +4542,116 @@ namespace rose::core::vulkan
 
             check_vk(vkCreateRenderPass(m_device, &present_render_pass_info, nullptr, &m_present_render_pass),
                      "Failed to create present render pass");
+
+            // Selection mask: seeds and their data are cleared and written, the scene depth is only
+            // tested against. The jump flood and the composite read both as storage images.
+            VkAttachmentDescription seed_attachment = color_attachment;
+            seed_attachment.format = VK_FORMAT_R32_UINT;
+            seed_attachment.finalLayout = VK_IMAGE_LAYOUT_GENERAL;
+            VkAttachmentDescription seed_data_attachment = seed_attachment;
+            seed_data_attachment.format = VK_FORMAT_R32G32_SFLOAT;
+            VkAttachmentDescription selection_depth_attachment = depth_attachment;
+            selection_depth_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+            selection_depth_attachment.initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+            const VkSubpassDescription selection_subpass = subpass;
+
+            // The previous frame's jump flood and composite may still read the seeds.
+            std::array<VkSubpassDependency, 2> selection_dependencies{};
+            selection_dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+            selection_dependencies[0].dstSubpass = 0;
+            selection_dependencies[0].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT
+                                                   | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+                                                   | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            selection_dependencies[0].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT
+                                                   | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            selection_dependencies[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            selection_dependencies[0].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+                                                    | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            selection_dependencies[1].srcSubpass = 0;
+            selection_dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+            selection_dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            selection_dependencies[1].dstStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+                                                   | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            selection_dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            selection_dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+            const std::array<VkAttachmentDescription, 3> selection_attachments{
+                seed_attachment,
+                seed_data_attachment,
+                selection_depth_attachment
+            };
+            VkRenderPassCreateInfo selection_render_pass_info = render_pass_info;
+            selection_render_pass_info.pAttachments = selection_attachments.data();
+            selection_render_pass_info.pSubpasses = &selection_subpass;
+            selection_render_pass_info.dependencyCount = static_cast<uint32_t>(selection_dependencies.size());
+            selection_render_pass_info.pDependencies = selection_dependencies.data();
+            check_vk(vkCreateRenderPass(m_device, &selection_render_pass_info, nullptr, &m_selection_render_pass),
+                     "Failed to create selection mask render pass");
+
+            // Selection composite: blends into the scene color in place, depth tested only.
+            VkAttachmentDescription outline_color_attachment = color_attachment;
+            outline_color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+            outline_color_attachment.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            const std::array<VkAttachmentDescription, 2> outline_attachments{
+                outline_color_attachment,
+                selection_depth_attachment
+            };
+            const VkAttachmentReference outline_depth_attachment_ref{1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+
+            VkSubpassDescription outline_subpass = subpass;
+            outline_subpass.colorAttachmentCount = 1;
+            outline_subpass.pColorAttachments = color_attachment_refs.data();
+            outline_subpass.pDepthStencilAttachment = &outline_depth_attachment_ref;
+
+            // The jump flood is ordered before the pass by its own barrier.
+            VkSubpassDependency outline_dependency{};
+            outline_dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+            outline_dependency.dstSubpass = 0;
+            outline_dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            outline_dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            outline_dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            outline_dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+            VkRenderPassCreateInfo outline_render_pass_info = render_pass_info;
+            outline_render_pass_info.attachmentCount = static_cast<uint32_t>(outline_attachments.size());
+            outline_render_pass_info.pAttachments = outline_attachments.data();
+            outline_render_pass_info.pSubpasses = &outline_subpass;
+            outline_render_pass_info.dependencyCount = 1;
+            outline_render_pass_info.pDependencies = &outline_dependency;
+            check_vk(vkCreateRenderPass(m_device, &outline_render_pass_info, nullptr, &m_selection_outline_render_pass),
+                     "Failed to create selection outline render pass");
+
+            // Pick: one object id and its own depth, copied to the frame's readback buffer.
+            VkAttachmentDescription pick_id_attachment = color_attachment;
+            pick_id_attachment.format = VK_FORMAT_R32_UINT;
+            pick_id_attachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            VkAttachmentDescription pick_depth_attachment = depth_attachment;
+            pick_depth_attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            const std::array<VkAttachmentDescription, 2> pick_attachments{pick_id_attachment, pick_depth_attachment};
+
+            std::array<VkSubpassDependency, 2> pick_dependencies{};
+            pick_dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+            pick_dependencies[0].dstSubpass = 0;
+            pick_dependencies[0].srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            pick_dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+                                              | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+            pick_dependencies[0].srcAccessMask = 0;
+            pick_dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+                                               | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            pick_dependencies[1].srcSubpass = 0;
+            pick_dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+            pick_dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            pick_dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            pick_dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            pick_dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+            VkRenderPassCreateInfo pick_render_pass_info = outline_render_pass_info;
+            pick_render_pass_info.pAttachments = pick_attachments.data();
+            pick_render_pass_info.dependencyCount = static_cast<uint32_t>(pick_dependencies.size());
+            pick_render_pass_info.pDependencies = pick_dependencies.data();
+            check_vk(vkCreateRenderPass(m_device, &pick_render_pass_info, nullptr, &m_pick_render_pass),
+                     "Failed to create pick render pass");
             spdlog::info("Vulkan: render passes created scene_color={} motion={} depth={} present={}",
                          vk_format_name(m_scene_color_format),
                          vk_format_name(m_motion_vector_format),
@@ -2270,12 +4659,12 @@ namespace rose::core::vulkan
                          vk_format_name(m_swapchain_image_format));
         }
 
-        [[nodiscard]] VkShaderModule create_shader_module(const std::vector<char>& code) const
+        [[nodiscard]] VkShaderModule create_shader_module(std::span<const uint32_t> code) const
         {
             VkShaderModuleCreateInfo create_info{};
             create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-            create_info.codeSize = code.size();
-            create_info.pCode = reinterpret_cast<const uint32_t*>(code.data());
+            create_info.codeSize = code.size_bytes();
+            create_info.pCode = code.data();
 
             VkShaderModule shader_module = VK_NULL_HANDLE;
             check_vk(vkCreateShaderModule(m_device, &create_info, nullptr, &shader_module), "Failed to create shader module");
@@ -2323,10 +4712,15 @@ namespace rose::core::vulkan
             VkDescriptorSetLayoutBinding sun_shadow_layout_binding = shadow_layout_binding;
             sun_shadow_layout_binding.binding = 2;
 
-            const std::array<VkDescriptorSetLayoutBinding, 3> light_bindings{
+            VkDescriptorSetLayoutBinding camera_layout_binding = light_layout_binding;
+            camera_layout_binding.binding = 3;
+            camera_layout_binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+            const std::array<VkDescriptorSetLayoutBinding, 4> light_bindings{
                 light_layout_binding,
                 shadow_layout_binding,
-                sun_shadow_layout_binding
+                sun_shadow_layout_binding,
+                camera_layout_binding
             };
 
             VkDescriptorSetLayoutCreateInfo light_layout_info{};
@@ -2336,20 +4730,117 @@ namespace rose::core::vulkan
             check_vk(vkCreateDescriptorSetLayout(m_device, &light_layout_info, nullptr, &m_light_descriptor_set_layout),
                      "Failed to create light descriptor set layout");
 
-            VkDescriptorSetLayoutBinding post_sampler_layout_binding{};
-            post_sampler_layout_binding.binding = 0;
-            post_sampler_layout_binding.descriptorCount = 1;
-            post_sampler_layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            post_sampler_layout_binding.pImmutableSamplers = nullptr;
-            post_sampler_layout_binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+            VkDescriptorSetLayoutBinding draw_layout_binding{};
+            draw_layout_binding.binding = 0;
+            draw_layout_binding.descriptorCount = 1;
+            draw_layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            draw_layout_binding.pImmutableSamplers = nullptr;
+            draw_layout_binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+            VkDescriptorSetLayoutCreateInfo draw_layout_info{};
+            draw_layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            draw_layout_info.bindingCount = 1;
+            draw_layout_info.pBindings = &draw_layout_binding;
+            check_vk(vkCreateDescriptorSetLayout(m_device, &draw_layout_info, nullptr, &m_draw_descriptor_set_layout),
+                     "Failed to create draw descriptor set layout");
+
+            // Cull pass: draw data, commands, counts, cull parameters and the depth pyramid.
+            std::array<VkDescriptorSetLayoutBinding, 5> cull_bindings{};
+            for (uint32_t binding = 0; binding < cull_bindings.size(); ++binding)
+            {
+                cull_bindings[binding].binding = binding;
+                cull_bindings[binding].descriptorCount = 1;
+                cull_bindings[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                cull_bindings[binding].pImmutableSamplers = nullptr;
+                cull_bindings[binding].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+            }
+            cull_bindings[3].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            cull_bindings[4].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+
+            VkDescriptorSetLayoutCreateInfo cull_layout_info{};
+            cull_layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            cull_layout_info.bindingCount = static_cast<uint32_t>(cull_bindings.size());
+            cull_layout_info.pBindings = cull_bindings.data();
+            check_vk(vkCreateDescriptorSetLayout(m_device, &cull_layout_info, nullptr, &m_cull_descriptor_set_layout),
+                     "Failed to create cull descriptor set layout");
+
+            std::array<VkDescriptorSetLayoutBinding, 2> hiz_bindings{};
+            hiz_bindings[0].binding = 0;
+            hiz_bindings[0].descriptorCount = 1;
+            hiz_bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            hiz_bindings[0].pImmutableSamplers = nullptr;
+            hiz_bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+            hiz_bindings[1] = hiz_bindings[0];
+            hiz_bindings[1].binding = 1;
+            hiz_bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+
+            VkDescriptorSetLayoutCreateInfo hiz_layout_info{};
+            hiz_layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            hiz_layout_info.bindingCount = static_cast<uint32_t>(hiz_bindings.size());
+            hiz_layout_info.pBindings = hiz_bindings.data();
+            check_vk(vkCreateDescriptorSetLayout(m_device, &hiz_layout_info, nullptr, &m_hiz_descriptor_set_layout),
+                     "Failed to create depth pyramid descriptor set layout");
+
+            // The resolved scene and the bloom pyramid's first level.
+            std::array<VkDescriptorSetLayoutBinding, 2> post_bindings{};
+            post_bindings[0].binding = 0;
+            post_bindings[0].descriptorCount = 1;
+            post_bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            post_bindings[0].pImmutableSamplers = nullptr;
+            post_bindings[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+            post_bindings[1] = post_bindings[0];
+            post_bindings[1].binding = 1;
 
             VkDescriptorSetLayoutCreateInfo post_layout_info{};
             post_layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-            post_layout_info.bindingCount = 1;
-            post_layout_info.pBindings = &post_sampler_layout_binding;
+            post_layout_info.bindingCount = static_cast<uint32_t>(post_bindings.size());
+            post_layout_info.pBindings = post_bindings.data();
             check_vk(vkCreateDescriptorSetLayout(m_device, &post_layout_info, nullptr, &m_post_descriptor_set_layout),
                      "Failed to create post-process descriptor set layout");
 
+            // The level read and the level written.
+            std::array<VkDescriptorSetLayoutBinding, 2> bloom_pyramid_bindings{};
+            bloom_pyramid_bindings[0].binding = 0;
+            bloom_pyramid_bindings[0].descriptorCount = 1;
+            bloom_pyramid_bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            bloom_pyramid_bindings[0].pImmutableSamplers = nullptr;
+            bloom_pyramid_bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+            bloom_pyramid_bindings[1] = bloom_pyramid_bindings[0];
+            bloom_pyramid_bindings[1].binding = 1;
+            bloom_pyramid_bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+
+            VkDescriptorSetLayoutCreateInfo bloom_pyramid_layout_info{};
+            bloom_pyramid_layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            bloom_pyramid_layout_info.bindingCount = static_cast<uint32_t>(bloom_pyramid_bindings.size());
+            bloom_pyramid_layout_info.pBindings = bloom_pyramid_bindings.data();
+            check_vk(vkCreateDescriptorSetLayout(m_device,
+                                                 &bloom_pyramid_layout_info,
+                                                 nullptr,
+                                                 &m_bloom_pyramid_descriptor_set_layout),
+                     "Failed to create bloom pyramid descriptor set layout");
+
+            // Selection seeds read and written by the jump flood, or the seeds and their data read
+            // by the composite.
+            std::array<VkDescriptorSetLayoutBinding, 2> selection_bindings{};
+            for (uint32_t binding = 0; binding < selection_bindings.size(); ++binding)
+            {
+                selection_bindings[binding].binding = binding;
+                selection_bindings[binding].descriptorCount = 1;
+                selection_bindings[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+                selection_bindings[binding].pImmutableSamplers = nullptr;
+                selection_bindings[binding].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+            }
+
+            VkDescriptorSetLayoutCreateInfo selection_layout_info{};
+            selection_layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            selection_layout_info.bindingCount = static_cast<uint32_t>(selection_bindings.size());
+            selection_layout_info.pBindings = selection_bindings.data();
+            check_vk(vkCreateDescriptorSetLayout(m_device,
+                                                 &selection_layout_info,
+                                                 nullptr,
+                                                 &m_selection_descriptor_set_layout),
+                     "Failed to create selection descriptor set layout");
+
             VkSamplerCreateInfo sampler_info{};
             sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
             sampler_info.magFilter = VK_FILTER_LINEAR;
@@ -2376,13 +4867,13 @@ namespace rose::core::vulkan
             check_vk(vkCreateSampler(m_device, &shadow_sampler_info, nullptr, &m_shadow_sampler),
                      "Failed to create shadow sampler");
 
-            VkDescriptorSetAllocateInfo alloc_info{};
-            alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-            alloc_info.descriptorPool = m_descriptor_pool;
-            alloc_info.descriptorSetCount = 1;
-            alloc_info.pSetLayouts = &m_post_descriptor_set_layout;
-            check_vk(vkAllocateDescriptorSets(m_device, &alloc_info, &m_bloom_descriptor_set),
-                     "Failed to allocate bloom descriptor set");
+            VkSamplerCreateInfo hiz_sampler_info = sampler_info;
+            hiz_sampler_info.magFilter = VK_FILTER_NEAREST;
+            hiz_sampler_info.minFilter = VK_FILTER_NEAREST;
+            hiz_sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+            hiz_sampler_info.maxLod = VK_LOD_CLAMP_NONE;
+            check_vk(vkCreateSampler(m_device, &hiz_sampler_info, nullptr, &m_hiz_sampler),
+                     "Failed to create depth pyramid sampler");
             spdlog::info("Vulkan: descriptor set layouts created");
         }
 
@@ -2394,6 +4885,10 @@ namespace rose::core::vulkan
                               VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
                               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
                               m_light_buffers[i]);
+                create_buffer(sizeof(CameraUniform),
+                              VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                              VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                              m_camera_buffers[i]);
 
                 VkDescriptorSetAllocateInfo alloc_info{};
                 alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
@@ -2403,34 +4898,176 @@ namespace rose::core::vulkan
                 check_vk(vkAllocateDescriptorSets(m_device, &alloc_info, &m_light_descriptor_sets[i]),
                          "Failed to allocate light descriptor set");
 
-                VkDescriptorBufferInfo buffer_info{};
-                buffer_info.buffer = m_light_buffers[i].buffer;
-                buffer_info.offset = 0;
-                buffer_info.range = sizeof(LightUniform);
+                // Never read before the first latch writes it, but the descriptor must be valid.
+                std::memset(mapped_memory(m_camera_buffers[i], "Camera buffer is not host visible"), 0, sizeof(CameraUniform));
+
+                std::array<VkDescriptorBufferInfo, 2> buffer_infos{};
+                buffer_infos[0].buffer = m_light_buffers[i].buffer;
+                buffer_infos[0].offset = 0;
+                buffer_infos[0].range = sizeof(LightUniform);
+                buffer_infos[1].buffer = m_camera_buffers[i].buffer;
+                buffer_infos[1].offset = 0;
+                buffer_infos[1].range = sizeof(CameraUniform);
+
+                std::array<VkWriteDescriptorSet, 2> descriptor_writes{};
+                for (std::size_t write = 0; write < descriptor_writes.size(); ++write)
+                {
+                    descriptor_writes[write].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                    descriptor_writes[write].dstSet = m_light_descriptor_sets[i];
+                    descriptor_writes[write].dstBinding = write == 0 ? 0u : 3u;
+                    descriptor_writes[write].dstArrayElement = 0;
+                    descriptor_writes[write].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                    descriptor_writes[write].descriptorCount = 1;
+                    descriptor_writes[write].pBufferInfo = &buffer_infos[write];
+                }
+
+                vkUpdateDescriptorSets(m_device,
+                                       static_cast<uint32_t>(descriptor_writes.size()),
+                                       descriptor_writes.data(),
+                                       0,
+                                       nullptr);
+            }
+        }
+
+        void destroy_light_resources() noexcept
+        {
+            for (BufferResource& buffer : m_light_buffers)
+                destroy_buffer(buffer);
+            for (BufferResource& buffer : m_camera_buffers)
+                destroy_buffer(buffer);
+            m_light_descriptor_sets = {};
+        }
+
+        void create_draw_resources()
+        {
+            using VertexType = omath::opengl_engine::Mesh::VertexType;
+            create_buffer(static_cast<VkDeviceSize>(k_arena_vertex_count) * sizeof(VertexType),
+                          VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                          m_arena_vertex_buffer,
+                          true);
+            create_buffer(static_cast<VkDeviceSize>(k_arena_index_count) * sizeof(uint32_t),
+                          VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                          m_arena_index_buffer,
+                          true);
+            m_arena_vertices = RangeAllocator(k_arena_vertex_count);
+            m_arena_indices = RangeAllocator(k_arena_index_count);
+
+            for (FrameDrawBuffers& buffers : m_draw_buffers)
+            {
+                VkDescriptorSetAllocateInfo alloc_info{};
+                alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+                alloc_info.descriptorPool = m_descriptor_pool;
+                alloc_info.descriptorSetCount = 1;
+                alloc_info.pSetLayouts = &m_draw_descriptor_set_layout;
+                check_vk(vkAllocateDescriptorSets(m_device, &alloc_info, &buffers.descriptor),
+                         "Failed to allocate draw descriptor set");
+
+                alloc_info.pSetLayouts = &m_cull_descriptor_set_layout;
+                check_vk(vkAllocateDescriptorSets(m_device, &alloc_info, &buffers.cull_descriptor),
+                         "Failed to allocate cull descriptor set");
+
+                create_buffer(sizeof(CullUniform),
+                              VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                              VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                              buffers.cull_uniform);
+
+                VkDescriptorBufferInfo uniform_info{};
+                uniform_info.buffer = buffers.cull_uniform.buffer;
+                uniform_info.offset = 0;
+                uniform_info.range = sizeof(CullUniform);
 
                 VkWriteDescriptorSet descriptor_write{};
                 descriptor_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                descriptor_write.dstSet = m_light_descriptor_sets[i];
-                descriptor_write.dstBinding = 0;
+                descriptor_write.dstSet = buffers.cull_descriptor;
+                descriptor_write.dstBinding = 3;
                 descriptor_write.dstArrayElement = 0;
                 descriptor_write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
                 descriptor_write.descriptorCount = 1;
-                descriptor_write.pBufferInfo = &buffer_info;
-
+                descriptor_write.pBufferInfo = &uniform_info;
                 vkUpdateDescriptorSets(m_device, 1, &descriptor_write, 0, nullptr);
+
+                resize_draw_buffers(buffers, k_initial_draw_count);
             }
+            spdlog::info("Vulkan: geometry arena created vertices={} indices={}",
+                         k_arena_vertex_count,
+                         k_arena_index_count);
         }
 
-        void destroy_light_resources() noexcept
+        void destroy_draw_resources() noexcept
         {
-            for (BufferResource& buffer : m_light_buffers)
-                destroy_buffer(buffer);
-            m_light_descriptor_sets = {};
+            for (FrameDrawBuffers& buffers : m_draw_buffers)
+            {
+                destroy_buffer(buffers.draw_data);
+                destroy_buffer(buffers.commands);
+                destroy_buffer(buffers.counts);
+                destroy_buffer(buffers.cull_uniform);
+                buffers = {};
+            }
+            destroy_buffer(m_arena_vertex_buffer);
+            destroy_buffer(m_arena_index_buffer);
+            m_arena_vertices = RangeAllocator();
+            m_arena_indices = RangeAllocator();
+        }
+
+        // Only called for the frame whose fence has been waited on, so the old buffers are idle.
+        void resize_draw_buffers(FrameDrawBuffers& buffers, uint32_t capacity)
+        {
+            destroy_buffer(buffers.draw_data);
+            destroy_buffer(buffers.commands);
+            destroy_buffer(buffers.counts);
+
+            create_buffer(static_cast<VkDeviceSize>(capacity) * sizeof(DrawData),
+                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                          buffers.draw_data);
+            create_buffer(static_cast<VkDeviceSize>(capacity) * k_cull_view_count * sizeof(VkDrawIndexedIndirectCommand),
+                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                          buffers.commands);
+            create_buffer(static_cast<VkDeviceSize>(k_max_cull_views + capacity) * sizeof(uint32_t),
+                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+                              | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
+                              | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                          buffers.counts);
+            buffers.capacity = capacity;
+
+            const std::array<VkDescriptorBufferInfo, 3> buffer_infos{{
+                {buffers.draw_data.buffer, 0, VK_WHOLE_SIZE},
+                {buffers.commands.buffer, 0, VK_WHOLE_SIZE},
+                {buffers.counts.buffer, 0, VK_WHOLE_SIZE},
+            }};
+
+            std::array<VkWriteDescriptorSet, 4> descriptor_writes{};
+            descriptor_writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptor_writes[0].dstSet = buffers.descriptor;
+            descriptor_writes[0].dstBinding = 0;
+            descriptor_writes[0].dstArrayElement = 0;
+            descriptor_writes[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            descriptor_writes[0].descriptorCount = 1;
+            descriptor_writes[0].pBufferInfo = &buffer_infos[0];
+            for (uint32_t binding = 0; binding < buffer_infos.size(); ++binding)
+            {
+                VkWriteDescriptorSet& descriptor_write = descriptor_writes[binding + 1];
+                descriptor_write = descriptor_writes[0];
+                descriptor_write.dstSet = buffers.cull_descriptor;
+                descriptor_write.dstBinding = binding;
+                descriptor_write.pBufferInfo = &buffer_infos[binding];
+            }
+            vkUpdateDescriptorSets(m_device,
+                                   static_cast<uint32_t>(descriptor_writes.size()),
+                                   descriptor_writes.data(),
+                                   0,
+                                   nullptr);
         }
 
-        void update_light_shadow_descriptors() const
+        // Points a frame slot's light and cull sets at the current frame targets. Only the
+        // slot whose fence was just waited on is rewritten; the others may still be in use.
+        void update_frame_descriptors(std::size_t frame_index)
         {
-            if (m_shadow_image.view == VK_NULL_HANDLE || m_sun_shadow_image.view == VK_NULL_HANDLE)
+            if (m_frame_descriptor_generations[frame_index] == m_frame_targets_generation)
                 return;
 
             VkDescriptorImageInfo shadow_image_info{};
@@ -2441,40 +5078,161 @@ namespace rose::core::vulkan
             VkDescriptorImageInfo sun_shadow_image_info = shadow_image_info;
             sun_shadow_image_info.imageView = m_sun_shadow_image.view;
 
-            std::array<VkWriteDescriptorSet, k_max_frames_in_flight * 2> descriptor_writes{};
-            for (std::size_t i = 0; i < k_max_frames_in_flight; ++i)
-            {
-                descriptor_writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                descriptor_writes[i].dstSet = m_light_descriptor_sets[i];
-                descriptor_writes[i].dstBinding = 1;
-                descriptor_writes[i].dstArrayElement = 0;
-                descriptor_writes[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-                descriptor_writes[i].descriptorCount = 1;
-                descriptor_writes[i].pImageInfo = &shadow_image_info;
-
-                descriptor_writes[i + k_max_frames_in_flight] = descriptor_writes[i];
-                descriptor_writes[i + k_max_frames_in_flight].dstBinding = 2;
-                descriptor_writes[i + k_max_frames_in_flight].pImageInfo = &sun_shadow_image_info;
-            }
+            VkDescriptorImageInfo pyramid_info{};
+            pyramid_info.sampler = m_hiz_sampler;
+            pyramid_info.imageView = m_hiz.image.view;
+            pyramid_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+            std::array<VkWriteDescriptorSet, 3> descriptor_writes{};
+            descriptor_writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptor_writes[0].dstSet = m_light_descriptor_sets[frame_index];
+            descriptor_writes[0].dstBinding = 1;
+            descriptor_writes[0].dstArrayElement = 0;
+            descriptor_writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            descriptor_writes[0].descriptorCount = 1;
+            descriptor_writes[0].pImageInfo = &shadow_image_info;
+
+            descriptor_writes[1] = descriptor_writes[0];
+            descriptor_writes[1].dstBinding = 2;
+            descriptor_writes[1].pImageInfo = &sun_shadow_image_info;
+
+            descriptor_writes[2] = descriptor_writes[0];
+            descriptor_writes[2].dstSet = m_draw_buffers[frame_index].cull_descriptor;
+            descriptor_writes[2].dstBinding = 4;
+            descriptor_writes[2].pImageInfo = &pyramid_info;
 
             vkUpdateDescriptorSets(m_device,
                                    static_cast<uint32_t>(descriptor_writes.size()),
                                    descriptor_writes.data(),
                                    0,
                                    nullptr);
+            m_frame_descriptor_generations[frame_index] = m_frame_targets_generation;
         }
 
-        void create_graphics_pipeline()
+        void create_pipeline_layouts()
         {
-            const std::filesystem::path vert_shader_path = shader_path("shader.vert.spv");
-            const std::filesystem::path frag_shader_path = shader_path("shader.frag.spv");
-            spdlog::info("Vulkan: creating graphics pipelines using shaders '{}' and '{}'",
-                         vert_shader_path.string(),
-                         frag_shader_path.string());
-            const std::vector<char> vert_shader_code = read_binary_file(vert_shader_path);
-            const std::vector<char> frag_shader_code = read_binary_file(frag_shader_path);
-            const VkShaderModule vert_shader_module = create_shader_module(vert_shader_code);
-            const VkShaderModule frag_shader_module = create_shader_module(frag_shader_code);
+            VkPushConstantRange push_constant_range{};
+            push_constant_range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+            push_constant_range.offset = 0;
+            push_constant_range.size = sizeof(PushConstants);
+
+            VkPhysicalDeviceProperties device_properties{};
+            vkGetPhysicalDeviceProperties(m_physical_device, &device_properties);
+            if (device_properties.limits.maxPushConstantsSize < static_cast<uint32_t>(sizeof(PushConstants)))
+                throw VulkanError("Vulkan device does not support the push constant size required for motion vectors");
+
+            const std::array<VkDescriptorSetLayout, 3> mesh_set_layouts{
+                m_descriptor_set_layout,
+                m_light_descriptor_set_layout,
+                m_draw_descriptor_set_layout
+            };
+
+            VkPipelineLayoutCreateInfo pipeline_layout_info{};
+            pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+            pipeline_layout_info.setLayoutCount = static_cast<uint32_t>(mesh_set_layouts.size());
+            pipeline_layout_info.pSetLayouts = mesh_set_layouts.data();
+            pipeline_layout_info.pushConstantRangeCount = 1;
+            pipeline_layout_info.pPushConstantRanges = &push_constant_range;
+
+            check_vk(vkCreatePipelineLayout(m_device, &pipeline_layout_info, nullptr, &m_pipeline_layout),
+                     "Failed to create pipeline layout");
+
+            VkPushConstantRange bloom_push_constant_range{};
+            bloom_push_constant_range.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+            bloom_push_constant_range.offset = 0;
+            bloom_push_constant_range.size = sizeof(BloomPushConstants);
+
+            VkPipelineLayoutCreateInfo bloom_pipeline_layout_info{};
+            bloom_pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+            bloom_pipeline_layout_info.setLayoutCount = 1;
+            bloom_pipeline_layout_info.pSetLayouts = &m_post_descriptor_set_layout;
+            bloom_pipeline_layout_info.pushConstantRangeCount = 1;
+            bloom_pipeline_layout_info.pPushConstantRanges = &bloom_push_constant_range;
+
+            check_vk(vkCreatePipelineLayout(m_device,
+                                            &bloom_pipeline_layout_info,
+                                            nullptr,
+                                            &m_bloom_pipeline_layout),
+                     "Failed to create bloom pipeline layout");
+
+            VkPipelineLayoutCreateInfo cull_pipeline_layout_info{};
+            cull_pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+            cull_pipeline_layout_info.setLayoutCount = 1;
+            cull_pipeline_layout_info.pSetLayouts = &m_cull_descriptor_set_layout;
+            check_vk(vkCreatePipelineLayout(m_device, &cull_pipeline_layout_info, nullptr, &m_cull_pipeline_layout),
+                     "Failed to create cull pipeline layout");
+
+            VkPushConstantRange hiz_push_constant_range{};
+            hiz_push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+            hiz_push_constant_range.offset = 0;
+            hiz_push_constant_range.size = sizeof(HizPushConstants);
+
+            VkPipelineLayoutCreateInfo hiz_pipeline_layout_info{};
+            hiz_pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+            hiz_pipeline_layout_info.setLayoutCount = 1;
+            hiz_pipeline_layout_info.pSetLayouts = &m_hiz_descriptor_set_layout;
+            hiz_pipeline_layout_info.pushConstantRangeCount = 1;
+            hiz_pipeline_layout_info.pPushConstantRanges = &hiz_push_constant_range;
+            check_vk(vkCreatePipelineLayout(m_device, &hiz_pipeline_layout_info, nullptr, &m_hiz_pipeline_layout),
+                     "Failed to create depth pyramid pipeline layout");
+
+            VkPushConstantRange bloom_pyramid_push_constant_range{};
+            bloom_pyramid_push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+            bloom_pyramid_push_constant_range.offset = 0;
+            bloom_pyramid_push_constant_range.size = sizeof(BloomPyramidPushConstants);
+
+            VkPipelineLayoutCreateInfo bloom_pyramid_pipeline_layout_info{};
+            bloom_pyramid_pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+            bloom_pyramid_pipeline_layout_info.setLayoutCount = 1;
+            bloom_pyramid_pipeline_layout_info.pSetLayouts = &m_bloom_pyramid_descriptor_set_layout;
+            bloom_pyramid_pipeline_layout_info.pushConstantRangeCount = 1;
+            bloom_pyramid_pipeline_layout_info.pPushConstantRanges = &bloom_pyramid_push_constant_range;
+            check_vk(vkCreatePipelineLayout(m_device,
+                                            &bloom_pyramid_pipeline_layout_info,
+                                            nullptr,
+                                            &m_bloom_pyramid_pipeline_layout),
+                     "Failed to create bloom pyramid pipeline layout");
+
+            VkPushConstantRange selection_push_constant_range{};
+            selection_push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+            selection_push_constant_range.offset = 0;
+            selection_push_constant_range.size = sizeof(SelectionPushConstants);
+
+            VkPipelineLayoutCreateInfo selection_pipeline_layout_info{};
+            selection_pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+            selection_pipeline_layout_info.setLayoutCount = 1;
+            selection_pipeline_layout_info.pSetLayouts = &m_selection_descriptor_set_layout;
+            selection_pipeline_layout_info.pushConstantRangeCount = 1;
+            selection_pipeline_layout_info.pPushConstantRanges = &selection_push_constant_range;
+            check_vk(vkCreatePipelineLayout(m_device,
+                                            &selection_pipeline_layout_info,
+                                            nullptr,
+                                            &m_selection_pipeline_layout),
+                     "Failed to create selection pipeline layout");
+        }
+
+        // Builds every pipeline from `shaders` against the layouts and render passes, which never
+        // change after startup, so shader hot reload can run this on a worker thread. `parallel`
+        // compiles on the recording workers; only startup uses it, when no frame needs them.
+        [[nodiscard]] PipelineSet create_pipelines(const ShaderLibrary& shaders, bool parallel)
+        {
+            const VkShaderModule vert_shader_module = create_shader_module(shaders.spirv("shader.vert.spv"));
+            const VkShaderModule frag_shader_module = create_shader_module(shaders.spirv("shader.frag.spv"));
+            const VkShaderModule post_vert_shader_module = create_shader_module(shaders.spirv("post.vert.spv"));
+            const VkShaderModule bloom_frag_shader_module = create_shader_module(shaders.spirv("bloom.frag.spv"));
+            const VkShaderModule cull_shader_module = create_shader_module(shaders.spirv("cull.comp.spv"));
+            const VkShaderModule hiz_shader_module = create_shader_module(shaders.spirv("hiz.comp.spv"));
+            const VkShaderModule bloom_downsample_shader_module =
+                create_shader_module(shaders.spirv("bloom_downsample.comp.spv"));
+            const VkShaderModule bloom_upsample_shader_module =
+                create_shader_module(shaders.spirv("bloom_upsample.comp.spv"));
+            const VkShaderModule selection_mask_shader_module =
+                create_shader_module(shaders.spirv("selection_mask.frag.spv"));
+            const VkShaderModule selection_jump_flood_shader_module =
+                create_shader_module(shaders.spirv("selection_jump_flood.comp.spv"));
+            const VkShaderModule selection_outline_shader_module =
+                create_shader_module(shaders.spirv("selection_outline.frag.spv"));
+            const VkShaderModule pick_shader_module = create_shader_module(shaders.spirv("pick.frag.spv"));
 
             VkPipelineShaderStageCreateInfo vert_shader_stage_info{};
             vert_shader_stage_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -2565,31 +5323,7 @@ namespace rose::core::vulkan
             dynamic_state.dynamicStateCount = 2;
             dynamic_state.pDynamicStates = dynamic_states;
 
-            VkPushConstantRange push_constant_range{};
-            push_constant_range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-            push_constant_range.offset = 0;
-            push_constant_range.size = sizeof(PushConstants);
-
-            VkPhysicalDeviceProperties device_properties{};
-            vkGetPhysicalDeviceProperties(m_physical_device, &device_properties);
-            if (device_properties.limits.maxPushConstantsSize < static_cast<uint32_t>(sizeof(PushConstants)))
-                throw VulkanError("Vulkan device does not support the push constant size required for motion vectors");
-
-            const std::array<VkDescriptorSetLayout, 2> mesh_set_layouts{
-                m_descriptor_set_layout,
-                m_light_descriptor_set_layout
-            };
-
-            VkPipelineLayoutCreateInfo pipeline_layout_info{};
-            pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-            pipeline_layout_info.setLayoutCount = static_cast<uint32_t>(mesh_set_layouts.size());
-            pipeline_layout_info.pSetLayouts = mesh_set_layouts.data();
-            pipeline_layout_info.pushConstantRangeCount = 1;
-            pipeline_layout_info.pPushConstantRanges = &push_constant_range;
-
-            check_vk(vkCreatePipelineLayout(m_device, &pipeline_layout_info, nullptr, &m_pipeline_layout),
-                     "Failed to create pipeline layout");
-
+            PipelineSet pipelines;
             VkGraphicsPipelineCreateInfo pipeline_info{};
             pipeline_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
             pipeline_info.stageCount = 2;
@@ -2606,43 +5340,64 @@ namespace rose::core::vulkan
             pipeline_info.renderPass = m_render_pass;
             pipeline_info.subpass = 0;
 
-            check_vk(vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &m_graphics_pipeline),
-                     "Failed to create graphics pipeline");
-
-            VkPipelineRasterizationStateCreateInfo outline_rasterizer = rasterizer;
-            outline_rasterizer.cullMode = VK_CULL_MODE_FRONT_BIT;
-
-            VkPipelineDepthStencilStateCreateInfo outline_depth_stencil = depth_stencil;
-            outline_depth_stencil.depthWriteEnable = VK_FALSE;
-            outline_depth_stencil.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
-
-            VkPipelineColorBlendAttachmentState outline_color_blend_attachment = color_blend_attachment;
-            outline_color_blend_attachment.blendEnable = VK_TRUE;
-            outline_color_blend_attachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-            outline_color_blend_attachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
-            outline_color_blend_attachment.colorBlendOp = VK_BLEND_OP_ADD;
-            outline_color_blend_attachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-            outline_color_blend_attachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-            outline_color_blend_attachment.alphaBlendOp = VK_BLEND_OP_ADD;
-
-            VkPipelineColorBlendAttachmentState outline_motion_blend_attachment = motion_blend_attachment;
-            outline_motion_blend_attachment.colorWriteMask = 0;
-            const std::array<VkPipelineColorBlendAttachmentState, 2> outline_color_blend_attachments{
-                outline_color_blend_attachment,
-                outline_motion_blend_attachment
+            std::vector<PipelineBuild> builds;
+            builds.push_back({&pipeline_info, nullptr, &pipelines.graphics, "Failed to create graphics pipeline"});
+
+            // Selected meshes write their seeds where they are visible. The bias lets them pass the
+            // depth test against the scene depth they wrote themselves.
+            VkPipelineShaderStageCreateInfo selection_mask_stage_info = frag_shader_stage_info;
+            selection_mask_stage_info.module = selection_mask_shader_module;
+            const VkPipelineShaderStageCreateInfo selection_mask_stages[] = {
+                vert_shader_stage_info,
+                selection_mask_stage_info
             };
 
-            VkPipelineColorBlendStateCreateInfo outline_color_blending = color_blending;
-            outline_color_blending.pAttachments = outline_color_blend_attachments.data();
+            VkPipelineRasterizationStateCreateInfo selection_mask_rasterizer = rasterizer;
+            selection_mask_rasterizer.depthBiasEnable = VK_TRUE;
+            selection_mask_rasterizer.depthBiasConstantFactor = -1.0f;
+            selection_mask_rasterizer.depthBiasClamp = 0.0f;
+            selection_mask_rasterizer.depthBiasSlopeFactor = -1.0f;
 
-            pipeline_info.pRasterizationState = &outline_rasterizer;
-            pipeline_info.pDepthStencilState = &outline_depth_stencil;
-            pipeline_info.pColorBlendState = &outline_color_blending;
+            VkPipelineDepthStencilStateCreateInfo selection_depth_stencil = depth_stencil;
+            selection_depth_stencil.depthWriteEnable = VK_FALSE;
+            selection_depth_stencil.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
 
-            check_vk(vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &m_outline_pipeline),
-                     "Failed to create outline pipeline");
+            VkPipelineColorBlendAttachmentState seed_blend_attachment = color_blend_attachment;
+            seed_blend_attachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT;
+            const std::array<VkPipelineColorBlendAttachmentState, 2> selection_mask_blend_attachments{
+                seed_blend_attachment,
+                motion_blend_attachment
+            };
+            VkPipelineColorBlendStateCreateInfo selection_mask_color_blending = color_blending;
+            selection_mask_color_blending.pAttachments = selection_mask_blend_attachments.data();
+
+            VkGraphicsPipelineCreateInfo selection_mask_pipeline_info = pipeline_info;
+            selection_mask_pipeline_info.pStages = selection_mask_stages;
+            selection_mask_pipeline_info.pRasterizationState = &selection_mask_rasterizer;
+            selection_mask_pipeline_info.pDepthStencilState = &selection_depth_stencil;
+            selection_mask_pipeline_info.pColorBlendState = &selection_mask_color_blending;
+            selection_mask_pipeline_info.renderPass = m_selection_render_pass;
+            builds.push_back({&selection_mask_pipeline_info,
+                              nullptr,
+                              &pipelines.selection_mask,
+                              "Failed to create selection mask pipeline"});
+
+            VkPipelineShaderStageCreateInfo pick_stage_info = frag_shader_stage_info;
+            pick_stage_info.module = pick_shader_module;
+            const VkPipelineShaderStageCreateInfo pick_stages[] = {vert_shader_stage_info, pick_stage_info};
+
+            VkPipelineColorBlendStateCreateInfo pick_color_blending = color_blending;
+            pick_color_blending.attachmentCount = 1;
+            pick_color_blending.pAttachments = &seed_blend_attachment;
+
+            VkGraphicsPipelineCreateInfo pick_pipeline_info = pipeline_info;
+            pick_pipeline_info.pStages = pick_stages;
+            pick_pipeline_info.pColorBlendState = &pick_color_blending;
+            pick_pipeline_info.renderPass = m_pick_render_pass;
+            builds.push_back({&pick_pipeline_info, nullptr, &pipelines.pick, "Failed to create pick pipeline"});
 
             VkPipelineRasterizationStateCreateInfo shadow_rasterizer = rasterizer;
+            shadow_rasterizer.depthClampEnable = m_depth_clamp_supported ? VK_TRUE : VK_FALSE;
             shadow_rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
             shadow_rasterizer.depthBiasEnable = VK_TRUE;
             shadow_rasterizer.depthBiasConstantFactor = 1.25f;
@@ -2666,23 +5421,41 @@ namespace rose::core::vulkan
             shadow_pipeline_info.pColorBlendState = &shadow_color_blending;
             shadow_pipeline_info.renderPass = m_shadow_render_pass;
 
-            check_vk(vkCreateGraphicsPipelines(m_device,
-                                               VK_NULL_HANDLE,
-                                               1,
-                                               &shadow_pipeline_info,
-                                               nullptr,
-                                               &m_shadow_pipeline),
-                     "Failed to create shadow pipeline");
-
-            const std::filesystem::path post_vert_shader_path = shader_path("post.vert.spv");
-            const std::filesystem::path bloom_frag_shader_path = shader_path("bloom.frag.spv");
-            spdlog::info("Vulkan: creating bloom pipeline using shaders '{}' and '{}'",
-                         post_vert_shader_path.string(),
-                         bloom_frag_shader_path.string());
-            const std::vector<char> post_vert_shader_code = read_binary_file(post_vert_shader_path);
-            const std::vector<char> bloom_frag_shader_code = read_binary_file(bloom_frag_shader_path);
-            const VkShaderModule post_vert_shader_module = create_shader_module(post_vert_shader_code);
-            const VkShaderModule bloom_frag_shader_module = create_shader_module(bloom_frag_shader_code);
+            builds.push_back({&shadow_pipeline_info, nullptr, &pipelines.shadow, "Failed to create shadow pipeline"});
+
+            // The GPU-driven variants read the model matrix from the per-draw storage buffer,
+            // indexed by the instance id that each indirect command's firstInstance selects.
+            const VkBool32 gpu_driven = VK_TRUE;
+            const VkSpecializationMapEntry gpu_driven_entry{0, 0, sizeof(VkBool32)};
+            VkSpecializationInfo gpu_driven_specialization{};
+            gpu_driven_specialization.mapEntryCount = 1;
+            gpu_driven_specialization.pMapEntries = &gpu_driven_entry;
+            gpu_driven_specialization.dataSize = sizeof(VkBool32);
+            gpu_driven_specialization.pData = &gpu_driven;
+
+            VkPipelineShaderStageCreateInfo indirect_vert_shader_stage_info = vert_shader_stage_info;
+            indirect_vert_shader_stage_info.pSpecializationInfo = &gpu_driven_specialization;
+            const VkPipelineShaderStageCreateInfo indirect_shader_stages[] = {
+                indirect_vert_shader_stage_info,
+                frag_shader_stage_info
+            };
+
+            VkGraphicsPipelineCreateInfo indirect_pipeline_info = pipeline_info;
+            indirect_pipeline_info.pStages = indirect_shader_stages;
+            indirect_pipeline_info.pRasterizationState = &rasterizer;
+            indirect_pipeline_info.pDepthStencilState = &depth_stencil;
+            indirect_pipeline_info.pColorBlendState = &color_blending;
+            builds.push_back({&indirect_pipeline_info,
+                              nullptr,
+                              &pipelines.indirect,
+                              "Failed to create indirect graphics pipeline"});
+
+            VkGraphicsPipelineCreateInfo indirect_shadow_pipeline_info = shadow_pipeline_info;
+            indirect_shadow_pipeline_info.pStages = &indirect_vert_shader_stage_info;
+            builds.push_back({&indirect_shadow_pipeline_info,
+                              nullptr,
+                              &pipelines.indirect_shadow,
+                              "Failed to create indirect shadow pipeline"});
 
             VkPipelineShaderStageCreateInfo post_vert_shader_stage_info{};
             post_vert_shader_stage_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -2720,24 +5493,6 @@ namespace rose::core::vulkan
             bloom_color_blending.attachmentCount = 1;
             bloom_color_blending.pAttachments = &color_blend_attachment;
 
-            VkPushConstantRange bloom_push_constant_range{};
-            bloom_push_constant_range.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-            bloom_push_constant_range.offset = 0;
-            bloom_push_constant_range.size = sizeof(BloomPushConstants);
-
-            VkPipelineLayoutCreateInfo bloom_pipeline_layout_info{};
-            bloom_pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-            bloom_pipeline_layout_info.setLayoutCount = 1;
-            bloom_pipeline_layout_info.pSetLayouts = &m_post_descriptor_set_layout;
-            bloom_pipeline_layout_info.pushConstantRangeCount = 1;
-            bloom_pipeline_layout_info.pPushConstantRanges = &bloom_push_constant_range;
-
-            check_vk(vkCreatePipelineLayout(m_device,
-                                            &bloom_pipeline_layout_info,
-                                            nullptr,
-                                            &m_bloom_pipeline_layout),
-                     "Failed to create bloom pipeline layout");
-
             VkGraphicsPipelineCreateInfo bloom_pipeline_info{};
             bloom_pipeline_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
             bloom_pipeline_info.stageCount = 2;
@@ -2754,19 +5509,165 @@ namespace rose::core::vulkan
             bloom_pipeline_info.renderPass = m_present_render_pass;
             bloom_pipeline_info.subpass = 0;
 
-            check_vk(vkCreateGraphicsPipelines(m_device,
-                                               VK_NULL_HANDLE,
-                                               1,
-                                               &bloom_pipeline_info,
-                                               nullptr,
-                                               &m_bloom_pipeline),
-                     "Failed to create bloom pipeline");
-            spdlog::info("Vulkan: graphics pipelines created");
+            builds.push_back({&bloom_pipeline_info, nullptr, &pipelines.bloom, "Failed to create bloom pipeline"});
+
+            // The glow is blended over the scene at the depth of its seed, so whatever is in front
+            // of the selection also hides its outline.
+            VkPipelineShaderStageCreateInfo selection_outline_stage_info = bloom_frag_shader_stage_info;
+            selection_outline_stage_info.module = selection_outline_shader_module;
+            const VkPipelineShaderStageCreateInfo selection_outline_stages[] = {
+                post_vert_shader_stage_info,
+                selection_outline_stage_info
+            };
+
+            VkPipelineColorBlendAttachmentState outline_blend_attachment = color_blend_attachment;
+            outline_blend_attachment.blendEnable = VK_TRUE;
+            outline_blend_attachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+            outline_blend_attachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+            outline_blend_attachment.colorBlendOp = VK_BLEND_OP_ADD;
+            outline_blend_attachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+            outline_blend_attachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+            outline_blend_attachment.alphaBlendOp = VK_BLEND_OP_ADD;
+            VkPipelineColorBlendStateCreateInfo outline_color_blending = bloom_color_blending;
+            outline_color_blending.pAttachments = &outline_blend_attachment;
+
+            VkGraphicsPipelineCreateInfo selection_outline_pipeline_info = bloom_pipeline_info;
+            selection_outline_pipeline_info.pStages = selection_outline_stages;
+            selection_outline_pipeline_info.pDepthStencilState = &selection_depth_stencil;
+            selection_outline_pipeline_info.pColorBlendState = &outline_color_blending;
+            selection_outline_pipeline_info.layout = m_selection_pipeline_layout;
+            selection_outline_pipeline_info.renderPass = m_selection_outline_render_pass;
+            builds.push_back({&selection_outline_pipeline_info,
+                              nullptr,
+                              &pipelines.selection_outline,
+                              "Failed to create selection outline pipeline"});
+
+            const VkComputePipelineCreateInfo cull_pipeline_info =
+                compute_pipeline_info(cull_shader_module, m_cull_pipeline_layout);
+            const VkComputePipelineCreateInfo hiz_pipeline_info =
+                compute_pipeline_info(hiz_shader_module, m_hiz_pipeline_layout);
+            builds.push_back({nullptr, &cull_pipeline_info, &pipelines.cull, "Failed to create cull pipeline"});
+            builds.push_back({nullptr,
+                              &hiz_pipeline_info,
+                              &pipelines.hiz,
+                              "Failed to create depth pyramid pipeline"});
+            const VkComputePipelineCreateInfo bloom_downsample_pipeline_info =
+                compute_pipeline_info(bloom_downsample_shader_module, m_bloom_pyramid_pipeline_layout);
+            const VkComputePipelineCreateInfo bloom_upsample_pipeline_info =
+                compute_pipeline_info(bloom_upsample_shader_module, m_bloom_pyramid_pipeline_layout);
+            builds.push_back({nullptr,
+                              &bloom_downsample_pipeline_info,
+                              &pipelines.bloom_downsample,
+                              "Failed to create bloom downsample pipeline"});
+            builds.push_back({nullptr,
+                              &bloom_upsample_pipeline_info,
+                              &pipelines.bloom_upsample,
+                              "Failed to create bloom upsample pipeline"});
+            const VkComputePipelineCreateInfo selection_jump_flood_pipeline_info =
+                compute_pipeline_info(selection_jump_flood_shader_module, m_selection_pipeline_layout);
+            builds.push_back({nullptr,
+                              &selection_jump_flood_pipeline_info,
+                              &pipelines.selection_jump_flood,
+                              "Failed to create selection jump flood pipeline"});
+
+            // Hot reload keeps running on the old pipelines when a new shader fails, so nothing
+            // may leak on the error path.
+            std::exception_ptr failure;
+            try
+            {
+                build_pipelines(builds, parallel);
+            }
+            catch (...)
+            {
+                failure = std::current_exception();
+            }
 
+            vkDestroyShaderModule(m_device, pick_shader_module, nullptr);
+            vkDestroyShaderModule(m_device, selection_outline_shader_module, nullptr);
+            vkDestroyShaderModule(m_device, selection_jump_flood_shader_module, nullptr);
+            vkDestroyShaderModule(m_device, selection_mask_shader_module, nullptr);
+            vkDestroyShaderModule(m_device, bloom_upsample_shader_module, nullptr);
+            vkDestroyShaderModule(m_device, bloom_downsample_shader_module, nullptr);
+            vkDestroyShaderModule(m_device, hiz_shader_module, nullptr);
+            vkDestroyShaderModule(m_device, cull_shader_module, nullptr);
             vkDestroyShaderModule(m_device, bloom_frag_shader_module, nullptr);
             vkDestroyShaderModule(m_device, post_vert_shader_module, nullptr);
             vkDestroyShaderModule(m_device, frag_shader_module, nullptr);
             vkDestroyShaderModule(m_device, vert_shader_module, nullptr);
+            if (failure)
+            {
+                destroy_pipelines(pipelines);
+                std::rethrow_exception(failure);
+            }
+            return pipelines;
+        }
+
+        [[nodiscard]] static VkComputePipelineCreateInfo compute_pipeline_info(VkShaderModule shader_module,
+                                                                               VkPipelineLayout layout)
+        {
+            VkComputePipelineCreateInfo pipeline_info{};
+            pipeline_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+            pipeline_info.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            pipeline_info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+            pipeline_info.stage.module = shader_module;
+            pipeline_info.stage.pName = "main";
+            pipeline_info.layout = layout;
+            return pipeline_info;
+        }
+
+        void install_pipelines(const PipelineSet& pipelines) noexcept
+        {
+            m_graphics_pipeline = pipelines.graphics;
+            m_selection_mask_pipeline = pipelines.selection_mask;
+            m_shadow_pipeline = pipelines.shadow;
+            m_indirect_pipeline = pipelines.indirect;
+            m_indirect_shadow_pipeline = pipelines.indirect_shadow;
+            m_bloom_pipeline = pipelines.bloom;
+            m_bloom_downsample_pipeline = pipelines.bloom_downsample;
+            m_bloom_upsample_pipeline = pipelines.bloom_upsample;
+            m_cull_pipeline = pipelines.cull;
+            m_hiz_pipeline = pipelines.hiz;
+            m_selection_jump_flood_pipeline = pipelines.selection_jump_flood;
+            m_selection_outline_pipeline = pipelines.selection_outline;
+            m_pick_pipeline = pipelines.pick;
+        }
+
+        [[nodiscard]] PipelineSet installed_pipelines() const noexcept
+        {
+            return {m_graphics_pipeline,
+                    m_selection_mask_pipeline,
+                    m_shadow_pipeline,
+                    m_indirect_pipeline,
+                    m_indirect_shadow_pipeline,
+                    m_bloom_pipeline,
+                    m_bloom_downsample_pipeline,
+                    m_bloom_upsample_pipeline,
+                    m_cull_pipeline,
+                    m_hiz_pipeline,
+                    m_selection_jump_flood_pipeline,
+                    m_selection_outline_pipeline,
+                    m_pick_pipeline};
+        }
+
+        void destroy_pipelines(const PipelineSet& pipelines) const noexcept
+        {
+            for (const VkPipeline pipeline : {pipelines.graphics,
+                                              pipelines.selection_mask,
+                                              pipelines.shadow,
+                                              pipelines.indirect,
+                                              pipelines.indirect_shadow,
+                                              pipelines.bloom,
+                                              pipelines.bloom_downsample,
+                                              pipelines.bloom_upsample,
+                                              pipelines.cull,
+                                              pipelines.hiz,
+                                              pipelines.selection_jump_flood,
+                                              pipelines.selection_outline,
+                                              pipelines.pick})
+            {
+                if (pipeline != VK_NULL_HANDLE)
+                    vkDestroyPipeline(m_device, pipeline, nullptr);
+            }
         }
 
         [[nodiscard]] VkFormat find_supported_format(const std::vector<VkFormat>& candidates,
@@ -2796,9 +5697,15 @@ namespace rose::core::vulkan
         }
 
         void create_render_targets()
+        {
+            create_scene_targets();
+            create_shadow_targets();
+        }
+
+        void create_scene_targets()
         {
             m_scene_extent = choose_scene_extent();
-            spdlog::info("Vulkan: creating render targets scene={}x{} swapchain={}x{} dlss_active={}",
+            spdlog::info("Vulkan: creating scene targets scene={}x{} swapchain={}x{} dlss_active={}",
                          m_scene_extent.width,
                          m_scene_extent.height,
                          m_swapchain_extent.width,
@@ -2840,27 +5747,7 @@ namespace rose::core::vulkan
                          m_depth_image);
             m_depth_image.view = create_image_view(m_depth_image.image, m_depth_format, VK_IMAGE_ASPECT_DEPTH_BIT);
 
-            create_image(k_shadow_map_size,
-                         k_shadow_map_size,
-                         m_depth_format,
-                         VK_IMAGE_TILING_OPTIMAL,
-                         VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
-                             | VK_IMAGE_USAGE_SAMPLED_BIT,
-                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                         m_shadow_image);
-            m_shadow_image.view = create_image_view(m_shadow_image.image, m_depth_format, VK_IMAGE_ASPECT_DEPTH_BIT);
-
-            create_image(k_shadow_map_size,
-                         k_shadow_map_size,
-                         m_depth_format,
-                         VK_IMAGE_TILING_OPTIMAL,
-                         VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
-                             | VK_IMAGE_USAGE_SAMPLED_BIT,
-                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                         m_sun_shadow_image);
-            m_sun_shadow_image.view =
-                create_image_view(m_sun_shadow_image.image, m_depth_format, VK_IMAGE_ASPECT_DEPTH_BIT);
-            update_light_shadow_descriptors();
+            create_hiz_resources();
 
             if (dlss_active())
             {
@@ -2878,11 +5765,10 @@ namespace rose::core::vulkan
                                                              m_scene_color_format,
                                                              VK_IMAGE_ASPECT_COLOR_BIT);
             }
-            spdlog::info("Vulkan: render targets created");
-        }
+            create_bloom_resources();
+            create_selection_resources();
+            create_pick_target();
 
-        void create_framebuffers()
-        {
             const std::array<VkImageView, 3> scene_attachments{
                 m_scene_color_image.view,
                 m_motion_vector_image.view,
@@ -2898,24 +5784,459 @@ namespace rose::core::vulkan
             scene_framebuffer_info.height = m_scene_extent.height;
             scene_framebuffer_info.layers = 1;
 
-            check_vk(vkCreateFramebuffer(m_device, &scene_framebuffer_info, nullptr, &m_scene_framebuffer),
-                     "Failed to create scene framebuffer");
+            check_vk(vkCreateFramebuffer(m_device, &scene_framebuffer_info, nullptr, &m_scene_framebuffer),
+                     "Failed to create scene framebuffer");
+            ++m_frame_targets_generation;
+            spdlog::info("Vulkan: scene targets created");
+        }
+
+        // Spotlight and sun cascade shadow maps with their caches. They do not depend on the
+        // swapchain, so only SunSettings changes rebuild them.
+        void create_shadow_targets()
+        {
+            create_image(k_shadow_map_size,
+                         k_shadow_map_size,
+                         m_depth_format,
+                         VK_IMAGE_TILING_OPTIMAL,
+                         VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
+                             | VK_IMAGE_USAGE_SAMPLED_BIT
+                             | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                         m_shadow_image);
+            m_shadow_image.view = create_image_view(m_shadow_image.image, m_depth_format, VK_IMAGE_ASPECT_DEPTH_BIT);
+
+            // The sun cascades are layers of one array image, sampled through a single array view.
+            m_sun_cascade_count = static_cast<uint32_t>(
+                std::clamp(m_sun_settings.cascade_count, 1, static_cast<int>(k_max_sun_cascades)));
+            m_sun_shadow_resolution = std::bit_floor(
+                static_cast<uint32_t>(std::clamp(m_sun_settings.cascade_resolution, 512, 4096)));
+            create_image(m_sun_shadow_resolution,
+                         m_sun_shadow_resolution,
+                         m_depth_format,
+                         VK_IMAGE_TILING_OPTIMAL,
+                         VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
+                             | VK_IMAGE_USAGE_SAMPLED_BIT
+                             | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                         m_sun_shadow_image,
+                         false,
+                         1,
+                         m_sun_cascade_count);
+            m_sun_shadow_image.view = create_image_view(m_sun_shadow_image.image,
+                                                        m_depth_format,
+                                                        VK_IMAGE_ASPECT_DEPTH_BIT,
+                                                        0,
+                                                        1,
+                                                        VK_IMAGE_VIEW_TYPE_2D_ARRAY,
+                                                        0,
+                                                        m_sun_cascade_count);
+            m_sun_shadow_layer_views.resize(m_sun_cascade_count);
+            for (uint32_t cascade = 0; cascade < m_sun_cascade_count; ++cascade)
+            {
+                m_sun_shadow_layer_views[cascade] = create_image_view(m_sun_shadow_image.image,
+                                                                      m_depth_format,
+                                                                      VK_IMAGE_ASPECT_DEPTH_BIT,
+                                                                      0,
+                                                                      1,
+                                                                      VK_IMAGE_VIEW_TYPE_2D,
+                                                                      cascade,
+                                                                      1);
+                create_shadow_cache(m_sun_shadow_caches[cascade], m_sun_shadow_resolution);
+            }
+            create_shadow_cache(m_shadow_cache, k_shadow_map_size);
+            spdlog::info("Vulkan: sun shadows cascades={} resolution={}", m_sun_cascade_count, m_sun_shadow_resolution);
+
+            VkFramebufferCreateInfo shadow_framebuffer_info{};
+            shadow_framebuffer_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+            shadow_framebuffer_info.renderPass = m_shadow_render_pass;
+            shadow_framebuffer_info.attachmentCount = 1;
+            shadow_framebuffer_info.pAttachments = &m_shadow_image.view;
+            shadow_framebuffer_info.width = k_shadow_map_size;
+            shadow_framebuffer_info.height = k_shadow_map_size;
+            shadow_framebuffer_info.layers = 1;
+            check_vk(vkCreateFramebuffer(m_device, &shadow_framebuffer_info, nullptr, &m_shadow_framebuffer),
+                     "Failed to create shadow framebuffer");
+
+            shadow_framebuffer_info.pAttachments = &m_shadow_cache.image.view;
+            check_vk(vkCreateFramebuffer(m_device, &shadow_framebuffer_info, nullptr, &m_shadow_cache.framebuffer),
+                     "Failed to create shadow cache framebuffer");
+
+            shadow_framebuffer_info.width = m_sun_shadow_resolution;
+            shadow_framebuffer_info.height = m_sun_shadow_resolution;
+            m_sun_shadow_framebuffers.resize(m_sun_cascade_count);
+            for (uint32_t cascade = 0; cascade < m_sun_cascade_count; ++cascade)
+            {
+                shadow_framebuffer_info.pAttachments = &m_sun_shadow_layer_views[cascade];
+                check_vk(vkCreateFramebuffer(m_device,
+                                             &shadow_framebuffer_info,
+                                             nullptr,
+                                             &m_sun_shadow_framebuffers[cascade]),
+                         "Failed to create sun shadow framebuffer");
+
+                shadow_framebuffer_info.pAttachments = &m_sun_shadow_caches[cascade].image.view;
+                check_vk(vkCreateFramebuffer(m_device,
+                                             &shadow_framebuffer_info,
+                                             nullptr,
+                                             &m_sun_shadow_caches[cascade].framebuffer),
+                         "Failed to create sun shadow cache framebuffer");
+            }
+            ++m_frame_targets_generation;
+        }
+
+        void create_hiz_resources()
+        {
+            const uint32_t width = std::max(1u, m_scene_extent.width / 2u);
+            const uint32_t height = std::max(1u, m_scene_extent.height / 2u);
+            m_hiz.mip_count = static_cast<uint32_t>(std::bit_width(std::max(width, height)));
+            create_image(width,
+                         height,
+                         VK_FORMAT_R32_SFLOAT,
+                         VK_IMAGE_TILING_OPTIMAL,
+                         VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                         m_hiz.image,
+                         false,
+                         m_hiz.mip_count);
+            m_hiz.image.view = create_image_view(m_hiz.image.image,
+                                                 VK_FORMAT_R32_SFLOAT,
+                                                 VK_IMAGE_ASPECT_COLOR_BIT,
+                                                 0,
+                                                 m_hiz.mip_count);
+
+            m_hiz.mip_views.resize(m_hiz.mip_count);
+            for (uint32_t mip = 0; mip < m_hiz.mip_count; ++mip)
+                m_hiz.mip_views[mip] =
+                    create_image_view(m_hiz.image.image, VK_FORMAT_R32_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT, mip);
+
+            const std::vector<VkDescriptorSetLayout> layouts(m_hiz.mip_count, m_hiz_descriptor_set_layout);
+            m_hiz.descriptors.resize(m_hiz.mip_count);
+            VkDescriptorSetAllocateInfo alloc_info{};
+            alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            alloc_info.descriptorPool = m_descriptor_pool;
+            alloc_info.descriptorSetCount = m_hiz.mip_count;
+            alloc_info.pSetLayouts = layouts.data();
+            check_vk(vkAllocateDescriptorSets(m_device, &alloc_info, m_hiz.descriptors.data()),
+                     "Failed to allocate depth pyramid descriptor sets");
+
+            // Each mip reduces the one above it; mip 0 reduces the scene depth buffer.
+            std::vector<VkDescriptorImageInfo> image_infos(static_cast<std::size_t>(m_hiz.mip_count) * 2u);
+            std::vector<VkWriteDescriptorSet> descriptor_writes(image_infos.size());
+            for (uint32_t mip = 0; mip < m_hiz.mip_count; ++mip)
+            {
+                VkDescriptorImageInfo& source_info = image_infos[mip * 2u];
+                source_info.sampler = m_hiz_sampler;
+                source_info.imageView = mip == 0 ? m_depth_image.view : m_hiz.mip_views[mip - 1u];
+                source_info.imageLayout = mip == 0
+                    ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL
+                    : VK_IMAGE_LAYOUT_GENERAL;
+
+                VkDescriptorImageInfo& destination_info = image_infos[mip * 2u + 1u];
+                destination_info.imageView = m_hiz.mip_views[mip];
+                destination_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+                for (uint32_t binding = 0; binding < 2; ++binding)
+                {
+                    VkWriteDescriptorSet& descriptor_write = descriptor_writes[mip * 2u + binding];
+                    descriptor_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                    descriptor_write.dstSet = m_hiz.descriptors[mip];
+                    descriptor_write.dstBinding = binding;
+                    descriptor_write.dstArrayElement = 0;
+                    descriptor_write.descriptorType = binding == 0
+                        ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER
+                        : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+                    descriptor_write.descriptorCount = 1;
+                    descriptor_write.pImageInfo = &image_infos[mip * 2u + binding];
+                }
+            }
+            vkUpdateDescriptorSets(m_device,
+                                   static_cast<uint32_t>(descriptor_writes.size()),
+                                   descriptor_writes.data(),
+                                   0,
+                                   nullptr);
+
+            m_hiz.valid = false;
+        }
+
+        // Sized for the resolved image: the DLSS output when DLSS is active, else the scene color.
+        void create_bloom_resources()
+        {
+            const VkExtent2D resolved_extent = dlss_active() ? m_swapchain_extent : m_scene_extent;
+            const uint32_t width = std::max(1u, resolved_extent.width / 2u);
+            const uint32_t height = std::max(1u, resolved_extent.height / 2u);
+            m_bloom.mip_count = std::min(static_cast<uint32_t>(BloomSettings::k_max_levels),
+                                         static_cast<uint32_t>(std::bit_width(std::min(width, height))));
+            create_image(width,
+                         height,
+                         VK_FORMAT_R16G16B16A16_SFLOAT,
+                         VK_IMAGE_TILING_OPTIMAL,
+                         VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                         m_bloom.image,
+                         false,
+                         m_bloom.mip_count);
+            m_bloom.mip_views.resize(m_bloom.mip_count);
+            for (uint32_t mip = 0; mip < m_bloom.mip_count; ++mip)
+                m_bloom.mip_views[mip] = create_image_view(m_bloom.image.image,
+                                                           VK_FORMAT_R16G16B16A16_SFLOAT,
+                                                           VK_IMAGE_ASPECT_COLOR_BIT,
+                                                           mip);
+
+            const auto allocate = [this](VkDescriptorSetLayout layout, std::span<VkDescriptorSet> sets)
+            {
+                if (sets.empty())
+                    return;
+                const std::vector<VkDescriptorSetLayout> layouts(sets.size(), layout);
+                VkDescriptorSetAllocateInfo alloc_info{};
+                alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+                alloc_info.descriptorPool = m_descriptor_pool;
+                alloc_info.descriptorSetCount = static_cast<uint32_t>(sets.size());
+                alloc_info.pSetLayouts = layouts.data();
+                check_vk(vkAllocateDescriptorSets(m_device, &alloc_info, sets.data()),
+                         "Failed to allocate bloom descriptor sets");
+            };
+
+            const std::array<VkImageView, 2> sources{m_scene_color_image.view, m_dlss_output_image.view};
+            const std::size_t source_count = sources[1] != VK_NULL_HANDLE ? 2u : 1u;
+            m_bloom.downsample_descriptors.resize(m_bloom.mip_count - 1u);
+            m_bloom.upsample_descriptors.resize(m_bloom.mip_count - 1u);
+            allocate(m_bloom_pyramid_descriptor_set_layout, std::span(m_bloom.prefilter_descriptors).first(source_count));
+            allocate(m_post_descriptor_set_layout, std::span(m_bloom.composite_descriptors).first(source_count));
+            allocate(m_bloom_pyramid_descriptor_set_layout, m_bloom.downsample_descriptors);
+            allocate(m_bloom_pyramid_descriptor_set_layout, m_bloom.upsample_descriptors);
+
+            // Every set reads binding 0 and writes (or, for the composite, reads) binding 1.
+            struct SetImages final
+            {
+                VkDescriptorSet set;
+                VkImageView source;
+                VkImageLayout source_layout;
+                VkImageView destination;
+                VkDescriptorType destination_type;
+            };
+            std::vector<SetImages> sets;
+            for (std::size_t source = 0; source < source_count; ++source)
+            {
+                sets.push_back({m_bloom.prefilter_descriptors[source],
+                                sources[source],
+                                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                m_bloom.mip_views[0],
+                                VK_DESCRIPTOR_TYPE_STORAGE_IMAGE});
+                sets.push_back({m_bloom.composite_descriptors[source],
+                                sources[source],
+                                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                m_bloom.mip_views[0],
+                                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER});
+            }
+            for (uint32_t level = 1; level < m_bloom.mip_count; ++level)
+            {
+                sets.push_back({m_bloom.downsample_descriptors[level - 1u],
+                                m_bloom.mip_views[level - 1u],
+                                VK_IMAGE_LAYOUT_GENERAL,
+                                m_bloom.mip_views[level],
+                                VK_DESCRIPTOR_TYPE_STORAGE_IMAGE});
+                sets.push_back({m_bloom.upsample_descriptors[level - 1u],
+                                m_bloom.mip_views[level],
+                                VK_IMAGE_LAYOUT_GENERAL,
+                                m_bloom.mip_views[level - 1u],
+                                VK_DESCRIPTOR_TYPE_STORAGE_IMAGE});
+            }
+
+            std::vector<VkDescriptorImageInfo> image_infos(sets.size() * 2u);
+            std::vector<VkWriteDescriptorSet> descriptor_writes(image_infos.size());
+            for (std::size_t i = 0; i < sets.size(); ++i)
+            {
+                VkDescriptorImageInfo& source_info = image_infos[i * 2u];
+                source_info.sampler = m_bloom_sampler;
+                source_info.imageView = sets[i].source;
+                source_info.imageLayout = sets[i].source_layout;
+
+                VkDescriptorImageInfo& destination_info = image_infos[i * 2u + 1u];
+                destination_info.sampler = m_bloom_sampler;
+                destination_info.imageView = sets[i].destination;
+                destination_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+                for (uint32_t binding = 0; binding < 2; ++binding)
+                {
+                    VkWriteDescriptorSet& descriptor_write = descriptor_writes[i * 2u + binding];
+                    descriptor_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                    descriptor_write.dstSet = sets[i].set;
+                    descriptor_write.dstBinding = binding;
+                    descriptor_write.dstArrayElement = 0;
+                    descriptor_write.descriptorType = binding == 0
+                        ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER
+                        : sets[i].destination_type;
+                    descriptor_write.descriptorCount = 1;
+                    descriptor_write.pImageInfo = &image_infos[i * 2u + binding];
+                }
+            }
+            vkUpdateDescriptorSets(m_device,
+                                   static_cast<uint32_t>(descriptor_writes.size()),
+                                   descriptor_writes.data(),
+                                   0,
+                                   nullptr);
+        }
+
+        // Seeds ping-pong between two images; the seed data is written once by the mask pass.
+        void create_selection_resources()
+        {
+            for (ImageResource& seeds : m_selection.seeds)
+            {
+                create_image(m_scene_extent.width,
+                             m_scene_extent.height,
+                             VK_FORMAT_R32_UINT,
+                             VK_IMAGE_TILING_OPTIMAL,
+                             VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT,
+                             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                             seeds);
+                seeds.view = create_image_view(seeds.image, VK_FORMAT_R32_UINT, VK_IMAGE_ASPECT_COLOR_BIT);
+            }
+            create_image(m_scene_extent.width,
+                         m_scene_extent.height,
+                         VK_FORMAT_R32G32_SFLOAT,
+                         VK_IMAGE_TILING_OPTIMAL,
+                         VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT,
+                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                         m_selection.seed_data);
+            m_selection.seed_data.view = create_image_view(m_selection.seed_data.image,
+                                                           VK_FORMAT_R32G32_SFLOAT,
+                                                           VK_IMAGE_ASPECT_COLOR_BIT);
+
+            const std::array<VkImageView, 3> mask_attachments{
+                m_selection.seeds[0].view,
+                m_selection.seed_data.view,
+                m_depth_image.view
+            };
+            VkFramebufferCreateInfo framebuffer_info{};
+            framebuffer_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+            framebuffer_info.renderPass = m_selection_render_pass;
+            framebuffer_info.attachmentCount = static_cast<uint32_t>(mask_attachments.size());
+            framebuffer_info.pAttachments = mask_attachments.data();
+            framebuffer_info.width = m_scene_extent.width;
+            framebuffer_info.height = m_scene_extent.height;
+            framebuffer_info.layers = 1;
+            check_vk(vkCreateFramebuffer(m_device, &framebuffer_info, nullptr, &m_selection.mask_framebuffer),
+                     "Failed to create selection mask framebuffer");
+
+            const std::array<VkImageView, 2> composite_attachments{m_scene_color_image.view, m_depth_image.view};
+            framebuffer_info.renderPass = m_selection_outline_render_pass;
+            framebuffer_info.attachmentCount = static_cast<uint32_t>(composite_attachments.size());
+            framebuffer_info.pAttachments = composite_attachments.data();
+            check_vk(vkCreateFramebuffer(m_device, &framebuffer_info, nullptr, &m_selection.composite_framebuffer),
+                     "Failed to create selection outline framebuffer");
+
+            std::array<VkDescriptorSet, 4> sets{};
+            const std::array<VkDescriptorSetLayout, 4> layouts{
+                m_selection_descriptor_set_layout,
+                m_selection_descriptor_set_layout,
+                m_selection_descriptor_set_layout,
+                m_selection_descriptor_set_layout
+            };
+            VkDescriptorSetAllocateInfo alloc_info{};
+            alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            alloc_info.descriptorPool = m_descriptor_pool;
+            alloc_info.descriptorSetCount = static_cast<uint32_t>(sets.size());
+            alloc_info.pSetLayouts = layouts.data();
+            check_vk(vkAllocateDescriptorSets(m_device, &alloc_info, sets.data()),
+                     "Failed to allocate selection descriptor sets");
+            m_selection.jump_descriptors = {sets[0], sets[1]};
+            m_selection.composite_descriptors = {sets[2], sets[3]};
+
+            // Jump flood i reads seeds[i] and writes the other; composite i reads seeds[i].
+            std::array<VkDescriptorImageInfo, 8> image_infos{};
+            std::array<VkWriteDescriptorSet, 8> descriptor_writes{};
+            for (std::size_t source = 0; source < 2; ++source)
+            {
+                const std::array<VkImageView, 4> views{
+                    m_selection.seeds[source].view,
+                    m_selection.seeds[1u - source].view,
+                    m_selection.seeds[source].view,
+                    m_selection.seed_data.view
+                };
+                const std::array<VkDescriptorSet, 2> targets{m_selection.jump_descriptors[source],
+                                                             m_selection.composite_descriptors[source]};
+                for (std::size_t i = 0; i < views.size(); ++i)
+                {
+                    const std::size_t index = source * views.size() + i;
+                    image_infos[index].imageView = views[i];
+                    image_infos[index].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+                    VkWriteDescriptorSet& descriptor_write = descriptor_writes[index];
+                    descriptor_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                    descriptor_write.dstSet = targets[i / 2u];
+                    descriptor_write.dstBinding = static_cast<uint32_t>(i % 2u);
+                    descriptor_write.dstArrayElement = 0;
+                    descriptor_write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+                    descriptor_write.descriptorCount = 1;
+                    descriptor_write.pImageInfo = &image_infos[index];
+                }
+            }
+            vkUpdateDescriptorSets(m_device,
+                                   static_cast<uint32_t>(descriptor_writes.size()),
+                                   descriptor_writes.data(),
+                                   0,
+                                   nullptr);
+        }
+
+        void create_pick_target()
+        {
+            create_image(1,
+                         1,
+                         VK_FORMAT_R32_UINT,
+                         VK_IMAGE_TILING_OPTIMAL,
+                         VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                         m_pick.ids);
+            m_pick.ids.view = create_image_view(m_pick.ids.image, VK_FORMAT_R32_UINT, VK_IMAGE_ASPECT_COLOR_BIT);
+            create_image(1,
+                         1,
+                         m_depth_format,
+                         VK_IMAGE_TILING_OPTIMAL,
+                         VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                         m_pick.depth);
+            m_pick.depth.view = create_image_view(m_pick.depth.image, m_depth_format, VK_IMAGE_ASPECT_DEPTH_BIT);
+
+            const std::array<VkImageView, 2> attachments{m_pick.ids.view, m_pick.depth.view};
+            VkFramebufferCreateInfo framebuffer_info{};
+            framebuffer_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+            framebuffer_info.renderPass = m_pick_render_pass;
+            framebuffer_info.attachmentCount = static_cast<uint32_t>(attachments.size());
+            framebuffer_info.pAttachments = attachments.data();
+            framebuffer_info.width = 1;
+            framebuffer_info.height = 1;
+            framebuffer_info.layers = 1;
+            check_vk(vkCreateFramebuffer(m_device, &framebuffer_info, nullptr, &m_pick.framebuffer),
+                     "Failed to create pick framebuffer");
+        }
 
-            VkFramebufferCreateInfo shadow_framebuffer_info{};
-            shadow_framebuffer_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-            shadow_framebuffer_info.renderPass = m_shadow_render_pass;
-            shadow_framebuffer_info.attachmentCount = 1;
-            shadow_framebuffer_info.pAttachments = &m_shadow_image.view;
-            shadow_framebuffer_info.width = k_shadow_map_size;
-            shadow_framebuffer_info.height = k_shadow_map_size;
-            shadow_framebuffer_info.layers = 1;
-            check_vk(vkCreateFramebuffer(m_device, &shadow_framebuffer_info, nullptr, &m_shadow_framebuffer),
-                     "Failed to create shadow framebuffer");
+        // The cache framebuffer is created with the other shadow framebuffers in create_framebuffers().
+        void create_shadow_cache(ShadowCache& cache, uint32_t size)
+        {
+            create_image(size,
+                         size,
+                         m_depth_format,
+                         VK_IMAGE_TILING_OPTIMAL,
+                         VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
+                             | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                         cache.image);
+            cache.image.view = create_image_view(cache.image.image, m_depth_format, VK_IMAGE_ASPECT_DEPTH_BIT);
+            cache.valid = false;
+            cache.shadow_map_current = false;
+        }
 
-            shadow_framebuffer_info.pAttachments = &m_sun_shadow_image.view;
-            check_vk(vkCreateFramebuffer(m_device, &shadow_framebuffer_info, nullptr, &m_sun_shadow_framebuffer),
-                     "Failed to create sun shadow framebuffer");
+        static void retire_shadow_cache(RetiredFrameResources& retired, ShadowCache& cache)
+        {
+            if (cache.framebuffer != VK_NULL_HANDLE)
+                retired.framebuffers.push_back(cache.framebuffer);
+            if (cache.image.image != VK_NULL_HANDLE)
+                retired.images.push_back(cache.image);
+            cache = {};
+        }
 
+        // One per swapchain image; the scene and shadow framebuffers belong to their targets.
+        void create_framebuffers()
+        {
             m_framebuffers.resize(m_swapchain_image_views.size());
             for (std::size_t i = 0; i < m_swapchain_image_views.size(); ++i)
             {
@@ -2935,6 +6256,51 @@ namespace rose::core::vulkan
             }
         }
 
+        // Cached pipelines live in ./cache unless ROSE_PIPELINE_CACHE_DIR names another directory.
+        void create_pipeline_cache()
+        {
+            std::filesystem::path directory;
+            if (const auto configured_directory = environment_value("ROSE_PIPELINE_CACHE_DIR"))
+                directory = *configured_directory;
+            else
+            {
+                std::error_code error;
+                directory = std::filesystem::current_path(error) / "cache";
+            }
+            m_pipeline_cache = std::make_unique<PipelineCache>(m_physical_device, m_device, directory);
+        }
+
+        // Compiles independent pipelines through the pipeline cache, concurrently when `parallel`
+        // is set. Every build finishes before the first failure is reported.
+        void build_pipelines(const std::vector<PipelineBuild>& builds, bool parallel)
+        {
+            const auto build_pipeline = [device = m_device, cache = m_pipeline_cache->handle()](const PipelineBuild& build)
+            {
+                if (build.graphics != nullptr)
+                    return vkCreateGraphicsPipelines(device, cache, 1, build.graphics, nullptr, build.pipeline);
+                return vkCreateComputePipelines(device, cache, 1, build.compute, nullptr, build.pipeline);
+            };
+
+            std::vector<VkResult> results;
+            results.reserve(builds.size());
+            if (parallel)
+            {
+                std::vector<std::future<VkResult>> jobs;
+                jobs.reserve(builds.size());
+                for (const PipelineBuild& build : builds)
+                    jobs.push_back(m_recording_pool.submit([build_pipeline, build] { return build_pipeline(build); }));
+                for (std::future<VkResult>& job : jobs)
+                    results.push_back(job.get());
+            }
+            else
+            {
+                for (const PipelineBuild& build : builds)
+                    results.push_back(build_pipeline(build));
+            }
+            for (std::size_t i = 0; i < builds.size(); ++i)
+                check_vk(results[i], builds[i].error_message);
+        }
+
         void create_command_pool()
         {
             const QueueFamilies queue_families = find_queue_families(m_physical_device);
@@ -2945,12 +6311,27 @@ namespace rose::core::vulkan
             pool_info.queueFamilyIndex = queue_families.graphics.value();
 
             check_vk(vkCreateCommandPool(m_device, &pool_info, nullptr, &m_command_pool), "Failed to create command pool");
+
+            VkCommandPoolCreateInfo recording_pool_info{};
+            recording_pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            recording_pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            recording_pool_info.queueFamilyIndex = queue_families.graphics.value();
+
+            const auto slot_count = static_cast<std::size_t>(m_recording_pool.size());
+            for (std::array<RecordingSlot, k_max_recording_slots>& slots : m_recording_slots)
+            {
+                for (std::size_t slot = 0; slot < slot_count; ++slot)
+                {
+                    check_vk(vkCreateCommandPool(m_device, &recording_pool_info, nullptr, &slots[slot].pool),
+                             "Failed to create recording command pool");
+                }
+            }
+            spdlog::info("Vulkan: command recording slots={}", slot_count);
         }
 
+        // One per frame slot, reused once the slot's fence has signalled.
         void create_command_buffers()
         {
-            m_command_buffers.resize(m_framebuffers.size());
-
             VkCommandBufferAllocateInfo alloc_info{};
             alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
             alloc_info.commandPool = m_command_pool;
@@ -3005,6 +6386,24 @@ namespace rose::core::vulkan
 
             check_vk(vkCreateDescriptorPool(m_device, &pool_info, nullptr, &m_descriptor_pool),
                      "Failed to create descriptor pool");
+
+            // Material sets are allocated by residency workers; a separate pool keeps them from
+            // contending with ImGui and the renderer's own sets on the shared pool.
+            const std::array<VkDescriptorPoolSize, 2> material_pool_sizes{{
+                {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4 * k_max_material_sets},
+                {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, k_max_material_sets},
+            }};
+
+            // Texture streaming replaces material sets and frees the old ones.
+            VkDescriptorPoolCreateInfo material_pool_info{};
+            material_pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+            material_pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+            material_pool_info.maxSets = k_max_material_sets;
+            material_pool_info.poolSizeCount = static_cast<uint32_t>(material_pool_sizes.size());
+            material_pool_info.pPoolSizes = material_pool_sizes.data();
+
+            check_vk(vkCreateDescriptorPool(m_device, &material_pool_info, nullptr, &m_material_descriptor_pool),
+                     "Failed to create material descriptor pool");
         }
 
         void init_imgui()
@@ -3023,58 +6422,62 @@ namespace rose::core::vulkan
             init_info.MinImageCount = m_min_image_count;
             init_info.ImageCount = static_cast<uint32_t>(m_swapchain_images.size());
             init_info.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
+            init_info.PipelineCache = m_pipeline_cache->handle();
             init_info.CheckVkResultFn = check_imgui_vk_result;
             ImGui_ImplVulkan_Init(&init_info);
         }
 
-        [[nodiscard]] uint32_t find_memory_type(uint32_t type_filter, VkMemoryPropertyFlags properties) const
+        [[nodiscard]] static void* mapped_memory(const BufferResource& buffer, const char* message)
         {
-            VkPhysicalDeviceMemoryProperties memory_properties{};
-            vkGetPhysicalDeviceMemoryProperties(m_physical_device, &memory_properties);
-
-            for (uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i)
-            {
-                if ((type_filter & (1u << i)) != 0
-                    && (memory_properties.memoryTypes[i].propertyFlags & properties) == properties)
-                    return i;
-            }
+            if (buffer.allocation.mapped == nullptr)
+                throw VulkanError(message);
+            return buffer.allocation.mapped;
+        }
 
-            throw VulkanError("Failed to find suitable Vulkan memory type");
+        // Resources written by the upload manager are shared with the transfer family so that no
+        // ownership transfer is needed when it runs on a dedicated queue.
+        [[nodiscard]] std::array<uint32_t, 2> upload_queue_families() const noexcept
+        {
+            return {m_graphics_queue_family, m_transfer_queue_family};
         }
 
         void create_buffer(VkDeviceSize size,
                            VkBufferUsageFlags usage,
                            VkMemoryPropertyFlags properties,
-                           BufferResource& buffer) const
+                           BufferResource& buffer,
+                           bool upload_target = false) const
         {
             buffer.size = size;
 
+            const std::array<uint32_t, 2> queue_families = upload_queue_families();
             VkBufferCreateInfo buffer_info{};
             buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
             buffer_info.size = size;
             buffer_info.usage = usage;
             buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            if (upload_target && m_transfer_queue_family != m_graphics_queue_family)
+            {
+                buffer_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+                buffer_info.queueFamilyIndexCount = static_cast<uint32_t>(queue_families.size());
+                buffer_info.pQueueFamilyIndices = queue_families.data();
+            }
 
             check_vk(vkCreateBuffer(m_device, &buffer_info, nullptr, &buffer.buffer), "Failed to create buffer");
 
             VkMemoryRequirements memory_requirements{};
             vkGetBufferMemoryRequirements(m_device, buffer.buffer, &memory_requirements);
 
-            VkMemoryAllocateInfo alloc_info{};
-            alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-            alloc_info.allocationSize = memory_requirements.size;
-            alloc_info.memoryTypeIndex = find_memory_type(memory_requirements.memoryTypeBits, properties);
-
-            check_vk(vkAllocateMemory(m_device, &alloc_info, nullptr, &buffer.memory), "Failed to allocate buffer memory");
-            check_vk(vkBindBufferMemory(m_device, buffer.buffer, buffer.memory, 0), "Failed to bind buffer memory");
+            buffer.allocation = m_allocator->allocate(memory_requirements, properties, true);
+            check_vk(vkBindBufferMemory(m_device, buffer.buffer, buffer.allocation.memory, buffer.allocation.offset),
+                     "Failed to bind buffer memory");
         }
 
         void destroy_buffer(BufferResource& buffer) const noexcept
         {
             if (buffer.buffer != VK_NULL_HANDLE)
                 vkDestroyBuffer(m_device, buffer.buffer, nullptr);
-            if (buffer.memory != VK_NULL_HANDLE)
-                vkFreeMemory(m_device, buffer.memory, nullptr);
+            if (buffer.allocation.memory != VK_NULL_HANDLE)
+                m_allocator->free(buffer.allocation);
             buffer = {};
         }
 
@@ -3112,48 +6515,16 @@ namespace rose::core::vulkan
             vkFreeCommandBuffers(m_device, m_command_pool, 1, &command_buffer);
         }
 
-        void copy_buffer(VkBuffer src_buffer, VkBuffer dst_buffer, VkDeviceSize size) const
-        {
-            VkCommandBuffer command_buffer = begin_single_time_commands();
-
-            VkBufferCopy copy_region{};
-            copy_region.size = size;
-            vkCmdCopyBuffer(command_buffer, src_buffer, dst_buffer, 1, &copy_region);
-
-            end_single_time_commands(command_buffer);
-        }
-
-        void create_device_buffer(const void* data,
-                                  VkDeviceSize size,
-                                  VkBufferUsageFlags usage,
-                                  BufferResource& out_buffer) const
-        {
-            BufferResource staging_buffer;
-            create_buffer(size,
-                          VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                          staging_buffer);
-
-            void* mapped = nullptr;
-            check_vk(vkMapMemory(m_device, staging_buffer.memory, 0, size, 0, &mapped), "Failed to map staging buffer");
-            std::memcpy(mapped, data, static_cast<std::size_t>(size));
-            vkUnmapMemory(m_device, staging_buffer.memory);
-
-            create_buffer(size,
-                          VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage,
-                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                          out_buffer);
-            copy_buffer(staging_buffer.buffer, out_buffer.buffer, size);
-            destroy_buffer(staging_buffer);
-        }
-
         void create_image(uint32_t width,
                           uint32_t height,
                           VkFormat format,
                           VkImageTiling tiling,
                           VkImageUsageFlags usage,
                           VkMemoryPropertyFlags properties,
-                          ImageResource& image) const
+                          ImageResource& image,
+                          bool upload_target = false,
+                          uint32_t mip_levels = 1,
+                          uint32_t array_layers = 1) const
         {
             image.format = format;
             image.extent = {width, height};
@@ -3165,27 +6536,30 @@ namespace rose::core::vulkan
             image_info.extent.width = width;
             image_info.extent.height = height;
             image_info.extent.depth = 1;
-            image_info.mipLevels = 1;
-            image_info.arrayLayers = 1;
+            image_info.mipLevels = mip_levels;
+            image_info.arrayLayers = array_layers;
             image_info.format = format;
             image_info.tiling = tiling;
             image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
             image_info.usage = usage;
             image_info.samples = VK_SAMPLE_COUNT_1_BIT;
             image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            const std::array<uint32_t, 2> queue_families = upload_queue_families();
+            if (upload_target && m_transfer_queue_family != m_graphics_queue_family)
+            {
+                image_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+                image_info.queueFamilyIndexCount = static_cast<uint32_t>(queue_families.size());
+                image_info.pQueueFamilyIndices = queue_families.data();
+            }
 
             check_vk(vkCreateImage(m_device, &image_info, nullptr, &image.image), "Failed to create image");
 
             VkMemoryRequirements memory_requirements{};
             vkGetImageMemoryRequirements(m_device, image.image, &memory_requirements);
 
-            VkMemoryAllocateInfo alloc_info{};
-            alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-            alloc_info.allocationSize = memory_requirements.size;
-            alloc_info.memoryTypeIndex = find_memory_type(memory_requirements.memoryTypeBits, properties);
-
-            check_vk(vkAllocateMemory(m_device, &alloc_info, nullptr, &image.memory), "Failed to allocate image memory");
-            check_vk(vkBindImageMemory(m_device, image.image, image.memory, 0), "Failed to bind image memory");
+            image.allocation = m_allocator->allocate(memory_requirements, properties, tiling == VK_IMAGE_TILING_LINEAR);
+            check_vk(vkBindImageMemory(m_device, image.image, image.allocation.memory, image.allocation.offset),
+                     "Failed to bind image memory");
         }
 
         void destroy_image(ImageResource& image) const noexcept
@@ -3194,73 +6568,20 @@ namespace rose::core::vulkan
                 vkDestroyImageView(m_device, image.view, nullptr);
             if (image.image != VK_NULL_HANDLE)
                 vkDestroyImage(m_device, image.image, nullptr);
-            if (image.memory != VK_NULL_HANDLE)
-                vkFreeMemory(m_device, image.memory, nullptr);
+            if (image.allocation.memory != VK_NULL_HANDLE)
+                m_allocator->free(image.allocation);
             image = {};
         }
 
-        void transition_image_layout(VkImage image,
-                                     VkFormat,
-                                     VkImageLayout old_layout,
-                                     VkImageLayout new_layout) const
-        {
-            VkCommandBuffer command_buffer = begin_single_time_commands();
-
-            VkImageMemoryBarrier barrier{};
-            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-            barrier.oldLayout = old_layout;
-            barrier.newLayout = new_layout;
-            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            barrier.image = image;
-            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            barrier.subresourceRange.baseMipLevel = 0;
-            barrier.subresourceRange.levelCount = 1;
-            barrier.subresourceRange.baseArrayLayer = 0;
-            barrier.subresourceRange.layerCount = 1;
-
-            VkPipelineStageFlags source_stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-            VkPipelineStageFlags destination_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-
-            if (old_layout == VK_IMAGE_LAYOUT_UNDEFINED && new_layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
-            {
-                barrier.srcAccessMask = 0;
-                barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            }
-            else if (old_layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-                     && new_layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-            {
-                barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-                barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-                source_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-                destination_stage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-            }
-            else
-            {
-                throw VulkanError("Unsupported image layout transition");
-            }
-
-            vkCmdPipelineBarrier(command_buffer,
-                                 source_stage,
-                                 destination_stage,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &barrier);
-
-            end_single_time_commands(command_buffer);
-        }
-
         void record_image_barrier(ImageResource& image,
                                   VkImageAspectFlags aspect_mask,
                                   VkImageLayout new_layout,
                                   VkAccessFlags src_access,
                                   VkAccessFlags dst_access,
                                   VkPipelineStageFlags src_stage,
-                                  VkPipelineStageFlags dst_stage) const
+                                  VkPipelineStageFlags dst_stage,
+                                  uint32_t base_array_layer = 0,
+                                  uint32_t layer_count = VK_REMAINING_ARRAY_LAYERS) const
         {
             VkImageMemoryBarrier barrier{};
             barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -3271,9 +6592,9 @@ namespace rose::core::vulkan
             barrier.image = image.image;
             barrier.subresourceRange.aspectMask = aspect_mask;
             barrier.subresourceRange.baseMipLevel = 0;
-            barrier.subresourceRange.levelCount = 1;
-            barrier.subresourceRange.baseArrayLayer = 0;
-            barrier.subresourceRange.layerCount = 1;
+            barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+            barrier.subresourceRange.baseArrayLayer = base_array_layer;
+            barrier.subresourceRange.layerCount = layer_count;
             barrier.srcAccessMask = src_access;
             barrier.dstAccessMask = dst_access;
             if (image.layout == VK_IMAGE_LAYOUT_UNDEFINED)
@@ -3295,6 +6616,27 @@ namespace rose::core::vulkan
             image.layout = new_layout;
         }
 
+        void record_memory_barrier(VkAccessFlags src_access,
+                                   VkAccessFlags dst_access,
+                                   VkPipelineStageFlags src_stage,
+                                   VkPipelineStageFlags dst_stage) const
+        {
+            VkMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            barrier.srcAccessMask = src_access;
+            barrier.dstAccessMask = dst_access;
+            vkCmdPipelineBarrier(m_active_command_buffer,
+                                 src_stage,
+                                 dst_stage,
+                                 0,
+                                 1,
+                                 &barrier,
+                                 0,
+                                 nullptr,
+                                 0,
+                                 nullptr);
+        }
+
         void record_swapchain_barrier(VkImageLayout old_layout,
                                       VkImageLayout new_layout,
                                       VkAccessFlags src_access,
@@ -3384,27 +6726,87 @@ namespace rose::core::vulkan
                                      VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
         }
 
-        void update_bloom_descriptor(const ImageResource& source)
+        [[nodiscard]] uint32_t bloom_level_count() const noexcept
         {
-            if (m_bloom_descriptor_image_view == source.view)
-                return;
+            return std::min(static_cast<uint32_t>(m_bloom_settings.levels), m_bloom.mip_count);
+        }
+
+        [[nodiscard]] VkExtent2D bloom_level_extent(uint32_t level) const noexcept
+        {
+            return {std::max(1u, m_bloom.image.extent.width >> level), std::max(1u, m_bloom.image.extent.height >> level)};
+        }
 
-            VkDescriptorImageInfo image_info{};
-            image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            image_info.imageView = source.view;
-            image_info.sampler = m_bloom_sampler;
+        void dispatch_bloom_pass(VkDescriptorSet descriptor, const BloomPyramidPushConstants& push)
+        {
+            vkCmdBindDescriptorSets(m_active_command_buffer,
+                                    VK_PIPELINE_BIND_POINT_COMPUTE,
+                                    m_bloom_pyramid_pipeline_layout,
+                                    0,
+                                    1,
+                                    &descriptor,
+                                    0,
+                                    nullptr);
+            vkCmdPushConstants(m_active_command_buffer,
+                               m_bloom_pyramid_pipeline_layout,
+                               VK_SHADER_STAGE_COMPUTE_BIT,
+                               0,
+                               sizeof(BloomPyramidPushConstants),
+                               &push);
+            vkCmdDispatch(m_active_command_buffer,
+                          (static_cast<uint32_t>(push.destination_size[0]) + k_bloom_group_size - 1u) / k_bloom_group_size,
+                          (static_cast<uint32_t>(push.destination_size[1]) + k_bloom_group_size - 1u) / k_bloom_group_size,
+                          1);
+            record_memory_barrier(VK_ACCESS_SHADER_WRITE_BIT,
+                                  VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+        }
+
+        // Every pass filters a fixed 13 or 9 taps per texel of a level, so the cost does not depend
+        // on the radius and all levels together cost about a third more than the first.
+        void record_bloom_pyramid(const ImageResource& source, std::size_t source_index)
+        {
+            // Only the previous frame's composite read the pyramid; its contents are rewritten.
+            record_image_barrier(m_bloom.image,
+                                 VK_IMAGE_ASPECT_COLOR_BIT,
+                                 VK_IMAGE_LAYOUT_GENERAL,
+                                 0,
+                                 VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                                 VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
 
-            VkWriteDescriptorSet descriptor_write{};
-            descriptor_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            descriptor_write.dstSet = m_bloom_descriptor_set;
-            descriptor_write.dstBinding = 0;
-            descriptor_write.dstArrayElement = 0;
-            descriptor_write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            descriptor_write.descriptorCount = 1;
-            descriptor_write.pImageInfo = &image_info;
+            const uint32_t level_count = bloom_level_count();
+            vkCmdBindPipeline(m_active_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_bloom_downsample_pipeline);
+            VkExtent2D source_extent = source.extent;
+            for (uint32_t level = 0; level < level_count; ++level)
+            {
+                const VkExtent2D destination = bloom_level_extent(level);
+                BloomPyramidPushConstants push{};
+                push.source_texel_size[0] = 1.0f / static_cast<float>(source_extent.width);
+                push.source_texel_size[1] = 1.0f / static_cast<float>(source_extent.height);
+                push.destination_size[0] = static_cast<int32_t>(destination.width);
+                push.destination_size[1] = static_cast<int32_t>(destination.height);
+                push.threshold = m_bloom_settings.threshold;
+                push.prefilter = level == 0 ? 1 : 0;
+                dispatch_bloom_pass(level == 0 ? m_bloom.prefilter_descriptors[source_index]
+                                               : m_bloom.downsample_descriptors[level - 1u],
+                                    push);
+                source_extent = destination;
+            }
 
-            vkUpdateDescriptorSets(m_device, 1, &descriptor_write, 0, nullptr);
-            m_bloom_descriptor_image_view = source.view;
+            vkCmdBindPipeline(m_active_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_bloom_upsample_pipeline);
+            for (uint32_t level = level_count - 1u; level-- > 0;)
+            {
+                const VkExtent2D smaller = bloom_level_extent(level + 1u);
+                const VkExtent2D destination = bloom_level_extent(level);
+                BloomPyramidPushConstants push{};
+                push.source_texel_size[0] = 1.0f / static_cast<float>(smaller.width);
+                push.source_texel_size[1] = 1.0f / static_cast<float>(smaller.height);
+                push.destination_size[0] = static_cast<int32_t>(destination.width);
+                push.destination_size[1] = static_cast<int32_t>(destination.height);
+                push.radius = m_bloom_settings.radius;
+                dispatch_bloom_pass(m_bloom.upsample_descriptors[level], push);
+            }
         }
 
         void render_bloom_to_swapchain(ImageResource& source)
@@ -3419,7 +6821,10 @@ namespace rose::core::vulkan
                                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
                                      | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
                                      | VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                 VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+            const std::size_t source_index = &source == &m_dlss_output_image ? 1u : 0u;
+            record_bloom_pyramid(source, source_index);
 
             record_swapchain_barrier(VK_IMAGE_LAYOUT_UNDEFINED,
                                      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
@@ -3448,7 +6853,6 @@ namespace rose::core::vulkan
                                      VK_PIPELINE_STAGE_TRANSFER_BIT,
                                      VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
 
-            update_bloom_descriptor(source);
             begin_present_render_pass();
 
             VkViewport viewport{};
@@ -3463,13 +6867,14 @@ namespace rose::core::vulkan
             const VkRect2D scissor{{0, 0}, m_swapchain_extent};
             vkCmdSetScissor(m_active_command_buffer, 0, 1, &scissor);
 
+            // Every level adds its share to level 0, so the intensity is split between them and
+            // the level count changes the reach rather than the brightness.
+            const VkExtent2D bloom_extent = bloom_level_extent(0);
             BloomPushConstants push{};
-            push.texel_size[0] = 1.0f / static_cast<float>(source.extent.width);
-            push.texel_size[1] = 1.0f / static_cast<float>(source.extent.height);
-            push.threshold = m_bloom_settings.threshold;
-            push.intensity = m_bloom_settings.intensity;
+            push.bloom_texel_size[0] = 1.0f / static_cast<float>(bloom_extent.width);
+            push.bloom_texel_size[1] = 1.0f / static_cast<float>(bloom_extent.height);
+            push.intensity = m_bloom_settings.intensity / static_cast<float>(bloom_level_count());
             push.radius = m_bloom_settings.radius;
-            push.quality = m_bloom_settings.quality;
 
             vkCmdBindPipeline(m_active_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_bloom_pipeline);
             vkCmdBindDescriptorSets(m_active_command_buffer,
@@ -3477,7 +6882,7 @@ namespace rose::core::vulkan
                                     m_bloom_pipeline_layout,
                                     0,
                                     1,
-                                    &m_bloom_descriptor_set,
+                                    &m_bloom.composite_descriptors[source_index],
                                     0,
                                     nullptr);
             vkCmdPushConstants(m_active_command_buffer,
@@ -3615,164 +7020,460 @@ namespace rose::core::vulkan
             m_present_render_pass_active = true;
         }
 
-        void finish_scene_rendering()
+        // Draws the selection mask, floods it and blends the glow into the scene color, which is
+        // still the color attachment it was in the scene pass.
+        void record_selection_outline(const RecordingPass& mask_pass)
         {
-            if (m_shadow_render_pass_active)
+            const std::array<VkClearValue, 3> clear_values{
+                VkClearValue{.color = {.uint32 = {0xffffffffu, 0u, 0u, 0u}}},
+                VkClearValue{.color = {{0.0f, 0.0f, 0.0f, 0.0f}}},
+                VkClearValue{.depthStencil = {1.0f, 0}},
+            };
+
+            VkRenderPassBeginInfo mask_pass_info{};
+            mask_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+            mask_pass_info.renderPass = mask_pass.render_pass;
+            mask_pass_info.framebuffer = mask_pass.framebuffer;
+            mask_pass_info.renderArea.offset = {0, 0};
+            mask_pass_info.renderArea.extent = mask_pass.extent;
+            mask_pass_info.clearValueCount = static_cast<uint32_t>(clear_values.size());
+            mask_pass_info.pClearValues = clear_values.data();
+            vkCmdBeginRenderPass(m_active_command_buffer, &mask_pass_info, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+            execute_recording_pass(mask_pass);
+            vkCmdEndRenderPass(m_active_command_buffer);
+            m_selection.seeds[0].layout = VK_IMAGE_LAYOUT_GENERAL;
+            m_selection.seed_data.layout = VK_IMAGE_LAYOUT_GENERAL;
+            if (m_selection.seeds[1].layout != VK_IMAGE_LAYOUT_GENERAL)
+                record_image_barrier(m_selection.seeds[1],
+                                     VK_IMAGE_ASPECT_COLOR_BIT,
+                                     VK_IMAGE_LAYOUT_GENERAL,
+                                     0,
+                                     VK_ACCESS_SHADER_WRITE_BIT,
+                                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+            SelectionPushConstants push{};
+            push.size[0] = static_cast<int32_t>(m_scene_extent.width);
+            push.size[1] = static_cast<int32_t>(m_scene_extent.height);
+            std::size_t source = 0;
+            vkCmdBindPipeline(m_active_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_selection_jump_flood_pipeline);
+            for (uint32_t step = std::bit_floor(static_cast<uint32_t>(std::ceil(m_selection_width_pixels))); step > 0;
+                 step /= 2u)
             {
-                vkCmdEndRenderPass(m_active_command_buffer);
-                m_shadow_render_pass_active = false;
-                m_shadow_image.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+                push.step = static_cast<int32_t>(step);
+                vkCmdBindDescriptorSets(m_active_command_buffer,
+                                        VK_PIPELINE_BIND_POINT_COMPUTE,
+                                        m_selection_pipeline_layout,
+                                        0,
+                                        1,
+                                        &m_selection.jump_descriptors[source],
+                                        0,
+                                        nullptr);
+                vkCmdPushConstants(m_active_command_buffer,
+                                   m_selection_pipeline_layout,
+                                   VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                                   0,
+                                   sizeof(SelectionPushConstants),
+                                   &push);
+                vkCmdDispatch(m_active_command_buffer,
+                              (m_scene_extent.width + k_selection_group_size - 1u) / k_selection_group_size,
+                              (m_scene_extent.height + k_selection_group_size - 1u) / k_selection_group_size,
+                              1);
+                record_memory_barrier(VK_ACCESS_SHADER_WRITE_BIT,
+                                      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+                source ^= 1u;
+            }
 
-                begin_shadow_render_pass(ShadowPassKind::Sun);
-                for (const QueuedDrawCall& draw_call : m_queued_draw_calls)
-                {
-                    if (draw_call.mesh == nullptr || draw_call.outline_enabled)
-                        continue;
+            VkRenderPassBeginInfo composite_pass_info{};
+            composite_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+            composite_pass_info.renderPass = m_selection_outline_render_pass;
+            composite_pass_info.framebuffer = m_selection.composite_framebuffer;
+            composite_pass_info.renderArea.offset = {0, 0};
+            composite_pass_info.renderArea.extent = m_scene_extent;
+            vkCmdBeginRenderPass(m_active_command_buffer, &composite_pass_info, VK_SUBPASS_CONTENTS_INLINE);
 
-                    GpuMesh& gpu_mesh = ensure_mesh_resource(*draw_call.mesh);
-                    if (gpu_mesh.index_count == 0)
-                        continue;
+            VkViewport viewport{};
+            viewport.width = static_cast<float>(m_scene_extent.width);
+            viewport.height = static_cast<float>(m_scene_extent.height);
+            viewport.minDepth = 0.0f;
+            viewport.maxDepth = 1.0f;
+            vkCmdSetViewport(m_active_command_buffer, 0, 1, &viewport);
+            const VkRect2D scissor{{0, 0}, m_scene_extent};
+            vkCmdSetScissor(m_active_command_buffer, 0, 1, &scissor);
 
-                    draw_shadow_mesh(*draw_call.mesh, gpu_mesh);
-                }
-                vkCmdEndRenderPass(m_active_command_buffer);
-                m_shadow_render_pass_active = false;
-                m_sun_shadow_image.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+            // A higher smoothing quality fades the glow over more of its width.
+            const int quality = std::clamp(m_selection_outline_settings.smoothing_quality, 1, 64);
+            std::copy(m_selection_outline_settings.color.begin(), m_selection_outline_settings.color.end(), push.color);
+            push.softness = 1.0f - 1.0f / static_cast<float>(quality);
+            vkCmdBindPipeline(m_active_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_selection_outline_pipeline);
+            vkCmdBindDescriptorSets(m_active_command_buffer,
+                                    VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                    m_selection_pipeline_layout,
+                                    0,
+                                    1,
+                                    &m_selection.composite_descriptors[source],
+                                    0,
+                                    nullptr);
+            vkCmdPushConstants(m_active_command_buffer,
+                               m_selection_pipeline_layout,
+                               VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                               0,
+                               sizeof(SelectionPushConstants),
+                               &push);
+            vkCmdDraw(m_active_command_buffer, 3, 1, 0, 0);
+            vkCmdEndRenderPass(m_active_command_buffer);
+        }
 
-                begin_scene_render_pass();
-                for (const QueuedDrawCall& draw_call : m_queued_draw_calls)
-                {
-                    if (draw_call.mesh == nullptr || draw_call.camera == nullptr)
-                        continue;
+        // Draws the pick pass and copies its id to the frame's readback buffer.
+        void record_pick(const RecordingPass& pick_pass)
+        {
+            const std::array<VkClearValue, 2> clear_values{
+                VkClearValue{.color = {.uint32 = {0u, 0u, 0u, 0u}}},
+                VkClearValue{.depthStencil = {1.0f, 0}},
+            };
 
-                    GpuMesh& gpu_mesh = ensure_mesh_resource(*draw_call.mesh);
-                    if (gpu_mesh.index_count == 0)
-                        continue;
+            VkRenderPassBeginInfo pick_pass_info{};
+            pick_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+            pick_pass_info.renderPass = pick_pass.render_pass;
+            pick_pass_info.framebuffer = pick_pass.framebuffer;
+            pick_pass_info.renderArea.offset = {0, 0};
+            pick_pass_info.renderArea.extent = pick_pass.extent;
+            pick_pass_info.clearValueCount = static_cast<uint32_t>(clear_values.size());
+            pick_pass_info.pClearValues = clear_values.data();
+            vkCmdBeginRenderPass(m_active_command_buffer, &pick_pass_info, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+            execute_recording_pass(pick_pass);
+            vkCmdEndRenderPass(m_active_command_buffer);
 
-                    draw_scene_mesh_with_pipeline(*draw_call.mesh,
-                                                  *draw_call.camera,
-                                                  gpu_mesh,
-                                                  draw_call.pipeline,
-                                                  draw_call.outline_color,
-                                                  draw_call.outline_width,
-                                                  draw_call.outline_alpha,
-                                                  draw_call.outline_enabled);
-                }
-                m_queued_draw_calls.clear();
+            VkBufferImageCopy copy_region{};
+            copy_region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            copy_region.imageSubresource.layerCount = 1;
+            copy_region.imageExtent = {1, 1, 1};
+            vkCmdCopyImageToBuffer(m_active_command_buffer,
+                                   m_pick.ids.image,
+                                   VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                   m_pick_slots[m_current_frame].readback.buffer.buffer,
+                                   1,
+                                   &copy_region);
+            record_memory_barrier(VK_ACCESS_TRANSFER_WRITE_BIT,
+                                  VK_ACCESS_HOST_READ_BIT,
+                                  VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                  VK_PIPELINE_STAGE_HOST_BIT);
+            m_pick_recorded = true;
+        }
+
+        void finish_scene_rendering()
+        {
+            if (m_collecting_draws)
+            {
+                m_collecting_draws = false;
+                record_queued_draws();
             }
 
             if (!m_scene_render_pass_active)
                 return;
 
             vkCmdEndRenderPass(m_active_command_buffer);
+            m_gpu_profiler->end_statistics(m_active_command_buffer);
+            end_gpu_pass(GpuPass::Scene);
             m_scene_render_pass_active = false;
             m_scene_color_image.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
             m_motion_vector_image.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
             m_depth_image.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+            if (const std::optional<std::size_t> selection_pass = std::exchange(m_selection_pass, std::nullopt))
+            {
+                begin_gpu_pass(GpuPass::Outline);
+                record_selection_outline(m_recording_passes[*selection_pass]);
+                end_gpu_pass(GpuPass::Outline);
+            }
+            if (const std::optional<std::size_t> pick_pass = std::exchange(m_pick_pass, std::nullopt))
+                record_pick(m_recording_passes[*pick_pass]);
+            if (gpu_culling_active() && m_occlusion_culling_enabled && m_frame_view_projection_set)
+            {
+                begin_gpu_pass(GpuPass::HiZ);
+                record_hiz_build();
+                end_gpu_pass(GpuPass::HiZ);
+            }
+            else
+                m_hiz.valid = false;
 
             ImageResource* resolved_source = &m_scene_color_image;
+            begin_gpu_pass(GpuPass::Dlss);
             if (evaluate_dlss())
                 resolved_source = &m_dlss_output_image;
+            end_gpu_pass(GpuPass::Dlss);
             if (m_bloom_settings.enabled)
+            {
+                begin_gpu_pass(GpuPass::Bloom);
                 render_bloom_to_swapchain(*resolved_source);
+                end_gpu_pass(GpuPass::Bloom);
+                begin_gpu_pass(GpuPass::Present);
+            }
             else
             {
+                begin_gpu_pass(GpuPass::Present);
                 blit_to_swapchain(*resolved_source);
                 begin_present_render_pass();
             }
         }
 
-        void copy_buffer_to_image(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height) const
+        void begin_gpu_pass(GpuPass pass) const
         {
-            VkCommandBuffer command_buffer = begin_single_time_commands();
+            m_gpu_profiler->begin_scope(m_active_command_buffer, static_cast<uint32_t>(pass));
+        }
 
-            VkBufferImageCopy region{};
-            region.bufferOffset = 0;
-            region.bufferRowLength = 0;
-            region.bufferImageHeight = 0;
-            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            region.imageSubresource.mipLevel = 0;
-            region.imageSubresource.baseArrayLayer = 0;
-            region.imageSubresource.layerCount = 1;
-            region.imageOffset = {0, 0, 0};
-            region.imageExtent = {width, height, 1};
-
-            vkCmdCopyBufferToImage(command_buffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-            end_single_time_commands(command_buffer);
+        void end_gpu_pass(GpuPass pass) const
+        {
+            m_gpu_profiler->end_scope(m_active_command_buffer, static_cast<uint32_t>(pass));
+        }
+
+        [[nodiscard]] GpuProfile gpu_profile() const
+        {
+            GpuProfile profile;
+            profile.timestamps_supported = m_gpu_profiler->timestamps_supported();
+            profile.pipeline_statistics_supported = m_gpu_profiler->pipeline_statistics_supported();
+            for (const GpuProfiler::Frame& frame : m_gpu_profiler->history())
+            {
+                profile.frame_ms.push_back(static_cast<float>(frame.frame_ms));
+                for (std::size_t pass = 0; pass < k_gpu_pass_count; ++pass)
+                    profile.pass_ms[pass].push_back(static_cast<float>(frame.scope_ms[pass]));
+            }
+            profile.frame_percentiles = timing_percentiles(profile.frame_ms);
+            for (std::size_t pass = 0; pass < k_gpu_pass_count; ++pass)
+                profile.pass_percentiles[pass] = timing_percentiles(profile.pass_ms[pass]);
+
+            if (!m_gpu_profiler->history().empty() && m_gpu_profiler->history().back().statistics)
+            {
+                const auto& counters = *m_gpu_profiler->history().back().statistics;
+                GpuPipelineStatistics& statistics = profile.statistics.emplace();
+                statistics.input_assembly_vertices = counters[0];
+                statistics.input_assembly_primitives = counters[1];
+                statistics.vertex_shader_invocations = counters[2];
+                statistics.clipping_primitives = counters[3];
+                statistics.fragment_shader_invocations = counters[4];
+                statistics.compute_shader_invocations = counters[5];
+            }
+            return profile;
+        }
+
+        [[nodiscard]] static VkFormat texture_vk_format(TextureFormat format) noexcept
+        {
+            switch (format)
+            {
+            case TextureFormat::Bc1:
+                return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+            case TextureFormat::Bc3:
+                return VK_FORMAT_BC3_UNORM_BLOCK;
+            case TextureFormat::Bc5:
+                return VK_FORMAT_BC5_UNORM_BLOCK;
+            case TextureFormat::Bc7:
+                return VK_FORMAT_BC7_UNORM_BLOCK;
+            case TextureFormat::Rgba8:
+                break;
+            }
+            return VK_FORMAT_R8G8B8A8_UNORM;
+        }
+
+        [[nodiscard]] static uint32_t texture_level_count(const Texture& texture) noexcept
+        {
+            if (!texture.mips().empty())
+                return static_cast<uint32_t>(texture.mips().size());
+            return mip_level_count(static_cast<uint32_t>(texture.width()), static_cast<uint32_t>(texture.height()));
+        }
+
+        [[nodiscard]] static std::vector<uint64_t> texture_level_bytes(const Texture& texture)
+        {
+            std::vector<uint64_t> bytes;
+            if (!texture.mips().empty())
+            {
+                for (const TextureMip& mip : texture.mips())
+                    bytes.push_back(mip.size);
+                return bytes;
+            }
+            auto width = static_cast<uint64_t>(texture.width());
+            auto height = static_cast<uint64_t>(texture.height());
+            for (uint32_t level = 0; level < texture_level_count(texture); ++level)
+            {
+                bytes.push_back(width * height * 4u);
+                width = std::max<uint64_t>(width / 2u, 1u);
+                height = std::max<uint64_t>(height / 2u, 1u);
+            }
+            return bytes;
         }
 
-        [[nodiscard]] std::vector<unsigned char> texture_pixels_rgba(const Texture& texture) const
+        // First mip that fits k_streaming_tail_extent; 0 means the texture is too small to stream.
+        [[nodiscard]] static uint32_t streaming_tail_level(const Texture& texture) noexcept
         {
-            std::vector<unsigned char> rgba(static_cast<std::size_t>(texture.width())
-                                           * static_cast<std::size_t>(texture.height())
-                                           * 4u);
-            const std::vector<unsigned char>& src = texture.pixels();
-            const int components = texture.components();
-
-            for (int y = 0; y < texture.height(); ++y)
+            const uint32_t level_count = texture_level_count(texture);
+            auto extent = static_cast<uint32_t>(std::max(texture.width(), texture.height()));
+            uint32_t level = 0;
+            while (extent > k_streaming_tail_extent && level + 1u < level_count)
             {
-                for (int x = 0; x < texture.width(); ++x)
-                {
-                    const auto src_index = static_cast<std::size_t>(y * texture.width() + x)
-                                         * static_cast<std::size_t>(components);
-                    const auto dst_index = static_cast<std::size_t>(y * texture.width() + x) * 4u;
-
-                    const unsigned char r = components >= 1 ? src[src_index] : 255u;
-                    const unsigned char g = components >= 2 ? src[src_index + 1u] : r;
-                    const unsigned char b = components >= 3 ? src[src_index + 2u] : r;
-                    const unsigned char a = components >= 4 ? src[src_index + 3u] : 255u;
-                    rgba[dst_index] = r;
-                    rgba[dst_index + 1u] = g;
-                    rgba[dst_index + 2u] = b;
-                    rgba[dst_index + 3u] = a;
-                }
+                extent = std::max(extent / 2u, 1u);
+                ++level;
             }
-
-            return rgba;
+            return level;
         }
 
-        GpuTexture create_texture_resource(const Texture& texture)
+        // Creates an image for mips base_level.. of a texture and uploads `levels`, which holds
+        // exactly those mips.
+        [[nodiscard]] GpuTexture upload_texture_levels(const Texture& levels, uint32_t base_level)
         {
-            const std::vector<unsigned char> pixels = texture_pixels_rgba(texture);
-            const uint32_t width = static_cast<uint32_t>(texture.width());
-            const uint32_t height = static_cast<uint32_t>(texture.height());
-            const VkDeviceSize image_size = static_cast<VkDeviceSize>(pixels.size());
+            const VkFormat format = texture_vk_format(levels.format());
+            std::vector<ImageUploadLevel> upload_levels;
+            upload_levels.reserve(levels.mips().size());
+            for (const TextureMip& mip : levels.mips())
+                upload_levels.push_back({mip.width, mip.height, static_cast<VkDeviceSize>(mip.offset)});
 
-            BufferResource staging_buffer;
-            create_buffer(image_size,
-                          VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                          staging_buffer);
+            GpuTexture gpu_texture;
+            gpu_texture.mip_levels = static_cast<uint32_t>(upload_levels.size());
+            gpu_texture.base_level = base_level;
+            gpu_texture.two_channel = levels.format() == TextureFormat::Bc5;
+            create_image(static_cast<uint32_t>(levels.width()),
+                         static_cast<uint32_t>(levels.height()),
+                         format,
+                         VK_IMAGE_TILING_OPTIMAL,
+                         VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                         gpu_texture.image,
+                         true,
+                         gpu_texture.mip_levels);
+            gpu_texture.ready_ticket = m_uploads->upload_image(gpu_texture.image.image,
+                                                               upload_levels,
+                                                               levels.pixels().data(),
+                                                               static_cast<VkDeviceSize>(levels.pixels().size()));
+            gpu_texture.image.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            gpu_texture.image.view = create_image_view(gpu_texture.image.image,
+                                                       format,
+                                                       VK_IMAGE_ASPECT_COLOR_BIT,
+                                                       0,
+                                                       gpu_texture.mip_levels);
+            return gpu_texture;
+        }
 
-            void* mapped = nullptr;
-            check_vk(vkMapMemory(m_device, staging_buffer.memory, 0, image_size, 0, &mapped),
-                     "Failed to map texture staging buffer");
-            std::memcpy(mapped, pixels.data(), pixels.size());
-            vkUnmapMemory(m_device, staging_buffer.memory);
+        // Decoded pixels get their mip chain filtered here and are expanded to RGBA8 straight into
+        // staging memory.
+        [[nodiscard]] GpuTexture upload_decoded_texture(const Texture& texture, TextureType type)
+        {
+            const PreparedMipChain chain = prepare_mip_chain(texture, type);
+            std::vector<ImageUploadLevel> levels;
+            levels.reserve(chain.mips.size());
+            for (const TextureMip& mip : chain.mips)
+                levels.push_back({mip.width, mip.height, static_cast<VkDeviceSize>(mip.offset)});
 
             GpuTexture gpu_texture;
-            create_image(width,
-                         height,
+            gpu_texture.mip_levels = static_cast<uint32_t>(levels.size());
+            create_image(static_cast<uint32_t>(texture.width()),
+                         static_cast<uint32_t>(texture.height()),
                          VK_FORMAT_R8G8B8A8_UNORM,
                          VK_IMAGE_TILING_OPTIMAL,
                          VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                         gpu_texture.image);
-
-            transition_image_layout(gpu_texture.image.image,
-                                    VK_FORMAT_R8G8B8A8_UNORM,
-                                    VK_IMAGE_LAYOUT_UNDEFINED,
-                                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-            copy_buffer_to_image(staging_buffer.buffer, gpu_texture.image.image, width, height);
-            transition_image_layout(gpu_texture.image.image,
-                                    VK_FORMAT_R8G8B8A8_UNORM,
-                                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-            destroy_buffer(staging_buffer);
-
+                         gpu_texture.image,
+                         true,
+                         gpu_texture.mip_levels);
+            gpu_texture.ready_ticket = m_uploads->upload_image(gpu_texture.image.image,
+                                                               levels,
+                                                               static_cast<VkDeviceSize>(chain.size),
+                                                               [&texture, &chain](void* staging)
+                                                               {
+                                                                   write_mip_chain(texture,
+                                                                                   chain,
+                                                                                   static_cast<unsigned char*>(staging));
+                                                               });
+            gpu_texture.image.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
             gpu_texture.image.view = create_image_view(gpu_texture.image.image,
                                                        VK_FORMAT_R8G8B8A8_UNORM,
-                                                       VK_IMAGE_ASPECT_COLOR_BIT);
+                                                       VK_IMAGE_ASPECT_COLOR_BIT,
+                                                       0,
+                                                       gpu_texture.mip_levels);
+            return gpu_texture;
+        }
+
+        // Writes decoded pixels to the texture cache as a full RGBA8 mip chain, or reuses the
+        // copy an earlier run cooked. Returns the chain when it was built here, so the caller can
+        // upload from memory instead of reading the file back.
+        [[nodiscard]] std::optional<Texture> cook_texture(Texture& texture, TextureType type) const
+        {
+            const std::filesystem::path path = m_texture_cache_directory / texture_cache_name(texture, type);
+            std::error_code ec;
+            if (std::filesystem::is_regular_file(path, ec))
+            {
+                texture.set_cooked_path(path);
+                return std::nullopt;
+            }
+
+            const PreparedMipChain chain = prepare_mip_chain(texture, type);
+            std::vector<unsigned char> texels(chain.size);
+            write_mip_chain(texture, chain, texels.data());
+            Texture cooked{TextureFormat::Rgba8, chain.mips, std::move(texels)};
+
+            // Written under a per-thread name and renamed, so readers never see a partial file.
+            std::filesystem::path staging_path = path;
+            staging_path += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+            write_ktx2(staging_path, cooked);
+            std::filesystem::rename(staging_path, path, ec);
+            if (ec)
+            {
+                std::filesystem::remove(staging_path, ec);
+                if (!std::filesystem::is_regular_file(path, ec))
+                    throw std::runtime_error("Failed to store cooked texture " + path.string());
+            }
+            texture.set_cooked_path(path);
+            cooked.set_cooked_path(path);
+            return cooked;
+        }
+
+        // Runs on residency workers. Large textures stream: only their mip tail is uploaded here,
+        // finer mips are read back from the cooked KTX2 on demand and the CPU copy is released.
+        // Textures that cannot be cooked are uploaded whole.
+        GpuTexture create_texture_resource(Texture& texture, TextureType type)
+        {
+            const uint32_t tail_level = streaming_tail_level(texture);
+            const bool has_pixels = !texture.pixels().empty();
+            const bool cookable = texture.mips().empty() ? !m_texture_cache_directory.empty()
+                                                         : !texture.cooked_path().empty();
+            if (tail_level > 0 && (has_pixels ? cookable : !texture.cooked_path().empty()))
+            {
+                try
+                {
+                    std::optional<Texture> cooked;
+                    // Decoded pixels are cooked even when they came from a KTX2 file, which
+                    // then had no mips of its own.
+                    if (has_pixels && texture.mips().empty())
+                        cooked = cook_texture(texture, type);
+
+                    const Texture tail = cooked ? mip_tail(*cooked, tail_level)
+                                       : has_pixels && !texture.mips().empty() ? mip_tail(texture, tail_level)
+                                       : load_ktx2(texture.cooked_path(), tail_level);
+                    GpuTexture gpu_texture = upload_texture_levels(tail, tail_level);
+                    gpu_texture.streamed_source = &texture;
+                    texture.release_pixels();
+                    return gpu_texture;
+                }
+                catch (const std::runtime_error& error)
+                {
+                    if (!has_pixels)
+                        throw;
+                    spdlog::warn("Vulkan: streaming disabled for a texture: {}", error.what());
+                }
+            }
+
+            if (!has_pixels)
+            {
+                const Texture levels = load_ktx2(texture.cooked_path());
+                return levels.mips().empty() ? upload_decoded_texture(levels, type) : upload_texture_levels(levels, 0);
+            }
+            return texture.mips().empty() ? upload_decoded_texture(texture, type) : upload_texture_levels(texture, 0);
+        }
+
+        void create_texture_sampler()
+        {
+            // m_max_sampler_anisotropy is 1 when the device lacks samplerAnisotropy.
+            m_texture_settings.max_anisotropy = std::clamp(m_texture_settings.max_anisotropy,
+                                                           1.0f,
+                                                           m_max_sampler_anisotropy);
 
             VkSamplerCreateInfo sampler_info{};
             sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
@@ -3781,41 +7482,57 @@ namespace rose::core::vulkan
             sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
             sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
             sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-            sampler_info.anisotropyEnable = VK_FALSE;
+            sampler_info.anisotropyEnable = m_texture_settings.max_anisotropy > 1.0f ? VK_TRUE : VK_FALSE;
+            sampler_info.maxAnisotropy = m_texture_settings.max_anisotropy;
             sampler_info.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
             sampler_info.unnormalizedCoordinates = VK_FALSE;
             sampler_info.compareEnable = VK_FALSE;
             sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-
-            check_vk(vkCreateSampler(m_device, &sampler_info, nullptr, &gpu_texture.sampler), "Failed to create texture sampler");
-            return gpu_texture;
+            sampler_info.mipLodBias = m_texture_settings.lod_bias;
+            sampler_info.minLod = 0.0f;
+            sampler_info.maxLod = m_texture_settings.mipmaps ? VK_LOD_CLAMP_NONE : 0.0f;
+
+            check_vk(vkCreateSampler(m_device, &sampler_info, nullptr, &m_texture_sampler),
+                     "Failed to create texture sampler");
+            spdlog::info("Vulkan: texture sampler anisotropy={} lod_bias={} mipmaps={}",
+                         m_texture_settings.max_anisotropy,
+                         m_texture_settings.lod_bias,
+                         m_texture_settings.mipmaps);
         }
 
-        [[nodiscard]] VkDescriptorSet allocate_material_descriptor(const Mesh& mesh, const BufferResource& material_buffer)
+        void set_texture_settings(const TextureSettings& settings)
         {
-            VkDescriptorSetAllocateInfo alloc_info{};
-            alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-            alloc_info.descriptorPool = m_descriptor_pool;
-            alloc_info.descriptorSetCount = 1;
-            alloc_info.pSetLayouts = &m_descriptor_set_layout;
-
-            VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
-            check_vk(vkAllocateDescriptorSets(m_device, &alloc_info, &descriptor_set), "Failed to allocate material descriptor set");
+            TextureSettings clamped = settings;
+            clamped.max_anisotropy = std::clamp(clamped.max_anisotropy, 1.0f, m_max_sampler_anisotropy);
+            clamped.lod_bias = std::clamp(clamped.lod_bias, -4.0f, 4.0f);
+            if (clamped.max_anisotropy == m_texture_settings.max_anisotropy
+                && clamped.lod_bias == m_texture_settings.lod_bias
+                && clamped.mipmaps == m_texture_settings.mipmaps)
+                return;
 
-            const std::array<GpuTexture*, 4> textures{
-                &texture_for_mesh_or_default(mesh, TextureType::BaseColor),
-                &texture_for_mesh_or_default(mesh, TextureType::Normal),
-                &texture_for_mesh_or_default(mesh, TextureType::MetallicRoughness),
-                &texture_for_mesh_or_default(mesh, TextureType::Emissive)
-            };
+            // Material descriptor sets reference the sampler, so they are rewritten while no frame
+            // uses them and no residency worker allocates new ones.
+            check_vk(vkDeviceWaitIdle(m_device), "Failed to wait for device before recreating texture sampler");
+            std::lock_guard lock(m_resource_mutex);
+            m_texture_settings = clamped;
+            vkDestroySampler(m_device, m_texture_sampler, nullptr);
+            m_texture_sampler = VK_NULL_HANDLE;
+            create_texture_sampler();
+            for (const auto& [key, material] : m_materials)
+                write_material_textures(material.descriptor, key.textures);
+        }
 
+        // Caller holds m_resource_mutex.
+        void write_material_textures(VkDescriptorSet descriptor_set,
+                                     const std::array<const GpuTexture*, 4>& textures) const
+        {
             std::array<VkDescriptorImageInfo, 4> image_infos{};
-            std::array<VkWriteDescriptorSet, 5> descriptor_writes{};
+            std::array<VkWriteDescriptorSet, 4> descriptor_writes{};
             for (uint32_t binding = 0; binding < image_infos.size(); ++binding)
             {
                 image_infos[binding].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
                 image_infos[binding].imageView = textures[binding]->image.view;
-                image_infos[binding].sampler = textures[binding]->sampler;
+                image_infos[binding].sampler = m_texture_sampler;
 
                 descriptor_writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
                 descriptor_writes[binding].dstSet = descriptor_set;
@@ -3826,165 +7543,702 @@ namespace rose::core::vulkan
                 descriptor_writes[binding].pImageInfo = &image_infos[binding];
             }
 
+            vkUpdateDescriptorSets(m_device,
+                                   static_cast<uint32_t>(descriptor_writes.size()),
+                                   descriptor_writes.data(),
+                                   0,
+                                   nullptr);
+        }
+
+        // Caller holds m_resource_mutex.
+        [[nodiscard]] VkDescriptorSet allocate_material_descriptor(const std::array<const GpuTexture*, 4>& textures,
+                                                                   const BufferResource& material_buffer)
+        {
+            VkDescriptorSetAllocateInfo alloc_info{};
+            alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            alloc_info.descriptorPool = m_material_descriptor_pool;
+            alloc_info.descriptorSetCount = 1;
+            alloc_info.pSetLayouts = &m_descriptor_set_layout;
+
+            VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+            check_vk(vkAllocateDescriptorSets(m_device, &alloc_info, &descriptor_set),
+                     "Failed to allocate material descriptor set");
+            write_material_textures(descriptor_set, textures);
+
             VkDescriptorBufferInfo material_buffer_info{};
             material_buffer_info.buffer = material_buffer.buffer;
             material_buffer_info.offset = 0;
             material_buffer_info.range = sizeof(MaterialUniform);
 
-            descriptor_writes[4].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            descriptor_writes[4].dstSet = descriptor_set;
-            descriptor_writes[4].dstBinding = 4;
-            descriptor_writes[4].dstArrayElement = 0;
-            descriptor_writes[4].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            descriptor_writes[4].descriptorCount = 1;
-            descriptor_writes[4].pBufferInfo = &material_buffer_info;
+            VkWriteDescriptorSet material_write{};
+            material_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            material_write.dstSet = descriptor_set;
+            material_write.dstBinding = 4;
+            material_write.dstArrayElement = 0;
+            material_write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            material_write.descriptorCount = 1;
+            material_write.pBufferInfo = &material_buffer_info;
 
-            vkUpdateDescriptorSets(m_device,
-                                   static_cast<uint32_t>(descriptor_writes.size()),
-                                   descriptor_writes.data(),
-                                   0,
-                                   nullptr);
+            vkUpdateDescriptorSets(m_device, 1, &material_write, 0, nullptr);
             return descriptor_set;
         }
 
-        [[nodiscard]] GpuTexture& default_texture(GpuTexture& gpu_texture,
-                                                  bool& created,
-                                                  const std::array<unsigned char, 4>& pixel)
+        [[nodiscard]] GpuTexture& default_texture(GpuTexture& gpu_texture,
+                                                  bool& created,
+                                                  const std::array<unsigned char, 4>& pixel)
+        {
+            if (!created)
+            {
+                Texture texture{1, 1, 4, pixel.data()};
+                gpu_texture = create_texture_resource(texture, TextureType::BaseColor);
+                created = true;
+            }
+            return gpu_texture;
+        }
+
+        // Created once on the frame thread so residency workers only ever read them.
+        void create_default_textures()
+        {
+            for (const TextureType type : {TextureType::BaseColor, TextureType::Normal, TextureType::Emissive})
+                static_cast<void>(default_texture_for(type));
+        }
+
+        [[nodiscard]] GpuTexture& default_texture_for(TextureType type)
+        {
+            switch (type)
+            {
+            case TextureType::Normal:
+            {
+                constexpr std::array<unsigned char, 4> normal{128u, 128u, 255u, 255u};
+                return default_texture(m_default_normal_texture, m_default_normal_texture_created, normal);
+            }
+            case TextureType::Emissive:
+            {
+                constexpr std::array<unsigned char, 4> black{0u, 0u, 0u, 255u};
+                return default_texture(m_default_emissive_texture, m_default_emissive_texture_created, black);
+            }
+            case TextureType::BaseColor:
+            case TextureType::MetallicRoughness:
+            {
+                constexpr std::array<unsigned char, 4> white{255u, 255u, 255u, 255u};
+                return default_texture(m_default_texture, m_default_texture_created, white);
+            }
+            }
+
+            constexpr std::array<unsigned char, 4> white{255u, 255u, 255u, 255u};
+            return default_texture(m_default_texture, m_default_texture_created, white);
+        }
+
+        // Safe to call from several residency workers: the first one to claim a texture builds it
+        // outside the lock, the others wait for it instead of uploading it twice.
+        [[nodiscard]] GpuTexture& texture_resource(Texture& texture, TextureType type)
+        {
+            const Texture* key = &texture;
+            std::unique_lock lock(m_resource_mutex);
+            for (;;)
+            {
+                const auto it = m_texture_resources.find(key);
+                if (it != m_texture_resources.end())
+                    return it->second;
+                if (m_textures_in_progress.insert(key).second)
+                    break;
+                m_resource_condition.wait(lock);
+            }
+            lock.unlock();
+
+            GpuTexture gpu_texture;
+            try
+            {
+                gpu_texture = create_texture_resource(texture, type);
+            }
+            catch (...)
+            {
+                lock.lock();
+                m_textures_in_progress.erase(key);
+                m_resource_condition.notify_all();
+                throw;
+            }
+
+            lock.lock();
+            m_textures_in_progress.erase(key);
+            auto [inserted_it, _] = m_texture_resources.emplace(key, gpu_texture);
+            if (gpu_texture.streamed_source != nullptr)
+                m_texture_streamer.add(key, texture_level_bytes(texture), gpu_texture.base_level);
+            m_resource_condition.notify_all();
+            return inserted_it->second;
+        }
+
+        [[nodiscard]] GpuTexture& texture_for_mesh_or_default(const Mesh& mesh, TextureType type)
+        {
+            for (const MeshTexture& mesh_texture : mesh.textures())
+            {
+                if (mesh_texture.type != type || !mesh_texture.texture || !mesh_texture.texture->valid())
+                    continue;
+                if (mesh_texture.texture->block_compressed() && !m_texture_compression_bc_supported)
+                {
+                    spdlog::warn("Vulkan: device cannot sample BC textures, using the default texture");
+                    continue;
+                }
+
+                return texture_resource(*mesh_texture.texture, type);
+            }
+            return default_texture_for(type);
+        }
+
+        [[nodiscard]] static UploadTicket material_ready_ticket(const MaterialKey& key) noexcept
+        {
+            UploadTicket ticket = 0;
+            for (const GpuTexture* texture : key.textures)
+                ticket = std::max(ticket, texture->ready_ticket);
+            return ticket;
+        }
+
+        [[nodiscard]] static MaterialUniform material_uniform_for_mesh(const Mesh& mesh)
+        {
+            MaterialUniform uniform{};
+            const PbrMaterial& material = mesh.material();
+            std::copy(material.base_color_factor.begin(),
+                      material.base_color_factor.end(),
+                      uniform.base_color_factor);
+            std::copy(material.emissive_factor.begin(),
+                      material.emissive_factor.end(),
+                      uniform.emissive_factor);
+            uniform.metallic_factor = std::clamp(material.metallic_factor, 0.0f, 1.0f);
+            uniform.roughness_factor = std::clamp(material.roughness_factor, 0.04f, 1.0f);
+            uniform.normal_scale = material.normal_scale;
+            return uniform;
+        }
+
+        // Returns the shared material for the mesh's textures and factors, creating it on first use.
+        [[nodiscard]] const GpuMaterial& acquire_material(const MaterialKey& key, const MaterialUniform& uniform)
+        {
+            std::lock_guard lock(m_resource_mutex);
+            if (const auto it = m_materials.find(key); it != m_materials.end())
+                return it->second;
+
+            GpuMaterial material;
+            material.textures = key.textures;
+            create_buffer(sizeof(MaterialUniform),
+                          VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                          material.uniform_buffer);
+            try
+            {
+                std::memcpy(mapped_memory(material.uniform_buffer, "Material buffer is not host visible"),
+                            &uniform,
+                            sizeof(MaterialUniform));
+                material.descriptor = allocate_material_descriptor(key.textures, material.uniform_buffer);
+            }
+            catch (...)
+            {
+                destroy_buffer(material.uniform_buffer);
+                throw;
+            }
+            return m_materials.emplace(key, material).first->second;
+        }
+
+        // Places the mesh in the geometry arena; returns false when the arena is full.
+        [[nodiscard]] bool allocate_arena_range(GpuMesh& gpu_mesh, VkDeviceSize vertex_count, VkDeviceSize index_count)
+        {
+            std::lock_guard lock(m_resource_mutex);
+            const std::optional<VkDeviceSize> first_vertex = m_arena_vertices.allocate(vertex_count, 1);
+            if (!first_vertex)
+                return false;
+            const std::optional<VkDeviceSize> first_index = m_arena_indices.allocate(index_count, 1);
+            if (!first_index)
+            {
+                m_arena_vertices.free(*first_vertex, vertex_count);
+                return false;
+            }
+
+            gpu_mesh.in_arena = true;
+            gpu_mesh.vertex_offset = static_cast<int32_t>(*first_vertex);
+            gpu_mesh.first_index = static_cast<uint32_t>(*first_index);
+            return true;
+        }
+
+        // Runs on a residency worker.
+        [[nodiscard]] GpuMesh create_mesh_resource(const Mesh& mesh)
+        {
+            GpuMesh gpu_mesh;
+            const auto& vertices = mesh.cpu_mesh().m_vertex_buffer;
+            const auto& triangles = mesh.cpu_mesh().m_element_buffer_object;
+            if (vertices.empty() || triangles.empty())
+                return gpu_mesh;
+
+            static_assert(sizeof(omath::Vector3<uint32_t>) == 3 * sizeof(uint32_t),
+                          "omath::Vector3<uint32_t> must be tightly packed");
+
+            const VkDeviceSize vertex_buffer_size = static_cast<VkDeviceSize>(vertices.size())
+                                                  * static_cast<VkDeviceSize>(sizeof(vertices.front()));
+            const VkDeviceSize index_buffer_size = static_cast<VkDeviceSize>(triangles.size())
+                                                 * static_cast<VkDeviceSize>(sizeof(triangles.front()));
+
+            gpu_mesh.index_count = static_cast<uint32_t>(triangles.size() * 3u);
+
+            UploadTicket vertex_ticket = 0;
+            UploadTicket index_ticket = 0;
+            if (allocate_arena_range(gpu_mesh, vertices.size(), gpu_mesh.index_count))
+            {
+                vertex_ticket = m_uploads->upload_buffer(m_arena_vertex_buffer.buffer,
+                                                         static_cast<VkDeviceSize>(gpu_mesh.vertex_offset)
+                                                             * sizeof(vertices.front()),
+                                                         vertices.data(),
+                                                         vertex_buffer_size);
+                index_ticket = m_uploads->upload_buffer(m_arena_index_buffer.buffer,
+                                                        static_cast<VkDeviceSize>(gpu_mesh.first_index) * sizeof(uint32_t),
+                                                        triangles.data(),
+                                                        index_buffer_size);
+            }
+            else
+            {
+                create_buffer(vertex_buffer_size,
+                              VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                              gpu_mesh.vertex_buffer,
+                              true);
+                create_buffer(index_buffer_size,
+                              VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                              gpu_mesh.index_buffer,
+                              true);
+                vertex_ticket = m_uploads->upload_buffer(gpu_mesh.vertex_buffer.buffer, 0, vertices.data(), vertex_buffer_size);
+                index_ticket = m_uploads->upload_buffer(gpu_mesh.index_buffer.buffer, 0, triangles.data(), index_buffer_size);
+            }
+
+            MaterialKey material_key;
+            material_key.textures = {
+                &texture_for_mesh_or_default(mesh, TextureType::BaseColor),
+                &texture_for_mesh_or_default(mesh, TextureType::Normal),
+                &texture_for_mesh_or_default(mesh, TextureType::MetallicRoughness),
+                &texture_for_mesh_or_default(mesh, TextureType::Emissive)
+            };
+            MaterialUniform material_uniform = material_uniform_for_mesh(mesh);
+            material_uniform.normal_reconstruct_z = material_key.textures[1]->two_channel ? 1.0f : 0.0f;
+            std::memcpy(material_key.uniform_bits.data(), &material_uniform, sizeof(MaterialUniform));
+            gpu_mesh.material = &acquire_material(material_key, material_uniform);
+            gpu_mesh.ready_ticket = std::max({vertex_ticket, index_ticket, material_ready_ticket(material_key)});
+
+            omath::Vector3<float> local_min = vertices.front().position;
+            omath::Vector3<float> local_max = vertices.front().position;
+            for (const auto& vertex : vertices)
+            {
+                local_min.x = std::min(local_min.x, vertex.position.x);
+                local_min.y = std::min(local_min.y, vertex.position.y);
+                local_min.z = std::min(local_min.z, vertex.position.z);
+                local_max.x = std::max(local_max.x, vertex.position.x);
+                local_max.y = std::max(local_max.y, vertex.position.y);
+                local_max.z = std::max(local_max.z, vertex.position.z);
+            }
+            gpu_mesh.local_center = (local_min + local_max) / 2.0f;
+            gpu_mesh.local_extent = (local_max - local_min) / 2.0f;
+            return gpu_mesh;
+        }
+
+        void request_mesh_residency(const Mesh& mesh)
+        {
+            if (m_mesh_resources.contains(&mesh) || !m_pending_meshes.insert(&mesh).second)
+                return;
+
+            m_residency_jobs.push_back(m_residency_pool.submit(
+                [this, &mesh]
+                {
+                    ROSE_PROFILE_THREAD("Residency worker");
+                    ROSE_PROFILE_ZONE("Make mesh resident");
+                    GpuMesh gpu_mesh;
+                    try
+                    {
+                        gpu_mesh = create_mesh_resource(mesh);
+                    }
+                    catch (const std::exception& error)
+                    {
+                        spdlog::error("Vulkan: failed to make mesh resident: {}", error.what());
+                    }
+
+                    std::lock_guard lock(m_resource_mutex);
+                    m_completed_meshes.emplace_back(&mesh, gpu_mesh);
+                }));
+        }
+
+        void collect_resident_meshes()
+        {
+            std::erase_if(m_residency_jobs,
+                          [](const std::future<void>& job)
+                          {
+                              return job.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+                          });
+
+            std::vector<std::pair<const Mesh*, GpuMesh>> completed;
+            {
+                std::lock_guard lock(m_resource_mutex);
+                completed.swap(m_completed_meshes);
+            }
+            for (auto& [mesh, gpu_mesh] : completed)
+            {
+                m_pending_meshes.erase(mesh);
+                m_mesh_resources.emplace(mesh, gpu_mesh);
+            }
+        }
+
+        // Asks the streamer for the mips each drawn texture needs: the level whose texel density
+        // matches the mesh's projected height on screen, assuming its UVs span the texture once.
+        void request_texture_levels()
+        {
+            ++m_streaming_frame;
+            const omath::opengl_engine::Camera* camera = frame_camera();
+            if (camera == nullptr)
+                return;
+
+            const auto view_projection = camera->get_view_projection_matrix().raw_array();
+            const float focal = std::sqrt(view_projection[1] * view_projection[1]
+                                        + view_projection[5] * view_projection[5]
+                                        + view_projection[9] * view_projection[9]);
+            const auto viewport_height = static_cast<float>(m_scene_extent.height);
+            for (const QueuedDrawCall& draw_call : m_queued_draw_calls)
+            {
+                if (draw_call.mesh == nullptr)
+                    continue;
+                const GpuMesh* gpu_mesh = resident_mesh(*draw_call.mesh);
+                if (gpu_mesh == nullptr || gpu_mesh->material == nullptr)
+                    continue;
+
+                const auto model = draw_call.mesh->cpu_mesh().get_to_world_matrix().raw_array();
+                const float local_c[3] = {gpu_mesh->local_center.x, gpu_mesh->local_center.y, gpu_mesh->local_center.z};
+                const float local_e[3] = {gpu_mesh->local_extent.x, gpu_mesh->local_extent.y, gpu_mesh->local_extent.z};
+                float center[4]{0.0f, 0.0f, 0.0f, 1.0f};
+                float radius_squared = 0.0f;
+                for (int row = 0; row < 3; ++row)
+                {
+                    center[row] = model[static_cast<std::size_t>(12 + row)];
+                    float extent = 0.0f;
+                    for (int column = 0; column < 3; ++column)
+                    {
+                        const float axis = model[static_cast<std::size_t>(column * 4 + row)];
+                        center[row] += axis * local_c[column];
+                        extent += std::abs(axis) * local_e[column];
+                    }
+                    radius_squared += extent * extent;
+                }
+                float clip_w = 0.0f;
+                for (int column = 0; column < 4; ++column)
+                    clip_w += view_projection[static_cast<std::size_t>(column * 4 + 3)] * center[column];
+
+                // Diameter in pixels; a mesh around the camera wants full detail.
+                const float radius = std::sqrt(radius_squared);
+                const float pixels = clip_w > radius ? radius * focal / clip_w * viewport_height
+                                                     : std::numeric_limits<float>::max();
+                for (const GpuTexture* texture : gpu_mesh->material->textures)
+                {
+                    const Texture* source = texture->streamed_source;
+                    if (source == nullptr)
+                        continue;
+                    const auto extent = static_cast<float>(std::max(source->width(), source->height()));
+                    const float level = std::floor(std::log2(std::max(extent / std::max(pixels, 1.0f), 1.0f))
+                                                   + m_texture_settings.lod_bias);
+                    m_texture_streamer.request(source,
+                                               static_cast<uint32_t>(std::clamp(level, 0.0f, 31.0f)),
+                                               m_streaming_frame);
+                }
+            }
+        }
+
+        // Bytes streamed textures may hold: the configured budget, capped by what the device-local
+        // heaps can still give after everything else. VK_EXT_memory_budget accounts for other
+        // processes too; without it the allocator's own reservations against 80% of the heaps are
+        // the best estimate.
+        [[nodiscard]] uint64_t texture_budget_bytes() const
         {
-            if (!created)
+            uint64_t device_budget = 0;
+            uint64_t device_usage = 0;
+            if (m_memory_budget_supported)
             {
-                const Texture texture{1, 1, 4, pixel.data()};
-                gpu_texture = create_texture_resource(texture);
-                created = true;
+                VkPhysicalDeviceMemoryBudgetPropertiesEXT budget{};
+                budget.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+                VkPhysicalDeviceMemoryProperties2 properties{};
+                properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+                properties.pNext = &budget;
+                vkGetPhysicalDeviceMemoryProperties2(m_physical_device, &properties);
+                for (uint32_t heap = 0; heap < properties.memoryProperties.memoryHeapCount; ++heap)
+                {
+                    if ((properties.memoryProperties.memoryHeaps[heap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) == 0)
+                        continue;
+                    device_budget += budget.heapBudget[heap];
+                    device_usage += budget.heapUsage[heap];
+                }
             }
-            return gpu_texture;
+            else if (m_allocator)
+            {
+                for (const DeviceHeapUsage& usage : m_allocator->heap_usage())
+                {
+                    if ((usage.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) == 0)
+                        continue;
+                    device_budget += usage.heap_size / 5u * 4u;
+                    device_usage += usage.reserved_bytes;
+                }
+            }
+
+            const uint64_t configured = static_cast<uint64_t>(m_texture_streaming_settings.budget_mib) << 20u;
+            if (device_budget == 0)
+                return configured;
+            const uint64_t streamed = m_texture_streamer.stats().resident_bytes;
+            const uint64_t other = device_usage > streamed ? device_usage - streamed : 0;
+            const uint64_t reserve = other + device_budget / 10u;
+            return std::min(configured, device_budget > reserve ? device_budget - reserve : 0);
         }
 
-        [[nodiscard]] GpuTexture& default_texture_for(TextureType type)
+        // Swaps in the texture levels finished since the last frame, then starts the next
+        // transitions the streamer plans for the current budget.
+        void update_texture_streaming()
         {
-            switch (type)
+            for (RetiredTexture& retired : m_retired_textures)
             {
-            case TextureType::Normal:
+                if (retired.frames_left > 0)
+                    --retired.frames_left;
+                if (retired.frames_left == 0)
+                    destroy_retired_texture(retired);
+            }
+            std::erase_if(m_retired_textures,
+                          [](const RetiredTexture& retired)
+                          {
+                              return retired.frames_left == 0;
+                          });
+
             {
-                constexpr std::array<unsigned char, 4> normal{128u, 128u, 255u, 255u};
-                return default_texture(m_default_normal_texture, m_default_normal_texture_created, normal);
+                std::lock_guard lock(m_resource_mutex);
+                std::ranges::move(m_completed_texture_streams, std::back_inserter(m_pending_texture_swaps));
+                m_completed_texture_streams.clear();
             }
-            case TextureType::Emissive:
+            std::erase_if(m_pending_texture_swaps,
+                          [this](StreamedTexture& streamed)
+                          {
+                              if (!streamed.failed && !m_uploads->is_complete(streamed.replacement.ready_ticket))
+                                  return false;
+                              swap_streamed_texture(streamed);
+                              return true;
+                          });
+
+            m_texture_budget_bytes = texture_budget_bytes();
+            for (const TextureStreamer::Transition& transition :
+                 m_texture_streamer.plan(m_streaming_frame, m_texture_budget_bytes, k_max_texture_transitions))
             {
-                constexpr std::array<unsigned char, 4> black{0u, 0u, 0u, 255u};
-                return default_texture(m_default_emissive_texture, m_default_emissive_texture_created, black);
+                const auto* source = static_cast<const Texture*>(transition.key);
+                GpuTexture* target = nullptr;
+                {
+                    std::lock_guard lock(m_resource_mutex);
+                    target = &m_texture_resources.at(source);
+                }
+
+                m_residency_jobs.push_back(m_residency_pool.submit(
+                    [this, source, target, base_level = transition.base_level]
+                    {
+                        ROSE_PROFILE_THREAD("Residency worker");
+                        ROSE_PROFILE_ZONE("Stream texture levels");
+                        StreamedTexture streamed{target, {}, false};
+                        try
+                        {
+                            streamed.replacement = upload_texture_levels(load_ktx2(source->cooked_path(), base_level),
+                                                                         base_level);
+                        }
+                        catch (const std::exception& error)
+                        {
+                            spdlog::error("Vulkan: failed to stream texture levels from {}: {}",
+                                          source->cooked_path().string(),
+                                          error.what());
+                            streamed.failed = true;
+                        }
+
+                        std::lock_guard lock(m_resource_mutex);
+                        m_completed_texture_streams.push_back(streamed);
+                    }));
             }
-            case TextureType::BaseColor:
-            case TextureType::MetallicRoughness:
+        }
+
+        // Points the texture, and every material sampling it, at the new levels. Frames in flight
+        // keep their old descriptor sets, so materials get fresh sets and the old ones retire with
+        // the old image.
+        void swap_streamed_texture(const StreamedTexture& streamed)
+        {
+            GpuTexture& target = *streamed.target;
+            if (streamed.failed)
             {
-                constexpr std::array<unsigned char, 4> white{255u, 255u, 255u, 255u};
-                return default_texture(m_default_texture, m_default_texture_created, white);
+                m_texture_streamer.cancel(target.streamed_source);
+                return;
             }
+
+            RetiredTexture retired{target.image, {}, k_max_frames_in_flight};
+            {
+                std::lock_guard lock(m_resource_mutex);
+                target.image = streamed.replacement.image;
+                target.mip_levels = streamed.replacement.mip_levels;
+                target.base_level = streamed.replacement.base_level;
+                for (auto& [_, material] : m_materials)
+                {
+                    if (std::ranges::find(material.textures, &target) == material.textures.end())
+                        continue;
+                    retired.descriptors.push_back(material.descriptor);
+                    material.descriptor = allocate_material_descriptor(material.textures, material.uniform_buffer);
+                }
             }
+            m_retired_textures.push_back(std::move(retired));
+            m_texture_streamer.complete(target.streamed_source, target.base_level);
+        }
 
-            constexpr std::array<unsigned char, 4> white{255u, 255u, 255u, 255u};
-            return default_texture(m_default_texture, m_default_texture_created, white);
+        void destroy_retired_texture(RetiredTexture& retired) noexcept
+        {
+            destroy_image(retired.image);
+            if (!retired.descriptors.empty())
+            {
+                std::lock_guard lock(m_resource_mutex);
+                vkFreeDescriptorSets(m_device,
+                                     m_material_descriptor_pool,
+                                     static_cast<uint32_t>(retired.descriptors.size()),
+                                     retired.descriptors.data());
+            }
+            retired.descriptors.clear();
         }
 
-        [[nodiscard]] GpuTexture& texture_resource(const Texture& texture)
+        // Residency jobs must have finished and the device must be idle.
+        void destroy_texture_streams() noexcept
         {
-            const Texture* key = &texture;
-            const auto it = m_texture_resources.find(key);
-            if (it != m_texture_resources.end())
-                return it->second;
+            for (std::vector<StreamedTexture>* streams : {&m_completed_texture_streams, &m_pending_texture_swaps})
+            {
+                for (StreamedTexture& streamed : *streams)
+                {
+                    if (!streamed.failed)
+                        destroy_texture(streamed.replacement);
+                }
+                streams->clear();
+            }
+            for (RetiredTexture& retired : m_retired_textures)
+                destroy_retired_texture(retired);
+            m_retired_textures.clear();
+        }
 
-            auto [inserted_it, _] = m_texture_resources.emplace(key, create_texture_resource(texture));
-            return inserted_it->second;
+        [[nodiscard]] TextureStreamingStats texture_streaming_stats() const
+        {
+            const TextureStreamer::Stats streamer = m_texture_streamer.stats();
+            TextureStreamingStats stats;
+            stats.resident_bytes = streamer.resident_bytes;
+            stats.budget_bytes = m_texture_budget_bytes;
+            stats.streamed_textures = streamer.texture_count;
+            stats.transitions_in_flight = streamer.transitions_in_flight;
+            stats.evicted_bytes = streamer.evicted_bytes;
+            stats.memory_budget_extension = m_memory_budget_supported;
+            return stats;
         }
 
-        [[nodiscard]] GpuTexture& texture_for_mesh_or_default(const Mesh& mesh, TextureType type)
+        // Returns the mesh's GPU resources once they are created and uploaded. A mesh that was never
+        // prepared is scheduled here and skipped until it becomes resident, so the frame thread
+        // never builds resources itself.
+        [[nodiscard]] const GpuMesh* resident_mesh(const Mesh& mesh)
         {
-            for (const MeshTexture& mesh_texture : mesh.textures())
+            const auto it = m_mesh_resources.find(&mesh);
+            if (it == m_mesh_resources.end())
             {
-                if (mesh_texture.type != type || !mesh_texture.texture || !mesh_texture.texture->valid())
-                    continue;
-
-                return texture_resource(*mesh_texture.texture);
+                request_mesh_residency(mesh);
+                return nullptr;
             }
-            return default_texture_for(type);
+
+            const GpuMesh& gpu_mesh = it->second;
+            if (gpu_mesh.index_count == 0 || !m_uploads->is_complete(gpu_mesh.ready_ticket))
+                return nullptr;
+            return &gpu_mesh;
         }
 
-        [[nodiscard]] static MaterialUniform material_uniform_for_mesh(const Mesh& mesh)
+        void prepare(const Model& model)
         {
-            MaterialUniform uniform{};
-            const PbrMaterial& material = mesh.material();
-            std::copy(material.base_color_factor.begin(),
-                      material.base_color_factor.end(),
-                      uniform.base_color_factor);
-            std::copy(material.emissive_factor.begin(),
-                      material.emissive_factor.end(),
-                      uniform.emissive_factor);
-            uniform.metallic_factor = std::clamp(material.metallic_factor, 0.0f, 1.0f);
-            uniform.roughness_factor = std::clamp(material.roughness_factor, 0.04f, 1.0f);
-            uniform.normal_scale = material.normal_scale;
-            return uniform;
+            for (const Mesh& mesh : model.get_meshes())
+                request_mesh_residency(mesh);
         }
 
-        [[nodiscard]] GpuMesh& ensure_mesh_resource(const Mesh& mesh)
+        [[nodiscard]] ResidencyProgress residency_progress() const
         {
-            const auto existing = m_mesh_resources.find(&mesh);
-            if (existing != m_mesh_resources.end())
-                return existing->second;
-
-            GpuMesh gpu_mesh;
-            const auto& vertices = mesh.cpu_mesh().m_vertex_buffer;
-            const auto& triangles = mesh.cpu_mesh().m_element_buffer_object;
+            ResidencyProgress progress;
+            progress.requested_meshes = m_mesh_resources.size() + m_pending_meshes.size();
+            for (const auto& [_, gpu_mesh] : m_mesh_resources)
+            {
+                if (gpu_mesh.index_count == 0 || m_uploads->is_complete(gpu_mesh.ready_ticket))
+                    ++progress.resident_meshes;
+            }
+            return progress;
+        }
 
-            static_assert(sizeof(omath::Vector3<uint32_t>) == 3 * sizeof(uint32_t),
-                          "omath::Vector3<uint32_t> must be tightly packed");
+        // Recompiles changed shader sources and rebuilds every pipeline on a residency worker; the
+        // frame thread keeps rendering with the current pipelines until collect_shader_reload()
+        // swaps the new set in.
+        void reload_shaders()
+        {
+            if (m_shader_reload.valid())
+                return;
 
-            const VkDeviceSize vertex_buffer_size = static_cast<VkDeviceSize>(vertices.size())
-                                                  * static_cast<VkDeviceSize>(sizeof(vertices.front()));
-            const VkDeviceSize index_buffer_size = static_cast<VkDeviceSize>(triangles.size())
-                                                 * static_cast<VkDeviceSize>(sizeof(triangles.front()));
+            const std::filesystem::path source_directory = shader_source_directory();
+            m_shader_reload_status = "Compiling shaders...";
+            spdlog::info("Vulkan: reloading shaders from '{}'", source_directory.string());
+            m_shader_reload = m_residency_pool.submit(
+                [this, shaders = m_shaders, source_directory]
+                {
+                    ShaderReload reload;
+                    reload.shaders = shaders.recompiled(source_directory, reload.compiled_count);
+                    if (reload.compiled_count > 0)
+                        reload.pipelines = create_pipelines(reload.shaders, false);
+                    return reload;
+                });
+        }
 
-            create_device_buffer(vertices.data(), vertex_buffer_size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, gpu_mesh.vertex_buffer);
-            create_device_buffer(triangles.data(), index_buffer_size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, gpu_mesh.index_buffer);
-            gpu_mesh.index_count = static_cast<uint32_t>(triangles.size() * 3u);
+        void collect_shader_reload()
+        {
+            for (RetiredPipelines& retired : m_retired_pipelines)
+            {
+                if (retired.frames_left > 0)
+                    --retired.frames_left;
+                if (retired.frames_left == 0)
+                    destroy_pipelines(retired.pipelines);
+            }
+            std::erase_if(m_retired_pipelines,
+                          [](const RetiredPipelines& retired)
+                          {
+                              return retired.frames_left == 0;
+                          });
+
+            if (!m_shader_reload.valid()
+                || m_shader_reload.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                return;
 
-            const MaterialUniform material_uniform = material_uniform_for_mesh(mesh);
-            create_buffer(sizeof(MaterialUniform),
-                          VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                          gpu_mesh.material_buffer);
-            void* material_mapped = nullptr;
-            check_vk(vkMapMemory(m_device,
-                                  gpu_mesh.material_buffer.memory,
-                                  0,
-                                  sizeof(MaterialUniform),
-                                  0,
-                                  &material_mapped),
-                     "Failed to map material buffer");
-            std::memcpy(material_mapped, &material_uniform, sizeof(MaterialUniform));
-            vkUnmapMemory(m_device, gpu_mesh.material_buffer.memory);
-            gpu_mesh.descriptor = allocate_material_descriptor(mesh, gpu_mesh.material_buffer);
+            ShaderReload reload;
+            try
+            {
+                reload = m_shader_reload.get();
+            }
+            catch (const std::exception& error)
+            {
+                m_shader_reload_status = std::string("Shader reload failed: ") + error.what();
+                spdlog::error("Vulkan: {}", m_shader_reload_status);
+                return;
+            }
 
-            omath::Vector3<float> local_min = vertices.front().position;
-            omath::Vector3<float> local_max = vertices.front().position;
-            for (const auto& vertex : vertices)
+            if (reload.compiled_count == 0)
             {
-                local_min.x = std::min(local_min.x, vertex.position.x);
-                local_min.y = std::min(local_min.y, vertex.position.y);
-                local_min.z = std::min(local_min.z, vertex.position.z);
-                local_max.x = std::max(local_max.x, vertex.position.x);
-                local_max.y = std::max(local_max.y, vertex.position.y);
-                local_max.z = std::max(local_max.z, vertex.position.z);
+                m_shader_reload_status = "Shaders are up to date";
+                return;
             }
-            gpu_mesh.local_center = (local_min + local_max) / 2.0f;
 
-            auto [inserted_it, _] = m_mesh_resources.emplace(&mesh, gpu_mesh);
-            return inserted_it->second;
+            // The other frame in flight may still execute the old pipelines; this frame's fence
+            // has already signalled, so destroy them once every frame slot has cycled.
+            m_retired_pipelines.push_back({installed_pipelines(), k_max_frames_in_flight});
+            install_pipelines(reload.pipelines);
+            m_shaders = std::move(reload.shaders);
+            m_pipeline_cache->save();
+            m_shader_reload_status = "Reloaded " + std::to_string(reload.compiled_count) + " shader(s)";
+            spdlog::info("Vulkan: {}", m_shader_reload_status);
+        }
+
+        [[nodiscard]] const std::string& shader_reload_status() const noexcept
+        {
+            return m_shader_reload_status;
         }
 
         void destroy_texture(GpuTexture& texture) const noexcept
         {
-            if (texture.sampler != VK_NULL_HANDLE)
-                vkDestroySampler(m_device, texture.sampler, nullptr);
             ImageResource image = texture.image;
             destroy_image(image);
             texture = {};
@@ -3996,10 +8250,13 @@ namespace rose::core::vulkan
             {
                 destroy_buffer(mesh.vertex_buffer);
                 destroy_buffer(mesh.index_buffer);
-                destroy_buffer(mesh.material_buffer);
             }
             m_mesh_resources.clear();
 
+            for (auto& [_, material] : m_materials)
+                destroy_buffer(material.uniform_buffer);
+            m_materials.clear();
+
             for (auto& [_, texture] : m_texture_resources)
                 destroy_texture(texture);
             m_texture_resources.clear();
@@ -4028,6 +8285,11 @@ namespace rose::core::vulkan
                 destroy_buffer(slot.buffer);
                 slot = {};
             }
+            for (PickSlot& slot : m_pick_slots)
+            {
+                destroy_buffer(slot.readback.buffer);
+                slot = {};
+            }
             m_completed_stream_frame.reset();
         }
 
@@ -4053,6 +8315,18 @@ namespace rose::core::vulkan
             slot.pending = false;
         }
 
+        void collect_completed_pick(std::size_t frame_index)
+        {
+            PickSlot& slot = m_pick_slots[frame_index];
+            if (!slot.readback.pending)
+                return;
+
+            uint32_t id = 0;
+            std::memcpy(&id, mapped_memory(slot.readback.buffer, "Pick buffer is not host visible"), sizeof(id));
+            m_pick_result = PickResult{id > 0 && id <= slot.meshes.size() ? slot.meshes[id - 1u] : nullptr};
+            slot.readback.pending = false;
+        }
+
         void record_screenshot_copy(const BufferResource& readback_buffer) const
         {
             VkImageMemoryBarrier to_transfer{};
@@ -4121,9 +8395,7 @@ namespace rose::core::vulkan
                                                    VkExtent2D extent,
                                                    VkFormat format) const
         {
-            void* mapped = nullptr;
-            check_vk(vkMapMemory(m_device, readback_buffer.memory, 0, readback_buffer.size, 0, &mapped),
-                     "Failed to map screenshot buffer");
+            const void* mapped = mapped_memory(readback_buffer, "Screenshot buffer is not host visible");
 
             CapturedFrame frame;
             frame.width = extent.width;
@@ -4131,22 +8403,12 @@ namespace rose::core::vulkan
             frame.format = is_bgra_format(format) ? CapturedFrameFormat::Bgra : CapturedFrameFormat::Rgba;
             frame.pixels.resize(static_cast<std::size_t>(extent.width) * static_cast<std::size_t>(extent.height) * 4u);
             std::memcpy(frame.pixels.data(), mapped, frame.pixels.size());
-
-            vkUnmapMemory(m_device, readback_buffer.memory);
             return frame;
         }
 
+        // The device must be idle.
         void cleanup_swapchain() noexcept
         {
-            if (!m_command_buffers.empty())
-            {
-                vkFreeCommandBuffers(m_device,
-                                     m_command_pool,
-                                     static_cast<uint32_t>(m_command_buffers.size()),
-                                     m_command_buffers.data());
-                m_command_buffers.clear();
-            }
-
             destroy_frame_targets();
             destroy_readback_slots();
 
@@ -4172,21 +8434,58 @@ namespace rose::core::vulkan
                 glfwGetFramebufferSize(m_window, &width, &height);
             }
 
+            // Frames in flight keep presenting from the old swapchain and rendering to the old
+            // targets; both retire once those frames' fences have signalled. The scene targets
+            // follow the swapchain size and are only rebuilt when it changed.
             spdlog::info("Vulkan: recreating swapchain");
-            check_vk(vkDeviceWaitIdle(m_device), "Failed to wait for device before swapchain recreation");
             const VkFormat old_format = m_swapchain_image_format;
-            cleanup_swapchain();
-            create_swapchain();
+            const VkExtent2D old_extent = m_swapchain_extent;
+            RetiredFrameResources retired;
+            retired.swapchain = std::exchange(m_swapchain, VK_NULL_HANDLE);
+            retired.image_views = std::exchange(m_swapchain_image_views, {});
+            retired.framebuffers = std::exchange(m_framebuffers, {});
+            create_swapchain(retired.swapchain);
             if (m_render_pass != VK_NULL_HANDLE && old_format != m_swapchain_image_format)
                 throw VulkanError("Swapchain image format changed during resize; restart the application");
             create_image_views();
-            create_render_targets();
             create_framebuffers();
-            create_command_buffers();
+            if (m_swapchain_extent.width != old_extent.width || m_swapchain_extent.height != old_extent.height)
+            {
+                retire_scene_targets(retired);
+                create_scene_targets();
+            }
+            retire_frame_resources(std::move(retired));
+            // Only waits for the device when the minimum image count changed.
             ImGui_ImplVulkan_SetMinImageCount(m_min_image_count);
         }
     };
 
+    const char* gpu_pass_name(GpuPass pass) noexcept
+    {
+        switch (pass)
+        {
+        case GpuPass::Cull:
+            return "Cull";
+        case GpuPass::Shadows:
+            return "Shadows";
+        case GpuPass::Scene:
+            return "Scene";
+        case GpuPass::Outline:
+            return "Outline";
+        case GpuPass::HiZ:
+            return "Hi-Z";
+        case GpuPass::Dlss:
+            return "DLSS";
+        case GpuPass::Bloom:
+            return "Bloom";
+        case GpuPass::Present:
+            return "Present";
+        case GpuPass::Count:
+            break;
+        }
+        return "Unknown";
+    }
+
     Renderer::Renderer(GLFWwindow* window, const omath::Vector2<int>& initial_size)
         : m_impl(std::make_unique<Impl>(window, initial_size))
     {}
@@ -4198,9 +8497,9 @@ namespace rose::core::vulkan
         return m_impl->begin_frame();
     }
 
-    void Renderer::draw_mesh(const Mesh& mesh, const omath::opengl_engine::Camera& camera)
+    void Renderer::draw_mesh(const Mesh& mesh, const omath::opengl_engine::Camera& camera, MeshMobility mobility)
     {
-        m_impl->draw_mesh(mesh, camera);
+        m_impl->draw_mesh(mesh, camera, mobility);
     }
 
     void Renderer::draw_mesh_outline(const Mesh& mesh, const omath::opengl_engine::Camera& camera)
@@ -4208,6 +8507,21 @@ namespace rose::core::vulkan
         m_impl->draw_mesh_outline(mesh, camera);
     }
 
+    std::vector<Frustum> Renderer::culling_frusta(const omath::opengl_engine::Camera& camera)
+    {
+        return m_impl->culling_frusta(camera);
+    }
+
+    void Renderer::request_pick(const omath::Vector2<float>& screen_position)
+    {
+        m_impl->request_pick(screen_position);
+    }
+
+    std::optional<PickResult> Renderer::take_pick_result()
+    {
+        return m_impl->take_pick_result();
+    }
+
     void Renderer::render_imgui(ImDrawData* draw_data)
     {
         m_impl->render_imgui(draw_data);
@@ -4297,4 +8611,170 @@ namespace rose::core::vulkan
     {
         m_impl->set_sun_settings(settings);
     }
+
+    TextureSettings Renderer::texture_settings() const
+    {
+        return m_impl->m_texture_settings;
+    }
+
+    void Renderer::set_texture_settings(const TextureSettings& settings)
+    {
+        m_impl->set_texture_settings(settings);
+    }
+
+    bool Renderer::gpu_profiler_enabled() const
+    {
+        return m_impl->m_gpu_profiler->enabled();
+    }
+
+    void Renderer::set_gpu_profiler_enabled(bool enabled)
+    {
+        m_impl->m_gpu_profiler->set_enabled(enabled);
+    }
+
+    bool Renderer::gpu_pipeline_statistics_enabled() const
+    {
+        return m_impl->m_gpu_profiler->statistics_enabled();
+    }
+
+    void Renderer::set_gpu_pipeline_statistics_enabled(bool enabled)
+    {
+        m_impl->m_gpu_profiler->set_statistics_enabled(enabled);
+    }
+
+    GpuProfile Renderer::gpu_profile() const
+    {
+        return m_impl->gpu_profile();
+    }
+
+    bool Renderer::present_wait_supported() const
+    {
+        return m_impl->m_present_wait_supported;
+    }
+
+    void Renderer::wait_for_present(uint32_t max_pending, uint64_t timeout_ns)
+    {
+        m_impl->wait_for_present(max_pending, timeout_ns);
+    }
+
+    LatencyProfile Renderer::latency_profile() const
+    {
+        return m_impl->m_latency_profile;
+    }
+
+    void Renderer::set_latency_profile(const LatencyProfile& profile)
+    {
+        m_impl->set_latency_profile(profile);
+    }
+
+    LatencyStats Renderer::latency_stats() const
+    {
+        return m_impl->latency_stats();
+    }
+
+    void Renderer::mark_input_sampled()
+    {
+        m_impl->m_input_sampled_at = std::chrono::steady_clock::now();
+    }
+
+    bool Renderer::late_latch_enabled() const
+    {
+        return m_impl->m_late_latch_enabled;
+    }
+
+    void Renderer::set_late_latch_enabled(bool enabled)
+    {
+        m_impl->m_late_latch_enabled = enabled;
+    }
+
+    void Renderer::late_latch_camera(const omath::opengl_engine::Camera& camera, std::function<void()> update)
+    {
+        m_impl->late_latch_camera(camera, std::move(update));
+    }
+
+    LateLatchStats Renderer::late_latch_stats() const
+    {
+        return m_impl->late_latch_stats();
+    }
+
+    TextureStreamingSettings Renderer::texture_streaming_settings() const
+    {
+        return m_impl->m_texture_streaming_settings;
+    }
+
+    void Renderer::set_texture_streaming_settings(const TextureStreamingSettings& settings)
+    {
+        m_impl->m_texture_streaming_settings = settings;
+        m_impl->m_texture_streaming_settings.budget_mib = std::max(settings.budget_mib, 64u);
+    }
+
+    TextureStreamingStats Renderer::texture_streaming_stats() const
+    {
+        return m_impl->texture_streaming_stats();
+    }
+
+    bool Renderer::gpu_driven_supported() const
+    {
+        return m_impl->gpu_driven_supported();
+    }
+
+    bool Renderer::gpu_driven_enabled() const
+    {
+        return m_impl->m_gpu_driven_enabled;
+    }
+
+    void Renderer::set_gpu_driven_enabled(bool enabled)
+    {
+        m_impl->m_gpu_driven_enabled = enabled;
+    }
+
+    bool Renderer::gpu_culling_active() const
+    {
+        return m_impl->gpu_culling_active();
+    }
+
+    bool Renderer::gpu_culling_enabled() const
+    {
+        return m_impl->m_gpu_culling_enabled;
+    }
+
+    void Renderer::set_gpu_culling_enabled(bool enabled)
+    {
+        m_impl->m_gpu_culling_enabled = enabled;
+    }
+
+    bool Renderer::occlusion_culling_enabled() const
+    {
+        return m_impl->m_occlusion_culling_enabled;
+    }
+
+    void Renderer::set_occlusion_culling_enabled(bool enabled)
+    {
+        m_impl->set_occlusion_culling_enabled(enabled);
+    }
+
+    std::vector<MemoryHeapStats> Renderer::memory_stats() const
+    {
+        return m_impl->memory_stats();
+    }
+
+    void Renderer::prepare(const Model& model)
+    {
+        m_impl->prepare(model);
+    }
+
+    ResidencyProgress Renderer::residency_progress() const
+    {
+        return m_impl->residency_progress();
+    }
+
+    void Renderer::reload_shaders()
+    {
+        m_impl->reload_shaders();
+    }
+
+    std::string Renderer::shader_reload_status() const
+    {
+        return m_impl->shader_reload_status();
+    }
 } // namespace rose::core::vulkan
@@ -0,0 +1,288 @@
+//
+// Created by orange on 16.10.2026.
+//
+#include "rose/core/vulkan/shader_library.hpp"
+
+#include <spdlog/spdlog.h>
+
+#ifdef _WIN32
+#include <process.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+namespace rose::core::vulkan
+{
+    namespace
+    {
+        constexpr uint32_t k_spirv_magic = 0x07230203u;
+
+        constexpr std::array<uint32_t, 64> k_sha256_rounds{
+            0x428a2f98u, 0x71374491u, 0xb5c0fbcfu, 0xe9b5dba5u, 0x3956c25bu, 0x59f111f1u, 0x923f82a4u, 0xab1c5ed5u,
+            0xd807aa98u, 0x12835b01u, 0x243185beu, 0x550c7dc3u, 0x72be5d74u, 0x80deb1feu, 0x9bdc06a7u, 0xc19bf174u,
+            0xe49b69c1u, 0xefbe4786u, 0x0fc19dc6u, 0x240ca1ccu, 0x2de92c6fu, 0x4a7484aau, 0x5cb0a9dcu, 0x76f988dau,
+            0x983e5152u, 0xa831c66du, 0xb00327c8u, 0xbf597fc7u, 0xc6e00bf3u, 0xd5a79147u, 0x06ca6351u, 0x14292967u,
+            0x27b70a85u, 0x2e1b2138u, 0x4d2c6dfcu, 0x53380d13u, 0x650a7354u, 0x766a0abbu, 0x81c2c92eu, 0x92722c85u,
+            0xa2bfe8a1u, 0xa81a664bu, 0xc24b8b70u, 0xc76c51a3u, 0xd192e819u, 0xd6990624u, 0xf40e3585u, 0x106aa070u,
+            0x19a4c116u, 0x1e376c08u, 0x2748774cu, 0x34b0bcb5u, 0x391c0cb3u, 0x4ed8aa4au, 0x5b9cca4fu, 0x682e6ff3u,
+            0x748f82eeu, 0x78a5636fu, 0x84c87814u, 0x8cc70208u, 0x90befffau, 0xa4506cebu, 0xbef9a3f7u, 0xc67178f2u,
+        };
+
+        // Lower-case hex SHA-256, matching CMake's string(SHA256) and file(SHA256).
+        [[nodiscard]] std::string sha256_hex(std::string_view data)
+        {
+            std::array<uint32_t, 8> state{
+                0x6a09e667u, 0xbb67ae85u, 0x3c6ef372u, 0xa54ff53au, 0x510e527fu, 0x9b05688cu, 0x1f83d9abu, 0x5be0cd19u
+            };
+
+            std::string message(data);
+            const uint64_t bit_length = static_cast<uint64_t>(data.size()) * 8u;
+            message.push_back(static_cast<char>(0x80));
+            while (message.size() % 64u != 56u)
+                message.push_back('\0');
+            for (int shift = 56; shift >= 0; shift -= 8)
+                message.push_back(static_cast<char>((bit_length >> shift) & 0xffu));
+
+            for (std::size_t block = 0; block < message.size(); block += 64u)
+            {
+                std::array<uint32_t, 64> schedule{};
+                for (std::size_t i = 0; i < 16; ++i)
+                {
+                    for (std::size_t byte = 0; byte < 4; ++byte)
+                        schedule[i] = schedule[i] << 8 | static_cast<uint8_t>(message[block + i * 4u + byte]);
+                }
+                for (std::size_t i = 16; i < schedule.size(); ++i)
+                {
+                    const uint32_t s0 = std::rotr(schedule[i - 15], 7) ^ std::rotr(schedule[i - 15], 18)
+                                      ^ schedule[i - 15] >> 3;
+                    const uint32_t s1 = std::rotr(schedule[i - 2], 17) ^ std::rotr(schedule[i - 2], 19)
+                                      ^ schedule[i - 2] >> 10;
+                    schedule[i] = schedule[i - 16] + s0 + schedule[i - 7] + s1;
+                }
+
+                std::array<uint32_t, 8> v = state;
+                for (std::size_t i = 0; i < schedule.size(); ++i)
+                {
+                    const uint32_t s1 = std::rotr(v[4], 6) ^ std::rotr(v[4], 11) ^ std::rotr(v[4], 25);
+                    const uint32_t choice = (v[4] & v[5]) ^ (~v[4] & v[6]);
+                    const uint32_t t1 = v[7] + s1 + choice + k_sha256_rounds[i] + schedule[i];
+                    const uint32_t s0 = std::rotr(v[0], 2) ^ std::rotr(v[0], 13) ^ std::rotr(v[0], 22);
+                    const uint32_t majority = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+                    v = {t1 + s0 + majority, v[0], v[1], v[2], v[3] + t1, v[4], v[5], v[6]};
+                }
+                for (std::size_t i = 0; i < state.size(); ++i)
+                    state[i] += v[i];
+            }
+
+            constexpr char digits[] = "0123456789abcdef";
+            std::string hex;
+            hex.reserve(64);
+            for (const uint32_t word : state)
+            {
+                for (int shift = 28; shift >= 0; shift -= 4)
+                    hex.push_back(digits[(word >> shift) & 0xfu]);
+            }
+            return hex;
+        }
+
+        // Same key embed_shaders.cmake computes: SHA-256 of the flag hash followed by the source hash.
+        [[nodiscard]] std::string shader_key(std::string_view flags, std::string_view source)
+        {
+            return sha256_hex(sha256_hex(flags) + sha256_hex(source));
+        }
+
+        [[nodiscard]] std::optional<std::string> read_file(const std::filesystem::path& path)
+        {
+            std::ifstream file(path, std::ios::binary);
+            if (!file)
+                return std::nullopt;
+            return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+
+        [[nodiscard]] std::optional<std::string> environment_value(const char* name)
+        {
+#ifdef _MSC_VER
+            char* value = nullptr;
+            std::size_t value_size = 0;
+            if (_dupenv_s(&value, &value_size, name) != 0 || value == nullptr)
+                return std::nullopt;
+            std::string result(value);
+            std::free(value);
+            if (result.empty())
+                return std::nullopt;
+            return result;
+#else
+            const char* value = std::getenv(name);
+            if (value == nullptr || value[0] == '\0')
+                return std::nullopt;
+            return std::string(value);
+#endif
+        }
+
+        [[nodiscard]] std::string quote_command_arg(const std::string& arg)
+        {
+            std::string result = "\"";
+            for (const char c : arg)
+            {
+                if (c == '"')
+                    result += "\\\"";
+                else
+                    result += c;
+            }
+            result += "\"";
+            return result;
+        }
+
+        [[nodiscard]] std::vector<std::string> split_flags(std::string_view flags)
+        {
+            std::vector<std::string> result;
+            std::istringstream stream{std::string(flags)};
+            for (std::string flag; stream >> flag;)
+                result.push_back(flag);
+            return result;
+        }
+
+        [[nodiscard]] int run_glslc(const std::filesystem::path& compiler_path,
+                                    std::string_view flags,
+                                    const std::filesystem::path& source_path,
+                                    const std::filesystem::path& output_path)
+        {
+            const std::vector<std::string> flag_args = split_flags(flags);
+#ifdef _WIN32
+            std::vector<std::wstring> arg_storage;
+            arg_storage.push_back(compiler_path.wstring());
+            for (const std::string& flag : flag_args)
+                arg_storage.push_back(std::filesystem::path(flag).wstring());
+            arg_storage.push_back(source_path.wstring());
+            arg_storage.push_back(L"-o");
+            arg_storage.push_back(output_path.wstring());
+
+            std::vector<const wchar_t*> args;
+            for (const std::wstring& arg : arg_storage)
+                args.push_back(arg.c_str());
+            args.push_back(nullptr);
+            return static_cast<int>(_wspawnvp(_P_WAIT, arg_storage.front().c_str(), args.data()));
+#else
+            std::string command = quote_command_arg(compiler_path.string());
+            for (const std::string& flag : flag_args)
+                command += " " + quote_command_arg(flag);
+            command += " " + quote_command_arg(source_path.string())
+                     + " -o "
+                     + quote_command_arg(output_path.string());
+            return std::system(command.c_str());
+#endif
+        }
+
+        [[nodiscard]] std::filesystem::path glslc_path()
+        {
+#ifdef _WIN32
+            constexpr const char* glslc_filename = "glslc.exe";
+#else
+            constexpr const char* glslc_filename = "glslc";
+#endif
+            std::error_code ec;
+            const std::filesystem::path local_glslc = std::filesystem::current_path(ec) / glslc_filename;
+            if (!ec && std::filesystem::exists(local_glslc))
+                return local_glslc;
+
+            if (const auto vulkan_sdk = environment_value("VULKAN_SDK"))
+            {
+#ifdef _WIN32
+                const std::filesystem::path sdk_glslc = std::filesystem::path(*vulkan_sdk) / "Bin" / glslc_filename;
+#else
+                const std::filesystem::path sdk_glslc = std::filesystem::path(*vulkan_sdk) / "bin" / glslc_filename;
+#endif
+                if (std::filesystem::exists(sdk_glslc))
+                    return sdk_glslc;
+            }
+
+            return glslc_filename;
+        }
+
+        [[nodiscard]] std::vector<uint32_t> read_spirv(const std::filesystem::path& path)
+        {
+            const std::optional<std::string> bytes = read_file(path);
+            if (!bytes || bytes->empty() || bytes->size() % sizeof(uint32_t) != 0)
+                throw std::runtime_error("Invalid SPIR-V output: " + path.string());
+
+            std::vector<uint32_t> words(bytes->size() / sizeof(uint32_t));
+            std::memcpy(words.data(), bytes->data(), bytes->size());
+            if (words.front() != k_spirv_magic)
+                throw std::runtime_error("Invalid SPIR-V output: " + path.string());
+            return words;
+        }
+    } // namespace
+
+    ShaderLibrary ShaderLibrary::embedded()
+    {
+        ShaderLibrary library;
+        library.m_flags = embedded_shader_flags();
+        for (const EmbeddedShader& shader : embedded_shaders())
+        {
+            library.m_shaders.push_back({std::string(shader.name),
+                                         std::string(shader.source_name),
+                                         std::string(shader.key),
+                                         nullptr,
+                                         shader.spirv});
+        }
+        return library;
+    }
+
+    ShaderLibrary ShaderLibrary::recompiled(const std::filesystem::path& source_directory,
+                                            std::size_t& compiled_count) const
+    {
+        compiled_count = 0;
+        ShaderLibrary library = *this;
+
+        std::error_code error;
+        const std::filesystem::path output_directory = std::filesystem::temp_directory_path(error) / "rose_shaders";
+        std::filesystem::create_directories(output_directory, error);
+        const std::filesystem::path compiler_path = glslc_path();
+
+        for (Shader& shader : library.m_shaders)
+        {
+            const std::filesystem::path source_path = source_directory / shader.source_name;
+            const std::optional<std::string> source = read_file(source_path);
+            if (!source)
+            {
+                spdlog::warn("Vulkan: shader source '{}' not found, keeping the loaded SPIR-V", source_path.string());
+                continue;
+            }
+
+            std::string key = shader_key(m_flags, *source);
+            if (key == shader.key)
+                continue;
+
+            const std::filesystem::path output_path = output_directory / shader.name;
+            std::filesystem::remove(output_path, error);
+            spdlog::info("Vulkan: compiling shader '{}' with '{}'", source_path.string(), compiler_path.string());
+            if (run_glslc(compiler_path, m_flags, source_path, output_path) != 0)
+                throw std::runtime_error("Failed to compile shader " + shader.source_name);
+
+            auto words = std::make_shared<const std::vector<uint32_t>>(read_spirv(output_path));
+            shader.spirv = *words;
+            shader.compiled = std::move(words);
+            shader.key = std::move(key);
+            ++compiled_count;
+        }
+        return library;
+    }
+
+    std::span<const uint32_t> ShaderLibrary::spirv(std::string_view name) const
+    {
+        const auto shader = std::ranges::find(m_shaders, name, &Shader::name);
+        if (shader == m_shaders.end())
+            throw std::runtime_error("Unknown shader: " + std::string(name));
+        return shader->spirv;
+    }
+} // namespace rose::core::vulkan
@@ -0,0 +1,294 @@
+//
+// Created by orange on 16.10.2026.
+//
+#include "rose/core/vulkan/texel_conversion.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ROSE_TEXEL_CONVERSION_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define ROSE_TEXEL_CONVERSION_X86 0
+#endif
+
+// MSVC emits any intrinsic without per-function target flags; GCC and Clang need them.
+#if defined(__GNUC__) || defined(__clang__)
+#define ROSE_TEXEL_TARGET(isa) __attribute__((target(isa)))
+#else
+#define ROSE_TEXEL_TARGET(isa)
+#endif
+
+namespace rose::core::vulkan
+{
+    namespace
+    {
+        using ExpandKernel = void (*)(const unsigned char*, int, std::size_t, unsigned char*) noexcept;
+
+        // Anything but 1-3 components is copied as RGBA8.
+        [[nodiscard]] constexpr std::size_t source_stride(int components) noexcept
+        {
+            return components >= 1 && components <= 3 ? static_cast<std::size_t>(components) : 4u;
+        }
+
+        void expand_scalar(const unsigned char* src, int components, std::size_t texel_count, unsigned char* dst) noexcept
+        {
+            switch (components)
+            {
+            case 1:
+                for (std::size_t i = 0; i < texel_count; ++i, dst += 4)
+                {
+                    dst[0] = dst[1] = dst[2] = src[i];
+                    dst[3] = 255u;
+                }
+                break;
+            case 2:
+                for (std::size_t i = 0; i < texel_count; ++i, src += 2, dst += 4)
+                {
+                    dst[0] = dst[1] = dst[2] = src[0];
+                    dst[3] = src[1];
+                }
+                break;
+            case 3:
+                for (std::size_t i = 0; i < texel_count; ++i, src += 3, dst += 4)
+                {
+                    dst[0] = src[0];
+                    dst[1] = src[1];
+                    dst[2] = src[2];
+                    dst[3] = 255u;
+                }
+                break;
+            default:
+                std::memcpy(dst, src, texel_count * 4u);
+                break;
+            }
+        }
+
+#if ROSE_TEXEL_CONVERSION_X86
+        constexpr char k_shuffle_zero = static_cast<char>(0x80);
+
+        // pshufb control for four RGBA8 output texels, starting at `first_texel` of the loaded
+        // source bytes. Zeroed alpha bytes are filled in afterwards by OR-ing in 0xFF.
+        [[nodiscard]] constexpr std::array<char, 16> expand_shuffle(int components, int first_texel) noexcept
+        {
+            std::array<char, 16> shuffle{};
+            for (int byte = 0; byte < 16; ++byte)
+            {
+                const int texel = first_texel + byte / 4;
+                const int channel = byte % 4;
+                if (components == 1)
+                    shuffle[byte] = channel < 3 ? static_cast<char>(texel) : k_shuffle_zero;
+                else if (components == 2)
+                    shuffle[byte] = static_cast<char>(channel < 3 ? texel * 2 : texel * 2 + 1);
+                else
+                    shuffle[byte] = channel < 3 ? static_cast<char>(texel * 3 + channel) : k_shuffle_zero;
+            }
+            return shuffle;
+        }
+
+        [[nodiscard]] constexpr std::array<char, 32> expand_shuffle_pair(int components,
+                                                                         int low_first_texel,
+                                                                         int high_first_texel) noexcept
+        {
+            const std::array<char, 16> low = expand_shuffle(components, low_first_texel);
+            const std::array<char, 16> high = expand_shuffle(components, high_first_texel);
+            std::array<char, 32> shuffle{};
+            for (std::size_t byte = 0; byte < 16; ++byte)
+            {
+                shuffle[byte] = low[byte];
+                shuffle[byte + 16] = high[byte];
+            }
+            return shuffle;
+        }
+
+        constexpr std::array k_ssse3_grey{expand_shuffle(1, 0), expand_shuffle(1, 4), expand_shuffle(1, 8), expand_shuffle(1, 12)};
+        constexpr std::array k_ssse3_grey_alpha{expand_shuffle(2, 0), expand_shuffle(2, 4)};
+        constexpr std::array<char, 16> k_ssse3_rgb = expand_shuffle(3, 0);
+        // AVX2 shuffles within each 128-bit lane, so both lanes hold the same source bytes (or,
+        // for RGB, the next four texels) and each lane picks its own texels.
+        constexpr std::array k_avx2_grey{expand_shuffle_pair(1, 0, 4), expand_shuffle_pair(1, 8, 12)};
+        constexpr std::array<char, 32> k_avx2_grey_alpha = expand_shuffle_pair(2, 0, 4);
+        constexpr std::array<char, 32> k_avx2_rgb = expand_shuffle_pair(3, 0, 0);
+
+        ROSE_TEXEL_TARGET("ssse3")
+        [[nodiscard]] __m128i load_shuffle(const std::array<char, 16>& shuffle) noexcept
+        {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle.data()));
+        }
+
+        ROSE_TEXEL_TARGET("avx2")
+        [[nodiscard]] __m256i load_shuffle(const std::array<char, 32>& shuffle) noexcept
+        {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(shuffle.data()));
+        }
+
+        ROSE_TEXEL_TARGET("ssse3")
+        void expand_ssse3(const unsigned char* src, int components, std::size_t texel_count, unsigned char* dst) noexcept
+        {
+            const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+            std::size_t texel = 0;
+            if (components == 1)
+            {
+                const std::array shuffles{load_shuffle(k_ssse3_grey[0]),
+                                          load_shuffle(k_ssse3_grey[1]),
+                                          load_shuffle(k_ssse3_grey[2]),
+                                          load_shuffle(k_ssse3_grey[3])};
+                for (; texel + 16 <= texel_count; texel += 16)
+                {
+                    const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + texel));
+                    for (std::size_t part = 0; part < shuffles.size(); ++part)
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + (texel + part * 4) * 4),
+                                         _mm_or_si128(_mm_shuffle_epi8(in, shuffles[part]), alpha));
+                }
+            }
+            else if (components == 2)
+            {
+                const __m128i low = load_shuffle(k_ssse3_grey_alpha[0]);
+                const __m128i high = load_shuffle(k_ssse3_grey_alpha[1]);
+                for (; texel + 8 <= texel_count; texel += 8)
+                {
+                    const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + texel * 2));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + texel * 4), _mm_shuffle_epi8(in, low));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + texel * 4 + 16), _mm_shuffle_epi8(in, high));
+                }
+            }
+            else if (components == 3)
+            {
+                // Four texels use 12 of the 16 loaded bytes; stop while the load stays in bounds.
+                const __m128i shuffle = load_shuffle(k_ssse3_rgb);
+                for (; (texel_count - texel) * 3 >= 16; texel += 4)
+                {
+                    const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + texel * 3));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + texel * 4),
+                                     _mm_or_si128(_mm_shuffle_epi8(in, shuffle), alpha));
+                }
+            }
+            expand_scalar(src + texel * source_stride(components), components, texel_count - texel, dst + texel * 4);
+        }
+
+        ROSE_TEXEL_TARGET("avx2")
+        void expand_avx2(const unsigned char* src, int components, std::size_t texel_count, unsigned char* dst) noexcept
+        {
+            const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+            std::size_t texel = 0;
+            if (components == 1)
+            {
+                const __m256i low = load_shuffle(k_avx2_grey[0]);
+                const __m256i high = load_shuffle(k_avx2_grey[1]);
+                for (; texel + 16 <= texel_count; texel += 16)
+                {
+                    const __m256i in = _mm256_broadcastsi128_si256(
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + texel)));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + texel * 4),
+                                        _mm256_or_si256(_mm256_shuffle_epi8(in, low), alpha));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + texel * 4 + 32),
+                                        _mm256_or_si256(_mm256_shuffle_epi8(in, high), alpha));
+                }
+            }
+            else if (components == 2)
+            {
+                const __m256i shuffle = load_shuffle(k_avx2_grey_alpha);
+                for (; texel + 8 <= texel_count; texel += 8)
+                {
+                    const __m256i in = _mm256_broadcastsi128_si256(
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + texel * 2)));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + texel * 4), _mm256_shuffle_epi8(in, shuffle));
+                }
+            }
+            else if (components == 3)
+            {
+                // Eight texels per step from two overlapping 16-byte loads at +0 and +12.
+                const __m256i shuffle = load_shuffle(k_avx2_rgb);
+                for (; (texel_count - texel) * 3 >= 28; texel += 8)
+                {
+                    const unsigned char* in_texels = src + texel * 3;
+                    const __m256i in = _mm256_inserti128_si256(
+                        _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in_texels))),
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(in_texels + 12)),
+                        1);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + texel * 4),
+                                        _mm256_or_si256(_mm256_shuffle_epi8(in, shuffle), alpha));
+                }
+            }
+            expand_scalar(src + texel * source_stride(components), components, texel_count - texel, dst + texel * 4);
+        }
+
+        struct CpuFeatures final
+        {
+            bool ssse3 = false;
+            bool avx2 = false;
+        };
+
+        [[nodiscard]] CpuFeatures cpu_features() noexcept
+        {
+            CpuFeatures features;
+#if defined(_MSC_VER) && !defined(__clang__)
+            std::array<int, 4> registers{};
+            __cpuid(registers.data(), 0);
+            const int max_leaf = registers[0];
+            __cpuid(registers.data(), 1);
+            features.ssse3 = (registers[2] & (1 << 9)) != 0;
+            const bool os_saves_ymm = (registers[2] & (1 << 27)) != 0 && (registers[2] & (1 << 28)) != 0
+                                   && (_xgetbv(0) & 0x6u) == 0x6u;
+            if (max_leaf >= 7 && os_saves_ymm)
+            {
+                __cpuidex(registers.data(), 7, 0);
+                features.avx2 = (registers[1] & (1 << 5)) != 0;
+            }
+#else
+            __builtin_cpu_init();
+            features.ssse3 = __builtin_cpu_supports("ssse3") != 0;
+            features.avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+            return features;
+        }
+#endif
+
+        struct ExpandDispatch final
+        {
+            ExpandKernel kernel = expand_scalar;
+            const char* isa = "scalar";
+
+            ExpandDispatch() noexcept
+            {
+#if ROSE_TEXEL_CONVERSION_X86
+                const CpuFeatures features = cpu_features();
+                if (features.avx2)
+                {
+                    kernel = expand_avx2;
+                    isa = "avx2";
+                }
+                else if (features.ssse3)
+                {
+                    kernel = expand_ssse3;
+                    isa = "ssse3";
+                }
+#endif
+            }
+        };
+
+        [[nodiscard]] const ExpandDispatch& expand_dispatch() noexcept
+        {
+            static const ExpandDispatch dispatch;
+            return dispatch;
+        }
+    } // namespace
+
+    void expand_texels_to_rgba8(const unsigned char* src,
+                                int components,
+                                std::size_t texel_count,
+                                unsigned char* dst) noexcept
+    {
+        expand_dispatch().kernel(src, components, texel_count, dst);
+    }
+
+    const char* texel_conversion_isa() noexcept
+    {
+        return expand_dispatch().isa;
+    }
+} // namespace rose::core::vulkan
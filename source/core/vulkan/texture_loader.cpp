@@ -0,0 +1,509 @@
+//
+// Created by orange on 16.10.2026.
+//
+#include "rose/core/vulkan/texture_loader.hpp"
+#include "rose/core/vulkan/texel_conversion.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace rose::core::vulkan
+{
+    namespace
+    {
+        constexpr std::array<unsigned char, 12> k_ktx2_identifier{
+            0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+        };
+        constexpr std::size_t k_linear_to_srgb_steps = 4096;
+
+        struct Ktx2Header final
+        {
+            uint32_t vk_format = 0;
+            uint32_t type_size = 0;
+            uint32_t pixel_width = 0;
+            uint32_t pixel_height = 0;
+            uint32_t pixel_depth = 0;
+            uint32_t layer_count = 0;
+            uint32_t face_count = 0;
+            uint32_t level_count = 0;
+            uint32_t supercompression_scheme = 0;
+            uint32_t dfd_byte_offset = 0;
+            uint32_t dfd_byte_length = 0;
+            uint32_t kvd_byte_offset = 0;
+            uint32_t kvd_byte_length = 0;
+        };
+        static_assert(sizeof(Ktx2Header) == 52, "Ktx2Header must match the KTX2 file layout");
+        // The header ends with the supercompression global data offset and length, which files
+        // without supercompression leave empty.
+        constexpr std::size_t k_ktx2_sgd_index_size = 2u * sizeof(uint64_t);
+
+        struct Ktx2Level final
+        {
+            uint64_t byte_offset = 0;
+            uint64_t byte_length = 0;
+            uint64_t uncompressed_byte_length = 0;
+        };
+        static_assert(sizeof(Ktx2Level) == 24, "Ktx2Level must match the KTX2 file layout");
+
+        [[nodiscard]] std::optional<TextureFormat> texture_format(uint32_t vk_format) noexcept
+        {
+            switch (static_cast<VkFormat>(vk_format))
+            {
+            case VK_FORMAT_R8G8B8A8_UNORM:
+            case VK_FORMAT_R8G8B8A8_SRGB:
+                return TextureFormat::Rgba8;
+            case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+            case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+                return TextureFormat::Bc1;
+            case VK_FORMAT_BC3_UNORM_BLOCK:
+            case VK_FORMAT_BC3_SRGB_BLOCK:
+                return TextureFormat::Bc3;
+            case VK_FORMAT_BC5_UNORM_BLOCK:
+                return TextureFormat::Bc5;
+            case VK_FORMAT_BC7_UNORM_BLOCK:
+            case VK_FORMAT_BC7_SRGB_BLOCK:
+                return TextureFormat::Bc7;
+            default:
+                return std::nullopt;
+            }
+        }
+
+        [[nodiscard]] VkFormat vk_format(TextureFormat format) noexcept
+        {
+            switch (format)
+            {
+            case TextureFormat::Bc1:
+                return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+            case TextureFormat::Bc3:
+                return VK_FORMAT_BC3_UNORM_BLOCK;
+            case TextureFormat::Bc5:
+                return VK_FORMAT_BC5_UNORM_BLOCK;
+            case TextureFormat::Bc7:
+                return VK_FORMAT_BC7_UNORM_BLOCK;
+            case TextureFormat::Rgba8:
+                break;
+            }
+            return VK_FORMAT_R8G8B8A8_UNORM;
+        }
+
+        // Khronos basic data format descriptor words; see the Khronos Data Format Specification.
+        constexpr uint32_t k_dfd_model_rgbsda = 1;
+        constexpr uint32_t k_dfd_model_bc1a = 129;
+        constexpr uint32_t k_dfd_model_bc3 = 130;
+        constexpr uint32_t k_dfd_model_bc5 = 132;
+        constexpr uint32_t k_dfd_model_bc7 = 134;
+        constexpr uint32_t k_dfd_primaries_bt709 = 1;
+        constexpr uint32_t k_dfd_transfer_linear = 1;
+        constexpr uint32_t k_dfd_block_header_size = 24;
+        constexpr uint32_t k_dfd_sample_size = 16;
+
+        struct DfdSample final
+        {
+            uint32_t bit_offset = 0;
+            uint32_t bit_length = 0;
+            uint32_t channel = 0;
+        };
+
+        [[nodiscard]] std::vector<uint32_t> data_format_descriptor(uint32_t color_model,
+                                                                   uint32_t block_extent,
+                                                                   uint32_t block_bytes,
+                                                                   std::span<const DfdSample> samples)
+        {
+            const auto block_size = k_dfd_block_header_size + k_dfd_sample_size * static_cast<uint32_t>(samples.size());
+            std::vector<uint32_t> words{
+                block_size + 4u,
+                0u, // vendor and descriptor type: Khronos basic
+                2u | (block_size << 16),
+                color_model | (k_dfd_primaries_bt709 << 8) | (k_dfd_transfer_linear << 16),
+                (block_extent - 1u) | ((block_extent - 1u) << 8),
+                block_bytes,
+                0u,
+            };
+            for (const DfdSample& sample : samples)
+            {
+                words.push_back(sample.bit_offset | ((sample.bit_length - 1u) << 16) | (sample.channel << 24));
+                words.push_back(0u);
+                words.push_back(0u);
+                words.push_back(sample.bit_length >= 32u ? 0xFFFFFFFFu : (1u << sample.bit_length) - 1u);
+            }
+            return words;
+        }
+
+        [[nodiscard]] std::vector<uint32_t> rgba8_data_format_descriptor()
+        {
+            constexpr std::array<DfdSample, 4> samples{{{0, 8, 0}, {8, 8, 1}, {16, 8, 2}, {24, 8, 15}}};
+            return data_format_descriptor(k_dfd_model_rgbsda, 1, 4, samples);
+        }
+
+        [[nodiscard]] std::vector<uint32_t> block_data_format_descriptor(TextureFormat format)
+        {
+            switch (format)
+            {
+            case TextureFormat::Bc1:
+                return data_format_descriptor(k_dfd_model_bc1a, 4, 8, std::array<DfdSample, 1>{{{0, 64, 0}}});
+            case TextureFormat::Bc3:
+                return data_format_descriptor(k_dfd_model_bc3, 4, 16, std::array<DfdSample, 2>{{{0, 64, 15}, {64, 64, 0}}});
+            case TextureFormat::Bc5:
+                return data_format_descriptor(k_dfd_model_bc5, 4, 16, std::array<DfdSample, 2>{{{0, 64, 0}, {64, 64, 1}}});
+            case TextureFormat::Bc7:
+            case TextureFormat::Rgba8:
+                break;
+            }
+            return data_format_descriptor(k_dfd_model_bc7, 4, 16, std::array<DfdSample, 1>{{{0, 128, 0}}});
+        }
+
+        [[nodiscard]] std::size_t level_size(TextureFormat format, uint32_t width, uint32_t height) noexcept
+        {
+            if (format == TextureFormat::Rgba8)
+                return static_cast<std::size_t>(width) * height * 4u;
+
+            const std::size_t block_size = format == TextureFormat::Bc1 ? 8u : 16u;
+            return static_cast<std::size_t>((width + 3u) / 4u) * ((height + 3u) / 4u) * block_size;
+        }
+
+        [[noreturn]] void unsupported_ktx2(const std::filesystem::path& path, const char* reason)
+        {
+            throw std::runtime_error("Unsupported KTX2 file " + path.string() + ": " + reason);
+        }
+
+        [[nodiscard]] float srgb_to_linear(float value) noexcept
+        {
+            return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+        }
+
+        [[nodiscard]] float linear_to_srgb(float value) noexcept
+        {
+            return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+        }
+
+        struct SrgbTables final
+        {
+            std::array<float, 256> to_linear{};
+            std::array<unsigned char, k_linear_to_srgb_steps> to_srgb{};
+
+            SrgbTables()
+            {
+                for (std::size_t i = 0; i < to_linear.size(); ++i)
+                    to_linear[i] = srgb_to_linear(static_cast<float>(i) / 255.0f);
+                for (std::size_t i = 0; i < to_srgb.size(); ++i)
+                {
+                    const float linear = static_cast<float>(i) / static_cast<float>(k_linear_to_srgb_steps - 1u);
+                    to_srgb[i] = static_cast<unsigned char>(std::lround(linear_to_srgb(linear) * 255.0f));
+                }
+            }
+        };
+
+        [[nodiscard]] const SrgbTables& srgb_tables()
+        {
+            static const SrgbTables tables;
+            return tables;
+        }
+
+        [[nodiscard]] unsigned char unorm8(float value) noexcept
+        {
+            return static_cast<unsigned char>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+        }
+
+        // Averages the (up to) 2x2 texels of two RGBA8 source rows under each texel of one
+        // destination row; an odd last column is reused.
+        void downsample_row(const unsigned char* src_row0,
+                            const unsigned char* src_row1,
+                            uint32_t src_width,
+                            unsigned char* dst,
+                            uint32_t dst_width,
+                            TextureType type)
+        {
+            const SrgbTables& tables = srgb_tables();
+            const bool srgb = type == TextureType::BaseColor || type == TextureType::Emissive;
+            const std::array<const unsigned char*, 2> rows{src_row0, src_row1};
+
+            for (uint32_t x = 0; x < dst_width; ++x)
+            {
+                const std::array<uint32_t, 2> columns{std::min(x * 2u, src_width - 1u),
+                                                      std::min(x * 2u + 1u, src_width - 1u)};
+                std::array<float, 4> sum{};
+                for (const unsigned char* row : rows)
+                {
+                    for (const uint32_t column : columns)
+                    {
+                        const unsigned char* texel = row + static_cast<std::size_t>(column) * 4u;
+                        for (std::size_t channel = 0; channel < 3; ++channel)
+                        {
+                            if (srgb)
+                                sum[channel] += tables.to_linear[texel[channel]];
+                            else if (type == TextureType::Normal)
+                                sum[channel] += static_cast<float>(texel[channel]) / 127.5f - 1.0f;
+                            else
+                                sum[channel] += static_cast<float>(texel[channel]) / 255.0f;
+                        }
+                        sum[3] += static_cast<float>(texel[3]) / 255.0f;
+                    }
+                }
+
+                unsigned char* out = dst + static_cast<std::size_t>(x) * 4u;
+                if (srgb)
+                {
+                    for (std::size_t channel = 0; channel < 3; ++channel)
+                    {
+                        const float linear = std::clamp(sum[channel] * 0.25f, 0.0f, 1.0f);
+                        out[channel] = tables.to_srgb[static_cast<std::size_t>(
+                            linear * static_cast<float>(k_linear_to_srgb_steps - 1u) + 0.5f)];
+                    }
+                }
+                else if (type == TextureType::Normal)
+                {
+                    const float length = std::sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+                    const float scale = length > 0.0001f ? 1.0f / length : 0.0f;
+                    for (std::size_t channel = 0; channel < 3; ++channel)
+                        out[channel] = unorm8(sum[channel] * scale * 0.5f + 0.5f);
+                    if (length <= 0.0001f)
+                        out[2] = 255u;
+                }
+                else
+                {
+                    for (std::size_t channel = 0; channel < 3; ++channel)
+                        out[channel] = unorm8(sum[channel] * 0.25f);
+                }
+                out[3] = unorm8(sum[3] * 0.25f);
+            }
+        }
+
+        [[nodiscard]] const unsigned char* rgba_row(const unsigned char* level, uint32_t width, uint32_t row) noexcept
+        {
+            return level + static_cast<std::size_t>(row) * width * 4u;
+        }
+    } // namespace
+
+    uint32_t mip_level_count(uint32_t width, uint32_t height) noexcept
+    {
+        return static_cast<uint32_t>(std::bit_width(std::max({width, height, 1u})));
+    }
+
+    PreparedMipChain prepare_mip_chain(const Texture& texture, TextureType type)
+    {
+        auto width = static_cast<uint32_t>(texture.width());
+        auto height = static_cast<uint32_t>(texture.height());
+        const uint32_t level_count = mip_level_count(width, height);
+
+        PreparedMipChain chain;
+        chain.mips.reserve(level_count);
+        for (uint32_t level = 0; level < level_count; ++level)
+        {
+            const std::size_t size = level_size(TextureFormat::Rgba8, width, height);
+            chain.mips.push_back({width, height, chain.size, size});
+            chain.size += size;
+            width = std::max(width / 2u, 1u);
+            height = std::max(height / 2u, 1u);
+        }
+        if (chain.mips.size() < 2)
+            return chain;
+
+        // Mip 1 is filtered from source rows expanded two at a time, so mip 0 is never held in
+        // full; the smaller mips are filtered from the one above.
+        const std::size_t lower_offset = chain.mips[1].offset;
+        chain.lower_mips.resize(chain.size - lower_offset);
+        const TextureMip& top = chain.mips[0];
+        const TextureMip& first = chain.mips[1];
+        const auto components = static_cast<std::size_t>(texture.components());
+        const std::size_t src_row_size = static_cast<std::size_t>(top.width) * components;
+        std::vector<unsigned char> rows(static_cast<std::size_t>(top.width) * 8u);
+        for (uint32_t y = 0; y < first.height; ++y)
+        {
+            const std::array<uint32_t, 2> src_rows{std::min(y * 2u, top.height - 1u),
+                                                   std::min(y * 2u + 1u, top.height - 1u)};
+            for (std::size_t row = 0; row < src_rows.size(); ++row)
+                expand_texels_to_rgba8(texture.pixels().data() + src_rows[row] * src_row_size,
+                                       texture.components(),
+                                       top.width,
+                                       rows.data() + row * top.width * 4u);
+            downsample_row(rows.data(),
+                           rows.data() + static_cast<std::size_t>(top.width) * 4u,
+                           top.width,
+                           chain.lower_mips.data() + static_cast<std::size_t>(y) * first.width * 4u,
+                           first.width,
+                           type);
+        }
+
+        for (std::size_t level = 2; level < chain.mips.size(); ++level)
+        {
+            const TextureMip& src = chain.mips[level - 1];
+            const TextureMip& dst = chain.mips[level];
+            const unsigned char* src_texels = chain.lower_mips.data() + (src.offset - lower_offset);
+            unsigned char* dst_texels = chain.lower_mips.data() + (dst.offset - lower_offset);
+            for (uint32_t y = 0; y < dst.height; ++y)
+                downsample_row(rgba_row(src_texels, src.width, std::min(y * 2u, src.height - 1u)),
+                               rgba_row(src_texels, src.width, std::min(y * 2u + 1u, src.height - 1u)),
+                               src.width,
+                               dst_texels + static_cast<std::size_t>(y) * dst.width * 4u,
+                               dst.width,
+                               type);
+        }
+        return chain;
+    }
+
+    void write_mip_chain(const Texture& texture, const PreparedMipChain& chain, unsigned char* dst) noexcept
+    {
+        if (chain.mips.empty())
+            return;
+        const TextureMip& top = chain.mips.front();
+        expand_texels_to_rgba8(texture.pixels().data(),
+                               texture.components(),
+                               static_cast<std::size_t>(top.width) * top.height,
+                               dst + top.offset);
+        if (!chain.lower_mips.empty())
+            std::memcpy(dst + top.size, chain.lower_mips.data(), chain.lower_mips.size());
+    }
+
+    Texture load_ktx2(const std::filesystem::path& path, uint32_t first_level)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+            throw std::runtime_error("Failed to open KTX2 file: " + path.string());
+        const auto file_size = static_cast<uint64_t>(file.tellg());
+        file.seekg(0);
+
+        std::array<unsigned char, k_ktx2_identifier.size()> identifier{};
+        Ktx2Header header;
+        file.read(reinterpret_cast<char*>(identifier.data()), static_cast<std::streamsize>(identifier.size()));
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        file.seekg(static_cast<std::streamoff>(k_ktx2_sgd_index_size), std::ios::cur);
+        if (!file || identifier != k_ktx2_identifier)
+            unsupported_ktx2(path, "not a KTX2 file");
+
+        const std::optional<TextureFormat> format = texture_format(header.vk_format);
+        if (!format)
+            unsupported_ktx2(path, "texel format is not RGBA8, BC1, BC3, BC5 or BC7");
+        if (header.supercompression_scheme != 0)
+            unsupported_ktx2(path, "supercompressed data");
+        if (header.pixel_width == 0 || header.pixel_height == 0 || header.pixel_depth > 1)
+            unsupported_ktx2(path, "not a 2D texture");
+        if (header.layer_count > 1 || header.face_count != 1)
+            unsupported_ktx2(path, "arrays and cube maps are not supported");
+
+        const bool generate_mips = header.level_count == 0;
+        const uint32_t level_count = std::min(std::max(header.level_count, 1u),
+                                              mip_level_count(header.pixel_width, header.pixel_height));
+        std::vector<Ktx2Level> entries(level_count);
+        file.read(reinterpret_cast<char*>(entries.data()),
+                  static_cast<std::streamsize>(entries.size() * sizeof(Ktx2Level)));
+        if (!file)
+            unsupported_ktx2(path, "truncated level index");
+
+        // Only the requested levels are read, so streaming a texture's small mips stays cheap.
+        first_level = std::min(first_level, level_count - 1u);
+        std::vector<TextureMip> mips;
+        mips.reserve(level_count - first_level);
+        std::vector<unsigned char> data;
+        for (uint32_t level = first_level; level < level_count; ++level)
+        {
+            const Ktx2Level& entry = entries[level];
+            const uint32_t width = std::max(header.pixel_width >> level, 1u);
+            const uint32_t height = std::max(header.pixel_height >> level, 1u);
+            const std::size_t size = level_size(*format, width, height);
+            if (entry.byte_length != size || entry.byte_offset > file_size || file_size - entry.byte_offset < size)
+                unsupported_ktx2(path, "level data does not match its dimensions");
+
+            mips.push_back({width, height, data.size(), size});
+            data.resize(data.size() + size);
+            file.seekg(static_cast<std::streamoff>(entry.byte_offset));
+            file.read(reinterpret_cast<char*>(data.data() + mips.back().offset), static_cast<std::streamsize>(size));
+            if (!file)
+                unsupported_ktx2(path, "truncated level data");
+        }
+
+        if (generate_mips && *format == TextureFormat::Rgba8)
+        {
+            Texture texture{static_cast<int>(header.pixel_width), static_cast<int>(header.pixel_height), 4, std::move(data)};
+            texture.set_cooked_path(path);
+            return texture;
+        }
+        Texture texture{*format, std::move(mips), std::move(data)};
+        texture.set_cooked_path(path);
+        return texture;
+    }
+
+    void write_ktx2(const std::filesystem::path& path, const Texture& texture)
+    {
+        const std::vector<TextureMip>& mips = texture.mips();
+        if (mips.empty() || texture.pixels().empty())
+            throw std::runtime_error("Cannot write a texture without a mip chain to " + path.string());
+
+        std::vector<uint32_t> dfd;
+        if (texture.format() == TextureFormat::Rgba8)
+            dfd = rgba8_data_format_descriptor();
+        else
+            dfd = block_data_format_descriptor(texture.format());
+
+        Ktx2Header header;
+        header.vk_format = static_cast<uint32_t>(vk_format(texture.format()));
+        header.type_size = 1;
+        header.pixel_width = mips.front().width;
+        header.pixel_height = mips.front().height;
+        header.face_count = 1;
+        header.level_count = static_cast<uint32_t>(mips.size());
+        const std::size_t level_index_offset = k_ktx2_identifier.size() + sizeof(header) + k_ktx2_sgd_index_size;
+        header.dfd_byte_offset = static_cast<uint32_t>(level_index_offset + mips.size() * sizeof(Ktx2Level));
+        header.dfd_byte_length = static_cast<uint32_t>(dfd.size() * sizeof(uint32_t));
+
+        // KTX2 stores the smallest level first; every level starts on a 16-byte boundary, which
+        // satisfies the alignment of all supported block sizes.
+        std::vector<Ktx2Level> entries(mips.size());
+        uint64_t offset = header.dfd_byte_offset + header.dfd_byte_length;
+        for (std::size_t level = mips.size(); level-- > 0;)
+        {
+            offset = (offset + 15u) / 16u * 16u;
+            entries[level] = {offset, mips[level].size, mips[level].size};
+            offset += mips[level].size;
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            throw std::runtime_error("Failed to create KTX2 file: " + path.string());
+        const std::array<unsigned char, k_ktx2_sgd_index_size> sgd_index{};
+        file.write(reinterpret_cast<const char*>(k_ktx2_identifier.data()), static_cast<std::streamsize>(k_ktx2_identifier.size()));
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(sgd_index.data()), static_cast<std::streamsize>(sgd_index.size()));
+        file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(Ktx2Level)));
+        file.write(reinterpret_cast<const char*>(dfd.data()), static_cast<std::streamsize>(dfd.size() * sizeof(uint32_t)));
+        for (std::size_t level = mips.size(); level-- > 0;)
+        {
+            const std::array<char, 16> padding{};
+            const auto position = static_cast<uint64_t>(file.tellp());
+            file.write(padding.data(), static_cast<std::streamsize>(entries[level].byte_offset - position));
+            file.write(reinterpret_cast<const char*>(texture.pixels().data() + mips[level].offset),
+                       static_cast<std::streamsize>(mips[level].size));
+        }
+        if (!file)
+            throw std::runtime_error("Failed to write KTX2 file: " + path.string());
+    }
+
+    Texture mip_tail(const Texture& texture, uint32_t first_level)
+    {
+        const std::vector<TextureMip>& mips = texture.mips();
+        if (first_level >= mips.size())
+            throw std::runtime_error("Texture has no mip level " + std::to_string(first_level));
+
+        std::vector<TextureMip> tail(mips.begin() + first_level, mips.end());
+        const std::size_t base_offset = tail.front().offset;
+        for (TextureMip& mip : tail)
+            mip.offset -= base_offset;
+        const auto first = texture.pixels().begin() + static_cast<std::ptrdiff_t>(base_offset);
+        const auto last = texture.pixels().begin() + static_cast<std::ptrdiff_t>(mips.back().offset + mips.back().size);
+        Texture result{texture.format(), std::move(tail), std::vector<unsigned char>(first, last)};
+        result.set_cooked_path(texture.cooked_path());
+        return result;
+    }
+} // namespace rose::core::vulkan
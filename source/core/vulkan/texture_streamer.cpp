@@ -0,0 +1,214 @@
+//
+// Created by orange on 16.10.2026.
+//
+#include "rose/core/vulkan/texture_streamer.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace rose::core::vulkan
+{
+    void TextureStreamer::add(Key key, std::vector<uint64_t> level_bytes, uint32_t tail_level)
+    {
+        if (level_bytes.empty())
+            return;
+
+        Entry entry;
+        entry.resident_bytes.resize(level_bytes.size());
+        uint64_t suffix = 0;
+        for (std::size_t level = level_bytes.size(); level-- > 0;)
+        {
+            suffix += level_bytes[level];
+            entry.resident_bytes[level] = suffix;
+        }
+        entry.tail_level = std::min(tail_level, static_cast<uint32_t>(level_bytes.size() - 1u));
+        entry.resident_level = entry.tail_level;
+        entry.requested_level = entry.tail_level;
+
+        std::lock_guard lock(m_mutex);
+        m_entries.insert_or_assign(key, std::move(entry));
+    }
+
+    void TextureStreamer::request(Key key, uint32_t base_level, uint64_t frame)
+    {
+        std::lock_guard lock(m_mutex);
+        const auto it = m_entries.find(key);
+        if (it == m_entries.end())
+            return;
+
+        Entry& entry = it->second;
+        if (!entry.requested || entry.requested_frame != frame)
+            entry.requested_level = base_level;
+        else
+            entry.requested_level = std::min(entry.requested_level, base_level);
+        entry.requested_frame = frame;
+        entry.requested = true;
+    }
+
+    uint32_t TextureStreamer::wanted_level(const Entry& entry, uint64_t frame) noexcept
+    {
+        if (!entry.requested || frame - entry.requested_frame > k_idle_frames)
+            return entry.tail_level;
+        return std::min(entry.requested_level, entry.tail_level);
+    }
+
+    uint64_t TextureStreamer::committed_bytes(const Entry& entry) noexcept
+    {
+        const uint32_t level = entry.in_flight ? std::min(entry.resident_level, entry.target_level) : entry.resident_level;
+        return entry.resident_bytes[level];
+    }
+
+    std::vector<TextureStreamer::Transition> TextureStreamer::plan(uint64_t frame,
+                                                                   uint64_t budget_bytes,
+                                                                   std::size_t max_transitions)
+    {
+        std::lock_guard lock(m_mutex);
+
+        uint64_t committed = 0;
+        uint64_t pending_free = 0;
+        std::vector<std::pair<Key, Entry*>> victims;
+        std::vector<std::pair<Key, Entry*>> upgrades;
+        for (auto& [key, entry] : m_entries)
+        {
+            committed += committed_bytes(entry);
+            if (entry.in_flight)
+            {
+                if (entry.target_level > entry.resident_level)
+                    pending_free += entry.resident_bytes[entry.resident_level] - entry.resident_bytes[entry.target_level];
+                continue;
+            }
+
+            const uint32_t wanted = wanted_level(entry, frame);
+            if (entry.resident_level < wanted)
+                victims.emplace_back(key, &entry);
+            else if (wanted < entry.resident_level)
+                upgrades.emplace_back(key, &entry);
+        }
+
+        // Least recently drawn detail goes first.
+        std::ranges::sort(victims,
+                          [](const auto& lhs, const auto& rhs)
+                          {
+                              return lhs.second->requested_frame < rhs.second->requested_frame;
+                          });
+        // The largest detail deficit goes first, then the most recently drawn.
+        std::ranges::sort(upgrades,
+                          [frame](const auto& lhs, const auto& rhs)
+                          {
+                              const uint32_t lhs_deficit = lhs.second->resident_level - wanted_level(*lhs.second, frame);
+                              const uint32_t rhs_deficit = rhs.second->resident_level - wanted_level(*rhs.second, frame);
+                              if (lhs_deficit != rhs_deficit)
+                                  return lhs_deficit > rhs_deficit;
+                              return lhs.second->requested_frame > rhs.second->requested_frame;
+                          });
+
+        std::vector<Transition> transitions;
+        auto start = [&](Key key, Entry& entry, uint32_t target_level)
+        {
+            entry.in_flight = true;
+            entry.target_level = target_level;
+            transitions.push_back({key, target_level});
+        };
+
+        std::size_t next_victim = 0;
+        auto evict_until = [&](uint64_t limit)
+        {
+            while (committed > limit + pending_free && next_victim < victims.size() && transitions.size() < max_transitions)
+            {
+                auto& [key, entry] = victims[next_victim++];
+                const uint32_t target_level = wanted_level(*entry, frame);
+                pending_free += entry->resident_bytes[entry->resident_level] - entry->resident_bytes[target_level];
+                start(key, *entry, target_level);
+            }
+        };
+
+        evict_until(budget_bytes);
+
+        for (auto& [key, entry] : upgrades)
+        {
+            if (transitions.size() >= max_transitions)
+                break;
+
+            // Take as much of the wanted detail as fits now and make room for the rest.
+            const uint32_t wanted = wanted_level(*entry, frame);
+            const uint64_t resident = entry->resident_bytes[entry->resident_level];
+            uint32_t target_level = wanted;
+            while (target_level < entry->resident_level
+                   && committed + (entry->resident_bytes[target_level] - resident) > budget_bytes)
+                ++target_level;
+            if (target_level < entry->resident_level)
+            {
+                committed += entry->resident_bytes[target_level] - resident;
+                start(key, *entry, target_level);
+            }
+            if (target_level != wanted)
+            {
+                const uint64_t missing = entry->resident_bytes[wanted] - entry->resident_bytes[target_level];
+                evict_until(budget_bytes > missing ? budget_bytes - missing : 0);
+            }
+        }
+
+        // Still over budget with nothing idle to evict, e.g. after the budget shrank: drop one
+        // level from the least recently drawn textures that hold more than their tail.
+        if (committed > budget_bytes + pending_free)
+        {
+            std::vector<std::pair<Key, Entry*>> pressured;
+            for (auto& [key, entry] : m_entries)
+            {
+                if (!entry.in_flight && entry.resident_level < entry.tail_level)
+                    pressured.emplace_back(key, &entry);
+            }
+            std::ranges::sort(pressured,
+                              [](const auto& lhs, const auto& rhs)
+                              {
+                                  return lhs.second->requested_frame < rhs.second->requested_frame;
+                              });
+            for (auto& [key, entry] : pressured)
+            {
+                if (committed <= budget_bytes + pending_free || transitions.size() >= max_transitions)
+                    break;
+                pending_free += entry->resident_bytes[entry->resident_level]
+                              - entry->resident_bytes[entry->resident_level + 1u];
+                start(key, *entry, entry->resident_level + 1u);
+            }
+        }
+        return transitions;
+    }
+
+    void TextureStreamer::complete(Key key, uint32_t base_level)
+    {
+        std::lock_guard lock(m_mutex);
+        const auto it = m_entries.find(key);
+        if (it == m_entries.end())
+            return;
+
+        Entry& entry = it->second;
+        base_level = std::min(base_level, entry.tail_level);
+        if (base_level > entry.resident_level)
+            m_evicted_bytes += entry.resident_bytes[entry.resident_level] - entry.resident_bytes[base_level];
+        entry.resident_level = base_level;
+        entry.in_flight = false;
+    }
+
+    void TextureStreamer::cancel(Key key)
+    {
+        std::lock_guard lock(m_mutex);
+        if (const auto it = m_entries.find(key); it != m_entries.end())
+            it->second.in_flight = false;
+    }
+
+    TextureStreamer::Stats TextureStreamer::stats() const
+    {
+        std::lock_guard lock(m_mutex);
+        Stats stats;
+        stats.texture_count = m_entries.size();
+        stats.evicted_bytes = m_evicted_bytes;
+        for (const auto& [_, entry] : m_entries)
+        {
+            stats.resident_bytes += entry.resident_bytes[entry.resident_level];
+            if (entry.in_flight)
+                ++stats.transitions_in_flight;
+        }
+        return stats;
+    }
+} // namespace rose::core::vulkan
@@ -0,0 +1,445 @@
+//
+// Created by orange on 16.10.2026.
+//
+#include "rose/core/vulkan/upload_manager.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace rose::core::vulkan
+{
+    namespace
+    {
+        void check_upload_vk(VkResult result, const char* message)
+        {
+            if (result != VK_SUCCESS)
+                throw std::runtime_error(std::string(message) + " (VkResult " + std::to_string(static_cast<int>(result)) + ")");
+        }
+
+        [[nodiscard]] constexpr VkDeviceSize align_up(VkDeviceSize value, VkDeviceSize alignment) noexcept
+        {
+            return alignment <= 1 ? value : (value + alignment - 1) / alignment * alignment;
+        }
+    } // namespace
+
+    UploadManager::UploadManager(VkPhysicalDevice physical_device,
+                                 VkDevice device,
+                                 DeviceAllocator& allocator,
+                                 const UploadQueue& queue,
+                                 VkDeviceSize ring_size)
+        : m_device(device)
+        , m_allocator(allocator)
+        , m_queue(queue)
+        , m_ring_size(ring_size)
+    {
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(physical_device, &properties);
+        m_copy_alignment = std::max<VkDeviceSize>(m_copy_alignment, properties.limits.optimalBufferCopyOffsetAlignment);
+
+        VkCommandPoolCreateInfo pool_info{};
+        pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        pool_info.queueFamilyIndex = m_queue.family;
+        check_upload_vk(vkCreateCommandPool(m_device, &pool_info, nullptr, &m_command_pool),
+                        "Failed to create upload command pool");
+
+        if (m_queue.timeline_semaphore)
+        {
+            VkSemaphoreTypeCreateInfo type_info{};
+            type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+            type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+            type_info.initialValue = 0;
+
+            VkSemaphoreCreateInfo semaphore_info{};
+            semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            semaphore_info.pNext = &type_info;
+            check_upload_vk(vkCreateSemaphore(m_device, &semaphore_info, nullptr, &m_timeline),
+                            "Failed to create upload timeline semaphore");
+        }
+
+        m_ring = create_staging_buffer(m_ring_size);
+        spdlog::info("Vulkan: upload manager ready ring={} MiB queue_family={} dedicated={} tracking={}",
+                     m_ring_size / (1024ull * 1024ull),
+                     m_queue.family,
+                     m_queue.dedicated,
+                     m_queue.timeline_semaphore ? "timeline" : "fence");
+    }
+
+    UploadManager::~UploadManager()
+    {
+        try
+        {
+            wait(m_has_open ? m_open.ticket : m_submitted_ticket);
+        }
+        catch (const std::exception& error)
+        {
+            spdlog::warn("Vulkan: failed to drain uploads during shutdown: {}", error.what());
+        }
+
+        auto release_batch = [this](Batch& batch)
+        {
+            for (StagingBuffer& staging : batch.dedicated_staging)
+                destroy_staging_buffer(staging);
+            if (batch.fence != VK_NULL_HANDLE)
+                vkDestroyFence(m_device, batch.fence, nullptr);
+        };
+        for (Batch& batch : m_in_flight)
+            release_batch(batch);
+        for (Batch& batch : m_free_batches)
+            release_batch(batch);
+
+        destroy_staging_buffer(m_ring);
+        if (m_timeline != VK_NULL_HANDLE)
+            vkDestroySemaphore(m_device, m_timeline, nullptr);
+        if (m_command_pool != VK_NULL_HANDLE)
+            vkDestroyCommandPool(m_device, m_command_pool, nullptr);
+    }
+
+    UploadManager::StagingBuffer UploadManager::create_staging_buffer(VkDeviceSize size)
+    {
+        StagingBuffer staging;
+
+        VkBufferCreateInfo buffer_info{};
+        buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        buffer_info.size = size;
+        buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        check_upload_vk(vkCreateBuffer(m_device, &buffer_info, nullptr, &staging.buffer),
+                        "Failed to create staging buffer");
+
+        VkMemoryRequirements memory_requirements{};
+        vkGetBufferMemoryRequirements(m_device, staging.buffer, &memory_requirements);
+        staging.allocation = m_allocator.allocate(memory_requirements,
+                                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                                                      | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                                  true);
+        check_upload_vk(vkBindBufferMemory(m_device,
+                                           staging.buffer,
+                                           staging.allocation.memory,
+                                           staging.allocation.offset),
+                        "Failed to bind staging buffer memory");
+        if (staging.allocation.mapped == nullptr)
+            throw std::runtime_error("Staging buffer is not host visible");
+        return staging;
+    }
+
+    void UploadManager::destroy_staging_buffer(StagingBuffer& buffer) noexcept
+    {
+        if (buffer.buffer != VK_NULL_HANDLE)
+            vkDestroyBuffer(m_device, buffer.buffer, nullptr);
+        if (buffer.allocation.memory != VK_NULL_HANDLE)
+            m_allocator.free(buffer.allocation);
+        buffer = {};
+    }
+
+    UploadManager::Batch& UploadManager::open_batch()
+    {
+        if (m_has_open)
+            return m_open;
+
+        Batch batch;
+        if (!m_free_batches.empty())
+        {
+            batch = std::move(m_free_batches.back());
+            m_free_batches.pop_back();
+        }
+        else
+        {
+            VkCommandBufferAllocateInfo alloc_info{};
+            alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            alloc_info.commandPool = m_command_pool;
+            alloc_info.commandBufferCount = 1;
+            check_upload_vk(vkAllocateCommandBuffers(m_device, &alloc_info, &batch.command_buffer),
+                            "Failed to allocate upload command buffer");
+
+            if (!m_queue.timeline_semaphore)
+            {
+                VkFenceCreateInfo fence_info{};
+                fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+                check_upload_vk(vkCreateFence(m_device, &fence_info, nullptr, &batch.fence),
+                                "Failed to create upload fence");
+            }
+        }
+
+        VkCommandBufferBeginInfo begin_info{};
+        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        check_upload_vk(vkBeginCommandBuffer(batch.command_buffer, &begin_info), "Failed to begin upload command buffer");
+
+        batch.ticket = m_next_ticket++;
+        batch.ring_bytes = 0;
+        m_open = std::move(batch);
+        m_has_open = true;
+        return m_open;
+    }
+
+    UploadManager::StagingRange UploadManager::stage(VkDeviceSize size)
+    {
+        Batch& batch = open_batch();
+
+        if (m_ring_used == 0)
+            m_ring_head = 0;
+
+        VkDeviceSize offset = align_up(m_ring_head, m_copy_alignment);
+        VkDeviceSize needed = offset - m_ring_head + size;
+        if (offset + size > m_ring_size)
+        {
+            // Wrap: the tail end of the ring is skipped and counted as used until this batch retires.
+            offset = 0;
+            needed = m_ring_size - m_ring_head + size;
+        }
+
+        StagingRange range;
+        if (size <= m_ring_size && m_ring_used + needed <= m_ring_size)
+        {
+            m_ring_head = offset + size;
+            m_ring_used += needed;
+            batch.ring_bytes += needed;
+            range.buffer = m_ring.buffer;
+            range.offset = offset;
+            range.mapped = static_cast<std::byte*>(m_ring.allocation.mapped) + offset;
+        }
+        else
+        {
+            StagingBuffer& staging = batch.dedicated_staging.emplace_back(create_staging_buffer(size));
+            range.buffer = staging.buffer;
+            range.mapped = staging.allocation.mapped;
+        }
+
+        return range;
+    }
+
+    UploadTicket UploadManager::upload_buffer(VkBuffer destination,
+                                              VkDeviceSize destination_offset,
+                                              const void* data,
+                                              VkDeviceSize size)
+    {
+        std::lock_guard lock(m_mutex);
+        const StagingRange source = stage(size);
+        std::memcpy(source.mapped, data, static_cast<std::size_t>(size));
+
+        VkBufferCopy copy_region{};
+        copy_region.srcOffset = source.offset;
+        copy_region.dstOffset = destination_offset;
+        copy_region.size = size;
+        vkCmdCopyBuffer(m_open.command_buffer, source.buffer, destination, 1, &copy_region);
+        return m_open.ticket;
+    }
+
+    UploadTicket UploadManager::upload_image(VkImage destination,
+                                             std::span<const ImageUploadLevel> levels,
+                                             const void* data,
+                                             VkDeviceSize size)
+    {
+        return upload_image(destination,
+                            levels,
+                            size,
+                            [data, size](void* staging)
+                            {
+                                std::memcpy(staging, data, static_cast<std::size_t>(size));
+                            });
+    }
+
+    UploadTicket UploadManager::upload_image(VkImage destination,
+                                             std::span<const ImageUploadLevel> levels,
+                                             VkDeviceSize size,
+                                             const std::function<void(void* staging)>& write)
+    {
+        std::lock_guard lock(m_mutex);
+        const StagingRange source = stage(size);
+        write(source.mapped);
+
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = destination;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = static_cast<uint32_t>(levels.size());
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(m_open.command_buffer,
+                             VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr,
+                             1,
+                             &barrier);
+
+        std::vector<VkBufferImageCopy> regions(levels.size());
+        for (std::size_t level = 0; level < levels.size(); ++level)
+        {
+            VkBufferImageCopy& region = regions[level];
+            region.bufferOffset = source.offset + levels[level].offset;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = static_cast<uint32_t>(level);
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = 1;
+            region.imageOffset = {0, 0, 0};
+            region.imageExtent = {levels[level].width, levels[level].height, 1};
+        }
+        vkCmdCopyBufferToImage(m_open.command_buffer,
+                               source.buffer,
+                               destination,
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               static_cast<uint32_t>(regions.size()),
+                               regions.data());
+
+        // A transfer-only queue cannot name shader stages, so the final transition only orders
+        // against the copy; the consumer is synchronised by the batch's semaphore or fence.
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = 0;
+        vkCmdPipelineBarrier(m_open.command_buffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                             0,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr,
+                             1,
+                             &barrier);
+        return m_open.ticket;
+    }
+
+    UploadTicket UploadManager::flush()
+    {
+        std::lock_guard lock(m_mutex);
+        if (!m_has_open)
+            return m_submitted_ticket;
+
+        check_upload_vk(vkEndCommandBuffer(m_open.command_buffer), "Failed to end upload command buffer");
+
+        VkTimelineSemaphoreSubmitInfo timeline_info{};
+        timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timeline_info.signalSemaphoreValueCount = 1;
+        timeline_info.pSignalSemaphoreValues = &m_open.ticket;
+
+        VkSubmitInfo submit_info{};
+        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = &m_open.command_buffer;
+        if (m_queue.timeline_semaphore)
+        {
+            submit_info.pNext = &timeline_info;
+            submit_info.signalSemaphoreCount = 1;
+            submit_info.pSignalSemaphores = &m_timeline;
+        }
+        check_upload_vk(vkQueueSubmit(m_queue.queue, 1, &submit_info, m_open.fence), "Failed to submit upload batch");
+
+        m_submitted_ticket = m_open.ticket;
+        m_in_flight.push_back(std::move(m_open));
+        m_open = {};
+        m_has_open = false;
+        return m_submitted_ticket;
+    }
+
+    UploadTicket UploadManager::query_completed_ticket() const
+    {
+        if (m_queue.timeline_semaphore)
+        {
+            uint64_t value = 0;
+            check_upload_vk(vkGetSemaphoreCounterValue(m_device, m_timeline, &value),
+                            "Failed to query upload timeline semaphore");
+            return value;
+        }
+
+        UploadTicket completed = m_completed_ticket;
+        for (const Batch& batch : m_in_flight)
+        {
+            if (vkGetFenceStatus(m_device, batch.fence) != VK_SUCCESS)
+                break;
+            completed = batch.ticket;
+        }
+        return completed;
+    }
+
+    void UploadManager::retire_completed(UploadTicket completed)
+    {
+        m_completed_ticket = std::max(m_completed_ticket, completed);
+        while (!m_in_flight.empty() && m_in_flight.front().ticket <= m_completed_ticket)
+        {
+            Batch batch = std::move(m_in_flight.front());
+            m_in_flight.pop_front();
+
+            m_ring_used -= std::min(m_ring_used, batch.ring_bytes);
+            for (StagingBuffer& staging : batch.dedicated_staging)
+                destroy_staging_buffer(staging);
+            batch.dedicated_staging.clear();
+            vkResetCommandBuffer(batch.command_buffer, 0);
+            if (batch.fence != VK_NULL_HANDLE)
+                vkResetFences(m_device, 1, &batch.fence);
+            m_free_batches.push_back(std::move(batch));
+        }
+    }
+
+    void UploadManager::collect()
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_in_flight.empty())
+            return;
+        retire_completed(query_completed_ticket());
+    }
+
+    void UploadManager::wait(UploadTicket ticket)
+    {
+        if (ticket == 0)
+            return;
+
+        flush();
+        std::lock_guard lock(m_mutex);
+        if (ticket <= m_completed_ticket)
+            return;
+
+        if (m_queue.timeline_semaphore)
+        {
+            VkSemaphoreWaitInfo wait_info{};
+            wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+            wait_info.semaphoreCount = 1;
+            wait_info.pSemaphores = &m_timeline;
+            wait_info.pValues = &ticket;
+            check_upload_vk(vkWaitSemaphores(m_device, &wait_info, std::numeric_limits<uint64_t>::max()),
+                            "Failed to wait for upload timeline semaphore");
+        }
+        else
+        {
+            for (const Batch& batch : m_in_flight)
+            {
+                if (batch.ticket > ticket)
+                    break;
+                check_upload_vk(vkWaitForFences(m_device, 1, &batch.fence, VK_TRUE, std::numeric_limits<uint64_t>::max()),
+                                "Failed to wait for upload fence");
+            }
+        }
+        retire_completed(ticket);
+    }
+
+    bool UploadManager::is_complete(UploadTicket ticket) const
+    {
+        std::lock_guard lock(m_mutex);
+        return ticket <= m_completed_ticket;
+    }
+
+    UploadTicket UploadManager::completed_ticket() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_completed_ticket;
+    }
+} // namespace rose::core::vulkan
@@ -8,8 +8,10 @@
 
 #include "rose/core/window_manager.hpp"
 #include "rose/core/collision_world.hpp"
+#include "rose/core/frame_pacer.hpp"
 #include "rose/core/model.hpp"
 #include "rose/core/player.hpp"
+#include "rose/core/profiler.hpp"
 #include "rose/core/vulkan/renderer.hpp"
 #include "rose/plugins/plugin_sdk.hpp"
 
@@ -30,14 +32,21 @@
 #include <chrono>
 #include <cmath>
 #include <condition_variable>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <exception>
+#include <filesystem>
+#include <format>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <string>
+#include <string_view>
 #include <thread>
+#include <utility>
 #include <vector>
 
 static void GlfwErrorCallback(int code, const char* desc)
@@ -155,40 +164,88 @@ static omath::Vector3<float> MatrixForward(const omath::opengl_engine::Mat4X4& m
     });
 }
 
-static bool PickProjectedSphere(const omath::Vector2<float>& screen_position,
-                                const omath::opengl_engine::Camera& camera,
-                                const omath::Vector3<float>& center,
-                                const omath::Vector2<int>& framebuffer_size,
-                                float pixel_radius)
+static void SaveTrace(const std::filesystem::path& path)
 {
-    const auto& view_projection = camera.get_view_projection_matrix();
-    const float clip_x = view_projection.at(0, 0) * center.x
-                       + view_projection.at(0, 1) * center.y
-                       + view_projection.at(0, 2) * center.z
-                       + view_projection.at(0, 3);
-    const float clip_y = view_projection.at(1, 0) * center.x
-                       + view_projection.at(1, 1) * center.y
-                       + view_projection.at(1, 2) * center.z
-                       + view_projection.at(1, 3);
-    const float clip_w = view_projection.at(3, 0) * center.x
-                       + view_projection.at(3, 1) * center.y
-                       + view_projection.at(3, 2) * center.z
-                       + view_projection.at(3, 3);
-    if (clip_w <= 0.0001f)
-        return false;
-
-    const float ndc_x = clip_x / clip_w;
-    const float ndc_y = clip_y / clip_w;
-    const float screen_x = (ndc_x * 0.5f + 0.5f) * static_cast<float>(framebuffer_size.x);
-    const float screen_y = (0.5f - ndc_y * 0.5f) * static_cast<float>(framebuffer_size.y);
-    const float dx = screen_position.x - screen_x;
-    const float dy = screen_position.y - screen_y;
-    return dx * dx + dy * dy <= pixel_radius * pixel_radius;
+    try
+    {
+        rose::core::profiler::write_chrome_trace(path);
+        spdlog::info("Saved CPU trace to {}", path.string());
+    }
+    catch (const std::exception& exception)
+    {
+        spdlog::error("Failed to save CPU trace: {}", exception.what());
+    }
+}
+
+// Zones of one frame, one row per nesting level and thread, clipped to [begin_ns, end_ns].
+static void DrawCpuTimeline(const std::vector<rose::core::profiler::ThreadTimeline>& timelines,
+                            const uint64_t begin_ns,
+                            const uint64_t end_ns)
+{
+    constexpr float label_width = 110.0f;
+    constexpr float timeline_width = 520.0f;
+    const float row_height = ImGui::GetTextLineHeight() + 4.0f;
+    const double span_ns = static_cast<double>(std::max<uint64_t>(end_ns - begin_ns, 1));
+
+    std::size_t row_count = 0;
+    for (const auto& timeline : timelines)
+    {
+        uint32_t depth_count = 0;
+        for (const auto& zone : timeline.zones)
+            depth_count = std::max(depth_count, zone.depth + 1u);
+        row_count += depth_count;
+    }
+    if (row_count == 0)
+    {
+        ImGui::TextUnformatted("No zones were recorded in the last frame.");
+        return;
+    }
+
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    const ImVec2 mouse = ImGui::GetIO().MousePos;
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    const float bars_x = origin.x + label_width;
+    const float row_width = timeline_width - label_width;
+    float y = origin.y;
+    for (const auto& timeline : timelines)
+    {
+        if (timeline.zones.empty())
+            continue;
+
+        draw_list->AddText({origin.x, y + 2.0f}, ImGui::GetColorU32(ImGuiCol_Text), timeline.name.c_str());
+        uint32_t depth_count = 0;
+        for (const auto& zone : timeline.zones)
+        {
+            depth_count = std::max(depth_count, zone.depth + 1u);
+
+            const uint64_t start = std::clamp(zone.start_ns, begin_ns, end_ns);
+            const uint64_t end = std::clamp(zone.end_ns, begin_ns, end_ns);
+            const ImVec2 min{bars_x + static_cast<float>(static_cast<double>(start - begin_ns) / span_ns) * row_width,
+                             y + static_cast<float>(zone.depth) * row_height};
+            const ImVec2 max{std::max(bars_x + static_cast<float>(static_cast<double>(end - begin_ns) / span_ns) * row_width,
+                                      min.x + 1.0f),
+                             min.y + row_height - 1.0f};
+
+            const float hue = static_cast<float>(std::hash<std::string_view>{}(zone.name) % 360u) / 360.0f;
+            draw_list->AddRectFilled(min, max, ImColor::HSV(hue, 0.55f, 0.75f));
+            if (max.x - min.x > 24.0f)
+            {
+                draw_list->PushClipRect(min, max, true);
+                draw_list->AddText({min.x + 3.0f, min.y + 1.0f}, IM_COL32(0, 0, 0, 255), zone.name);
+                draw_list->PopClipRect();
+            }
+            if (mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y)
+                ImGui::SetTooltip("%s\n%.3f ms", zone.name, static_cast<double>(zone.end_ns - zone.start_ns) / 1.0e6);
+        }
+        y += static_cast<float>(depth_count) * row_height + 4.0f;
+    }
+    ImGui::Dummy({timeline_width, y - origin.y});
 }
 
 namespace rose::core
 {
-    WindowManager::WindowManager()
+    WindowManager::WindowManager(LaunchOptions options)
+        : m_options(std::move(options))
     {
         glfwSetErrorCallback(GlfwErrorCallback);
         if (!glfwInit())
@@ -239,6 +296,8 @@ namespace rose::core
 
     void WindowManager::run()
     {
+        ROSE_PROFILE_THREAD("Main");
+
         const boost::dll::fs::path lib_path("rose.stream.dll");
         using pluginapi_create_t = std::shared_ptr<StreamPluginApi>();
         std::shared_ptr<StreamPluginApi> plugin;
@@ -276,6 +335,7 @@ namespace rose::core
                  &stream_worker_busy,
                  &stop_stream_worker]
                 {
+                    ROSE_PROFILE_THREAD("Stream worker");
                     bool poll_error_logged = false;
                     bool push_error_logged = false;
                     while (true)
@@ -317,6 +377,7 @@ namespace rose::core
                         stream_worker_busy.store(true, std::memory_order_release);
                         try
                         {
+                            ROSE_PROFILE_ZONE("Encode and push stream frame");
                             std::vector<std::byte> bmp = EncodeStreamFrame(*frame);
                             if (!bmp.empty())
                                 plugin->push_frame(bmp);
@@ -351,6 +412,7 @@ namespace rose::core
         };
 
         auto map = Model("map2.glb");
+        m_renderer->prepare(map);
 
         spdlog::info("Building {} map colliders...", map.get_meshes().size());
         std::vector<CollisionWorld::Collider> raw_colliders;
@@ -379,6 +441,11 @@ namespace rose::core
         auto sun_marker = CreateSunMarkerMesh();
         auto sun_settings = m_renderer->sun_settings();
         sun_marker.cpu_mesh().set_origin(Normalized(-sun_settings.direction) * 18.0f);
+        // Sampler changes rebuild every material descriptor, so sliders apply on release.
+        auto texture_settings = m_renderer->texture_settings();
+        auto texture_streaming_settings = m_renderer->texture_streaming_settings();
+        // Applying a latency profile rebuilds the swapchain, so the image count applies on release.
+        auto latency_profile = m_renderer->latency_profile();
 
         constexpr float radians_per_degree = 3.14159265358979323846f / 180.0f;
         constexpr float degrees_per_radian = 180.0f / 3.14159265358979323846f;
@@ -388,12 +455,18 @@ namespace rose::core
         bool   insert_was_pressed = false;
         bool   fullscreen = false;
         bool   f11_was_pressed = false;
+        bool   f9_was_pressed = false;
+        bool   cpu_timeline_frozen = false;
+        std::vector<profiler::ThreadTimeline> cpu_timeline;
+        uint64_t cpu_timeline_begin_ns = 0;
+        uint64_t cpu_timeline_end_ns = 0;
         int    windowed_x = 0;
         int    windowed_y = 0;
         int    windowed_width = m_window_size.x;
         int    windowed_height = m_window_size.y;
         bool   restore_mouse_capture_after_overlay = false;
-        bool   fps_cap_enabled = true;
+        FramePacingMode pacing_mode = FramePacingMode::FixedRate;
+        FramePacer frame_pacer;
         bool   auto_bhop = false;
         bool   wallrun_enabled = false;
         float  ground_max_slope_degrees = std::acos(Player::k_floor_dot) * degrees_per_radian;
@@ -446,9 +519,33 @@ namespace rose::core
             first_mouse = true;
         };
 
+        const auto timestamped_trace_path = []
+        {
+            const auto now = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+            return std::filesystem::path(std::format("rose_trace_{:%Y%m%d_%H%M%S}.json", now));
+        };
+
         while (!glfwWindowShouldClose(m_window))
         {
-            glfwPollEvents();
+            ROSE_PROFILE_FRAME();
+            ROSE_PROFILE_ZONE("Frame");
+            // Input is sampled once the previous frame is on its way to the display, so it is
+            // as fresh as the swapchain allows.
+            if (pacing_mode == FramePacingMode::Display)
+                m_renderer->wait_for_present(1, 100'000'000);
+            {
+                ROSE_PROFILE_ZONE("Poll events");
+                glfwPollEvents();
+                m_renderer->mark_input_sampled();
+            }
+
+            // Clicks are answered by the GPU a frame or two after they were drawn.
+            if (const std::optional<vulkan::PickResult> pick = m_renderer->take_pick_result())
+            {
+                spotlight_selected = pick->mesh == &spotlight_marker;
+                sun_selected = pick->mesh == &sun_marker;
+                selected_mesh = map.mesh_index(pick->mesh);
+            }
 
             const double current_time = glfwGetTime();
             const float delta_time = std::min(static_cast<float>(current_time - last_time), 0.05f);
@@ -507,8 +604,33 @@ namespace rose::core
                 toggle_fullscreen();
             f11_was_pressed = f11_pressed;
 
+            const bool f9_pressed = glfwGetKey(m_window, GLFW_KEY_F9) == GLFW_PRESS;
+            if (f9_pressed && !f9_was_pressed && profiler::k_enabled)
+                SaveTrace(timestamped_trace_path());
+            f9_was_pressed = f9_pressed;
+
+            const vulkan::ResidencyProgress residency = m_renderer->residency_progress();
+            if (!residency.complete())
+            {
+                const ImGuiIO& io = ImGui::GetIO();
+                ImGui::SetNextWindowPos({io.DisplaySize.x * 0.5f, io.DisplaySize.y - 48.0f}, ImGuiCond_Always, {0.5f, 1.0f});
+                ImGui::SetNextWindowBgAlpha(0.6f);
+                ImGui::Begin("Streaming",
+                             nullptr,
+                             ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize
+                                 | ImGuiWindowFlags_NoInputs | ImGuiWindowFlags_NoSavedSettings);
+                const float fraction = residency.requested_meshes == 0
+                                     ? 1.0f
+                                     : static_cast<float>(residency.resident_meshes)
+                                           / static_cast<float>(residency.requested_meshes);
+                ImGui::Text("Streaming map: %zu / %zu meshes", residency.resident_meshes, residency.requested_meshes);
+                ImGui::ProgressBar(fraction, {240.0f, 0.0f});
+                ImGui::End();
+            }
+
             if (overlay_open)
             {
+                ROSE_PROFILE_ZONE("Overlay UI");
                 bool imgui_window_open = true;
                 ImGui::SetNextWindowPos({16.f, 16.f}, ImGuiCond_FirstUseEver);
                 ImGui::SetNextWindowSize({320.f, 0.f}, ImGuiCond_FirstUseEver);
@@ -523,10 +645,33 @@ namespace rose::core
                 {
                     if (ImGui::BeginTabItem("General"))
                     {
-                        ImGui::Checkbox("FPS cap", &fps_cap_enabled);
-                        ImGui::BeginDisabled(!fps_cap_enabled);
+                        int pacing_mode_index = static_cast<int>(pacing_mode);
+                        if (ImGui::Combo("Frame pacing",
+                                         &pacing_mode_index,
+                                         "Unpaced\0FPS limit\0Stream rate\0Display (present wait)\0"))
+                        {
+                            pacing_mode = static_cast<FramePacingMode>(pacing_mode_index);
+                            if (pacing_mode == FramePacingMode::Display && !m_renderer->present_wait_supported())
+                            {
+                                spdlog::warn("Display pacing needs VK_KHR_present_wait; using the FPS limit");
+                                pacing_mode = FramePacingMode::FixedRate;
+                            }
+                        }
+                        ImGui::BeginDisabled(pacing_mode != FramePacingMode::FixedRate
+                                             && pacing_mode != FramePacingMode::StreamRate);
                         ImGui::SliderInt("FPS limit", &fps_limit, 30, 360);
                         ImGui::EndDisabled();
+                        const FramePacingStats pacing = frame_pacer.stats();
+                        ImGui::Text("Frame %.2f ms, jitter %.2f ms, p99 %.2f ms, max %.2f ms",
+                                    pacing.mean_ms,
+                                    pacing.jitter_ms,
+                                    pacing.p99_ms,
+                                    pacing.max_ms);
+                        ImGui::Text("Late frames %zu / %zu, wake guard %.2f ms, yielding %.2f ms/frame",
+                                    pacing.late_frames,
+                                    pacing.samples,
+                                    pacing.oversleep_ms,
+                                    pacing.spin_ms);
                         ImGui::Checkbox("Auto bhop", &auto_bhop);
                         ImGui::Checkbox("Wallrun", &wallrun_enabled);
                         if (ImGui::SliderFloat("Ground max slope", &ground_max_slope_degrees, 0.0f, 89.0f, "%.1f deg"))
@@ -555,12 +700,12 @@ namespace rose::core
                         bloom_settings_changed |= ImGui::SliderFloat("Bloom radius",
                                                                      &bloom_settings.radius,
                                                                      0.0f,
-                                                                     16.0f,
-                                                                     "%.1f px");
-                        bloom_settings_changed |= ImGui::SliderInt("Bloom quality",
-                                                                   &bloom_settings.quality,
+                                                                     4.0f,
+                                                                     "%.2f texels");
+                        bloom_settings_changed |= ImGui::SliderInt("Bloom levels",
+                                                                   &bloom_settings.levels,
                                                                    1,
-                                                                   64);
+                                                                   vulkan::BloomSettings::k_max_levels);
                         ImGui::EndDisabled();
                         if (bloom_settings_changed)
                             m_renderer->set_bloom_settings(bloom_settings);
@@ -604,15 +749,125 @@ namespace rose::core
                                                           0.0f,
                                                           10.0f,
                                                           "%.2f");
-                        sun_changed |= ImGui::SliderFloat("Sun shadow area",
+                        sun_changed |= ImGui::SliderFloat("Sun shadow distance",
                                                           &sun_settings.shadow_distance,
                                                           5.0f,
                                                           200.0f,
                                                           "%.1f m");
+                        sun_changed |= ImGui::SliderInt("Sun cascades", &sun_settings.cascade_count, 1, 4);
+                        constexpr int cascade_resolutions[] = {512, 1024, 2048, 4096};
+                        constexpr const char* cascade_resolution_labels[] = {"512", "1024", "2048", "4096"};
+                        int cascade_resolution_index = 0;
+                        for (std::size_t i = 0; i < std::size(cascade_resolutions); ++i)
+                            if (cascade_resolutions[i] == sun_settings.cascade_resolution)
+                                cascade_resolution_index = static_cast<int>(i);
+                        if (ImGui::Combo("Cascade resolution",
+                                         &cascade_resolution_index,
+                                         cascade_resolution_labels,
+                                         static_cast<int>(std::size(cascade_resolution_labels))))
+                        {
+                            sun_settings.cascade_resolution = cascade_resolutions[cascade_resolution_index];
+                            sun_changed = true;
+                        }
+                        sun_changed |= ImGui::SliderFloat("Cascade split",
+                                                          &sun_settings.split_lambda,
+                                                          0.0f,
+                                                          1.0f,
+                                                          "%.2f");
                         ImGui::EndDisabled();
                         if (sun_changed)
                             m_renderer->set_sun_settings(sun_settings);
 
+                        ImGui::Separator();
+                        bool texture_settings_changed = false;
+                        ImGui::SliderFloat("Anisotropy", &texture_settings.max_anisotropy, 1.0f, 16.0f, "%.0fx");
+                        texture_settings_changed |= ImGui::IsItemDeactivatedAfterEdit();
+                        ImGui::SliderFloat("Texture LOD bias", &texture_settings.lod_bias, -2.0f, 2.0f, "%.2f");
+                        texture_settings_changed |= ImGui::IsItemDeactivatedAfterEdit();
+                        texture_settings_changed |= ImGui::Checkbox("Mipmaps", &texture_settings.mipmaps);
+                        if (texture_settings_changed)
+                        {
+                            m_renderer->set_texture_settings(texture_settings);
+                            texture_settings = m_renderer->texture_settings();
+                        }
+
+                        auto texture_budget = static_cast<int>(texture_streaming_settings.budget_mib);
+                        if (ImGui::SliderInt("Texture budget", &texture_budget, 64, 8192, "%d MiB"))
+                            texture_streaming_settings.budget_mib = static_cast<uint32_t>(texture_budget);
+                        if (ImGui::IsItemDeactivatedAfterEdit())
+                        {
+                            m_renderer->set_texture_streaming_settings(texture_streaming_settings);
+                            texture_streaming_settings = m_renderer->texture_streaming_settings();
+                        }
+                        const vulkan::TextureStreamingStats streaming = m_renderer->texture_streaming_stats();
+                        ImGui::Text("Streamed textures: %zu, %.1f / %.1f MiB resident, %zu in flight, %.1f MiB evicted%s",
+                                    streaming.streamed_textures,
+                                    static_cast<double>(streaming.resident_bytes) / (1024.0 * 1024.0),
+                                    static_cast<double>(streaming.budget_bytes) / (1024.0 * 1024.0),
+                                    streaming.transitions_in_flight,
+                                    static_cast<double>(streaming.evicted_bytes) / (1024.0 * 1024.0),
+                                    streaming.memory_budget_extension ? "" : " (no VK_EXT_memory_budget)");
+
+                        ImGui::Separator();
+                        bool latency_profile_changed = false;
+                        if (ImGui::Button("Low latency"))
+                        {
+                            latency_profile = vulkan::LatencyProfile::low_latency();
+                            latency_profile_changed = true;
+                        }
+                        ImGui::SameLine();
+                        if (ImGui::Button("Balanced"))
+                        {
+                            latency_profile = vulkan::LatencyProfile::balanced();
+                            latency_profile_changed = true;
+                        }
+                        ImGui::SameLine();
+                        if (ImGui::Button("Throughput"))
+                        {
+                            latency_profile = vulkan::LatencyProfile::throughput();
+                            latency_profile_changed = true;
+                        }
+                        int present_mode = static_cast<int>(latency_profile.present_mode);
+                        if (ImGui::Combo("Present mode", &present_mode, "Immediate\0Mailbox\0FIFO\0FIFO relaxed\0"))
+                        {
+                            latency_profile.present_mode = static_cast<vulkan::PresentMode>(present_mode);
+                            latency_profile_changed = true;
+                        }
+                        auto frames_in_flight = static_cast<int>(latency_profile.frames_in_flight);
+                        if (ImGui::SliderInt("Frames in flight", &frames_in_flight, 1, 3))
+                            latency_profile.frames_in_flight = static_cast<uint32_t>(frames_in_flight);
+                        latency_profile_changed |= ImGui::IsItemDeactivatedAfterEdit();
+                        auto swapchain_images = static_cast<int>(latency_profile.swapchain_images);
+                        if (ImGui::SliderInt("Swapchain images", &swapchain_images, 0, 4, swapchain_images == 0 ? "Auto" : "%d"))
+                            latency_profile.swapchain_images = static_cast<uint32_t>(swapchain_images);
+                        latency_profile_changed |= ImGui::IsItemDeactivatedAfterEdit();
+                        if (latency_profile_changed)
+                        {
+                            m_renderer->set_latency_profile(latency_profile);
+                            latency_profile = m_renderer->latency_profile();
+                        }
+                        constexpr const char* present_mode_labels[] = {"Immediate", "Mailbox", "FIFO", "FIFO relaxed"};
+                        const vulkan::LatencyStats latency = m_renderer->latency_stats();
+                        ImGui::Text("%s, %u images, %u in flight",
+                                    present_mode_labels[static_cast<int>(latency.present_mode)],
+                                    latency.swapchain_images,
+                                    latency.frames_in_flight);
+                        ImGui::Text("Input to %s: %.1f ms mean, p50 %.1f, p95 %.1f, p99 %.1f ms",
+                                    latency.to_display ? "display" : "GPU done",
+                                    latency.mean_ms,
+                                    latency.p50_ms,
+                                    latency.p95_ms,
+                                    latency.p99_ms);
+                        bool late_latch = m_renderer->late_latch_enabled();
+                        if (ImGui::Checkbox("Late-latch camera", &late_latch))
+                            m_renderer->set_late_latch_enabled(late_latch);
+                        const vulkan::LateLatchStats late_latch_stats = m_renderer->late_latch_stats();
+                        ImGui::Text("Latched %.1f ms after input (p95 %.1f ms), turning %.2f deg mean, %.2f deg max",
+                                    late_latch_stats.mean_ms,
+                                    late_latch_stats.p95_ms,
+                                    late_latch_stats.mean_degrees,
+                                    late_latch_stats.max_degrees);
+
                         ImGui::Separator();
                         bool dlss_enabled = m_renderer->dlss_enabled();
                         ImGui::BeginDisabled(!m_renderer->dlss_available());
@@ -635,6 +890,129 @@ namespace rose::core
                             m_renderer->set_dlss_quality(static_cast<vulkan::DlssQuality>(dlss_quality));
                         ImGui::EndDisabled();
                         ImGui::TextWrapped("%s", m_renderer->dlss_status().c_str());
+
+                        ImGui::Separator();
+                        bool gpu_driven = m_renderer->gpu_driven_enabled();
+                        ImGui::BeginDisabled(!m_renderer->gpu_driven_supported());
+                        if (ImGui::Checkbox("GPU-driven draws", &gpu_driven))
+                            m_renderer->set_gpu_driven_enabled(gpu_driven);
+                        ImGui::BeginDisabled(!m_renderer->gpu_driven_enabled());
+                        bool gpu_culling = m_renderer->gpu_culling_enabled();
+                        if (ImGui::Checkbox("GPU culling", &gpu_culling))
+                            m_renderer->set_gpu_culling_enabled(gpu_culling);
+                        bool occlusion_culling = m_renderer->occlusion_culling_enabled();
+                        ImGui::BeginDisabled(!gpu_culling);
+                        if (ImGui::Checkbox("Occlusion culling", &occlusion_culling))
+                            m_renderer->set_occlusion_culling_enabled(occlusion_culling);
+                        ImGui::EndDisabled();
+                        ImGui::EndDisabled();
+                        ImGui::EndDisabled();
+
+                        ImGui::Separator();
+                        if (ImGui::Button("Reload shaders"))
+                            m_renderer->reload_shaders();
+                        ImGui::SameLine();
+                        ImGui::TextUnformatted(m_renderer->shader_reload_status().c_str());
+
+                        ImGui::Separator();
+                        ImGui::TextUnformatted("GPU memory");
+                        for (const vulkan::MemoryHeapStats& heap : m_renderer->memory_stats())
+                        {
+                            constexpr double mib = 1024.0 * 1024.0;
+                            ImGui::Text("Heap %u (%s): %.1f / %.1f MiB in %u block(s), %u dedicated, %u allocation(s)",
+                                        heap.heap_index,
+                                        heap.device_local ? "device" : "host",
+                                        static_cast<double>(heap.used_bytes) / mib,
+                                        static_cast<double>(heap.reserved_bytes) / mib,
+                                        heap.block_count,
+                                        heap.dedicated_count,
+                                        heap.allocation_count);
+                        }
+                        ImGui::EndTabItem();
+                    }
+
+                    if (ImGui::BeginTabItem("Profiler"))
+                    {
+                        const vulkan::GpuProfile profile = m_renderer->gpu_profile();
+                        bool profiler_enabled = m_renderer->gpu_profiler_enabled();
+                        ImGui::BeginDisabled(!profile.timestamps_supported);
+                        if (ImGui::Checkbox("GPU timings", &profiler_enabled))
+                            m_renderer->set_gpu_profiler_enabled(profiler_enabled);
+                        ImGui::EndDisabled();
+                        ImGui::SameLine();
+                        bool statistics_enabled = m_renderer->gpu_pipeline_statistics_enabled();
+                        ImGui::BeginDisabled(!profile.pipeline_statistics_supported);
+                        if (ImGui::Checkbox("Pipeline statistics", &statistics_enabled))
+                            m_renderer->set_gpu_pipeline_statistics_enabled(statistics_enabled);
+                        ImGui::EndDisabled();
+                        if (!profile.timestamps_supported)
+                            ImGui::TextUnformatted("The graphics queue does not support timestamps.");
+
+                        const auto plot = [](const char* label,
+                                             const std::vector<float>& samples,
+                                             const vulkan::GpuTimingPercentiles& percentiles)
+                        {
+                            const std::string overlay = std::format("p50 {:.2f}  p95 {:.2f}  p99 {:.2f} ms",
+                                                                    percentiles.p50,
+                                                                    percentiles.p95,
+                                                                    percentiles.p99);
+                            ImGui::PlotLines(label,
+                                             samples.data(),
+                                             static_cast<int>(samples.size()),
+                                             0,
+                                             overlay.c_str(),
+                                             0.0f,
+                                             std::max(percentiles.p99 * 1.25f, 0.1f),
+                                             {0.0f, 40.0f});
+                        };
+                        plot("GPU frame", profile.frame_ms, profile.frame_percentiles);
+                        for (std::size_t pass = 0; pass < vulkan::k_gpu_pass_count; ++pass)
+                            plot(vulkan::gpu_pass_name(static_cast<vulkan::GpuPass>(pass)),
+                                 profile.pass_ms[pass],
+                                 profile.pass_percentiles[pass]);
+
+                        if (profile.statistics)
+                        {
+                            ImGui::Separator();
+                            ImGui::TextUnformatted("Scene pass");
+                            ImGui::Text("Vertices: %llu, primitives: %llu",
+                                        static_cast<unsigned long long>(profile.statistics->input_assembly_vertices),
+                                        static_cast<unsigned long long>(profile.statistics->input_assembly_primitives));
+                            ImGui::Text("Vertex shader invocations: %llu",
+                                        static_cast<unsigned long long>(profile.statistics->vertex_shader_invocations));
+                            ImGui::Text("Clipping primitives: %llu",
+                                        static_cast<unsigned long long>(profile.statistics->clipping_primitives));
+                            ImGui::Text("Fragment shader invocations: %llu",
+                                        static_cast<unsigned long long>(profile.statistics->fragment_shader_invocations));
+                            ImGui::Text("Compute shader invocations: %llu",
+                                        static_cast<unsigned long long>(profile.statistics->compute_shader_invocations));
+                        }
+
+                        ImGui::Separator();
+                        if (!profiler::k_enabled)
+                        {
+                            ImGui::TextUnformatted("CPU zones are compiled out (ROSE_ENABLE_PROFILER=OFF).");
+                        }
+                        else
+                        {
+                            ImGui::Checkbox("Freeze CPU timeline", &cpu_timeline_frozen);
+                            ImGui::SameLine();
+                            if (ImGui::Button("Save trace (F9)"))
+                                SaveTrace(timestamped_trace_path());
+
+                            // The newest mark opened this frame, so the two before it bound the
+                            // last complete one.
+                            const std::vector<uint64_t> frame_marks = profiler::frame_marks();
+                            if (!cpu_timeline_frozen && frame_marks.size() >= 2)
+                            {
+                                cpu_timeline_begin_ns = frame_marks[frame_marks.size() - 2];
+                                cpu_timeline_end_ns = frame_marks.back();
+                                cpu_timeline = profiler::capture(cpu_timeline_begin_ns, cpu_timeline_end_ns);
+                            }
+                            ImGui::Text("CPU frame %.3f ms",
+                                        static_cast<double>(cpu_timeline_end_ns - cpu_timeline_begin_ns) / 1.0e6);
+                            DrawCpuTimeline(cpu_timeline, cpu_timeline_begin_ns, cpu_timeline_end_ns);
+                        }
                         ImGui::EndTabItem();
                     }
 
@@ -852,6 +1230,7 @@ namespace rose::core
                 && !ImGuizmo::IsOver()
                 && !ImGuizmo::IsUsing())
             {
+                ROSE_PROFILE_ZONE("Pick");
                 double cursor_x = 0.0;
                 double cursor_y = 0.0;
                 glfwGetCursorPos(m_window, &cursor_x, &cursor_y);
@@ -871,24 +1250,7 @@ namespace rose::core
                     static_cast<float>(cursor_x) * scale_x,
                     static_cast<float>(cursor_y) * scale_y
                 };
-                if (PickProjectedSphere(screen_position, camera, spotlight_marker.cpu_mesh().get_origin(), framebuffer, 22.0f))
-                {
-                    spotlight_selected = true;
-                    sun_selected = false;
-                    selected_mesh.reset();
-                }
-                else if (PickProjectedSphere(screen_position, camera, sun_marker.cpu_mesh().get_origin(), framebuffer, 26.0f))
-                {
-                    spotlight_selected = false;
-                    sun_selected = true;
-                    selected_mesh.reset();
-                }
-                else
-                {
-                    selected_mesh = map.pick_mesh(screen_position, camera);
-                    spotlight_selected = false;
-                    sun_selected = false;
-                }
+                m_renderer->request_pick(screen_position);
             }
             left_mouse_was_pressed = left_mouse_pressed;
 
@@ -900,20 +1262,42 @@ namespace rose::core
 
             ImGui::Render();
 
+            const bool stream_paced = pacing_mode == FramePacingMode::StreamRate
+                                   && plugin != nullptr
+                                   && stream_ready.load(std::memory_order_acquire);
+
             if (m_renderer->begin_frame())
             {
+                ROSE_PROFILE_ZONE("Render");
+                if (mouse_captured && !first_mouse)
+                {
+                    m_renderer->late_latch_camera(camera, [&]
+                    {
+                        // A captured cursor is virtual and only moves while events are processed.
+                        glfwPollEvents();
+                        double mx = 0.0;
+                        double my = 0.0;
+                        glfwGetCursorPos(m_window, &mx, &my);
+                        player.apply_late_look(static_cast<float>(mx - last_mouse_x), static_cast<float>(my - last_mouse_y));
+                        last_mouse_x = mx;
+                        last_mouse_y = my;
+                        camera.set_view_angles(player.get_view_angles());
+                    });
+                }
                 map.draw(*m_renderer, camera, selected_mesh);
-                m_renderer->draw_mesh(spotlight_marker, camera);
+                m_renderer->draw_mesh(spotlight_marker, camera, vulkan::MeshMobility::Dynamic);
                 if (spotlight_selected)
                     m_renderer->draw_mesh_outline(spotlight_marker, camera);
-                m_renderer->draw_mesh(sun_marker, camera);
+                m_renderer->draw_mesh(sun_marker, camera, vulkan::MeshMobility::Dynamic);
                 if (sun_selected)
                     m_renderer->draw_mesh_outline(sun_marker, camera);
                 m_renderer->render_imgui(ImGui::GetDrawData());
 
+                // Frames paced to the capture rate are all captured; a deadline would drop every
+                // frame that started a little early.
                 bool capture_frame = false;
                 if (plugin != nullptr
-                    && current_time >= next_stream_capture_time
+                    && (stream_paced || current_time >= next_stream_capture_time)
                     && stream_ready.load(std::memory_order_acquire)
                     && !stream_worker_busy.load(std::memory_order_acquire)
                     && !stream_has_pending_frame())
@@ -929,16 +1313,14 @@ namespace rose::core
             framebuffer = m_renderer->framebuffer_size();
             camera.set_view_port({static_cast<float>(framebuffer.x), static_cast<float>(framebuffer.y)});
 
-            if (fps_cap_enabled)
-            {
-                fps_limit = std::clamp(fps_limit, 1, 1000);
-                const double frame_target = current_time + 1.0 / static_cast<double>(fps_limit);
-                const double sleep_s = frame_target - 0.002 - glfwGetTime();
-                if (sleep_s > 0.0)
-                    std::this_thread::sleep_for(std::chrono::duration<double>(sleep_s));
-                while (glfwGetTime() < frame_target)
-                    ;
-            }
+            if (pacing_mode == FramePacingMode::FixedRate
+                || (pacing_mode == FramePacingMode::StreamRate && !stream_paced))
+                frame_pacer.set_target_rate(static_cast<double>(std::clamp(fps_limit, 1, 1000)));
+            else if (stream_paced)
+                frame_pacer.set_target_rate(1.0 / stream_capture_interval);
+            else
+                frame_pacer.set_target_rate(0.0);
+            frame_pacer.wait();
         }
 
         if (stream_worker.joinable())
@@ -953,5 +1335,8 @@ namespace rose::core
         }
 
         m_renderer->wait_idle();
+
+        if (m_options.trace_path && profiler::k_enabled)
+            SaveTrace(*m_options.trace_path);
     }
 } // namespace rose::core
@@ -2,12 +2,43 @@
 // Created by orange on 29.01.2026.
 //
 
+#include "rose/core/culling_benchmark.hpp"
 #include "rose/core/window_manager.hpp"
 #include <boost/dll.hpp>
+#include <spdlog/spdlog.h>
 #include <filesystem>
+#include <string_view>
 #include <thread>
-int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
+
+// --trace[=path]: write a Chrome trace of the CPU profiler when the window closes.
+// --benchmark-culling: time frustum culling on a synthetic scene and exit.
+static rose::core::LaunchOptions ParseLaunchOptions(int argc, char** argv)
 {
-    rose::core::WindowManager window_manager;
+    rose::core::LaunchOptions options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view argument = argv[i];
+        if (argument == "--trace")
+            options.trace_path = "rose_trace.json";
+        else if (argument.starts_with("--trace="))
+            options.trace_path = std::filesystem::path(argument.substr(std::string_view("--trace=").size()));
+        else if (argument == "--benchmark-culling")
+            options.benchmark_culling = true;
+        else
+            spdlog::warn("Ignoring unknown argument: {}", argument);
+    }
+    return options;
+}
+
+int main(int argc, char** argv)
+{
+    const rose::core::LaunchOptions options = ParseLaunchOptions(argc, argv);
+    if (options.benchmark_culling)
+    {
+        rose::core::run_culling_benchmark();
+        return 0;
+    }
+
+    rose::core::WindowManager window_manager(options);
     window_manager.run();
 }